@@ -0,0 +1,192 @@
+/*
+ * AnalysisService.h - off-audio-thread analysis of audio signals for meters,
+ *                     scopes and spectrum displays
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef ANALYSIS_SERVICE_H
+#define ANALYSIS_SERVICE_H
+
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <vector>
+
+#include "lmms_export.h"
+#include "LocklessRingBuffer.h"
+
+namespace lmms
+{
+
+class AnalysisService;
+
+
+//! Interface for expensive analysis (e.g. FFT) that is run by the
+//! AnalysisService threads instead of the audio thread
+class AnalysisProcessor
+{
+public:
+	virtual ~AnalysisProcessor() = default;
+
+	//! Called at GUI rate with all frames written since the last call.
+	//! May be called with zero frames, e.g. to let the processor apply
+	//! pending state changes.
+	virtual void analyze(const sampleFrame* buffer, fpp_t frames) = 0;
+};
+
+
+/**
+	\brief A point in the signal path that can be watched by the GUI
+
+	The audio thread hands its buffers over with write(), which only costs a
+	lockless ringbuffer write and is skipped entirely while no view watches
+	the tap. Views keep a tap alive by calling requestAnalysis() from their
+	periodic update; once they stop doing so (e.g. because they have been
+	hidden), the tap deactivates itself.
+
+	Peak and RMS values are always computed. Additional work is attached by
+	registering an AnalysisProcessor.
+*/
+class LMMS_EXPORT AnalysisTap
+{
+public:
+	AnalysisTap();
+	~AnalysisTap();
+
+	AnalysisTap(const AnalysisTap&) = delete;
+	AnalysisTap& operator=(const AnalysisTap&) = delete;
+
+	//! Audio thread: pass a buffer on for analysis
+	void write(const sampleFrame* buffer, fpp_t frames)
+	{
+		if (m_active.load(std::memory_order_acquire))
+		{
+			m_buffer.write(buffer, frames);
+		}
+	}
+
+	//! GUI thread: keep the analysis of this tap running for a while
+	void requestAnalysis();
+
+	bool isActive() const
+	{
+		return m_active.load(std::memory_order_acquire);
+	}
+
+	//! Fetch the peak values measured since the last call.
+	//! Returns false if no new data has been analyzed in the meantime.
+	bool takePeaks(float& left, float& right);
+
+	float rmsLeft() const { return m_rmsLeft.load(std::memory_order_relaxed); }
+	float rmsRight() const { return m_rmsRight.load(std::memory_order_relaxed); }
+
+	//! The processor is called by the service threads; removeProcessor()
+	//! blocks until a running analyze() call has returned
+	void addProcessor(AnalysisProcessor* processor);
+	void removeProcessor(AnalysisProcessor* processor);
+
+private:
+	//! Called by the service threads, returns whether the tap is still active
+	bool process(qint64 now);
+
+	static constexpr std::size_t BufferSize = 4 * 4096;
+
+	LocklessRingBuffer<sampleFrame> m_buffer;
+	LocklessRingBufferReader<sampleFrame> m_reader;
+	std::vector<sampleFrame> m_scratch;
+
+	std::atomic<bool> m_active;
+	std::atomic<qint64> m_lastRequest;
+	std::atomic_flag m_busy = ATOMIC_FLAG_INIT;
+
+	std::atomic<float> m_peakLeft;
+	std::atomic<float> m_peakRight;
+	std::atomic<float> m_rmsLeft;
+	std::atomic<float> m_rmsRight;
+	std::atomic<bool> m_hasNewPeaks;
+
+	QMutex m_processorsLock;
+	QVector<AnalysisProcessor*> m_processors;
+
+	friend class AnalysisService;
+};
+
+
+/**
+	\brief Small thread pool running all AnalysisTaps at GUI rate
+
+	The threads sleep as long as no tap is active, so the service costs
+	nothing while no meter, scope or spectrum view is open.
+*/
+class LMMS_EXPORT AnalysisService
+{
+public:
+	//! How often active taps are analyzed
+	static constexpr int UpdateInterval = 1000 / 60;
+	//! How long a tap stays active after the last requestAnalysis()
+	static constexpr int KeepAliveTime = 500;
+
+	AnalysisService();
+	~AnalysisService();
+
+	void registerTap(AnalysisTap* tap);
+	void unregisterTap(AnalysisTap* tap);
+
+	//! Wake the threads up after a tap was (re)activated
+	void wakeUp();
+
+	static qint64 now();
+
+private:
+	class Worker : public QThread
+	{
+	public:
+		Worker(AnalysisService* service);
+
+	private:
+		void run() override;
+
+		AnalysisService* m_service;
+	};
+
+	//! Run all active taps, returns whether any of them is still active
+	bool processTaps();
+
+	QVector<AnalysisTap*> m_taps;
+	QReadWriteLock m_tapsLock;
+
+	QVector<Worker*> m_workers;
+	std::atomic<bool> m_quit;
+
+	QMutex m_idleMutex;
+	QWaitCondition m_idleCondition;
+	bool m_wakeRequested;
+};
+
+
+} // namespace lmms
+
+#endif // ANALYSIS_SERVICE_H
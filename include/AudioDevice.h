@@ -64,6 +64,11 @@ public:
 	virtual void unregisterPort( AudioPort * _port );
 	virtual void renamePort( AudioPort * _port );
 
+	// called by the mixer in the rendering thread once per period after
+	// the master mix, while the buffers of all AudioPorts and mixer
+	// channels still hold the output of this period
+	virtual void processExtOutputs();
+
 
 	inline bool supportsCapture() const
 	{
@@ -89,6 +94,14 @@ public:
 
 	virtual void stopProcessing();
 
+	// whether the driver renders by calling
+	// AudioEngine::renderNextBufferSynchronously() from within its process
+	// callback instead of being fed by the FIFO writer thread
+	virtual bool isSynchronous() const
+	{
+		return false;
+	}
+
 	virtual void applyQualitySettings();
 
 
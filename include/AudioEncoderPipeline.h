@@ -0,0 +1,153 @@
+/*
+ * AudioEncoderPipeline.h - audio device which feeds the rendered output to
+ *                          several file encoders running on their own threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AUDIO_ENCODER_PIPELINE_H
+#define AUDIO_ENCODER_PIPELINE_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QSemaphore>
+#include <QStringList>
+#include <QThread>
+
+#include "AudioDevice.h"
+
+namespace lmms
+{
+
+class AudioFileDevice;
+
+
+/**
+	\brief Renders once and encodes into any number of files
+
+	Every period is copied into a ring of preallocated slots, from which one
+	thread per AudioFileDevice encodes it. The render loop only blocks when
+	the slowest encoder lags QueueCapacity periods behind, so encoding
+	overlaps with rendering instead of adding to it.
+
+	The pipeline runs at the highest sample rate of its encoders. Encoders
+	with a lower rate, like OGG above 48 kHz, resample on their own thread.
+*/
+class AudioEncoderPipeline : public AudioDevice
+{
+public:
+	//! Number of periods the encoders may lag behind the render loop
+	static constexpr int QueueCapacity = 16;
+
+	AudioEncoderPipeline(ch_cnt_t channels, AudioEngine* audioEngine);
+	~AudioEncoderPipeline() override;
+
+	//! Takes ownership of the encoder. Only call this before processing
+	//! has been started.
+	void addEncoder(AudioFileDevice* encoder);
+
+	bool hasEncoders() const
+	{
+		return !m_encoders.empty();
+	}
+
+	QStringList outputFiles() const;
+
+	//! Only encode the output frames in [begin, end), counted from the
+	//! first written period. Nothing is encoded while begin is negative,
+	//! and everything after begin while end is.
+	void setOutputWindow(f_cnt_t begin, f_cnt_t end)
+	{
+		m_windowBegin = begin;
+		m_windowEnd = end;
+	}
+
+	//! Whether all frames of a bounded output window have been written
+	bool isOutputWindowComplete() const
+	{
+		return m_windowEnd >= 0 && m_framesWritten >= m_windowEnd;
+	}
+
+	void startProcessing() override;
+
+	//! Wait until all queued periods have been encoded and stop the
+	//! encoder threads. The files are completed when the pipeline is
+	//! destroyed.
+	void finish();
+
+
+protected:
+	void writeBuffer(const surroundSampleFrame* buffer, const fpp_t frames, const float masterGain) override;
+
+
+private:
+	struct Slot
+	{
+		std::vector<surroundSampleFrame> frames;
+		//! 0 tells the encoder threads to quit
+		fpp_t count = 0;
+		float masterGain = 1.0f;
+		//! Number of encoders which have not encoded the slot yet
+		std::atomic<int> pending{0};
+	} ;
+
+	class EncoderThread : public QThread
+	{
+	public:
+		EncoderThread(AudioEncoderPipeline* pipeline, AudioFileDevice* encoder);
+
+		//! Called by the render thread when the next slot is filled
+		void slotFilled()
+		{
+			m_filledSlots.release();
+		}
+
+	private:
+		void run() override;
+
+		AudioEncoderPipeline* m_pipeline;
+		AudioFileDevice* m_encoder;
+		QSemaphore m_filledSlots;
+	} ;
+
+	void publish(Slot& slot);
+	void release(Slot& slot);
+
+	std::array<Slot, QueueCapacity> m_slots;
+	QSemaphore m_freeSlots;
+	int m_writeIndex;
+	bool m_running;
+
+	f_cnt_t m_framesWritten;
+	f_cnt_t m_windowBegin;
+	f_cnt_t m_windowEnd;
+
+	std::vector<std::unique_ptr<AudioFileDevice>> m_encoders;
+	std::vector<std::unique_ptr<EncoderThread>> m_threads;
+} ;
+
+
+} // namespace lmms
+
+#endif // AUDIO_ENCODER_PIPELINE_H
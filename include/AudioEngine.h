@@ -38,6 +38,7 @@
 
 
 #include "lmms_basics.h"
+#include "AnalysisService.h"
 #include "LocklessList.h"
 #include "FifoBuffer.h"
 #include "AudioEngineProfiler.h"
@@ -55,6 +56,8 @@ class AudioEngineWorkerThread;
 
 const fpp_t MINIMUM_BUFFER_SIZE = 32;
 const fpp_t DEFAULT_BUFFER_SIZE = 256;
+//! Upper bound for the period of a render-only engine, see Engine::init()
+const fpp_t MAXIMUM_RENDER_BLOCK_SIZE = 8192;
 
 const int BYTES_PER_SAMPLE = sizeof( sample_t );
 const int BYTES_PER_INT_SAMPLE = sizeof( int_sample_t );
@@ -232,6 +235,11 @@ public:
 
 	void removeAudioPort(AudioPort * port);
 
+	inline const QVector<AudioPort *> & audioPorts() const
+	{
+		return m_audioPorts;
+	}
+
 
 	// MIDI-client-stuff
 	inline const QString & midiClientName() const
@@ -264,6 +272,13 @@ public:
 		return m_framesPerPeriod;
 	}
 
+	//! Whether effect chains pass planar buffers to the effects which can
+	//! process them, instead of interleaved frames
+	inline bool usesPlanarBuffers() const
+	{
+		return m_planarBuffers;
+	}
+
 
 	AudioEngineProfiler& profiler()
 	{
@@ -312,13 +327,11 @@ public:
 	}
 
 
-	struct StereoSample
+	//! The master output as seen by meters and scopes
+	AnalysisTap & outputTap()
 	{
-		StereoSample(sample_t _left, sample_t _right) : left(_left), right(_right) {}
-		sample_t left;
-		sample_t right;
-	};
-	StereoSample getPeakValues(sampleFrame * ab, const f_cnt_t _frames) const;
+		return m_outputTap;
+	}
 
 
 	bool criticalXRuns() const;
@@ -345,6 +358,14 @@ public:
 		return hasFifoWriter() ? m_fifo->read() : renderNextBuffer();
 	}
 
+	//! For audio devices rendering from within their process callback (see
+	//! AudioDevice::isSynchronous()): render the next period. A change in
+	//! model in progress is waited for during half a period at most, then
+	//! nullptr is returned instead of blocking the callback any longer.
+	//! Unlike nextBuffer(), this returns the period just rendered, which
+	//! stays valid until the next call.
+	const surroundSampleFrame * renderNextBufferSynchronously();
+
 	void changeQuality(const struct qualitySettings & qs);
 
 	inline bool isMetronomeActive() const { return m_metronomeActive; }
@@ -391,7 +412,7 @@ private:
 	} ;
 
 
-	AudioEngine( bool renderOnly );
+	AudioEngine( bool renderOnly, fpp_t renderBlockSize );
 	~AudioEngine() override;
 
 	void startProcessing(bool needsFifo = true);
@@ -415,6 +436,7 @@ private:
 	void runChangesInModel();
 
 	bool m_renderOnly;
+	bool m_planarBuffers;
 
 	QVector<AudioPort *> m_audioPorts;
 
@@ -462,6 +484,8 @@ private:
 
 	AudioEngineProfiler m_profiler;
 
+	AnalysisTap m_outputTap;
+
 	bool m_metronomeActive;
 
 	bool m_clearSignal;
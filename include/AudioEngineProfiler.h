@@ -26,6 +26,8 @@
 #define AUDIO_ENGINE_PROFILER_H
 
 #include <QFile>
+#include <QMutex>
+#include <QStringList>
 
 #include "lmms_basics.h"
 #include "MicroTimer.h"
@@ -53,11 +55,19 @@ public:
 
 	void setOutputFile( const QString& outputFile );
 
+	//! Record how a thread or the process has been set up. Written to the
+	//! output file as comments, as threads may report late.
+	void addConfiguration( const QString& name, const QString& value );
+
 
 private:
 	MicroTimer m_periodTimer;
 	int m_cpuLoad;
 	QFile m_outputFile;
+
+	QMutex m_configurationMutex;
+	QStringList m_configuration;
+	int m_configurationWritten;
 };
 
 } // namespace lmms
@@ -116,6 +116,9 @@ private:
 	static QWaitCondition * queueReadyWaitCond;
 	static QList<AudioEngineWorkerThread *> workerThreads;
 
+	AudioEngine* m_audioEngine;
+	//! Selects the CPU if workers are pinned
+	int m_index;
 	volatile bool m_quit;
 } ;
 
@@ -27,6 +27,7 @@
 #define AUDIO_FILE_DEVICE_H
 
 #include <QFile>
+#include <vector>
 
 #include "AudioDevice.h"
 #include "OutputSettings.h"
@@ -49,6 +50,12 @@ public:
 
 	OutputSettings const & getOutputSettings() const { return m_outputSettings; }
 
+	// encode a buffer rendered at sourceRate, resampling it first if this
+	// file has another sample rate - used by AudioEncoderPipeline, which
+	// calls it from the encoder's own thread
+	void encodeBuffer( const surroundSampleFrame * buffer, const fpp_t frames,
+					const float masterGain, const sample_rate_t sourceRate );
+
 
 protected:
 	int writeData( const void* data, int len );
@@ -66,6 +73,8 @@ protected:
 private:
 	QFile m_outputFile;
 	OutputSettings m_outputSettings;
+
+	std::vector<surroundSampleFrame> m_resampleBuffer;
 } ;
 
 using AudioFileDeviceInstantiaton
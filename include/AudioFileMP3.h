@@ -30,6 +30,8 @@
 
 #ifdef LMMS_HAVE_MP3LAME
 
+#include <vector>
+
 #include "AudioFileDevice.h"
 
 #include "lame/lame.h"
@@ -69,6 +71,10 @@ private:
 
 private:
 	lame_t m_lame;
+
+	// reused for every period, writeBuffer() runs once per period
+	std::vector<float> m_interleavedBuffer;
+	std::vector<unsigned char> m_encodingBuffer;
 };
 
 } // namespace lmms
@@ -30,6 +30,7 @@
 #include "AudioFileDevice.h"
 
 #include <sndfile.h>
+#include <vector>
 
 namespace lmms
 {
@@ -66,6 +67,10 @@ private:
 private:
 	SF_INFO m_si;
 	SNDFILE * m_sf;
+
+	// conversion buffers, reused for every period
+	std::vector<float> m_floatBuffer;
+	std::vector<int_sample_t> m_intBuffer;
 } ;
 
 
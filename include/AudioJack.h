@@ -35,10 +35,14 @@
 #endif
 
 #include <atomic>
+#include <vector>
+#include <QMap>
+#include <QMutex>
 #include <QVector>
 
 #include "AudioDevice.h"
 #include "AudioDeviceSetupWidget.h"
+#include "LocklessRingBuffer.h"
 
 class QLineEdit;
 
@@ -50,6 +54,7 @@ class MidiJack;
 namespace gui
 {
 class LcdSpinBox;
+class LedCheckBox;
 }
 
 
@@ -85,24 +90,90 @@ class setupWidget : public gui::AudioDeviceSetupWidget
 	private:
 		QLineEdit * m_clientName;
 		gui::LcdSpinBox * m_channels;
+		gui::LedCheckBox * m_mixerOutputs;
+		gui::LedCheckBox * m_trackOutputs;
+		gui::LedCheckBox * m_synchronous;
 
 	} ;
 
 
 private slots:
 	void restartAfterZombified();
+	void updateExtOutputs();
+	void collectRetiredExtOutputs();
 
 
 private:
+	//! A stereo pair of JACK ports providing the output of a single mixer
+	//! channel or AudioPort
+	struct ExtOutput
+	{
+		ExtOutput( AudioPort * _port, int _mixerChannel );
+
+		// source of the output: either an AudioPort or a mixer channel
+		AudioPort * port;
+		int mixerChannel;
+
+		jack_port_t * ports[DEFAULT_CHANNELS];
+		// only used by the process callback
+		jack_default_audio_sample_t * portBuffers[DEFAULT_CHANNELS];
+		quint64 portCycle;
+		bool running;
+
+		// written once per period by the rendering thread and drained by
+		// the process callback in lockstep with the master output
+		LocklessRingBuffer<sampleFrame> buffer;
+		LocklessRingBufferReader<sampleFrame> reader;
+
+		// index of the first period written to the buffer, -1 if none yet
+		std::atomic<qint64> firstPeriod;
+	} ;
+
+	using ExtOutputList = std::vector<ExtOutput *>;
+
+	//! Outputs and lists which might still be used by the process callback
+	struct RetiredExtOutputs
+	{
+		quint64 callbackCount;
+		ExtOutputList * list;
+		QVector<ExtOutput *> outputs;
+	} ;
+
 	bool initJackClient();
 
 	void startProcessing() override;
 	void stopProcessing() override;
+	bool isSynchronous() const override;
 	void applyQualitySettings() override;
 
 	void registerPort( AudioPort * _port ) override;
 	void unregisterPort( AudioPort * _port ) override;
 	void renamePort( AudioPort * _port ) override;
+	void processExtOutputs() override;
+
+	ExtOutput * createExtOutput( const QString & _name, AudioPort * _port,
+							int _mixerChannel );
+	void setExtOutputName( ExtOutput * _output, const QString & _name );
+	QString uniquePortName( const QString & _name ) const;
+
+	// hand the current set of outputs over to the rendering thread and the
+	// process callback, retiring the outputs which have been removed
+	void publishExtOutputs( const QVector<ExtOutput *> & _removed );
+	void clearExtOutputs();
+	void deleteExtOutputs( ExtOutputList * _list,
+				const QVector<ExtOutput *> & _outputs );
+
+	bool startExtOutput( ExtOutput * _output );
+	void writeExtOutputs( ExtOutputList * _outputs, jack_nframes_t _offset,
+						jack_nframes_t _frames );
+	void skipExtOutputs( ExtOutputList * _outputs, fpp_t _frames );
+
+	// fill the port buffers from the FIFO or render the engine's periods
+	// right in the process callback, both return the number of frames written
+	jack_nframes_t pullFromFifo( ExtOutputList * _outputs,
+						jack_nframes_t _nframes );
+	jack_nframes_t renderInCallback( ExtOutputList * _outputs,
+						jack_nframes_t _nframes );
 
 	int processCallback( jack_nframes_t _nframes, void * _udata );
 
@@ -124,16 +195,34 @@ private:
 	f_cnt_t m_framesDoneInCurBuf;
 	f_cnt_t m_framesToDoInCurBuf;
 
-
-#ifdef AUDIO_PORT_SUPPORT
-	struct StereoPort
-	{
-		jack_port_t * ports[2];
-	} ;
-
-	using JackPortMap = QMap<AudioPort *, StereoPort>;
-	JackPortMap m_portMap;
-#endif
+	const bool m_mixerOutputsEnabled;
+	const bool m_trackOutputsEnabled;
+
+	// render in the process callback instead of the FIFO writer thread
+	const bool m_synchronous;
+	std::atomic<bool> m_renderInCallback;
+	// where periods rendered in the callback go in the port buffers
+	qint64 m_directOutputOffset;
+
+	// bookkeeping of the external outputs, never touched by the rendering
+	// thread or the process callback
+	QMutex m_extOutputsLock;
+	QVector<AudioPort *> m_pendingPorts;
+	QMap<AudioPort *, ExtOutput *> m_portOutputs;
+	QVector<ExtOutput *> m_mixerOutputs;
+	QVector<RetiredExtOutputs> m_retiredExtOutputs;
+
+	// the outputs in use by the rendering thread and the process callback
+	std::atomic<ExtOutputList *> m_extOutputs;
+	std::vector<sampleFrame> m_silence;
+
+	// number of periods rendered and index of the period being played,
+	// used for keeping the external outputs in sync with the master output
+	std::atomic<qint64> m_renderedPeriods;
+	qint64 m_currentPeriod;
+	bool m_extOutputsInSync;
+
+	std::atomic<quint64> m_callbackCount;
 
 signals:
 	void zombified();
@@ -25,10 +25,12 @@
 #ifndef AUDIO_PORT_H
 #define AUDIO_PORT_H
 
+#include <atomic>
 #include <memory>
 #include <QString>
 #include <QMutex>
 
+#include "CompensationDelay.h"
 #include "MemoryManager.h"
 #include "PlayHandle.h"
 
@@ -72,6 +74,9 @@ public:
 
 	void setExtOutputEnabled( bool _enabled );
 
+	// whether the port is muted - its buffer is not updated then
+	bool isMuted() const;
+
 
 	// next mixer-channel after this audio-port
 	// (-1 = none  0 = master)
@@ -101,6 +106,38 @@ public:
 
 	bool processEffects();
 
+	//! Latency of the instrument feeding this port, set while processing it
+	void setSourceLatency( f_cnt_t frames )
+	{
+		m_sourceLatency = frames;
+	}
+
+	//! Frames by which the output lags behind the song, including effects
+	f_cnt_t latency() const;
+
+	//! Delay applied to the output to line it up with slower paths into the
+	//! same mixer channel, see Mixer::updateLatencyCompensation()
+	void setCompensation( f_cnt_t frames )
+	{
+		m_compensation.setDelay( frames );
+	}
+
+	f_cnt_t compensation() const
+	{
+		return m_compensation.delay();
+	}
+
+	bool needsCompensationReserve() const
+	{
+		return m_compensation.needsReserve();
+	}
+
+	//! See Mixer::reserveCompensationDelays()
+	void reserveCompensation()
+	{
+		m_compensation.reserve();
+	}
+
 	// ThreadableJob stuff
 	void doProcessing() override;
 	bool requiresProcessing() const override
@@ -124,6 +161,9 @@ private:
 
 	std::unique_ptr<EffectChain> m_effects;
 
+	std::atomic<f_cnt_t> m_sourceLatency;
+	CompensationDelay m_compensation;
+
 	PlayHandleList m_playHandles;
 	QMutex m_playHandleLock;
 
@@ -26,10 +26,8 @@
 #ifndef AUDIO_SAMPLE_RECORDER_H
 #define AUDIO_SAMPLE_RECORDER_H
 
-#include <QList>
-#include <QPair>
-
 #include "AudioDevice.h"
+#include "DiskRecorder.h"
 
 namespace lmms
 {
@@ -44,6 +42,8 @@ public:
 	~AudioSampleRecorder() override;
 
 	f_cnt_t framesRecorded() const;
+	//! Finish the recording and load it from the written file. Returns an
+	//! empty buffer if nothing could be recorded.
 	void createSampleBuffer( SampleBuffer** sampleBuffer );
 
 
@@ -52,8 +52,8 @@ private:
 						const fpp_t _frames,
 						const float _master_gain ) override;
 
-	using BufferList = QList<QPair<sampleFrame*, fpp_t>>;
-	BufferList m_buffers;
+	DiskRecorder::TakePtr m_take;
+	bool m_finished;
 
 } ;
 
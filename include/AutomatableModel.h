@@ -27,6 +27,7 @@
 
 #include <QMap>
 #include <QMutex>
+#include <vector>
 
 #include "JournallingObject.h"
 #include "Model.h"
@@ -212,7 +213,10 @@ public:
 
 	void setInitValue( const float value );
 
-	void setAutomatedValue( const float value );
+	//! @param frameOffset Offset of the automation tick in the current
+	//!        period. If a period holds several ticks, valueBuffer() follows
+	//!        each of them instead of only the last one.
+	void setAutomatedValue( const float value, const fpp_t frameOffset = 0 );
 	void setValue( const float value );
 
 	void incValue( int steps )
@@ -270,6 +274,10 @@ public:
 				specified DOM element using <name> as attribute/node name */
 	virtual void loadSettings( const QDomElement& element, const QString& name );
 
+	/*! \brief Whether the model saved as <name> in the specified DOM element is automated or
+				controlled, which can be checked before loading it and resolving automation */
+	static bool isSavedAutomated( const QDomElement& element, const QString& name );
+
 	QString nodeName() const override
 	{
 		return "automatablemodel";
@@ -312,6 +320,12 @@ public:
 		s_periodCounter = 0;
 	}
 
+	//! Number of the period currently being rendered
+	static long periodCounter()
+	{
+		return s_periodCounter;
+	}
+
 	bool useControllerValue()
 	{
 		return m_useControllerValue;
@@ -410,6 +424,21 @@ private:
 	long m_lastUpdatedPeriod;
 	static long s_periodCounter;
 
+	struct AutomationStep
+	{
+		fpp_t frameOffset;
+		float value;
+	} ;
+
+	//! Values set by automation during the period m_automationStepsPeriod
+	std::vector<AutomationStep> m_automationSteps;
+	long m_automationStepsPeriod;
+	//! The value before the first step of that period
+	float m_automationStartValue;
+
+	bool followsAutomationSteps() const;
+	void fillFromAutomationSteps();
+
 	bool m_hasSampleExactData;
 
 	// prevent several threads from attempting to write the same vb at the same time
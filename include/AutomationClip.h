@@ -27,12 +27,17 @@
 #ifndef AUTOMATION_CLIP_H
 #define AUTOMATION_CLIP_H
 
+#include <array>
+#include <atomic>
+#include <memory>
+
 #include <QMap>
 #include <QPointer>
 #if (QT_VERSION >= QT_VERSION_CHECK(5,14,0))
 	#include <QRecursiveMutex>
 #endif
 
+#include "AutomationCurve.h"
 #include "AutomationNode.h"
 #include "Clip.h"
 
@@ -154,6 +159,11 @@ public:
 	float valueAt( const TimePos & _time ) const;
 	float *valuesAfter( const TimePos & _time ) const;
 
+	//! The values sampled for drawing at a zoom of @p ticksPerPixel. Built
+	//! on first use after the nodes changed and shared by all views, so it
+	//! must only be called by the GUI thread.
+	std::shared_ptr<const AutomationCurve> curve( float ticksPerPixel ) const;
+
 	const QString name() const;
 
 	// settings-management
@@ -189,6 +199,14 @@ private:
 	void generateTangents();
 	void generateTangents(timeMap::iterator it, int numToGenerate);
 	float valueAt( timeMap::const_iterator v, int offset ) const;
+	static float valueAt( timeMap::const_iterator v, int offset,
+				ProgressionTypes progression, float tension );
+
+	//! The nodes changed, may be called by any thread
+	void invalidateCurves()
+	{
+		m_curveGeneration.fetch_add( 1, std::memory_order_relaxed );
+	}
 
 	// Mutex to make methods involving automation clips thread safe
 	// Mutable so we can lock it from const objects
@@ -214,12 +232,18 @@ private:
 	bool m_isRecording;
 	float m_lastRecordedValue;
 
+	//! Curves cached per resolution and the generation they were built for
+	mutable std::array<std::shared_ptr<const AutomationCurve>, AutomationCurve::Resolutions> m_curves;
+	mutable std::array<int, AutomationCurve::Resolutions> m_curveGenerations;
+	std::atomic<int> m_curveGeneration;
+
 	static int s_quantization;
 
 	static const float DEFAULT_MIN_VALUE;
 	static const float DEFAULT_MAX_VALUE;
 
 	friend class gui::AutomationClipView;
+	friend class AutomationCurve;
 	friend class AutomationNode;
 
 } ;
@@ -0,0 +1,116 @@
+/*
+ * AutomationCurve.h - polyline of the values of an automation clip
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef AUTOMATION_CURVE_H
+#define AUTOMATION_CURVE_H
+
+#include <vector>
+
+#include "lmms_basics.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class AutomationClip;
+
+
+/**
+	\brief The values of an automation clip sampled for drawing
+
+	Holds one polyline per segment between two nodes, sampled every
+	ticksPerPoint() ticks. Discrete and linear segments only need their end
+	points, so just cubic segments get more points at finer resolutions.
+	Drawing from it needs neither valueAt() nor the lock of the clip, which
+	the audio thread takes while processing automations.
+
+	Curves are built and cached by AutomationClip::curve() for a few
+	resolutions, so the views can pick the one matching their zoom.
+*/
+class LMMS_EXPORT AutomationCurve
+{
+public:
+	//! Number of resolutions cached, from 1 to 256 ticks per point
+	static constexpr int Resolutions = 5;
+
+	struct Point
+	{
+		tick_t tick;
+		float value;
+	} ;
+
+	//! Points of the curve between two neighbouring nodes
+	struct Segment
+	{
+		tick_t begin;
+		tick_t end;
+		//! Index of the first point, which is at begin
+		int first;
+		//! Number of points, the last one is at end
+		int count;
+	} ;
+
+	//! Samples @p clip at resolution @p level
+	AutomationCurve(const AutomationClip& clip, int level);
+
+	//! Ticks per point of resolution @p level
+	static int ticksPerPoint(int level)
+	{
+		return 1 << (2 * level);
+	}
+
+	//! Coarsest resolution still having a point per pixel
+	static int levelFor(float ticksPerPixel);
+
+	int ticksPerPoint() const
+	{
+		return m_ticksPerPoint;
+	}
+
+	//! One segment per node except the last one, in the order of the nodes
+	const std::vector<Segment>& segments() const
+	{
+		return m_segments;
+	}
+
+	const Point* begin(const Segment& segment) const
+	{
+		return m_points.data() + segment.first;
+	}
+
+	const Point* end(const Segment& segment) const
+	{
+		return m_points.data() + segment.first + segment.count;
+	}
+
+private:
+	int m_ticksPerPoint;
+	std::vector<Segment> m_segments;
+	std::vector<Point> m_points;
+} ;
+
+
+} // namespace lmms
+
+#endif // AUTOMATION_CURVE_H
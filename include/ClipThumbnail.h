@@ -0,0 +1,108 @@
+/*
+ * ClipThumbnail.h - content of a clip view rendered in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef CLIP_THUMBNAIL_H
+#define CLIP_THUMBNAIL_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+
+class QPainter;
+
+namespace lmms::gui
+{
+
+
+/**
+	\brief Cached image of the content of a clip, e.g. its notes or waveform
+
+	Clip views draw their background, borders and label themselves and only
+	blit this image on top, so repainting a clip doesn't depend on how much
+	it contains. The image is rendered by a thread of the global thread pool
+	and ready() is emitted once it is available; until then, the last image
+	can be drawn instead. Views call invalidate() when the clip's data
+	changes and request() whenever isValid() returns false.
+
+	Must be owned by a std::shared_ptr, so it outlives running renders.
+*/
+class ClipThumbnail : public QObject, public std::enable_shared_from_this<ClipThumbnail>
+{
+	Q_OBJECT
+public:
+	//! Draws into a transparent image of the requested size. Called by a
+	//! worker thread, so it must only use data it owns.
+	using Renderer = std::function<void(QPainter&, const QSize&)>;
+
+	ClipThumbnail();
+	~ClipThumbnail() override = default;
+
+	//! The content changed, the current image is only kept until the new
+	//! one is ready
+	void invalidate()
+	{
+		++m_generation;
+	}
+
+	//! Whether the image shows the current content at @p size
+	bool isValid(const QSize& size) const;
+
+	//! The last image rendered, may be out of date or of another size and
+	//! is null before the first render finished
+	QImage image() const;
+
+	//! Render the current content at @p size, unless this is already
+	//! running. Renders which are superseded before they start are skipped.
+	void request(const QSize& size, Renderer renderer);
+
+signals:
+	void ready();
+
+private:
+	class RenderJob;
+
+	//! Called by the worker thread
+	void render(const QSize& size, int generation, int request, const Renderer& renderer);
+
+	mutable QMutex m_imageMutex;
+	QImage m_image;
+	int m_imageGeneration;
+
+	//! Only used by the GUI thread
+	int m_generation;
+	int m_pendingGeneration;
+	QSize m_pendingSize;
+
+	//! Number of the latest request, older ones are skipped
+	std::atomic<int> m_request;
+} ;
+
+
+} // namespace lmms::gui
+
+#endif // CLIP_THUMBNAIL_H
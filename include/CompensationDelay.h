@@ -0,0 +1,95 @@
+/*
+ * CompensationDelay.h - delay line aligning signals of different latency
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef COMPENSATION_DELAY_H
+#define COMPENSATION_DELAY_H
+
+#include <atomic>
+#include <vector>
+
+#include "lmms_basics.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Whole-frame delay used for plugin delay compensation
+
+	A path through the mixer with less latency than a parallel one is
+	delayed by the difference, so that both arrive at the same time. Changing
+	the delay clears the line, the rare click is preferred over resampling.
+
+	The delay is set on the audio thread, which must not allocate, so the
+	line only grows in reserve(). Until then the delay is cut short.
+*/
+class LMMS_EXPORT CompensationDelay
+{
+public:
+	CompensationDelay();
+
+	f_cnt_t delay() const
+	{
+		return m_delay;
+	}
+
+	void setDelay( f_cnt_t frames );
+
+	//! Whether the line is too short for the last delay set
+	bool needsReserve() const
+	{
+		return m_requested.load( std::memory_order_relaxed ) > static_cast<f_cnt_t>( m_line.size() );
+	}
+
+	//! Grow the line to the last delay set. Must not run concurrently with
+	//! process(), e.g. while the audio engine is locked.
+	void reserve();
+
+	//! Drop the input still in the line, for paths which stopped processing
+	void clear();
+
+	//! Whether input is still on its way through the line, i.e. whether
+	//! silence must be fed in to get it out
+	bool isPending() const
+	{
+		return m_pending > 0;
+	}
+
+	//! Delay @p frames of @p buf in place
+	void process( sampleFrame * buf, fpp_t frames, bool hasInput = true );
+
+private:
+	std::vector<sampleFrame> m_line;
+	std::atomic<f_cnt_t> m_requested;
+	f_cnt_t m_delay;
+	f_cnt_t m_position;
+	//! Frames until the last input has left the line
+	f_cnt_t m_pending;
+} ;
+
+
+} // namespace lmms
+
+#endif // COMPENSATION_DELAY_H
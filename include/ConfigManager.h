@@ -49,6 +49,8 @@ const QString PRESETS_PATH = "presets/";
 const QString SAMPLES_PATH = "samples/";
 const QString GIG_PATH = "samples/gig/";
 const QString SF2_PATH = "samples/soundfonts/";
+const QString RECORDINGS_PATH = "samples/recordings/";
+const QString FREEZE_PATH = "freeze/";
 const QString LADSPA_PATH ="plugins/ladspa/";
 const QString DEFAULT_THEME_PATH = "themes/default/";
 const QString TRACK_ICON_PATH = "track_icons/";
@@ -129,6 +131,17 @@ public:
 		return workingDir() + SAMPLES_PATH;
 	}
 
+	QString userRecordingsDir() const
+	{
+		return workingDir() + RECORDINGS_PATH;
+	}
+
+	//! Stems of frozen tracks, see TrackFreezer
+	QString userFreezeDir() const
+	{
+		return workingDir() + FREEZE_PATH;
+	}
+
 
 	const QString & vstDir() const
 	{
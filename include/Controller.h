@@ -27,10 +27,13 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <QMutex>
+
 #include "lmms_export.h"
 #include "Engine.h"
 #include "Model.h"
 #include "JournallingObject.h"
+#include "ThreadableJob.h"
 #include "ValueBuffer.h"
 
 namespace lmms
@@ -48,7 +51,7 @@ class ControllerDialog;
 
 using ControllerVector = QVector<Controller*>;
 
-class LMMS_EXPORT Controller : public Model, public JournallingObject
+class LMMS_EXPORT Controller : public Model, public JournallingObject, public ThreadableJob
 {
 	Q_OBJECT
 public:
@@ -132,6 +135,18 @@ public:
 	static void triggerFrameCounter();
 	static void resetFrameCounter();
 
+	//! Compute the value buffers of all connected controllers for the
+	//! current period. Called by the AudioEngine before any instrument or
+	//! effect is processed; controllers are evaluated after the controllers
+	//! their own models are connected to, independent ones in parallel.
+	//! Afterwards, value() and valueBuffer() only read the results.
+	static void evaluateControllers();
+
+	bool requiresProcessing() const override
+	{
+		return m_connectionCount > 0;
+	}
+
 	//Accepts a ControllerConnection * as it may be used in the future.
 	void addConnection( ControllerConnection * );
 	void removeConnection( ControllerConnection * );
@@ -154,6 +169,8 @@ protected:
 
 	virtual void updateValueBuffer();
 
+	void doProcessing() override;
+
 	// buffer for storing sample-exact values in case there
 	// are more than one model wanting it, so we don't have to create it
 	// again every time
@@ -161,7 +178,6 @@ protected:
 	// when we last updated the valuebuffer - so we know if we have to update it
 	long m_bufferLastUpdated;
 
-	float m_currentValue;
 	bool  m_sampleExact;
 	int m_connectionCount;
 
@@ -173,6 +189,27 @@ protected:
 	static long s_periods;
 
 
+private:
+	//! Whether evaluateControllers() takes care of this controller, the
+	//! others update their buffer on first access in a period
+	bool isEvaluatedPerPeriod() const
+	{
+		return m_type != DummyController && m_type != MidiController;
+	}
+
+	//! Controllers connected to the models of this controller
+	ControllerVector inputs() const;
+
+	static void updateEvaluationOrder();
+
+	//! Controllers grouped by the stage they are evaluated in
+	static QVector<ControllerVector> s_evaluationLevels;
+	static bool s_evaluationOrderChanged;
+	//! Guards the two above and keeps controllers from being destroyed
+	//! while they are evaluated
+	static QMutex s_evaluationMutex;
+
+
 signals:
 	// The value changed while the audio engine isn't running (i.e: MIDI CC)
 	void valueChanged();
@@ -0,0 +1,194 @@
+/*
+ * DiskRecorder.h - streams recorded audio to files on a background thread
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef DISK_RECORDER_H
+#define DISK_RECORDER_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QFile>
+#include <QMutex>
+#include <QObject>
+#include <QSemaphore>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <sndfile.h>
+
+#include "LocklessRingBuffer.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Writes recordings to disk while they are being recorded
+
+	Each take owns a lock-free ring which the audio thread fills without
+	allocating or blocking. A single writer thread streams all running takes
+	into their files, so any number of tracks can record at the same time and
+	memory use does not grow with the length of a take.
+
+	Takes are written to the recordings directory of the working directory
+	as WAV, W64 or FLAC, depending on "audioengine/recordformat" ("wav",
+	"w64" or "flac"). WAV and W64 headers are updated on every write, so the
+	file is complete up to the last written block if LMMS crashes. WAV files
+	are limited to 4 GB, long takes should use W64.
+*/
+class LMMS_EXPORT DiskRecorder : public QObject
+{
+	Q_OBJECT
+public:
+	enum class Format
+	{
+		Wave,
+		Wave64,
+		Flac
+	} ;
+
+	//! How often the writer thread looks for new data
+	static constexpr int PollInterval = 20;
+	//! Seconds of audio a take can buffer while the disk is busy
+	static constexpr int RingSeconds = 4;
+
+	class LMMS_EXPORT Take
+	{
+	public:
+		Take(const QString& name, sample_rate_t sampleRate, Format format);
+		~Take();
+
+		//! Called by the audio thread. Never blocks; frames which do not
+		//! fit into the ring are dropped and counted.
+		void write(const sampleFrame* buf, f_cnt_t frames);
+
+		//! Frames accepted by write()
+		f_cnt_t framesRecorded() const { return m_framesRecorded; }
+		f_cnt_t framesDropped() const { return m_framesDropped; }
+
+		//! Path of the file, known once the writer thread created it
+		const QString& fileName() const { return m_fileName; }
+		sample_rate_t sampleRate() const { return m_sampleRate; }
+
+		//! Whether a complete file has been written. Takes without any
+		//! data don't create a file. Valid once the take is closed.
+		bool isValid() const { return !m_failed && !m_fileName.isEmpty(); }
+
+	private:
+		//! Called by the writer thread
+		bool open();
+		bool flush(std::vector<sampleFrame>& scratch);
+		void close();
+
+		const QString m_name;
+		QString m_fileName;
+		const sample_rate_t m_sampleRate;
+		const Format m_format;
+
+		LocklessRingBuffer<sampleFrame> m_ring;
+		LocklessRingBufferReader<sampleFrame> m_reader;
+
+		QFile m_file;
+		SNDFILE* m_sf;
+		bool m_failed;
+
+		std::atomic<f_cnt_t> m_framesRecorded;
+		std::atomic<f_cnt_t> m_framesDropped;
+
+		//! set by finishTake(), no data is written afterwards
+		std::atomic<bool> m_finishing;
+		bool m_closed;
+		std::function<void(const Take&)> m_onFinished;
+
+		friend class DiskRecorder;
+	} ;
+
+	using TakePtr = std::shared_ptr<Take>;
+	using FinishedCallback = std::function<void(const Take&)>;
+
+	DiskRecorder();
+	~DiskRecorder() override;
+
+	//! Create a take named after @p name. Allocates the ring, so call this
+	//! before recording starts, not on the audio thread. The file is
+	//! created by the writer thread once data arrives. Once the finished
+	//! take is on disk and the file is closed, @p onFinished is called on
+	//! the thread of the recorder.
+	TakePtr startTake(const QString& name, sample_rate_t sampleRate, FinishedCallback onFinished = {});
+
+	//! Stop writing @p take. Does not block or allocate, so it can be called
+	//! from the audio thread.
+	void finishTake(const TakePtr& take);
+
+	//! Block until @p take has been finished and closed
+	void waitForTake(const TakePtr& take);
+
+	Format format() const { return m_format; }
+	void setFormat(Format format) { m_format = format; }
+
+	static QString fileExtension(Format format);
+
+private slots:
+	void deliverFinishedTakes();
+
+private:
+	class Writer : public QThread
+	{
+	public:
+		Writer(DiskRecorder* recorder);
+
+	private:
+		void run() override;
+
+		DiskRecorder* m_recorder;
+	} ;
+
+	//! Write the rings of all takes, returns whether anything was written
+	bool processTakes(std::vector<sampleFrame>& scratch);
+
+	static QString uniqueFileName(const QString& name, Format format);
+
+	std::atomic<Format> m_format;
+
+	std::vector<TakePtr> m_takes;
+	QMutex m_takesLock;
+
+	std::vector<TakePtr> m_finished;
+	QMutex m_finishedLock;
+
+	QMutex m_closedLock;
+	QWaitCondition m_closedCondition;
+
+	Writer m_writer;
+	QSemaphore m_wake;
+	std::atomic<bool> m_quit;
+} ;
+
+
+} // namespace lmms
+
+#endif // DISK_RECORDER_H
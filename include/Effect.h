@@ -26,18 +26,23 @@
 #ifndef EFFECT_H
 #define EFFECT_H
 
+#include <memory>
+#include <vector>
+
 #include "Plugin.h"
 #include "Engine.h"
 #include "AudioEngine.h"
 #include "AutomatableModel.h"
 #include "TempoSyncKnobModel.h"
 #include "MemoryManager.h"
+#include "PolyphaseResampler.h"
 
 namespace lmms
 {
 
 class EffectChain;
 class EffectControls;
+class PlanarBuffer;
 
 namespace gui
 {
@@ -69,6 +74,30 @@ public:
 	virtual bool processAudioBuffer( sampleFrame * _buf,
 						const fpp_t _frames ) = 0;
 
+	//! Effects which implement processPlanarBuffers() themselves return
+	//! true, so that effect chains don't convert the buffer for them
+	virtual bool hasPlanarProcessing() const
+	{
+		return false;
+	}
+
+	//! Process the non-interleaved channels of @p _in into @p _out. Effect
+	//! chains pass the output of one effect on as the input of the next
+	//! one, so effects can connect their ports to both buffers directly.
+	//! @p _in must not be modified, @p _out must be filled even if the
+	//! effect doesn't run. The default implementation is the adapter for
+	//! effects which only process interleaved frames.
+	virtual bool processPlanarBuffers( PlanarBuffer & _in, PlanarBuffer & _out,
+							const fpp_t _frames );
+
+	//! Frames by which the effect delays its output, at the processing
+	//! sample rate. Mixer channels which are mixed with this effect's output
+	//! are delayed by the same amount, see Mixer::updateLatencyCompensation().
+	virtual f_cnt_t latency() const
+	{
+		return 0;
+	}
+
 	inline ch_cnt_t processorCount() const
 	{
 		return m_processors;
@@ -184,34 +213,34 @@ protected:
 
 	// some effects might not be capable of higher sample-rates so they can
 	// sample it down before processing and back after processing
-	inline void sampleDown( const sampleFrame * _src_buf,
-							sampleFrame * _dst_buf,
-							sample_rate_t _dst_sr )
-	{
-		resample( 0, _src_buf,
-				Engine::audioEngine()->processingSampleRate(),
-					_dst_buf, _dst_sr,
-					Engine::audioEngine()->framesPerPeriod() );
-	}
+	//! Run the effect at @p _sr, resampling from and to the processing
+	//! sample rate. Rates at or above the processing rate disable it.
+	void setResamplingRate( sample_rate_t _sr );
 
-	inline void sampleBack( const sampleFrame * _src_buf,
-							sampleFrame * _dst_buf,
-							sample_rate_t _src_sr )
+	inline bool isResampling() const
 	{
-		resample( 1, _src_buf, _src_sr, _dst_buf,
-				Engine::audioEngine()->processingSampleRate(),
-			Engine::audioEngine()->framesPerPeriod() * _src_sr /
-				Engine::audioEngine()->processingSampleRate() );
+		return m_resampleDown != nullptr;
 	}
-	void reinitSRC();
+
+	//! Convert a period to the rate given to setResamplingRate(), returns
+	//! the number of frames written to @p _dst_buf. That varies from period
+	//! to period, but never exceeds maxResampledFrames().
+	f_cnt_t sampleDown( const sampleFrame * _src_buf, sampleFrame * _dst_buf );
+
+	//! Convert @p _frames processed frames back, always writes a full period
+	//! to @p _dst_buf
+	void sampleBack( const sampleFrame * _src_buf, f_cnt_t _frames,
+							sampleFrame * _dst_buf );
+
+	f_cnt_t maxResampledFrames() const;
+
+	//! Delay added by sampleDown() and sampleBack() together, at the
+	//! processing sample rate
+	f_cnt_t resamplingLatency() const;
 
 
 private:
 	EffectChain * m_parent;
-	void resample( int _i, const sampleFrame * _src_buf,
-					sample_rate_t _src_sr,
-					sampleFrame * _dst_buf, sample_rate_t _dst_sr,
-					const f_cnt_t _frames );
 
 	ch_cnt_t m_processors;
 
@@ -227,8 +256,14 @@ private:
 	
 	bool m_autoQuitDisabled;
 
-	SRC_DATA m_srcData[2];
-	SRC_STATE * m_srcState[2];
+	std::unique_ptr<PolyphaseResampler> m_resampleDown;
+	std::unique_ptr<PolyphaseResampler> m_resampleBack;
+	//! Output of sampleBack() which didn't fit into the last period. Primed
+	//! with m_resampleHeadroom frames of silence, as the number of frames
+	//! the effect produces per period jitters.
+	std::vector<sampleFrame> m_resampleFifo;
+	f_cnt_t m_resampleFifoFrames;
+	f_cnt_t m_resampleHeadroom;
 
 
 	friend class gui::EffectView;
@@ -26,14 +26,21 @@
 #ifndef EFFECT_CHAIN_H
 #define EFFECT_CHAIN_H
 
+#include <array>
+#include <memory>
+
+#include <QDomDocument>
+
 #include "Model.h"
 #include "SerializingObject.h"
 #include "AutomatableModel.h"
+#include "PlanarBuffer.h"
 
 namespace lmms
 {
 
 class Effect;
+class PluginLoaderThread;
 
 namespace gui
 {
@@ -65,15 +72,69 @@ public:
 	bool processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, bool hasInputNoise );
 	void startRunning();
 
+	//! Sum of the latencies of the enabled effects
+	f_cnt_t latency() const;
+
 	void clear();
 
+	//! Whether the effects were loaded but not instantiated yet, since
+	//! the chain was disabled
+	bool hasPendingEffects() const
+	{
+		return !m_pendingEffects.isNull();
+	}
+
+	//! Instantiate the pending effects right away. Done when they are
+	//! shown or the track is unfrozen.
+	void instantiatePendingEffects();
+
+	//! Replace the effects by the saved chain @p _this without
+	//! instantiating it, until instantiatePendingEffects() is called.
+	//! Frozen tracks hold their effects, see TrackFreezer.
+	void holdEffects( const QDomElement & _this );
+
+	bool isHoldingEffects() const
+	{
+		return m_holdingEffects;
+	}
+
+
+public slots:
+	//! Start instantiating the pending effects in the background, they
+	//! are appended once they are there. Done when the chain is enabled.
+	void loadPendingEffects();
+
+
+private slots:
+	void effectsLoaded();
+
 
 private:
 	using EffectList = QVector<Effect*>;
+
+	void loadEffects( const QDomElement & _this );
+	//! Create the effects of the saved chain @p _this. Without a @p chain,
+	//! when created on another thread, they have no parents yet.
+	static EffectList createEffects( const QDomElement & _this, EffectChain * chain );
+	//! Take the effects from m_effectLoader, waiting for it if needed
+	void adoptLoadedEffects();
+	void deleteEffects();
+
 	EffectList m_effects;
 
 	BoolModel m_enabledModel;
 
+	//! Settings of the effects of a disabled chain loaded with a project
+	QDomDocument m_pendingEffects;
+	//! Whether the pending effects stay pending when the chain is enabled
+	bool m_holdingEffects;
+	//! Instantiates m_pendingEffects in the background
+	std::unique_ptr<PluginLoaderThread> m_effectLoader;
+
+	//! Hold the signal while it passes effects that process planar
+	//! buffers. Each effect reads one and writes the other, so plugins
+	//! are connected to them without copying between their ports.
+	std::array<PlanarBuffer, 2> m_planarBuffers;
 
 	friend class gui::EffectRackView;
 
@@ -37,11 +37,15 @@
 namespace lmms
 {
 
+class AnalysisService;
 class AudioEngine;
+class DiskRecorder;
 class Mixer;
 class PatternStore;
 class ProjectJournal;
+class SampleIndex;
 class Song;
+class TrackFreezer;
 class Ladspa2LMMS;
 
 namespace gui
@@ -54,7 +58,10 @@ class LMMS_EXPORT Engine : public QObject
 {
 	Q_OBJECT
 public:
-	static void init( bool renderOnly );
+	//! @param renderBlockSize Frames per period of a render-only engine, 0
+	//!        for the default. Can't be changed afterwards, as all buffers
+	//!        are allocated with this size.
+	static void init( bool renderOnly, fpp_t renderBlockSize = 0 );
 	static void destroy();
 
 	// core
@@ -83,6 +90,27 @@ public:
 		return s_projectJournal;
 	}
 
+	static AnalysisService * analysisService()
+	{
+		return s_analysisService;
+	}
+
+	static DiskRecorder * diskRecorder()
+	{
+		return s_diskRecorder;
+	}
+
+	static TrackFreezer * trackFreezer()
+	{
+		return s_trackFreezer;
+	}
+
+	//! nullptr when rendering only or if disabled in the settings
+	static SampleIndex * sampleIndex()
+	{
+		return s_sampleIndex;
+	}
+
 	static bool ignorePluginBlacklist();
 
 #ifdef LMMS_HAVE_LV2
@@ -141,6 +169,10 @@ private:
 	static Song * s_song;
 	static PatternStore * s_patternStore;
 	static ProjectJournal * s_projectJournal;
+	static AnalysisService * s_analysisService;
+	static DiskRecorder * s_diskRecorder;
+	static SampleIndex * s_sampleIndex;
+	static TrackFreezer * s_trackFreezer;
 
 #ifdef LMMS_HAVE_LV2
 	static class Lv2Manager* s_lv2Manager;
@@ -79,17 +79,25 @@ private slots:
 	// call with item=NULL to filter the entire tree
 	bool filterItems( const QString & filter, QTreeWidgetItem * item=nullptr );
 	void giveFocusToFilter();
+	void updateSearchResults();
 
 private:
 	void keyPressEvent( QKeyEvent * ke ) override;
 
 	void addItems( const QString & path );
 
+	//! Whether searches are answered by the sample index instead of the tree
+	bool usesIndex() const;
+	void showSearchResults( const QString & filter );
+
 	FileBrowserTreeWidget * m_fileBrowserTreeWidget;
+	//! Shown instead of the tree while searching the sample index
+	FileBrowserTreeWidget * m_searchResults = nullptr;
 
 	QLineEdit * m_filterEdit;
 
 	QString m_directories; //!< Directories to search, split with '*'
+	QStringList m_paths; //!< Directories currently shown
 	QString m_filter; //!< Filter as used in QDir::match()
 
 	bool m_dirsAsItems;
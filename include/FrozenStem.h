@@ -0,0 +1,165 @@
+/*
+ * FrozenStem.h - plays the rendered output of a frozen track
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef FROZEN_STEM_H
+#define FROZEN_STEM_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+#include <QString>
+
+#include "AudioPort.h"
+#include "PlayHandle.h"
+
+class QThreadPool;
+
+namespace lmms
+{
+
+class SampleStream;
+class TimePos;
+
+
+/**
+	\brief Plays the rendered output of a frozen track
+
+	The stem is streamed from the freeze cache into an audio port of its
+	own, which has no effects and feeds the mixer channel the track fed
+	when it was rendered. The port is muted along with the track.
+
+	Whenever the track is played, it calls sync() with the song position,
+	so the stem follows jumps and loops of the song. A jump needs a stream
+	starting there. The audio thread only takes one which was prepared,
+	see prepare(), and plays silence until the freezer has prepared one
+	for a position nobody expected. The freezer also has the streams
+	decode ahead and frees the ones the audio thread dropped, see
+	decodeAhead(). Exports start and decode streams themselves instead,
+	since they must not miss anything.
+
+	See TrackFreezer for how stems are rendered and when they are dropped.
+*/
+class LMMS_EXPORT FrozenStem : public PlayHandle
+{
+public:
+	//! Streams kept ready at once, for where playback starts and loops to
+	static constexpr int MaxPrepared = 2;
+	//! How often the freezer calls decodeAhead() in milliseconds, well
+	//! within what the ring of a stream holds
+	static constexpr int DecodeInterval = 50;
+
+	//! Play @p file into the mixer channel @p channel for @p track,
+	//! decoding in @p pool
+	FrozenStem(Track* track, const QString& key, const QString& file, mix_ch_t channel, QThreadPool* pool);
+	~FrozenStem() override;
+
+	//! State key of the track the stem was rendered from
+	const QString& key() const
+	{
+		return m_key;
+	}
+
+	const QString& file() const
+	{
+		return m_file;
+	}
+
+	//! Start decoding from @p frame, so playback can jump there without a
+	//! gap. Called by the GUI thread.
+	void prepare(f_cnt_t frame);
+
+	//! Prepare a stream for where the audio thread jumped to, free the
+	//! streams it dropped and decode ahead in the others. Called by the
+	//! GUI thread every DecodeInterval.
+	void decodeAhead();
+
+	//! Called by the track while the song plays @p start at @p offset
+	//! frames into the current period
+	void sync(const TimePos& start, f_cnt_t offset);
+
+	bool affinityMatters() const override
+	{
+		return true;
+	}
+
+	void play(sampleFrame* buffer) override;
+
+	bool isFinished() const override
+	{
+		return false;
+	}
+
+	bool isFromTrack(const Track* track) const override
+	{
+		return m_track == track;
+	}
+
+private:
+	//! Continue the stem at @p frame
+	void seek(f_cnt_t frame);
+	//! Take a stream for m_requestedFrame if there is one
+	void takeStream();
+	//! Stop playing the current stream, which the GUI thread frees
+	void dropStream();
+	//! Copy the next @p frames of the stem to @p dst
+	void read(sampleFrame* dst, f_cnt_t frames);
+	//! Whether m_streams has a stream for @p frame which isn't played yet.
+	//! Called with m_streamsLock locked.
+	bool hasPrepared(f_cnt_t frame) const;
+	//! Add a stream for @p frame to m_streams, called with m_streamsLock
+	//! locked
+	void addStream(f_cnt_t frame);
+
+	Track* m_track;
+	const QString m_key;
+	const QString m_file;
+	const sample_rate_t m_sampleRate;
+	QThreadPool* m_pool;
+	AudioPort m_audioPort;
+
+	//! Stream the audio thread plays, owned by m_streams. It's set with
+	//! m_streamsLock locked and not touched anymore once it's cancelled.
+	std::atomic<SampleStream*> m_stream;
+	//! Frame of the stem the audio thread needs a stream for, -1 if none
+	std::atomic<f_cnt_t> m_requestedFrame;
+	//! Frame of the stem read next, -1 while the song isn't playing
+	f_cnt_t m_position;
+	//! Frames the stream fell behind, dropped as soon as they are decoded
+	f_cnt_t m_behind;
+	//! Where in the current period the song jumped and to which frame of
+	//! the stem, -1 if it didn't
+	f_cnt_t m_jumpOffset;
+	f_cnt_t m_jumpFrame;
+
+	//! All streams, only ever freed by the GUI thread
+	std::vector<std::shared_ptr<SampleStream>> m_streams;
+	QMutex m_streamsLock;
+} ;
+
+
+} // namespace lmms
+
+#endif // FROZEN_STEM_H
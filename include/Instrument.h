@@ -105,6 +105,13 @@ public:
 		return NoFlags;
 	}
 
+	// frames by which the output is delayed against the notes, at the
+	// processing sample rate - other tracks are delayed to match
+	virtual f_cnt_t latency() const
+	{
+		return 0;
+	}
+
 	// sub-classes can re-implement this for receiving all incoming
 	// MIDI-events
 	inline virtual bool handleMidiEvent( const MidiEvent&, const TimePos& = TimePos(), f_cnt_t offset = 0 )
@@ -26,6 +26,8 @@
 #ifndef INSTRUMENT_TRACK_H
 #define INSTRUMENT_TRACK_H
 
+#include <QDomDocument>
+
 #include "AudioPort.h"
 #include "InstrumentFunctions.h"
 #include "InstrumentSoundShaping.h"
@@ -45,6 +47,7 @@ namespace lmms
 
 class Instrument;
 class DataFile;
+class PluginLoaderThread;
 
 namespace gui
 {
@@ -100,6 +103,23 @@ public:
 		return m_instrument;
 	}
 
+	//! Whether the instrument isn't instantiated, since the track was muted
+	//! or an unused track of the pattern store when it was loaded (see
+	//! Plugin::deferInstantiation()) or is frozen
+	bool hasPendingInstrument() const
+	{
+		return !m_pendingInstrument.isNull();
+	}
+
+	//! Instantiate the instrument right away if that was deferred. Done
+	//! when its window is opened or the track is unfrozen.
+	void instantiatePendingInstrument();
+
+	//! Unload the instrument and effects, keeping their settings from
+	//! @p state, the saved track, until they are instantiated again. Used
+	//! for frozen tracks, see TrackFreezer.
+	void unloadPlugins( const QDomElement & state );
+
 	void deleteNotePluginData( NotePlayHandle * _n );
 
 	// name-stuff
@@ -240,6 +260,12 @@ public:
 
 	void autoAssignMidiDevice( bool );
 
+public slots:
+	//! Start instantiating the instrument in the background if that was
+	//! deferred; instrumentChanged() is emitted once it's there. Done when
+	//! the track is unmuted, gets notes or receives a note-on event.
+	void loadPendingInstrument();
+
 signals:
 	void instrumentChanged();
 	void midiNoteOn( const lmms::Note& );
@@ -265,8 +291,18 @@ protected slots:
 	void updateMixerChannel();
 
 
+private slots:
+	void instrumentLoaded();
+
+
 private:
 	void processCCEvent(int controller);
+	//! Take the instrument from m_instrumentLoader, waiting for it if needed
+	void adoptLoadedInstrument();
+	//! Let a running instrument loader finish, so its instrument's play
+	//! handle is removed by silenceAllNotes() before the instrument is
+	//! deleted with the loader
+	void waitForInstrumentLoader();
 
 	MidiPort m_midiPort;
 
@@ -302,6 +338,10 @@ private:
 	BoolModel m_useMasterPitchModel;
 
 	Instrument * m_instrument;
+	//! Saved instrument while its instantiation is deferred
+	QDomDocument m_pendingInstrument;
+	//! Instantiates m_pendingInstrument in the background
+	std::unique_ptr<PluginLoaderThread> m_instrumentLoader;
 	InstrumentSoundShaping m_soundShaping;
 	InstrumentFunctionArpeggio m_arpeggio;
 	InstrumentFunctionNoteStacking m_noteStacking;
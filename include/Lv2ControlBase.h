@@ -42,6 +42,7 @@ namespace lmms
 
 
 class Lv2Proc;
+class PlanarBuffer;
 class PluginIssue;
 
 /**
@@ -120,6 +121,13 @@ protected:
 	void copyBuffersFromLmms(const sampleFrame *buf, fpp_t frames);
 	//! Copy our ports into buffers passed by LMMS
 	void copyBuffersToLmms(sampleFrame *buf, fpp_t frames) const;
+	//! Planar variants of the above
+	void copyBuffersFromLmms(const PlanarBuffer &buf, fpp_t frames);
+	void copyBuffersToLmms(PlanarBuffer &buf, fpp_t frames) const;
+	//! Let all processors work on @p in and @p out directly, see
+	//! Lv2Proc::connectBuffers(). If one of them can't, all of them use
+	//! their own buffers and false is returned.
+	bool connectBuffersToLmms(PlanarBuffer *in, PlanarBuffer *out);
 	//! Run the Lv2 plugin instance for @param frames frames
 	void run(fpp_t frames);
 
@@ -138,6 +146,8 @@ protected:
 	std::size_t controlCount() const;
 	QString nodeName() const { return "lv2controls"; }
 	bool hasNoteInput() const;
+	//! Largest latency of the processors, in frames
+	f_cnt_t latency() const;
 	void handleMidiInputEvent(const class MidiEvent &event,
 		const class TimePos &time, f_cnt_t offset);
 
@@ -166,7 +166,7 @@ struct Control : public VisitablePort<Control, ControlPortBase>
 	//! Data location which Lv2 plugins see
 	//! Model values are being copied here every run
 	//! Between runs, this data is not up-to-date
-	float m_val;
+	float m_val = 0.0f;
 };
 
 struct Cv : public VisitablePort<Cv, ControlPortBase>
@@ -194,14 +194,26 @@ struct Audio : public VisitablePort<Audio, PortBase>
 	void copyBuffersToCore(sampleFrame *lmmsBuf,
 		unsigned channel, fpp_t frames) const;
 
+	//! Planar variants of the above, taking one channel of a PlanarBuffer
+	void copyBuffersFromCore(const sample_t *channelBuf, fpp_t frames);
+	void averageWithBuffersFromCore(const sample_t *channelBuf, fpp_t frames);
+	void copyBuffersToCore(sample_t *channelBuf, fpp_t frames) const;
+
 	bool isSideChain() const { return m_sidechain; }
 	bool isOptional() const { return m_optional; }
 	bool mustBeUsed() const { return !isSideChain() && !isOptional(); }
 	std::size_t bufferSize() const { return m_buffer.size(); }
 
+	//! Let the plugin read/write @p buf instead of the own buffer, nullptr
+	//! switches back. The copy functions above must not be used meanwhile.
+	//! @return whether the port must be connected again
+	bool useBuffer(sample_t *buf);
+
 private:
 	//! the buffer where Lv2 reads/writes the data from/to
 	std::vector<float> m_buffer;
+	//! buffer of the core used instead of m_buffer, if any
+	sample_t *m_coreBuffer = nullptr;
 	bool m_sidechain;
 
 	// the only case when data of m_buffer may be referenced:
@@ -37,6 +37,7 @@
 #include "Lv2Options.h"
 #include "LinkedModelGroups.h"
 #include "Plugin.h"
+#include "SubBlockSplitter.h"
 #include "../src/3rdparty/ringbuffer/include/ringbuffer/ringbuffer.h"
 #include "TimePos.h"
 
@@ -44,6 +45,7 @@
 namespace lmms
 {
 
+class PlanarBuffer;
 class PluginIssue;
 
 // forward declare port structs/enums
@@ -144,7 +146,23 @@ public:
 	 */
 	void copyBuffersToCore(sampleFrame *buf, unsigned firstChan, unsigned num,
 								fpp_t frames) const;
-	//! Run the Lv2 plugin instance for @param frames frames
+	//! Same as the above, with @p firstChan indexing the channels of @p buf
+	void copyBuffersFromCore(const PlanarBuffer &buf,
+								unsigned firstChan, unsigned num, fpp_t frames);
+	void copyBuffersToCore(PlanarBuffer &buf, unsigned firstChan, unsigned num,
+								fpp_t frames) const;
+	/**
+	 * Connect the audio ports to channels of @p in and @p out directly, so
+	 * that the buffers don't need to be copied. Falls back to the own
+	 * buffers if @p in or @p out is null, or if channels had to be averaged
+	 * or duplicated.
+	 * @return whether the ports are connected to @p in and @p out
+	 */
+	bool connectBuffers(PlanarBuffer *in, PlanarBuffer *out,
+								unsigned firstChan, unsigned num);
+	//! Run the Lv2 plugin instance for @param frames frames. Plugins without
+	//! event inputs are run in blocks if their controls are automated within
+	//! the period, see SubBlockSplitter.
 	void run(fpp_t frames);
 
 	void handleMidiInputEvent(const class MidiEvent &event,
@@ -156,6 +174,8 @@ public:
 	class AutomatableModel *modelAtPort(const QString &uri); // unused currently
 	std::size_t controlCount() const { return LinkedModelGroup::modelNum(); }
 	bool hasNoteInput() const;
+	//! Latency the plugin reported during the last run, in frames
+	f_cnt_t latency() const;
 
 protected:
 	/*
@@ -179,6 +199,20 @@ private:
 	// quick reference to specific, unique ports
 	StereoPortRef m_inPorts, m_outPorts;
 	Lv2Ports::AtomSeq *m_midiIn = nullptr, *m_midiOut = nullptr;
+	//! output port reporting the latency, if the plugin has one
+	Lv2Ports::Control *m_latencyPort = nullptr;
+
+	// control inputs which are automated within the current period
+	struct AutomatedControl
+	{
+		Lv2Ports::Control* m_port;
+		const float* m_values;
+	};
+	std::vector<AutomatedControl> m_automatedControls;
+	SubBlockSplitter m_splitter;
+	//! false if the plugin has event inputs, which are timed relative to
+	//! the whole period
+	bool m_canSplit = true;
 
 	// MIDI
 	// many things here may be moved into the `Instrument` class
@@ -208,6 +242,8 @@ private:
 	void createPort(std::size_t portNum);
 	//! connect m_ports[portNum] with Lv2
 	void connectPort(std::size_t num);
+	//! point all used audio ports @p offset frames into their buffers
+	void connectAudioPorts(fpp_t offset);
 
 	void dumpPort(std::size_t num);
 
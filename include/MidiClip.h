@@ -29,6 +29,8 @@
 
 #include "Clip.h"
 #include "Note.h"
+#include "NoteArena.h"
+#include "NoteIndex.h"
 
 
 namespace lmms
@@ -76,6 +78,18 @@ public:
 		return m_notes;
 	}
 
+	//! Notes overlapping the ticks [from, to] with keys in [lowKey, highKey],
+	//! in the order of notes(), see NoteIndex. Editors changing notes in
+	//! place have to emit dataChanged() afterwards.
+	NoteVector notesInRange( tick_t from, tick_t to, int lowKey = 0, int highKey = NumKeys - 1 )
+	{
+		return m_noteIndex.notesInRange( from, to, lowKey, highKey );
+	}
+
+	//! Emits dataChanged() after @p notes were moved or resized in place,
+	//! updating their entries in the index instead of rebuilding it
+	void notesMoved( const NoteVector & notes );
+
 	Note * addStepNote( int step );
 	void setStep( int step, bool enabled );
 
@@ -140,7 +154,12 @@ private:
 	MidiClipTypes m_clipType;
 
 	// data-stuff
+	//! Owns the notes, m_notes keeps them sorted
+	NoteArena m_noteArena;
 	NoteVector m_notes;
+	NoteIndex m_noteIndex;
+	//! Set while notesMoved() emits dataChanged()
+	bool m_noteIndexUpdated;
 	int m_steps;
 
 	MidiClip * adjacentMidiClipByOffset(int offset) const;
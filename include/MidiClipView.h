@@ -25,6 +25,7 @@
 #ifndef MIDI_CLIP_VIEW_H
 #define MIDI_CLIP_VIEW_H
  
+#include <memory>
 #include <QStaticText>
 #include "ClipView.h"
 
@@ -36,6 +37,7 @@ class MidiClip;
 namespace gui
 {
 
+class ClipThumbnail;
 
 class MidiClipView : public ClipView
 {
@@ -75,6 +77,8 @@ protected slots:
 	void changeName();
 	void transposeSelection();
 
+	void invalidateThumbnail();
+
 
 protected:
 	void constructContextMenu( QMenu * ) override;
@@ -93,6 +97,14 @@ private:
 	MidiClip* m_clip;
 	QPixmap m_paintPixmap;
 
+	//! The notes of melody clips, drawn over the background
+	std::shared_ptr<ClipThumbnail> m_thumbnail;
+	//! How the thumbnail's notes were drawn
+	QColor m_thumbnailFillColor;
+	QColor m_thumbnailBorderColor;
+	float m_thumbnailTop;
+	bar_t m_thumbnailBars;
+
 	QColor m_noteFillColor;
 	QColor m_noteBorderColor;
 	QColor m_mutedNoteFillColor;
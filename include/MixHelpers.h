@@ -30,6 +30,7 @@
 namespace lmms
 {
 
+class PlanarBuffer;
 class ValueBuffer;
 namespace MixHelpers
 {
@@ -42,9 +43,15 @@ void setNaNHandler( bool use );
 
 bool sanitize( sampleFrame * src, int frames );
 
+/*! \brief Same as sanitize() for sampleFrames, clears all channels if any of them contains infs/nans */
+bool sanitize( PlanarBuffer & buffer, int frames );
+
 /*! \brief Add samples from src to dst */
 void add( sampleFrame* dst, const sampleFrame* src, int frames );
 
+/*! \brief Raise peakLeft/peakRight to the largest magnitude of each channel of src */
+void peak( const sampleFrame* src, int frames, float& peakLeft, float& peakRight );
+
 
 /*! \brief Add samples from src multiplied by coeffSrc to dst */
 void addMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames );
@@ -0,0 +1,114 @@
+/*
+ * MixKernels.h - buffer kernels for MixHelpers and sample format conversion,
+ *                selected for the instruction sets of the CPU at runtime
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef MIX_KERNELS_H
+#define MIX_KERNELS_H
+
+// this header is included by the translation units built for other
+// instruction sets, keep it free of inline code
+#include <cstddef>
+#include <cstdint>
+
+#include "lmms_export.h"
+
+namespace lmms::MixKernels
+{
+
+
+enum class InstructionSet
+{
+	Scalar,
+	Sse2,
+	Avx2,
+	Avx512
+} ;
+
+//! Samples below this magnitude are considered silent by isSilent()
+constexpr float SilenceThreshold = 0.0000001f;
+//! sanitize() clamps finite samples to this magnitude
+constexpr float SanitizeLimit = 1000.0f;
+
+
+/**
+	\brief Function table of one kernel implementation
+
+	All kernels work on `count` interleaved samples. Kernels that measure
+	peaks expect stereo frames, i.e. an even count, and raise peaks[0] and
+	peaks[1] to the largest magnitude of the left and right channel. The
+	conversions between interleaved and planar stereo take a frame count.
+
+	Every implementation gives bit-identical results to the scalar one for
+	all inputs, including infinities and NaNs. The only exception is
+	converting a NaN to 16 bit, which is undefined in C++ anyway.
+*/
+struct KernelTable
+{
+	//! dst += src
+	void (*add)(float* dst, const float* src, std::size_t count);
+	//! dst += src * coeff
+	void (*addMultiplied)(float* dst, const float* src, float coeff, std::size_t count);
+	//! dst += src * coeff, skipping infinite and NaN samples of src
+	void (*addSanitizedMultiplied)(float* dst, const float* src, float coeff, std::size_t count);
+	//! Clamp all samples to +-SanitizeLimit, or clear the whole buffer and
+	//! return true if any sample is infinite or NaN
+	bool (*sanitize)(float* data, std::size_t count);
+	bool (*isSilent)(const float* data, std::size_t count);
+	void (*peak)(const float* data, std::size_t count, float* peaks);
+	//! Scale by gain, clip to [-1, 1] and convert to 16 bit, optionally
+	//! swapping the byte order
+	void (*convertToS16)(const float* src, std::size_t count, float gain, int16_t* dst, bool swapBytes);
+	//! Split interleaved stereo frames into a left and a right channel
+	void (*deinterleave)(const float* src, float* left, float* right, std::size_t frames);
+	//! Merge a left and a right channel into interleaved stereo frames
+	void (*interleave)(const float* left, const float* right, float* dst, std::size_t frames);
+} ;
+
+
+//! The kernels for the best instruction set supported by this CPU. Can be
+//! limited by setting LMMS_MIX_KERNELS to scalar, sse2, avx2 or avx512.
+LMMS_EXPORT const KernelTable& kernels();
+LMMS_EXPORT InstructionSet instructionSet();
+
+//! The kernels for the given instruction set, or nullptr if neither the
+//! build nor the CPU support it
+LMMS_EXPORT const KernelTable* kernels(InstructionSet set);
+
+LMMS_EXPORT const char* name(InstructionSet set);
+
+
+namespace detail
+{
+
+// defined in the translation units built for the respective instruction set
+const KernelTable* sse2Kernels();
+const KernelTable* avx2Kernels();
+const KernelTable* avx512Kernels();
+
+} // namespace detail
+
+
+} // namespace lmms::MixKernels
+
+#endif // MIX_KERNELS_H
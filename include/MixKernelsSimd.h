@@ -0,0 +1,294 @@
+/*
+ * MixKernelsSimd.h - MixKernels implemented on top of a SIMD register type
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef MIX_KERNELS_SIMD_H
+#define MIX_KERNELS_SIMD_H
+
+#include "MixKernels.h"
+
+// Only include this from the MixKernels*.cpp files built for a specific
+// instruction set. Everything here has internal linkage: an inline function
+// shared with other translation units could otherwise end up in the binary
+// compiled for an instruction set the CPU doesn't support.
+namespace lmms::MixKernels
+{
+
+namespace
+{
+
+
+inline bool isFinite(float x)
+{
+	return x - x == 0.0f;
+}
+
+inline float magnitude(float x)
+{
+	return x < 0.0f ? -x : (x == 0.0f ? 0.0f : x);
+}
+
+//! Same as std::max(peak, x)
+inline float raisePeak(float peak, float x)
+{
+	return peak < x ? x : peak;
+}
+
+inline int16_t toS16(float x, float gain, bool swapBytes)
+{
+	float clipped = x * gain;
+	if (clipped > 1.0f) { clipped = 1.0f; }
+	else if (clipped < -1.0f) { clipped = -1.0f; }
+	const auto value = static_cast<int16_t>(clipped * 32767.0f);
+	return swapBytes ? static_cast<int16_t>((value & 0x00ff) << 8 | (value & 0xff00) >> 8) : value;
+}
+
+
+/**
+	Kernels for a register type V, which provides:
+
+	- Reg, the register type, and Width, the number of floats in it
+	- load(), store(), set1() and zero()
+	- add(), mul(), min() and max() with the semantics of the SSE
+	  instructions, i.e. min(a, b) == (a < b ? a : b)
+	- abs(), anyNonFinite() and anyGreaterEqual()
+	- zeroNonFinite(x, s), which clears the lanes of x where s is infinite
+	  or NaN
+	- storeS16(), which converts with truncation like static_cast<int16_t>
+	- deinterleave(a, b, even, odd), which gathers the even and the odd
+	  lanes of the 2 * Width samples in a and b, and interleave(), which
+	  does the opposite
+
+	Vectors always start at an even sample, so even lanes hold the left and
+	odd lanes the right channel. The remaining samples are processed with
+	scalar code that matches the reference implementation.
+*/
+template<class V>
+struct SimdKernels
+{
+	using Reg = typename V::Reg;
+	static constexpr std::size_t Width = V::Width;
+
+	static void add(float* dst, const float* src, std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			V::store(dst + i, V::add(V::load(dst + i), V::load(src + i)));
+		}
+		for (; i < count; ++i)
+		{
+			dst[i] += src[i];
+		}
+	}
+
+	static void addMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+	{
+		const Reg c = V::set1(coeff);
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			V::store(dst + i, V::add(V::load(dst + i), V::mul(V::load(src + i), c)));
+		}
+		for (; i < count; ++i)
+		{
+			dst[i] += src[i] * coeff;
+		}
+	}
+
+	static void addSanitizedMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+	{
+		const Reg c = V::set1(coeff);
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			const Reg s = V::load(src + i);
+			// mask the product rather than the source, so an infinite
+			// coefficient doesn't turn 0 * inf into a NaN
+			V::store(dst + i, V::add(V::load(dst + i), V::zeroNonFinite(V::mul(s, c), s)));
+		}
+		for (; i < count; ++i)
+		{
+			dst[i] += isFinite(src[i]) ? src[i] * coeff : 0.0f;
+		}
+	}
+
+	static bool sanitize(float* data, std::size_t count)
+	{
+		const Reg lower = V::set1(-SanitizeLimit);
+		const Reg upper = V::set1(SanitizeLimit);
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			const Reg x = V::load(data + i);
+			if (V::anyNonFinite(x))
+			{
+				clear(data, count);
+				return true;
+			}
+			// same as qBound(-SanitizeLimit, x, SanitizeLimit)
+			V::store(data + i, V::max(V::min(upper, x), lower));
+		}
+		for (; i < count; ++i)
+		{
+			if (!isFinite(data[i]))
+			{
+				clear(data, count);
+				return true;
+			}
+			const float bounded = SanitizeLimit < data[i] ? SanitizeLimit : data[i];
+			data[i] = -SanitizeLimit < bounded ? bounded : -SanitizeLimit;
+		}
+		return false;
+	}
+
+	static bool isSilent(const float* data, std::size_t count)
+	{
+		const Reg threshold = V::set1(SilenceThreshold);
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			if (V::anyGreaterEqual(V::abs(V::load(data + i)), threshold)) { return false; }
+		}
+		for (; i < count; ++i)
+		{
+			if (magnitude(data[i]) >= SilenceThreshold) { return false; }
+		}
+		return true;
+	}
+
+	static void peak(const float* data, std::size_t count, float* peaks)
+	{
+		Reg peak = V::zero();
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			peak = V::max(V::abs(V::load(data + i)), peak);
+		}
+		reducePeak(peak, peaks);
+		for (; i < count; ++i)
+		{
+			peaks[i & 1] = raisePeak(peaks[i & 1], magnitude(data[i]));
+		}
+	}
+
+	static void convertToS16(const float* src, std::size_t count, float gain, int16_t* dst, bool swapBytes)
+	{
+		const Reg g = V::set1(gain);
+		const Reg lower = V::set1(-1.0f);
+		const Reg upper = V::set1(1.0f);
+		const Reg multiplier = V::set1(32767.0f);
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			// same as AudioEngine::clip(), NaNs stay NaNs
+			const Reg clipped = V::max(lower, V::min(upper, V::mul(V::load(src + i), g)));
+			V::storeS16(dst + i, V::mul(clipped, multiplier), swapBytes);
+		}
+		for (; i < count; ++i)
+		{
+			dst[i] = toS16(src[i], gain, swapBytes);
+		}
+	}
+
+	static void deinterleave(const float* src, float* left, float* right, std::size_t frames)
+	{
+		std::size_t f = 0;
+		for (; f + Width <= frames; f += Width)
+		{
+			Reg even, odd;
+			V::deinterleave(V::load(src + 2 * f), V::load(src + 2 * f + Width), even, odd);
+			V::store(left + f, even);
+			V::store(right + f, odd);
+		}
+		for (; f < frames; ++f)
+		{
+			left[f] = src[2 * f];
+			right[f] = src[2 * f + 1];
+		}
+	}
+
+	static void interleave(const float* left, const float* right, float* dst, std::size_t frames)
+	{
+		std::size_t f = 0;
+		for (; f + Width <= frames; f += Width)
+		{
+			Reg first, second;
+			V::interleave(V::load(left + f), V::load(right + f), first, second);
+			V::store(dst + 2 * f, first);
+			V::store(dst + 2 * f + Width, second);
+		}
+		for (; f < frames; ++f)
+		{
+			dst[2 * f] = left[f];
+			dst[2 * f + 1] = right[f];
+		}
+	}
+
+	static void clear(float* data, std::size_t count)
+	{
+		const Reg zero = V::zero();
+		std::size_t i = 0;
+		for (; i + Width <= count; i += Width)
+		{
+			V::store(data + i, zero);
+		}
+		for (; i < count; ++i)
+		{
+			data[i] = 0.0f;
+		}
+	}
+
+	static void reducePeak(Reg peak, float* peaks)
+	{
+		float lanes[Width];
+		V::store(lanes, peak);
+		for (std::size_t lane = 0; lane < Width; ++lane)
+		{
+			peaks[lane & 1] = raisePeak(peaks[lane & 1], lanes[lane]);
+		}
+	}
+
+	static const KernelTable* table()
+	{
+		static const KernelTable kernels = {
+			&add,
+			&addMultiplied,
+			&addSanitizedMultiplied,
+			&sanitize,
+			&isSilent,
+			&peak,
+			&convertToS16,
+			&deinterleave,
+			&interleave
+		};
+		return &kernels;
+	}
+} ;
+
+
+} // namespace
+
+} // namespace lmms::MixKernels
+
+#endif // MIX_KERNELS_SIMD_H
@@ -25,12 +25,15 @@
 #ifndef MIXER_H
 #define MIXER_H
 
+#include "AnalysisService.h"
+#include "CompensationDelay.h"
 #include "Model.h"
 #include "EffectChain.h"
 #include "JournallingObject.h"
 #include "ThreadableJob.h"
 
 #include <atomic>
+#include <vector>
 
 #include <QColor>
 
@@ -54,8 +57,8 @@ class MixerChannel : public ThreadableJob
 		// set to true if any effect in the channel is enabled and running
 		bool m_stillRunning;
 
-		float m_peakLeft;
-		float m_peakRight;
+		// feeds the peak meters of the mixer view
+		AnalysisTap m_analysisTap;
 		sampleFrame * m_buffer;
 		bool m_muteBeforeSolo;
 		BoolModel m_muteModel;
@@ -73,6 +76,12 @@ class MixerChannel : public ThreadableJob
 		// pointers to other channels that send to this one
 		MixerRouteVector m_receives;
 
+		// latency of the slowest input and of the output including the
+		// effects, in frames - updated by Mixer::updateLatencyCompensation()
+		f_cnt_t m_inputLatency;
+		std::atomic<f_cnt_t> m_latency;
+		bool m_latencyUpdated;
+
 		bool requiresProcessing() const override { return true; }
 		void unmuteForSolo();
 
@@ -130,11 +139,18 @@ class MixerRoute : public QObject
 	}
 	
 	void updateName();
+
+	// delay lining the sent signal up with slower inputs of the receiver
+	CompensationDelay * compensation()
+	{
+		return &m_compensation;
+	}
 		
 	private:
 		MixerChannel * m_from;
 		MixerChannel * m_to;
 		FloatModel m_amount;
+		CompensationDelay m_compensation;
 };
 
 
@@ -150,6 +166,16 @@ public:
 	void prepareMasterMix();
 	void masterMix( sampleFrame * _buf );
 
+	// delay audio ports and routes such that all inputs of a channel arrive
+	// with the latency of the slowest one
+	void updateLatencyCompensation();
+
+	// latency of the master output against the song, in frames
+	f_cnt_t totalLatency() const
+	{
+		return m_mixerChannels[0]->m_latency;
+	}
+
 	void saveSettings( QDomDocument & _doc, QDomElement & _parent ) override;
 	void loadSettings( const QDomElement & _this ) override;
 
@@ -213,6 +239,17 @@ public:
 
 	MixerRouteVector m_mixerRoutes;
 
+public slots:
+	// grow the delay lines of the latency compensation, which the audio
+	// thread can't do
+	void reserveCompensationDelays();
+
+signals:
+	// emitted when channels have been added or removed
+	void channelsChanged();
+	// emitted from the audio thread when delay lines are too short
+	void compensationDelaysTooShort();
+
 private:
 	// the mixer channels in the mixer. index 0 is always master.
 	QVector<MixerChannel *> m_mixerChannels;
@@ -220,7 +257,14 @@ private:
 	// make sure we have at least num channels
 	void allocateChannelsTo(int num);
 
+	void updateChannelLatency( MixerChannel * ch );
+
 	int m_lastSoloed;
+
+	bool m_delayCompensation;
+	std::vector<f_cnt_t> m_portLatencies;
+	// whether compensationDelaysTooShort() was emitted and not handled yet
+	std::atomic<bool> m_reservePending;
 } ;
 
 
@@ -28,6 +28,8 @@
 
 #include <QWidget>
 
+#include "lmms_basics.h"
+
 class QGraphicsView;
 class QLineEdit;
 
@@ -60,6 +62,11 @@ public:
 	inline int channelIndex() { return m_channelIndex; }
 	void setChannelIndex(int index);
 
+	//! Show the name and the latency of the channel as tool tip
+	void updateToolTip();
+	//! Update the tool tip if the latency of the channel changed
+	void updateLatency();
+
 	Knob * m_sendKnob;
 	SendButtonIndicator * m_sendBtn;
 
@@ -97,6 +104,7 @@ private:
 	static QPixmap * s_sendBgArrow;
 	static QPixmap * s_receiveBgArrow;
 	bool m_inRename;
+	f_cnt_t m_shownLatency;
 	QLineEdit * m_renameLineEdit;
 	QGraphicsView * m_view;
 
@@ -234,19 +234,23 @@ protected:
 
 
 private:
+	// ordered by size to keep the notes of large clips small
+	//! Only notes with detuning automation have one, see createDetuning()
+	DetuningHelper * m_detuning;
+
+	int m_key;
+	TimePos m_length;
+	TimePos m_pos;
+
 	// for piano roll editing
-	bool m_selected;
 	int m_oldKey;
 	TimePos m_oldPos;
 	TimePos m_oldLength;
-	bool m_isPlaying;
 
-	int m_key;
 	volume_t m_volume;
 	panning_t m_panning;
-	TimePos m_length;
-	TimePos m_pos;
-	DetuningHelper * m_detuning;
+	bool m_selected;
+	bool m_isPlaying;
 };
 
 using NoteVector = QVector<Note*>;
@@ -0,0 +1,109 @@
+/*
+ * NoteArena.h - contiguous storage for the notes of a clip
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NOTE_ARENA_H
+#define NOTE_ARENA_H
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "Note.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Allocates the notes of a clip in blocks
+
+	Notes are placed next to each other in blocks growing from a few notes
+	up to a thousand, instead of one heap allocation each. Notes created in
+	order, e.g. when a project or MIDI file is loaded, lie in memory in the
+	order they are played and painted in, and the heap doesn't have to keep
+	track of every single note.
+
+	A note keeps its address as long as it exists, however the note vector
+	referring to it is sorted, so editors can keep using the pointer as a
+	stable ID of the note. Slots of destroyed notes are reused.
+
+	Clips keep a sorted NoteVector of pointers into the arena rather than a
+	vector of plain note records. Instrument plugins, the piano roll, its
+	selection and undo, the NoteIndex and the note play handles all hold
+	Note pointers, which a vector of records would invalidate whenever a
+	note is inserted in the middle. Without the detuning, a note is only a
+	few dozen bytes, and the vtable and hook pointer that SerializingObject
+	adds are what a record would save, see the benchmarks in MidiClipTest.
+*/
+class LMMS_EXPORT NoteArena
+{
+public:
+	NoteArena();
+	NoteArena(const NoteArena&) = delete;
+	NoteArena& operator=(const NoteArena&) = delete;
+	~NoteArena() = default;
+
+	Note* create(const Note& note)
+	{
+		return new (allocate()) Note(note);
+	}
+
+	void destroy(Note* note)
+	{
+		note->~Note();
+		m_free.push_back(note);
+	}
+
+	//! Release the memory, all notes must have been destroyed
+	void clear();
+
+	//! Bytes allocated for notes, used or not
+	std::size_t capacity() const;
+
+private:
+	static constexpr std::size_t FirstBlockSize = 16;
+	static constexpr std::size_t MaxBlockSize = 1024;
+
+	using Slot = std::aligned_storage_t<sizeof(Note), alignof(Note)>;
+
+	struct Block
+	{
+		std::unique_ptr<Slot[]> slots;
+		std::size_t size;
+	} ;
+
+	void* allocate();
+
+	std::vector<Block> m_blocks;
+	//! Slots of the last block handed out so far
+	std::size_t m_used;
+	std::vector<void*> m_free;
+} ;
+
+
+} // namespace lmms
+
+#endif // NOTE_ARENA_H
@@ -0,0 +1,111 @@
+/*
+ * NoteIndex.h - finds the notes of a clip by position and key
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef NOTE_INDEX_H
+#define NOTE_INDEX_H
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "Note.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Index of a note vector by key and time
+
+	The notes of each key are kept sorted by position together with the
+	longest of them, so the notes overlapping a range of ticks are found
+	by a binary search per key instead of a scan over all notes. This
+	keeps painting, hit testing and selecting in clips with tens of
+	thousands of notes as fast as in small ones.
+
+	Notes are changed in place by their editors, so the index can't follow
+	every change. It has to be invalidated whenever the notes were added,
+	removed, moved or resized and rebuilds itself on the next query, which
+	takes a single pass over the notes as long as they are sorted. Editors
+	moving a few notes many times, like the piano roll while dragging, can
+	update() the entries of just those notes instead.
+*/
+class LMMS_EXPORT NoteIndex
+{
+public:
+	//! Ticks step notes with a negative length are considered to cover, as
+	//! the editors draw them
+	static constexpr tick_t StepNoteLength = 4;
+
+	explicit NoteIndex(const NoteVector& notes);
+
+	void invalidate()
+	{
+		m_valid = false;
+	}
+
+	//! Follow @p notes, which were moved or resized in place. Rebuilds the
+	//! index on the next query if that is cheaper.
+	void update(const NoteVector& notes);
+
+	//! Notes overlapping the ticks [from, to] with keys in [lowKey, highKey],
+	//! in the order of the note vector. Notes with a length of 0 are only
+	//! returned if they start within the range.
+	NoteVector notesInRange(tick_t from, tick_t to, int lowKey, int highKey);
+
+private:
+	struct Entry
+	{
+		tick_t pos;
+		tick_t end;
+		//! Position in the note vector
+		int order;
+		Note* note;
+	} ;
+
+	//! Where the entry of a note is
+	struct Location
+	{
+		int key;
+		tick_t pos;
+	} ;
+
+	void build();
+	void locateNotes();
+
+	const NoteVector& m_notes;
+	std::array<std::vector<Entry>, NumKeys> m_keys;
+	//! Length of the longest note of each key. After update() it may be
+	//! longer, which only widens the search.
+	std::array<tick_t, NumKeys> m_maxLength;
+	//! Filled by the first update() after build()
+	std::unordered_map<const Note*, Location> m_locations;
+	bool m_valid;
+} ;
+
+
+} // namespace lmms
+
+#endif // NOTE_INDEX_H
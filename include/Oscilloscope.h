@@ -26,16 +26,18 @@
 #ifndef OSCILLOSCOPE_H
 #define OSCILLOSCOPE_H
 
+#include <QMutex>
 #include <QWidget>
 #include <QPixmap>
 
+#include "AnalysisService.h"
 #include "lmms_basics.h"
 
 namespace lmms::gui
 {
 
 
-class Oscilloscope : public QWidget
+class Oscilloscope : public QWidget, public AnalysisProcessor
 {
 	Q_OBJECT
 public:
@@ -58,9 +60,12 @@ protected:
 	void paintEvent( QPaintEvent * _pe ) override;
 	void mousePressEvent( QMouseEvent * _me ) override;
 
+	//! Called by the analysis service with the latest master output
+	void analyze( const sampleFrame * buffer, fpp_t frames ) override;
+
 
 protected slots:
-	void updateAudioBuffer( const lmms::surroundSampleFrame * buffer );
+	void periodicalUpdate();
 
 private:
 	QColor const & determineLineColor(float level) const;
@@ -69,8 +74,17 @@ private:
 	QPixmap m_background;
 	QPointF * m_points;
 
+	//! The period painted, only touched by the GUI thread
 	sampleFrame * m_buffer;
+	//! The period analyze() keeps up to date, only touched by the service
+	sampleFrame * m_analysisBuffer;
+	//! The latest analyzed period, swapped with m_buffer when painting
+	sampleFrame * m_publishedBuffer;
+	bool m_published;
+	QMutex m_publishLock;
+
 	bool m_active;
+	float m_maxLevel;
 
 	QColor m_normalColor;
 	QColor m_clippingColor;
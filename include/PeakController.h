@@ -64,7 +64,9 @@ public slots:
 	void updateCoeffs();
 
 protected:
-	// The internal per-controller get-value function
+	// The internal per-controller get-value function. Controllers are
+	// evaluated before any effect runs, so the buffer of a period always
+	// follows the peak measured in the previous one.
 	void updateValueBuffer() override;
 
 	PeakControllerEffect * m_peakEffect;
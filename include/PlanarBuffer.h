@@ -0,0 +1,85 @@
+/*
+ * PlanarBuffer.h - stereo audio buffer with one contiguous array per channel
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef PLANAR_BUFFER_H
+#define PLANAR_BUFFER_H
+
+#include <vector>
+
+#include "lmms_basics.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Non-interleaved counterpart of a sampleFrame array
+
+	The channels are stored one after another, so each of them can be handed
+	to plugins which expect planar buffers, like LADSPA and LV2, without
+	being copied sample by sample. The conversions from and to sampleFrames
+	are the adapters for everything still working on interleaved frames.
+*/
+class LMMS_EXPORT PlanarBuffer
+{
+public:
+	explicit PlanarBuffer( fpp_t frames = 0 );
+
+	//! Number of frames each channel can hold
+	fpp_t capacity() const
+	{
+		return m_capacity;
+	}
+
+	//! Discards the contents
+	void reserve( fpp_t frames );
+
+	sample_t * channel( ch_cnt_t ch )
+	{
+		return m_samples.data() + ch * m_capacity;
+	}
+
+	const sample_t * channel( ch_cnt_t ch ) const
+	{
+		return m_samples.data() + ch * m_capacity;
+	}
+
+	void clear( fpp_t frames );
+
+	//! Copy the first @p frames frames of each channel of @p src
+	void copyFrom( const PlanarBuffer & src, fpp_t frames );
+
+	void fromInterleaved( const sampleFrame * src, fpp_t frames );
+	void toInterleaved( sampleFrame * dst, fpp_t frames ) const;
+
+private:
+	fpp_t m_capacity;
+	std::vector<sample_t> m_samples;
+} ;
+
+
+} // namespace lmms
+
+#endif // PLANAR_BUFFER_H
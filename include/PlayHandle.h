@@ -50,7 +50,8 @@ public:
 		TypeNotePlayHandle = 0x01,
 		TypeInstrumentPlayHandle = 0x02,
 		TypeSamplePlayHandle = 0x04,
-		TypePresetPreviewHandle = 0x08
+		TypePresetPreviewHandle = 0x08,
+		TypeFrozenStemHandle = 0x10
 	} ;
 	using Type = Types;
 
@@ -291,6 +291,17 @@ public:
 	//!   use instantiateWithKey instead
 	static Plugin * instantiate(const QString& pluginName, Model * parent, void *data);
 
+	//! Whether plugins of muted tracks, unused tracks of the pattern store
+	//! and disabled effect chains should only be instantiated once they are
+	//! needed, which is the case while loading a project unless disabled in
+	//! the settings. They are instantiated by a PluginLoaderThread then.
+	static bool deferInstantiation();
+
+	//! Whether the plugin saved in @p state can be instantiated after the
+	//! project was loaded. Automation and controllers are connected to the
+	//! models of a plugin while loading, so they must not refer to any.
+	static bool canDeferInstantiation(const QDomElement& state);
+
 	//! Create a view for the model
 	gui::PluginView * createView( QWidget * parent );
 
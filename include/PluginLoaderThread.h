@@ -0,0 +1,74 @@
+/*
+ * PluginLoaderThread.h - instantiate plugins in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef PLUGIN_LOADER_THREAD_H
+#define PLUGIN_LOADER_THREAD_H
+
+#include <functional>
+#include <vector>
+
+#include <QThread>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class Plugin;
+
+
+//! Runs a function creating plugins on its own thread, like
+//! InstrumentLoaderThread, and hands the plugins over to the thread which
+//! created the loader. The plugins have no parent object until they are
+//! taken, since Qt doesn't allow parents living on another thread.
+class LMMS_EXPORT PluginLoaderThread : public QThread
+{
+	Q_OBJECT
+public:
+	using LoadFunction = std::function<std::vector<Plugin*>()>;
+
+	PluginLoaderThread(LoadFunction load, QObject* parent = nullptr);
+	//! Waits for the plugins and deletes those which weren't taken
+	~PluginLoaderThread() override;
+
+	//! Waits for the plugins and passes their ownership to the caller
+	std::vector<Plugin*> takePlugins();
+
+	//! Whether the plugin can be loaded without asking the user anything,
+	//! which only the main thread can do
+	static bool canLoad(const QString& pluginName);
+
+protected:
+	void run() override;
+
+private:
+	LoadFunction m_load;
+	std::vector<Plugin*> m_plugins;
+	QThread* m_targetThread;
+};
+
+
+} // namespace lmms
+
+#endif // PLUGIN_LOADER_THREAD_H
@@ -0,0 +1,107 @@
+/*
+ * PolyphaseResampler.h - streaming rational sample rate converter
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef POLYPHASE_RESAMPLER_H
+#define POLYPHASE_RESAMPLER_H
+
+#include <array>
+#include <vector>
+
+#include "lmms_basics.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Converts stereo audio between two fixed sample rates
+
+	The ratio of the rates is reduced to L/M. Conceptually the input is
+	upsampled by L, low pass filtered below the lower of both Nyquist
+	frequencies and decimated by M; only the L phases of the windowed sinc
+	filter which are actually needed are evaluated, so every output frame
+	costs taps() multiplications per channel.
+
+	The state carries over between calls, so a stream can be converted in
+	periods of any length without discontinuities. Only the constructor
+	allocates.
+*/
+class LMMS_EXPORT PolyphaseResampler
+{
+public:
+	//! Filter length in frames of the lower of both rates
+	static constexpr int DefaultTaps = 32;
+
+	PolyphaseResampler(sample_rate_t srcRate, sample_rate_t dstRate, int taps = DefaultTaps);
+
+	//! Convert @p frames frames from @p src, returns the number of frames
+	//! written to @p dst, which never exceeds maxOutput(frames)
+	f_cnt_t process(const sampleFrame* src, f_cnt_t frames, sampleFrame* dst);
+
+	//! Upper bound of what process() returns for @p frames input frames
+	f_cnt_t maxOutput(f_cnt_t frames) const;
+
+	//! Delay of the filter in input frames
+	double latency() const;
+
+	//! Forget the history, as if no frames were processed yet
+	void reset();
+
+	//! Filter length in input frames
+	int taps() const
+	{
+		return m_taps;
+	}
+
+	//! Output frames per input frame
+	double ratio() const
+	{
+		return static_cast<double>(m_up) / m_down;
+	}
+
+private:
+	int m_taps;
+	//! Upsampling factor L
+	int m_up;
+	//! Decimation factor M
+	int m_down;
+
+	//! m_up phases of m_taps coefficients each, reversed so that they
+	//! line up with the history from the oldest to the newest frame
+	std::vector<float> m_phases;
+
+	//! The last m_taps input frames of each channel, written twice so that
+	//! they are always contiguous from m_pos on
+	std::array<std::vector<float>, DEFAULT_CHANNELS> m_history;
+	int m_pos;
+	//! Position of the next output frame relative to the newest input
+	//! frame, in units of the upsampled rate
+	int m_time;
+} ;
+
+
+} // namespace lmms
+
+#endif // POLYPHASE_RESAMPLER_H
@@ -26,6 +26,7 @@
 #define PROJECT_JOURNAL_H
 
 #include <QHash>
+#include <QMutex>
 #include <QStack>
 
 #include "lmms_basics.h"
@@ -91,11 +92,8 @@ public:
 	void stopAllJournalling();
 	JournallingObject * journallingObject( const jo_id_t _id )
 	{
-		if( m_joIDs.contains( _id ) )
-		{
-			return m_joIDs[_id];
-		}
-		return nullptr;
+		QMutexLocker idLock( &m_idLock );
+		return m_joIDs.value( _id, nullptr );
 	}
 
 
@@ -115,6 +113,9 @@ private:
 	using CheckPointStack = QStack<CheckPoint>;
 
 	JoIdMap m_joIDs;
+	//! Guards m_joIDs, since plugins loaded in the background by a
+	//! PluginLoaderThread allocate IDs for their models
+	QMutex m_idLock;
 
 	CheckPointStack m_undoCheckPoints;
 	CheckPointStack m_redoCheckPoints;
@@ -25,6 +25,8 @@
 #ifndef PROJECT_RENDERER_H
 #define PROJECT_RENDERER_H
 
+#include <QVector>
+
 #include "AudioFileDevice.h"
 #include "lmmsconfig.h"
 #include "AudioEngine.h"
@@ -35,6 +37,8 @@
 namespace lmms
 {
 
+class AudioEncoderPipeline;
+
 
 class LMMS_EXPORT ProjectRenderer : public QThread
 {
@@ -59,16 +63,26 @@ public:
 		AudioFileDeviceInstantiaton m_getDevInst;
 	} ;
 
+	struct ExportTarget
+	{
+		ExportFileFormats format;
+		QString path;
+	} ;
+
 
 	ProjectRenderer( const AudioEngine::qualitySettings & _qs,
 				const OutputSettings & _os,
 				ExportFileFormats _file_format,
 				const QString & _out_file );
+	//! Render once and encode into all targets simultaneously
+	ProjectRenderer( const AudioEngine::qualitySettings & qualitySettings,
+				const OutputSettings & outputSettings,
+				const QVector<ExportTarget> & targets );
 	~ProjectRenderer() override = default;
 
 	bool isReady() const
 	{
-		return m_fileDev != nullptr;
+		return m_pipeline != nullptr;
 	}
 
 	static ExportFileFormats getFileFormatFromExtension(
@@ -76,6 +90,10 @@ public:
 
 	static QString getFileExtensionFromFormat( ExportFileFormats fmt );
 
+	//! Replace the extension of a registered format in path by the one of
+	//! fmt, or append it if path has none
+	static QString pathForFormat( const QString & path, ExportFileFormats fmt );
+
 	static const std::array<FileEncodeDevice, 5> fileEncodeDevices;
 
 public slots:
@@ -92,7 +110,11 @@ signals:
 private:
 	void run() override;
 
-	AudioFileDevice * m_fileDev;
+	//! Convert frames at the processing rate into frames written to the files
+	f_cnt_t outputFrames( f_cnt_t processedFrames ) const;
+
+	// owned by the audio engine once processing has been started
+	AudioEncoderPipeline * m_pipeline;
 	AudioEngine::qualitySettings m_qualitySettings;
 
 	volatile int m_progress;
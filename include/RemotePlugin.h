@@ -25,6 +25,7 @@
 #ifndef REMOTE_PLUGIN_H
 #define REMOTE_PLUGIN_H
 
+#include "RemotePluginAudioSync.h"
 #include "RemotePluginBase.h"
 #include "SharedMemory.h"
 
@@ -98,6 +99,15 @@ public:
 
 	bool process( const sampleFrame * _in_buf, sampleFrame * _out_buf );
 
+	//! Whether the plugin runs one period ahead, see SetupDialog
+	bool isPipelined() const
+	{
+		return m_pipelined;
+	}
+
+	//! Frames by which process() delays the plugin's output
+	f_cnt_t latency() const;
+
 	void processMidiEvent( const MidiEvent&, const f_cnt_t _offset );
 
 	void updateSampleRate( sample_rate_t _sr )
@@ -154,6 +164,14 @@ protected:
 	bool m_failed;
 private:
 	void resizeSharedProcessingMemory();
+	void setupAudioSync();
+
+	void writeInputs( const sampleFrame * inBuf, fpp_t frames );
+	void readOutputs( sampleFrame * outBuf, fpp_t frames ) const;
+	//! Hand the audio buffer over to the plugin
+	bool startPeriod();
+	//! Wait until the plugin has processed the audio buffer
+	bool waitForPeriod();
 
 
 	QProcess m_process;
@@ -169,9 +187,29 @@ private:
 #endif
 	bool m_splitChannels;
 
+	//! Collect the result of each period during the next one
+	const bool m_pipelined;
+	//! A period has been started but its result was not collected yet
+	bool m_periodPending;
+	//! IdProcessingDone messages not collected by waitForPeriod() yet.
+	//! Counted in processMessage(), since any thread waiting for another
+	//! message may receive them. Guarded by m_commMutex.
+	int m_periodsDone;
+
 	SharedMemory<float[]> m_audioBuffer;
 	std::size_t m_audioBufferSize;
 
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	SharedMemory<RemotePluginAudioSync> m_audioSync;
+	//! Set once the client has attached to m_audioSync
+	std::atomic<bool> m_audioSyncReady;
+	//! Serializes writers of the MIDI event queue
+	QMutex m_midiEventLock;
+	//! Whether the pending period was started through the handshake
+	bool m_pendingSynced;
+	uint32_t m_pendingRequest;
+#endif
+
 	int m_inputCount;
 	int m_outputCount;
 
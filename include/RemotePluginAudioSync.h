@@ -0,0 +1,221 @@
+/*
+ * RemotePluginAudioSync.h - lock-free period handshake and MIDI event queue
+ *                           shared between RemotePlugin and its client
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef REMOTE_PLUGIN_AUDIO_SYNC_H
+#define REMOTE_PLUGIN_AUDIO_SYNC_H
+
+#include "lmmsconfig.h"
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+// futexes work across processes on plain shared memory mappings; Wine
+// builds of remote plugins keep using messages
+#if defined(LMMS_BUILD_LINUX) && !defined(__WINE__)
+#define LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+
+#include <cerrno>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lmms
+{
+
+
+struct RemotePluginMidiEvent
+{
+	int32_t type;
+	int32_t channel;
+	int32_t param0;
+	int32_t param1;
+	int32_t offset;
+} ;
+
+
+/**
+	\brief Lives in shared memory and lets the host hand periods to a remote
+	plugin without serializing messages
+
+	The host queues the period's MIDI events in a single-producer,
+	single-consumer ring, marks the end of the period's events in the ring,
+	increments the request counter and wakes the client. The client's
+	processing thread drains the ring up to that mark, renders the audio
+	buffer and publishes the handled request in the done counter. Events
+	queued meanwhile, e.g. for the next period while the host runs one
+	period ahead, stay in the ring until the next request.
+	Both sides sleep on the counters with futexes, so neither spins nor
+	takes a lock shared with the other process.
+
+	The struct has to stay trivial to be placed in SharedMemory, so the
+	counters are plain integers accessed through atomic().
+*/
+struct RemotePluginAudioSync
+{
+	static constexpr uint32_t MidiEventCapacity = 1024;
+	static_assert((MidiEventCapacity & (MidiEventCapacity - 1)) == 0, "capacity must be a power of two");
+
+	//! Number of periods requested by the host
+	alignas(64) uint32_t requested;
+	//! midiWrite at the last request, the end of that period's events
+	uint32_t midiEnd;
+	//! Last request the client finished
+	alignas(64) uint32_t done;
+	//! Set by either side to stop the client's processing thread
+	uint32_t quit;
+
+	alignas(64) uint32_t midiWrite;
+	alignas(64) uint32_t midiRead;
+	RemotePluginMidiEvent midiEvents[MidiEventCapacity];
+
+
+	static std::atomic<uint32_t>& atomic(uint32_t& value)
+	{
+		static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+			std::atomic<uint32_t>::is_always_lock_free, "atomics must be usable in shared memory");
+		return *reinterpret_cast<std::atomic<uint32_t>*>(&value);
+	}
+
+	//! Host side, returns false if the queue is full
+	bool pushMidiEvent(const RemotePluginMidiEvent& event)
+	{
+		const uint32_t write = atomic(midiWrite).load(std::memory_order_relaxed);
+		if (write - atomic(midiRead).load(std::memory_order_acquire) == MidiEventCapacity)
+		{
+			return false;
+		}
+		midiEvents[write & (MidiEventCapacity - 1)] = event;
+		atomic(midiWrite).store(write + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! Client side, the end of the events of the request being handled
+	uint32_t midiEventsEnd()
+	{
+		return atomic(midiEnd).load(std::memory_order_acquire);
+	}
+
+	//! Client side, returns false if no events are left before end
+	bool popMidiEvent(RemotePluginMidiEvent& event, uint32_t end)
+	{
+		const uint32_t read = atomic(midiRead).load(std::memory_order_relaxed);
+		if (read == end)
+		{
+			return false;
+		}
+		event = midiEvents[read & (MidiEventCapacity - 1)];
+		atomic(midiRead).store(read + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! Host side, returns the request to wait for
+	uint32_t requestProcessing()
+	{
+		// events may be pushed by another thread, acquire them so they are
+		// published to the client together with the request
+		atomic(midiEnd).store(atomic(midiWrite).load(std::memory_order_acquire), std::memory_order_relaxed);
+		const uint32_t request = atomic(requested).fetch_add(1, std::memory_order_release) + 1;
+		wake(requested);
+		return request;
+	}
+
+	//! Host side, returns false if the client did not answer within timeoutMs
+	bool waitForProcessing(uint32_t request, int timeoutMs)
+	{
+		uint32_t current;
+		while ((current = atomic(done).load(std::memory_order_acquire)) != request)
+		{
+			if (!wait(done, current, timeoutMs)) { return false; }
+		}
+		return true;
+	}
+
+	//! Client side, waits for a request newer than handled. Returns false on
+	//! timeout or when asked to quit.
+	bool waitForRequest(uint32_t handled, uint32_t& request, int timeoutMs)
+	{
+		while ((request = atomic(requested).load(std::memory_order_acquire)) == handled)
+		{
+			if (atomic(quit).load(std::memory_order_relaxed) || !wait(requested, handled, timeoutMs))
+			{
+				return false;
+			}
+		}
+		return !atomic(quit).load(std::memory_order_relaxed);
+	}
+
+	//! Client side
+	void processingDone(uint32_t request)
+	{
+		atomic(done).store(request, std::memory_order_release);
+		wake(done);
+	}
+
+	void requestQuit()
+	{
+		atomic(quit).store(1, std::memory_order_relaxed);
+		// the client might be sleeping on the request counter
+		atomic(requested).fetch_add(1, std::memory_order_release);
+		wake(requested);
+	}
+
+private:
+	//! Sleep while word == expected, returns false on timeout
+	static bool wait(uint32_t& word, uint32_t expected, int timeoutMs)
+	{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+		timespec timeout;
+		timeout.tv_sec = timeoutMs / 1000;
+		timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+		// not FUTEX_PRIVATE_FLAG, the word is shared with another process
+		if (syscall(SYS_futex, &word, FUTEX_WAIT, expected, &timeout, nullptr, 0) == -1)
+		{
+			return errno != ETIMEDOUT;
+		}
+		return true;
+#else
+		(void) word;
+		(void) expected;
+		(void) timeoutMs;
+		return false;
+#endif
+	}
+
+	static void wake(uint32_t& word)
+	{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+		syscall(SYS_futex, &word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+		(void) word;
+#endif
+	}
+} ;
+
+
+} // namespace lmms
+
+#endif // REMOTE_PLUGIN_AUDIO_SYNC_H
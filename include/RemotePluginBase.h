@@ -374,6 +374,8 @@ enum RemoteMessageIDs
 	IdLoadPresetFile,
 	IdDebugMessage,
 	IdIdle,
+	IdChangeAudioSyncKey,
+	IdAudioSyncReady,
 	IdUserBase = 64
 } ;
 
@@ -25,6 +25,7 @@
 #ifndef REMOTE_PLUGIN_CLIENT_H
 #define REMOTE_PLUGIN_CLIENT_H
 
+#include "RemotePluginAudioSync.h"
 #include "RemotePluginBase.h"
 
 #include <stdexcept>
@@ -120,13 +121,40 @@ public:
 	}
 
 
+protected:
+	//! Let the host hand over periods and MIDI events through shared memory
+	//! instead of messages, if the platform supports it. process() and
+	//! processMidiEvent() are then called from a separate thread, see
+	//! processSynced().
+	void enableAudioSync()
+	{
+		m_audioSyncEnabled = true;
+	}
+
+	//! Stop the audio sync thread, must be called before a derived class
+	//! destroys anything used by process()
+	void disableAudioSync();
+
+	//! Called by the audio sync thread for every period. Clients have to
+	//! make sure it doesn't run concurrently with processMessage().
+	virtual void processSynced();
+
+
 private:
 	void setShmKey(const std::string& key);
+	void setAudioSyncKey(const std::string& key);
 	void doProcessing();
+	void audioSyncLoop();
 
 	SharedMemory<float[]> m_audioBuffer;
 	SharedMemory<const VstSyncData> m_vstSyncData;
 
+	bool m_audioSyncEnabled;
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	SharedMemory<RemotePluginAudioSync> m_audioSync;
+	std::thread m_audioSyncThread;
+#endif
+
 	int m_inputCount;
 	int m_outputCount;
 
@@ -182,6 +210,7 @@ RemotePluginClient::RemotePluginClient( const std::string& _shm_in, const std::s
 RemotePluginClient::RemotePluginClient( const char * socketPath ) :
 	RemotePluginBase(),
 #endif
+	m_audioSyncEnabled( false ),
 	m_inputCount( 0 ),
 	m_outputCount( 0 ),
 	m_sampleRate( 44100 ),
@@ -217,6 +246,7 @@ RemotePluginClient::RemotePluginClient( const char * socketPath ) :
 
 RemotePluginClient::~RemotePluginClient()
 {
+	disableAudioSync();
 	sendMessage( IdQuit );
 
 #ifndef SYNC_WITH_SHM_FIFO
@@ -301,6 +331,10 @@ bool RemotePluginClient::processMessage( const message & _m )
 			setShmKey(_m.getString(0));
 			break;
 
+		case IdChangeAudioSyncKey:
+			setAudioSyncKey(_m.getString(0));
+			break;
+
 		case IdInitDone:
 			break;
 
@@ -338,6 +372,89 @@ void RemotePluginClient::setShmKey(const std::string& key)
 
 
 
+void RemotePluginClient::setAudioSyncKey(const std::string& key)
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	if (!m_audioSyncEnabled || m_audioSyncThread.joinable())
+	{
+		// keep using messages
+		return;
+	}
+
+	try
+	{
+		m_audioSync.attach(key);
+	}
+	catch (const std::runtime_error& error)
+	{
+		debugMessage(std::string{"failed getting audio sync memory: "} + error.what() + '\n');
+		return;
+	}
+
+	m_audioSyncThread = std::thread{&RemotePluginClient::audioSyncLoop, this};
+	sendMessage(IdAudioSyncReady);
+#else
+	(void) key;
+#endif
+}
+
+
+
+
+void RemotePluginClient::disableAudioSync()
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	if (m_audioSyncThread.joinable())
+	{
+		m_audioSync->requestQuit();
+		m_audioSyncThread.join();
+	}
+#endif
+	m_audioSyncEnabled = false;
+}
+
+
+
+
+void RemotePluginClient::processSynced()
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	// events queued after the request belong to the next period
+	const uint32_t end = m_audioSync->midiEventsEnd();
+	RemotePluginMidiEvent event;
+	while (m_audioSync->popMidiEvent(event, end))
+	{
+		processMidiEvent(MidiEvent(static_cast<MidiEventTypes>(event.type),
+						event.channel, event.param0, event.param1), event.offset);
+	}
+#endif
+	doProcessing();
+}
+
+
+
+
+void RemotePluginClient::audioSyncLoop()
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	RemotePluginAudioSync& sync = *m_audioSync;
+	uint32_t handled = RemotePluginAudioSync::atomic(sync.requested).load(std::memory_order_acquire);
+	uint32_t request;
+	while (!RemotePluginAudioSync::atomic(sync.quit).load(std::memory_order_relaxed))
+	{
+		if (sync.waitForRequest(handled, request, 500))
+		{
+			processSynced();
+			sync.processingDone(request);
+			handled = request;
+		}
+	}
+#endif
+}
+
+
+
+
 void RemotePluginClient::doProcessing()
 {
 	if (m_audioBuffer)
@@ -46,6 +46,14 @@ public:
 		ProjectRenderer::ExportFileFormats fmt,
 		QString outputPath);
 
+	/// Encode every render into all given formats. The files differ from
+	/// the output path only by their extension.
+	RenderManager(
+		const AudioEngine::qualitySettings & qualitySettings,
+		const OutputSettings & outputSettings,
+		const QVector<ProjectRenderer::ExportFileFormats> & formats,
+		QString outputPath);
+
 	~RenderManager() override;
 
 	/// Export all unmuted tracks into a single file
@@ -73,7 +81,7 @@ private:
 	const AudioEngine::qualitySettings m_qualitySettings;
 	const AudioEngine::qualitySettings m_oldQualitySettings;
 	const OutputSettings m_outputSettings;
-	ProjectRenderer::ExportFileFormats m_format;
+	const QVector<ProjectRenderer::ExportFileFormats> m_formats;
 	QString m_outputPath;
 
 	std::unique_ptr<ProjectRenderer> m_activeRenderer;
@@ -47,6 +47,8 @@ class QRect;
 namespace lmms
 {
 
+class WaveformOverview;
+
 // values for buffer margins, used for various libsamplerate interpolation modes
 // the array positions correspond to the converter_type parameter values in libsamplerate
 // if there appears problems with playback on some interpolation mode, then the value for that mode
@@ -295,6 +297,12 @@ private:
 
 	void update(bool keepSettings = false);
 
+	//! Drop the waveform overview, must be called with m_varLock locked for
+	//! writing before m_data is changed or freed
+	void resetOverview();
+	//! Identifies the sample data an overview cache file was built from
+	QByteArray overviewStamp() const;
+
 	void convertIntToFloat(int_sample_t * & ibuf, f_cnt_t frames, int channels);
 	void directFloatWrite(sample_t * & fbuf, f_cnt_t frames, int channels);
 
@@ -333,6 +341,8 @@ private:
 	bool m_reversed;
 	float m_frequency;
 	sample_rate_t m_sampleRate;
+	//! Built on demand by visualize(), accessed atomically
+	std::shared_ptr<WaveformOverview> m_overview;
 
 	sampleFrame * getSampleFragment(
 		f_cnt_t index,
@@ -351,6 +361,8 @@ private:
 
 signals:
 	void sampleUpdated();
+	//! More of the waveform overview is available, views should redraw
+	void overviewUpdated();
 
 } ;
 
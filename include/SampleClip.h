@@ -26,6 +26,7 @@
 #define SAMPLE_CLIP_H
 
 #include "Clip.h"
+#include "DiskRecorder.h"
 
 namespace lmms
 {
@@ -75,6 +76,13 @@ public:
 	bool isPlaying() const;
 	void setIsPlaying(bool isPlaying);
 
+	//! Hand the take prepared while the clip is armed over to the
+	//! SampleRecordHandle, so it doesn't allocate on the audio thread
+	DiskRecorder::TakePtr takeRecordTake()
+	{
+		return std::move( m_recordTake );
+	}
+
 public slots:
 	void setSampleBuffer( lmms::SampleBuffer* sb );
 	void setSampleFile( const QString & _sf );
@@ -84,10 +92,16 @@ public slots:
 	void updateTrackClips();
 
 
+private slots:
+	void updateRecordTake();
+
+
 private:
 	SampleBuffer* m_sampleBuffer;
 	BoolModel m_recordModel;
 	bool m_isPlaying;
+	//! Guarded by AudioEngine::requestChangeInModel()
+	DiskRecorder::TakePtr m_recordTake;
 
 	friend class gui::SampleClipView;
 
@@ -25,6 +25,8 @@
 #ifndef SAMPLE_CLIP_VIEW_H
 #define SAMPLE_CLIP_VIEW_H
 
+#include <memory>
+
 #include "ClipView.h"
 
 
@@ -37,6 +39,7 @@ class SampleClip;
 namespace gui
 {
 
+class ClipThumbnail;
 
 class SampleClipView : public ClipView
 {
@@ -62,9 +65,20 @@ protected:
 	void paintEvent( QPaintEvent * ) override;
 
 
+private slots:
+	void invalidateThumbnail();
+
+
 private:
 	SampleClip * m_clip;
 	QPixmap m_paintPixmap;
+
+	//! The waveform, drawn over the background
+	std::shared_ptr<ClipThumbnail> m_thumbnail;
+	//! Where the thumbnail's waveform was placed and the pen it was drawn with
+	QRect m_thumbnailRect;
+	QColor m_thumbnailColor;
+
 	bool splitClip( const TimePos pos ) override;
 } ;
 
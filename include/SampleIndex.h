@@ -0,0 +1,203 @@
+/*
+ * SampleIndex.h - background index of sample libraries for instant search
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SAMPLE_INDEX_H
+#define SAMPLE_INDEX_H
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSemaphore>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+
+#include "lmms_basics.h"
+#include "lmms_export.h"
+
+class QFileInfo;
+
+namespace lmms
+{
+
+
+/**
+	\brief Persistent index of the files below the library directories
+
+	A scanner thread walks the roots given to addRoot() and records every
+	file with its type and, for samples, length, sample rate and a coarse
+	peak overview. Only files which are new or changed since the last scan
+	are decoded, the index is saved to the working directory and loaded
+	again on the next start. A filesystem watcher queues rescans of the
+	directories that change while LMMS is running.
+
+	search() never touches the disk, so it can be called on every key press
+	even for libraries of several hundred thousand files.
+
+	Enabled by "ui/indexsamplelibrary".
+*/
+class LMMS_EXPORT SampleIndex : public QObject
+{
+	Q_OBJECT
+public:
+	enum class Type : quint8
+	{
+		Unknown,
+		Sample,
+		Project,
+		Preset,
+		Midi,
+		SoundFont
+	} ;
+
+	//! Number of parts the peak overview of a sample consists of
+	static constexpr int PeakCount = 64;
+	//! Results returned by search() at most
+	static constexpr int MaxResults = 500;
+	//! Directories watched for changes at most, to stay below the limits
+	//! of the operating system. Others are rescanned by addRoot().
+	static constexpr int MaxWatchedDirectories = 4096;
+
+	struct Entry
+	{
+		QString path;
+		//! File name in lower case, what search() matches against
+		QString key;
+		Type type = Type::Unknown;
+		qint64 size = 0;
+		qint64 modified = 0;
+		f_cnt_t frames = 0;
+		sample_rate_t sampleRate = 0;
+		//! Maximum absolute level of each part, 255 is full scale
+		std::array<quint8, PeakCount> peaks = {};
+
+		//! Length in seconds, 0 for everything but samples
+		double duration() const
+		{
+			return sampleRate > 0 ? static_cast<double>(frames) / sampleRate : 0.;
+		}
+	} ;
+
+	SampleIndex();
+	~SampleIndex() override;
+
+	//! Index everything below @p path. Known roots are rescanned, which only
+	//! decodes files that changed.
+	void addRoot(const QString& path);
+
+	//! Files below one of @p roots whose names contain all words of
+	//! @p text, as prefix, substring or in order with gaps, best matches
+	//! first. Directory names only match as substrings.
+	std::vector<Entry> search(const QString& text, const QStringList& roots, int limit = MaxResults) const;
+
+	//! Look up a single file, returns false if it isn't indexed (yet)
+	bool entry(const QString& path, Entry& result) const;
+
+	//! Whether the scanner is still working through queued directories
+	bool isScanning() const
+	{
+		return m_scanning;
+	}
+
+	static Type typeOf(const QString& fileName);
+
+signals:
+	//! The index changed, emitted at most every ChangeInterval ms
+	void changed();
+
+private slots:
+	void directoryChanged(const QString& path);
+	void watchDirectories(const QStringList& paths);
+
+private:
+	//! Minimum time between two changed() signals while scanning
+	static constexpr int ChangeInterval = 500;
+
+	struct Directory
+	{
+		std::vector<Entry> files;
+		QStringList subdirectories;
+	} ;
+
+	struct Job
+	{
+		QString path;
+		bool recursive;
+	} ;
+
+	class Scanner : public QThread
+	{
+	public:
+		Scanner(SampleIndex* index);
+
+	private:
+		void run() override;
+
+		SampleIndex* m_index;
+	} ;
+
+	void enqueue(const QString& path, bool recursive);
+	//! Called by the scanner thread
+	void scanDirectory(const Job& job);
+	Entry probe(const QFileInfo& info) const;
+	void removeDirectory(const QString& path);
+	//! Emit changed() if the last time is long enough ago or @p force is set
+	void markChanged(bool force);
+
+	bool load();
+	bool save() const;
+	static QString cacheFile();
+
+	//! Normalized to end with a slash
+	static QString directoryPath(const QString& path);
+
+	QHash<QString, Directory> m_directories;
+	mutable QReadWriteLock m_lock;
+
+	std::deque<Job> m_jobs;
+	QMutex m_jobsLock;
+	QSemaphore m_wake;
+
+	QFileSystemWatcher m_watcher;
+	QSet<QString> m_watched;
+
+	Scanner m_scanner;
+	std::atomic<bool> m_scanning;
+	std::atomic<bool> m_quit;
+	//! Whether the index differs from the cache file
+	bool m_dirty;
+	qint64 m_lastChange;
+} ;
+
+
+} // namespace lmms
+
+#endif // SAMPLE_INDEX_H
@@ -26,6 +26,8 @@
 #ifndef SAMPLE_PLAY_HANDLE_H
 #define SAMPLE_PLAY_HANDLE_H
 
+#include <memory>
+
 #include "SampleBuffer.h"
 #include "AutomatableModel.h"
 #include "PlayHandle.h"
@@ -38,6 +40,7 @@ class PatternTrack;
 class SampleClip;
 class Track;
 class AudioPort;
+class SampleStream;
 
 
 class SamplePlayHandle : public PlayHandle
@@ -46,6 +49,8 @@ public:
 	SamplePlayHandle( SampleBuffer* sampleBuffer , bool ownAudioPort = true );
 	SamplePlayHandle( const QString& sampleFile );
 	SamplePlayHandle( SampleClip* clip );
+	//! Play @p stream while it is being decoded, see SampleStream
+	SamplePlayHandle( std::shared_ptr<SampleStream> stream );
 	~SamplePlayHandle() override;
 
 	inline bool affinityMatters() const override
@@ -81,7 +86,10 @@ public:
 
 
 private:
+	void playStream( sampleFrame * buffer, fpp_t frames );
+
 	SampleBuffer * m_sampleBuffer;
+	std::shared_ptr<SampleStream> m_stream;
 	bool m_doneMayReturnTrue;
 
 	f_cnt_t m_frame;
@@ -26,9 +26,7 @@
 #ifndef SAMPLE_RECORD_HANDLE_H
 #define SAMPLE_RECORD_HANDLE_H
 
-#include <QList>
-#include <QPair>
-
+#include "DiskRecorder.h"
 #include "PlayHandle.h"
 #include "TimePos.h"
 
@@ -37,7 +35,6 @@ namespace lmms
 
 
 class PatternTrack;
-class SampleBuffer;
 class SampleClip;
 class Track;
 
@@ -54,16 +51,12 @@ public:
 	bool isFromTrack( const Track * _track ) const override;
 
 	f_cnt_t framesRecorded() const;
-	void createSampleBuffer( SampleBuffer * * _sample_buf );
 
 
 private:
-	virtual void writeBuffer( const sampleFrame * _ab,
-						const f_cnt_t _frames );
-
-	using bufferList = QList<QPair<sampleFrame*, f_cnt_t>>;
-	bufferList m_buffers;
-	f_cnt_t m_framesRecorded;
+	// prepared by the clip while it is armed and streamed to disk by the
+	// DiskRecorder, the clip gets the file when recording stops
+	DiskRecorder::TakePtr m_take;
 	TimePos m_minLength;
 
 	Track * m_track;
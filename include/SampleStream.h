@@ -0,0 +1,167 @@
+/*
+ * SampleStream.h - decodes a sample file in the background while it plays
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SAMPLE_STREAM_H
+#define SAMPLE_STREAM_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+#include "LocklessRingBuffer.h"
+#include "lmms_export.h"
+
+class QThreadPool;
+
+namespace lmms
+{
+
+
+/**
+	\brief Sample file which is decoded while it is being played
+
+	A thread of the global thread pool decodes the file block by block,
+	resamples it to the output rate and feeds a lock-free ring which the
+	audio thread reads from. Playback can start as soon as the first block is
+	decoded and long files are never held in memory as a whole, which makes
+	it suitable for previews. Owners of many streams let them decode ahead
+	instead, which doesn't take a thread while the ring is full.
+
+	Files which libsndfile can't read are loaded through SampleBuffer in the
+	same thread instead, so every format SampleBuffer supports can be
+	streamed.
+*/
+class LMMS_EXPORT SampleStream : public std::enable_shared_from_this<SampleStream>
+{
+public:
+	//! How often the decoder looks for free space while the ring is full
+	static constexpr int PollInterval = 10;
+	//! Seconds of audio decoded ahead of playback
+	static constexpr int RingSeconds = 2;
+	//! Frames decoded at once
+	static constexpr f_cnt_t BlockFrames = 4096;
+
+	//! Stream @p file at @p sampleRate, starting @p startFrame frames at
+	//! that rate into the file
+	SampleStream(const QString& file, sample_rate_t sampleRate, f_cnt_t startFrame = 0);
+	~SampleStream();
+
+	//! Start decoding in the background, in @p pool or the global thread
+	//! pool, which takes a thread until the whole file is decoded. The
+	//! stream must be owned by a std::shared_ptr.
+	void start(QThreadPool* pool = nullptr);
+
+	//! Decode what fits into the ring in @p pool, unless that's being done.
+	//! Called periodically from a thread which may block instead of
+	//! start(). Returns false once there's nothing more to decode.
+	bool decodeAhead(QThreadPool* pool);
+
+	//! Decode on the calling thread unless a decoder is running, in which
+	//! case wait until it wrote something or stopped. Not realtime safe,
+	//! for exports which must not miss anything.
+	void waitForFrames();
+
+	//! Stop decoding, does not wait for the decoder
+	void cancel()
+	{
+		m_cancelled.store(true, std::memory_order_relaxed);
+	}
+
+	bool isCancelled() const
+	{
+		return m_cancelled.load(std::memory_order_relaxed);
+	}
+
+	//! Copy up to @p frames decoded frames to @p dst, returns how many were
+	//! copied. Realtime safe, called by the audio thread.
+	f_cnt_t read(sampleFrame* dst, f_cnt_t frames);
+
+	//! Length at the output rate, 0 until the file has been opened
+	f_cnt_t totalFrames() const
+	{
+		return m_totalFrames.load(std::memory_order_relaxed);
+	}
+
+	//! Whether all decoded frames have been read
+	bool isFinished() const
+	{
+		return m_decoded.load(std::memory_order_acquire) && m_reader.empty();
+	}
+
+	const QString& file() const
+	{
+		return m_file;
+	}
+
+	sample_rate_t sampleRate() const
+	{
+		return m_sampleRate;
+	}
+
+	f_cnt_t startFrame() const
+	{
+		return m_startFrame;
+	}
+
+private:
+	class DecodeJob;
+	struct Decoder;
+
+	//! Called by the decoder thread, decodes until the ring is full.
+	//! Returns true once there's nothing more to decode.
+	bool decodeWhatFits();
+	//! Returns false if there's nothing to decode
+	bool openDecoder();
+	void finishDecoding();
+	//! Write @p frames to the ring, which has room for them
+	void write(const sampleFrame* buf, f_cnt_t frames);
+	//! Wake waitForFrames()
+	void notifyReaders();
+
+	const QString m_file;
+	const sample_rate_t m_sampleRate;
+	const f_cnt_t m_startFrame;
+
+	LocklessRingBuffer<sampleFrame> m_ring;
+	LocklessRingBufferReader<sampleFrame> m_reader;
+
+	std::atomic<f_cnt_t> m_totalFrames;
+	std::atomic<bool> m_decoded;
+	std::atomic<bool> m_cancelled;
+
+	//! Only accessed by the thread which set m_decoding
+	std::unique_ptr<Decoder> m_decoder;
+	std::atomic<bool> m_decoding;
+	QMutex m_waitLock;
+	QWaitCondition m_framesWritten;
+} ;
+
+
+} // namespace lmms
+
+#endif // SAMPLE_STREAM_H
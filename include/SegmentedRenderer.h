@@ -0,0 +1,160 @@
+/*
+ * SegmentedRenderer.h - renders a project in segments, each in its own LMMS
+ *                       process, and splices them into one file
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SEGMENTED_RENDERER_H
+#define SEGMENTED_RENDERER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include "ProjectRenderer.h"
+#include "OutputSettings.h"
+#include "TimePos.h"
+
+
+namespace lmms
+{
+
+
+/**
+	\brief Renders a project with one process per segment
+
+	The engine is a singleton, so a song can only be rendered at one
+	position per process. To use more cores, the export range is split into
+	segments at bar boundaries, and every segment is rendered by running
+	"lmms render" on the project with --range. Each of them starts the given
+	number of bars early, so that reverb tails and envelopes have settled when
+	the segment begins, and writes a 32 bit float file. The segments are then
+	spliced at the exact frames where they reach their first tick, or
+	crossfaded over a number of frames, and encoded into the requested
+	formats.
+
+	Song positions are only tracked with whole-frame accuracy, and LFOs run
+	freely from the start of each process, so the result can differ slightly
+	from a serial render. compare() measures how much.
+*/
+class SegmentedRenderer : public QObject
+{
+	Q_OBJECT
+public:
+	struct Settings
+	{
+		QString projectFile;
+		//! Part of the song to render, in whole bars
+		TimePos begin;
+		TimePos end;
+		int segments = 2;
+		bar_t preRollBars = 2;
+		f_cnt_t crossfadeFrames = 0;
+		//! Passed on to every segment process, e.g. the configuration file
+		QStringList extraArguments;
+	} ;
+
+	//! Numerical difference between two audio files
+	struct Difference
+	{
+		QString error;
+		sample_rate_t sampleRate = 0;
+		//! Frames present in both files
+		f_cnt_t frames = 0;
+		//! Frames the second file is longer than the first one
+		f_cnt_t lengthDifference = 0;
+		double peak = 0.0;
+		double rms = 0.0;
+		//! First frame differing by more than the threshold, -1 if none
+		f_cnt_t firstDifferentFrame = -1;
+	} ;
+
+	SegmentedRenderer(
+		const AudioEngine::qualitySettings & qualitySettings,
+		const OutputSettings & outputSettings,
+		const QVector<ProjectRenderer::ExportFileFormats> & formats,
+		const QString & outputPath,
+		const Settings & settings);
+	~SegmentedRenderer() override;
+
+	//! Start the segment processes. finished() is emitted once the output
+	//! files have been written or rendering has failed.
+	void render();
+
+	void abortProcessing();
+
+	//! Compare two audio files sample by sample. Differences above
+	//! threshold count as differing frames.
+	static Difference compare(const QString & reference, const QString & file, double threshold = 1e-5);
+
+	using EncodeFunction = std::function<void(const surroundSampleFrame *, f_cnt_t)>;
+	//! Join segment files, all but the last of which rendered
+	//! crossfadeFrames past the start of the next one, and pass the result
+	//! to encode. Returns an error message if a file couldn't be read.
+	static QString spliceFiles(const QStringList & files, f_cnt_t crossfadeFrames, const EncodeFunction & encode);
+
+signals:
+	void finished(bool successful);
+
+public slots:
+	void updateConsoleProgress();
+
+private:
+	struct Segment
+	{
+		TimePos begin;
+		TimePos end;
+		QString path;
+		std::unique_ptr<QProcess> process;
+	} ;
+
+	void segmentFinished(std::size_t index, int exitCode, QProcess::ExitStatus exitStatus);
+	QStringList argumentsFor(const Segment & segment) const;
+	void startNextSegment();
+	//! Join the segments into the output files, reports failures with fail()
+	bool splice();
+	void fail(const QString & message);
+
+	const AudioEngine::qualitySettings m_qualitySettings;
+	const OutputSettings m_outputSettings;
+	const QVector<ProjectRenderer::ExportFileFormats> m_formats;
+	const QString m_outputPath;
+	const Settings m_settings;
+
+	QTemporaryDir m_tempDir;
+	std::vector<Segment> m_segments;
+	std::size_t m_nextSegment;
+	int m_running;
+	int m_done;
+	bool m_failed;
+} ;
+
+
+} // namespace lmms
+
+#endif // SEGMENTED_RENDERER_H
@@ -95,9 +95,16 @@ private slots:
 	void toggleRunningAutoSave(bool enabled);
 	void toggleSmoothScroll(bool enabled);
 	void toggleAnimateAFP(bool enabled);
+	void toggleSaveWaveformOverview(bool enabled);
+	void toggleIndexSampleLibrary(bool enabled);
 	void vstEmbedMethodChanged();
 	void toggleVSTAlwaysOnTop(bool en);
 	void toggleDisableAutoQuit(bool enabled);
+	void toggleSf2SharedSynth(bool enabled);
+	void togglePipelineRemotePlugins(bool enabled);
+	void togglePlanarBuffers(bool enabled);
+	void toggleDelayCompensation(bool enabled);
+	void toggleLazyPlugins(bool enabled);
 
 	// Audio settings widget.
 	void audioInterfaceChanged(const QString & driver);
@@ -158,12 +165,19 @@ private:
 	LedCheckBox * m_runningAutoSave;
 	bool m_smoothScroll;
 	bool m_animateAFP;
+	bool m_saveWaveformOverview;
+	bool m_indexSampleLibrary;
 	QLabel * m_vstEmbedLbl;
 	QComboBox* m_vstEmbedComboBox;
 	QString m_vstEmbedMethod;
 	LedCheckBox * m_vstAlwaysOnTopCheckBox;
 	bool m_vstAlwaysOnTop;
 	bool m_disableAutoQuit;
+	bool m_sf2SharedSynth;
+	bool m_pipelineRemotePlugins;
+	bool m_planarBuffers;
+	bool m_delayCompensation;
+	bool m_lazyPlugins;
 
 	using AswMap = QMap<QString, AudioDeviceSetupWidget*>;
 	using MswMap = QMap<QString, MidiSetupWidget*>;
@@ -26,6 +26,7 @@
 #define SONG_H
 
 #include <memory>
+#include <optional>
 
 #include <QHash>
 #include <QString>
@@ -223,6 +224,43 @@ namespace lmms {
       m_renderBetweenMarkers = renderBetweenMarkers;
     }
 
+    //! Part of the song to export instead of the whole song, e.g. one
+    //! segment of a render split across several processes
+    struct ExportRange
+    {
+      //! Rendering starts here, so that tails and envelopes have settled
+      //! when begin is reached. The frames before begin are not written.
+      TimePos preRollBegin;
+      TimePos begin;
+      TimePos end;
+      //! Frames to keep writing after end, to crossfade with the next segment
+      f_cnt_t overlapFrames = 0;
+    } ;
+
+    inline void setExportRange(const ExportRange& range) {
+      m_exportRange = range;
+    }
+
+    inline void clearExportRange() {
+      m_exportRange.reset();
+    }
+
+    inline const std::optional<ExportRange>& exportRange() const {
+      return m_exportRange;
+    }
+
+    //! Frames rendered since startExport() when the play position reached
+    //! the first exported tick, -1 until then. Sample accurate, as it is
+    //! taken inside the period.
+    inline f_cnt_t exportBeginFrame() const {
+      return m_exportBeginFrame;
+    }
+
+    //! Like exportBeginFrame(), for the end of the export
+    inline f_cnt_t exportEndFrame() const {
+      return m_exportEndFrame;
+    }
+
     inline PlayModes playMode() const {
       return m_playMode;
     }
@@ -306,6 +344,10 @@ namespace lmms {
       return m_timeSigModel;
     }
 
+    IntModel& tempoModel() {
+      return m_tempoModel;
+    }
+
     void exportProjectMidi(QString const& exportFileName) const;
 
     inline void setLoadOnLaunch(bool value) { m_loadOnLaunch = value; }
@@ -389,7 +431,7 @@ namespace lmms {
     void saveKeymapStates(QDomDocument& doc, QDomElement& element);
     void restoreKeymapStates(const QDomElement& element);
 
-    void processAutomations(const TrackList& tracks, TimePos timeStart, fpp_t frames);
+    void processAutomations(const TrackList& tracks, TimePos timeStart, fpp_t frames, f_cnt_t frameOffsetInPeriod);
 
     void setModified(bool value);
 
@@ -447,6 +489,11 @@ namespace lmms {
     TimePos m_exportLoopEnd;
     TimePos m_exportSongEnd;
     TimePos m_exportEffectiveLength;
+    std::optional<ExportRange> m_exportRange;
+    TimePos m_exportOutputBegin;
+    f_cnt_t m_exportFrames;
+    f_cnt_t m_exportBeginFrame;
+    f_cnt_t m_exportEndFrame;
 
     std::shared_ptr<Scale> m_scales[MaxScaleCount];
     std::shared_ptr<Keymap> m_keymaps[MaxKeymapCount];
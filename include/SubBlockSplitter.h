@@ -0,0 +1,115 @@
+/*
+ * SubBlockSplitter.h - splits periods where automated controls change
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SUB_BLOCK_SPLITTER_H
+#define SUB_BLOCK_SPLITTER_H
+
+#include <vector>
+
+#include "lmms_basics.h"
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Finds where a period has to be split to follow automation
+
+	Plugins with control rate ports only see one value per run. To follow
+	automation and sample exact controllers within a period, the plugin is
+	run in blocks, with each control set to its value at the start of the
+	block. A new block starts on a multiple of blockFrames() whenever a
+	control has moved by more than its tolerance since the start of the
+	current block, so unchanged controls cost nothing and ramps are
+	followed with a bounded error.
+
+	The granularity is read from "audioengine/subblockframes" and is
+	clamped to [MinBlockFrames, MaxBlockFrames]; 0 disables splitting.
+*/
+class LMMS_EXPORT SubBlockSplitter
+{
+public:
+	static constexpr fpp_t MinBlockFrames = 16;
+	static constexpr fpp_t MaxBlockFrames = 64;
+	static constexpr fpp_t DefaultBlockFrames = 32;
+	//! Default tolerance, relative to the range of a control
+	static constexpr float DefaultTolerance = 0.001f;
+
+	SubBlockSplitter();
+	explicit SubBlockSplitter(fpp_t blockFrames);
+
+	fpp_t blockFrames() const
+	{
+		return m_blockFrames;
+	}
+
+	bool isEnabled() const
+	{
+		return m_blockFrames > 0;
+	}
+
+	//! Allocate for @p controls controls, so that the audio thread doesn't
+	//! have to
+	void reserve(std::size_t controls);
+
+	//! Forget the controls of the last period
+	void clear()
+	{
+		m_controls.clear();
+	}
+
+	//! Follow @p values, one per frame of the period
+	void addControl(const float* values, float tolerance);
+
+	//! Split the period into blocks, returns their number
+	std::size_t split(fpp_t frames);
+
+	fpp_t blockStart(std::size_t block) const
+	{
+		return m_bounds[block];
+	}
+
+	fpp_t blockEnd(std::size_t block) const
+	{
+		return m_bounds[block + 1];
+	}
+
+private:
+	struct Control
+	{
+		const float* values;
+		float tolerance;
+	} ;
+
+	fpp_t m_blockFrames;
+	std::vector<Control> m_controls;
+	//! Start of every block, followed by the end of the last one
+	std::vector<fpp_t> m_bounds;
+} ;
+
+
+} // namespace lmms
+
+#endif // SUB_BLOCK_SPLITTER_H
@@ -0,0 +1,117 @@
+/*
+ * ThreadConfiguration.h - worker count, CPU affinity and scheduling policy
+ *                         of the audio threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef THREAD_CONFIGURATION_H
+#define THREAD_CONFIGURATION_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief How the audio engine sets up its threads
+
+	The render thread is the one calling AudioEngine::renderNextBuffer(),
+	i.e. the FIFO writer, the export thread or the callback thread of the
+	audio device. Worker threads process the jobs of each period together
+	with it.
+
+	The settings are read from the "audioengine" section of the
+	configuration file, and can be overridden from the command line:
+
+	  workers         number of worker threads, -1 for one less than
+	                  the number of cores
+	  rendercpus      CPUs the render thread may run on, e.g. "0,2-3"
+	  workercpus      CPUs for the workers, each worker is pinned to one
+	                  of them in turn
+	  renderpriority  scheduling policy of the render thread, "default",
+	                  "fifo" or "rr", optionally followed by ":<priority>"
+	  workerpriority  the same for the worker threads
+	  lockmemory      lock all memory of the process with mlockall()
+
+	Anything left empty is not touched, so the threads keep what they
+	inherited from the process.
+*/
+class LMMS_EXPORT ThreadConfiguration
+{
+public:
+	enum class Policy
+	{
+		Default,
+		Fifo,
+		RoundRobin
+	} ;
+
+	struct ThreadSettings
+	{
+		QList<int> cpus;
+		Policy policy = Policy::Default;
+		//! Realtime priority, 0 for the middle of the range of the policy
+		int priority = 0;
+	} ;
+
+	int workers = -1;
+	ThreadSettings render;
+	ThreadSettings worker;
+	bool lockMemory = false;
+
+	//! Read the configuration file, preferring values from @p overrides,
+	//! which is keyed like the configuration
+	static ThreadConfiguration fromConfig( const QMap<QString, QString> & overrides = {} );
+
+	//! The configuration the audio engine is started with
+	static const ThreadConfiguration & current();
+	static void setCurrent( const ThreadConfiguration & configuration );
+
+	//! Worker threads to start, with -1 resolved
+	int effectiveWorkers() const;
+
+	//! Parse lists like "0,2-5". Returns false on syntax errors.
+	static bool parseCpuList( const QString & text, QList<int> & cpus );
+	static QString cpuListToString( const QList<int> & cpus );
+
+	//! Parse "fifo:70", "rr" or "default". Returns false on syntax errors.
+	static bool parsePriority( const QString & text, ThreadSettings & settings );
+	static QString priorityToString( const ThreadSettings & settings );
+
+	//! Apply @p settings to the calling thread, @p index selects the CPU if
+	//! the thread is pinned to a single one, -1 allows all of them.
+	//! Returns a description of what took effect, for the profiler.
+	static QString applyToCurrentThread( const ThreadSettings & settings, int index = -1 );
+
+	//! Lock all current and future memory of the process into RAM
+	static bool lockProcessMemory( QString & error );
+} ;
+
+
+} // namespace lmms
+
+#endif // THREAD_CONFIGURATION_H
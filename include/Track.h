@@ -38,6 +38,7 @@ namespace lmms {
   class TimePos;
   class TrackContainer;
   class Clip;
+  class FrozenStem;
 
   namespace gui {
     class TrackView;
@@ -179,6 +180,21 @@ namespace lmms {
 
     BoolModel* getMutedModel();
 
+    //! Whether a rendered stem is played instead of the track, see
+    //! TrackFreezer
+    bool isFrozen() const {
+      return m_frozenStem != nullptr;
+    }
+
+    FrozenStem* frozenStem() const {
+      return m_frozenStem;
+    }
+
+    //! Key of the stem the track was frozen with when it was saved
+    const QString& savedFreezeKey() const {
+      return m_savedFreezeKey;
+    }
+
   public slots:
     virtual void setName(const QString& newName) {
       m_name = newName;
@@ -216,7 +232,11 @@ namespace lmms {
     QColor m_color;
     bool m_hasColor;
 
+    FrozenStem* m_frozenStem;
+    QString m_savedFreezeKey;
+
     friend class gui::TrackView;
+    friend class TrackFreezer;
 
 
   signals:
@@ -224,6 +244,7 @@ namespace lmms {
     void nameChanged();
     void clipAdded(lmms::Clip*);
     void colorChanged();
+    void frozenChanged();
   };
 
 
@@ -25,6 +25,9 @@
 #ifndef TRACK_CONTENT_WIDGET_H
 #define TRACK_CONTENT_WIDGET_H
 
+#include <vector>
+
+#include <QPointer>
 #include <QWidget>
 
 #include "JournallingObject.h"
@@ -36,6 +39,7 @@ class QMimeData;
 namespace lmms
 {
 
+class Clip;
 class Track;
 
 namespace gui
@@ -71,6 +75,19 @@ public:
 		}
 	}
 
+	/*! \brief Create the view of a clip only once it is scrolled into view.
+	 *
+	 *  Creating widgets for all clips makes large projects slow to open and
+	 *  to scroll, so the song editor creates views on demand.
+	 */
+	void deferClipView( Clip * clip );
+	//! Whether any part of @p clip is in the visible range
+	bool isInView( const Clip * clip );
+	//! Create the views of deferred clips overlapping [begin, end]
+	void createPendingClipViews( const TimePos & begin, const TimePos & end );
+	//! Create the views of all deferred clips, e.g. to select them
+	void createPendingClipViews();
+
 	bool canPasteSelection( TimePos clipPos, const QDropEvent *de );
 	bool canPasteSelection( TimePos clipPos, const QMimeData *md, bool allowSameBar = false );
 	bool pasteSelection( TimePos clipPos, QDropEvent * de );
@@ -129,12 +146,19 @@ protected:
 private:
 	Track * getTrack();
 	TimePos getPosition( int mouseX );
+	//! Create the views of deferred clips overlapping [begin, end] without
+	//! positioning them, returns whether there were any
+	bool createClipViews( const TimePos & begin, const TimePos & end );
 
 	TrackView * m_trackView;
 
 	using clipViewVector = QVector<ClipView*>;
 	clipViewVector m_clipViews;
 
+	//! Clips without a view yet, see deferClipView()
+	std::vector<QPointer<Clip>> m_pendingClips;
+	bool m_creatingClipViews;
+
 	QPixmap m_background;
 
 	// qproperty fields
@@ -0,0 +1,157 @@
+/*
+ * TrackFreezer.h - renders tracks to stems which are played instead
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef TRACK_FREEZER_H
+#define TRACK_FREEZER_H
+
+#include <memory>
+#include <vector>
+
+#include <QDomDocument>
+#include <QMetaObject>
+#include <QObject>
+#include <QPointer>
+#include <QThreadPool>
+#include <QTimer>
+
+#include "lmms_export.h"
+
+namespace lmms
+{
+
+class Track;
+
+
+/**
+	\brief Renders tracks to stems which are played instead
+
+	Freezing renders the output of an instrument track, i.e. its instrument
+	and effects, or of a pattern track to a stem before it enters the mixer
+	channel. The stem is played by a FrozenStem then and the instrument and
+	effects of an instrument track are unloaded, so the track doesn't cost
+	anything but decoding the stem anymore.
+
+	Stems are cached in the freeze directory of the working directory,
+	named after the key of the state they were rendered from, see
+	stateKey(). A track whose state changes is unfrozen; freezing it again
+	after undoing the change or loading a project with frozen tracks reuses
+	the cached stem. The cache is limited to "app"/"freezecachesize" MB, the
+	least recently rendered stems not used by the current project are
+	deleted beyond that.
+
+	Tracks can only be frozen if the output only depends on the song
+	position, so models controlled by a controller rule it out, as do
+	automated models of the instrument or effects since they are unloaded.
+*/
+class LMMS_EXPORT TrackFreezer : public QObject
+{
+	Q_OBJECT
+public:
+	//! How long edits have to settle before frozen tracks are checked
+	static constexpr int CheckDelay = 250;
+	//! Default size limit of the cache in MB
+	static constexpr int DefaultCacheSize = 4096;
+	//! Most threads decoding stems at once
+	static constexpr int MaxDecoderThreads = 4;
+
+	TrackFreezer();
+	~TrackFreezer() override;
+
+	//! Whether @p track can be frozen now, if not @p reason tells why
+	bool canFreeze(Track* track, QString* reason = nullptr) const;
+
+	//! Freeze @p track, rendering it unless the cache has a stem for its
+	//! state already. Emits finished() when done.
+	void freeze(Track* track);
+	void unfreeze(Track* track);
+
+	bool isRendering() const
+	{
+		return m_render != nullptr;
+	}
+
+	//! Hash of everything the output of @p track depends on, which names
+	//! its stem
+	static QString stateKey(Track* track);
+	static QString stemFile(const QString& key);
+	static bool hasStem(const QString& key);
+
+	//! Decodes the stems
+	QThreadPool* streamPool()
+	{
+		return &m_streamPool;
+	}
+
+public slots:
+	//! Stop rendering, the track is left unfrozen
+	void abort();
+
+	//! Start decoding the stems of the frozen tracks where playback will
+	//! start and loop to
+	void prepareStems();
+
+signals:
+	void progressChanged(int percent);
+	void finished(bool frozen);
+
+private slots:
+	void restoreFrozenTracks();
+	void scheduleCheck();
+	void checkFrozenTracks();
+	//! Keep the streams of the frozen tracks decoding ahead
+	void decodeStems();
+	void renderFinished();
+
+private:
+	class StemWriter;
+	class RenderThread;
+
+	struct Render;
+
+	//! The saved track and what else its output depends on
+	static QDomDocument trackState(Track* track);
+	static QString keyOf(const QDomDocument& state);
+
+	//! Play the stem of @p key instead of @p track, @p state being the
+	//! saved track the key was taken from
+	bool applyFreeze(Track* track, const QString& key, const QDomDocument& state);
+	void thaw(Track* track);
+
+	QVector<Track*> frozenTracks() const;
+	//! Connect to everything that changes the state of the frozen tracks
+	void watchFrozenTracks();
+	void pruneCache();
+
+	QThreadPool m_streamPool;
+	QTimer m_checkTimer;
+	QTimer m_decodeTimer;
+	std::vector<QMetaObject::Connection> m_watches;
+
+	std::unique_ptr<Render> m_render;
+} ;
+
+
+} // namespace lmms
+
+#endif // TRACK_FREEZER_H
@@ -48,6 +48,7 @@ public slots:
 	void rename();
 	void renameFinished();
 	void nameChanged();
+	void frozenChanged();
 
 
 protected:
@@ -0,0 +1,133 @@
+/*
+ * WaveformOverview.h - multi-resolution peak and RMS summary of sample data
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef WAVEFORM_OVERVIEW_H
+#define WAVEFORM_OVERVIEW_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "lmms_export.h"
+#include "lmms_basics.h"
+
+namespace lmms
+{
+
+
+/**
+	\brief Peak/RMS pyramid that lets waveforms be drawn at any zoom level in
+	time proportional to the number of pixels
+
+	The finest level summarizes BlockSize frames per entry, every further
+	level combines LevelFactor entries of the level below. The overview is
+	built in a background thread; until it is complete, the frames covered
+	so far can already be queried. Optionally, the finest level is saved to
+	and loaded from a file so it doesn't have to be rebuilt next time.
+
+	The overview reads the sample data directly, so its owner has to
+	cancel() it before changing or freeing the data.
+*/
+class LMMS_EXPORT WaveformOverview : public QObject, public std::enable_shared_from_this<WaveformOverview>
+{
+	Q_OBJECT
+public:
+	struct Peak
+	{
+		float min = 1.0f;
+		float max = -1.0f;
+		//! Sum of the squared samples of both channels
+		float squares = 0.0f;
+		//! Number of frames the squares were summed over
+		f_cnt_t frames = 0;
+
+		void add(const Peak& other);
+	};
+
+	//! Frames summarized by one entry of the finest level
+	static constexpr f_cnt_t BlockSize = 256;
+	static constexpr int LevelFactor = 4;
+
+	WaveformOverview(const sampleFrame* data, f_cnt_t frames);
+	~WaveformOverview() override;
+
+	//! Load the overview from cacheFile if it matches stamp, otherwise build
+	//! it and, if cacheFile is not empty, save it there. Runs in a thread of
+	//! the global thread pool, emits ready() when done. The overview must be
+	//! owned by a std::shared_ptr.
+	void buildInBackground(const QString& cacheFile = QString(), const QByteArray& stamp = QByteArray());
+	void build();
+
+	//! Stop a running build and wait for it, the data may be freed afterwards
+	void cancel();
+
+	bool isComplete() const
+	{
+		return m_builtBlocks.load(std::memory_order_acquire) == blocks();
+	}
+
+	//! Summarize the frames [from, to), rounded to whole blocks. Returns
+	//! false if this part of the overview has not been built yet.
+	bool peak(f_cnt_t from, f_cnt_t to, Peak& result) const;
+
+	//! Summarize the frames [from, to) by reading every stride-th one
+	static Peak scan(const sampleFrame* data, f_cnt_t from, f_cnt_t to, f_cnt_t stride = 1);
+
+	bool save(const QString& file, const QByteArray& stamp) const;
+	bool load(const QString& file, const QByteArray& stamp);
+
+signals:
+	void ready();
+
+private:
+	f_cnt_t blocks() const
+	{
+		return static_cast<f_cnt_t>(m_levels[0].size());
+	}
+
+	//! Compute the entries of the coarser levels that end with block
+	void propagate(f_cnt_t block);
+
+	const sampleFrame* m_data;
+	const f_cnt_t m_frames;
+
+	std::vector<std::vector<Peak>> m_levels;
+	//! Number of finest level entries that have been computed, including
+	//! all coarser entries made up of them
+	std::atomic<f_cnt_t> m_builtBlocks;
+
+	std::atomic<bool> m_cancelled;
+	//! Held while building
+	QMutex m_buildMutex;
+} ;
+
+
+} // namespace lmms
+
+#endif // WAVEFORM_OVERVIEW_H
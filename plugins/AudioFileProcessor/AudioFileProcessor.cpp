@@ -750,6 +750,9 @@ AudioFileProcessorWaveView::AudioFileProcessorWaveView( QWidget * _parent, int _
 
 	updateSampleRange();
 
+	connect( &m_sampleBuffer, SIGNAL( overviewUpdated() ),
+			this, SLOT( redrawGraph() ) );
+
 	m_graph.fill( Qt::transparent );
 	update();
 	updateCursor();
@@ -767,6 +770,16 @@ void AudioFileProcessorWaveView::isPlaying( f_cnt_t _current_frame )
 
 
 
+void AudioFileProcessorWaveView::redrawGraph()
+{
+	// the range hasn't changed, but the waveform can now be drawn exactly
+	m_last_to = -1;
+	update();
+}
+
+
+
+
 void AudioFileProcessorWaveView::enterEvent( QEvent * _e )
 {
 	updateCursor();
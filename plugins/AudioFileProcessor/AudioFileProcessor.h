@@ -236,6 +236,7 @@ public slots:
 	}
 
 	void isPlaying( lmms::f_cnt_t _current_frame );
+	void redrawGraph();
 
 
 private:
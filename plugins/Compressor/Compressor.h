@@ -50,6 +50,12 @@ public:
 		return &m_compressorControls;
 	}
 
+	// the lookahead delays the whole signal by 20 ms
+	f_cnt_t latency() const override
+	{
+		return m_compressorControls.m_lookaheadModel.value() ? m_lookaheadDelayLength : 0;
+	}
+
 private slots:
 	void calcAutoMakeup();
 	void calcAttack();
@@ -36,6 +36,7 @@ namespace lmms
 
 EqControls::EqControls( EqEffect *effect ) :
 	EffectControls( effect ),
+	m_outFftBands( [this]( const EqAnalyser & analyser ) { updateBandPeaks( analyser ); } ),
 	m_effect( effect ),
 	m_inGainModel( 0.0, -60.0, 20.0, 0.01, this, tr( "Input gain") ),
 	m_outGainModel( -.0, -60.0, 20.0, 0.01, this, tr( "Output gain" ) ),
@@ -106,6 +107,46 @@ EqControls::EqControls( EqEffect *effect ) :
 
 
 
+void EqControls::updateBandPeaks( const EqAnalyser & analyser )
+{
+	const float lowShelfFreq = m_lowShelfFreqModel.value();
+	const float lowShelfPeak = analyser.peakBand(
+			lowShelfFreq * ( 1 - m_lowShelfResModel.value() * 0.5 ), lowShelfFreq );
+	m_lowShelfPeakL = lowShelfPeak;
+	m_lowShelfPeakR = lowShelfPeak;
+
+	const auto paraPeak = [&analyser]( const FloatModel & freq, const FloatModel & bw )
+	{
+		return analyser.peakBand( freq.value() * ( 1 - bw.value() * 0.5 ),
+								  freq.value() * ( 1 + bw.value() * 0.5 ) );
+	};
+
+	const float para1Peak = paraPeak( m_para1FreqModel, m_para1BwModel );
+	m_para1PeakL = para1Peak;
+	m_para1PeakR = para1Peak;
+
+	const float para2Peak = paraPeak( m_para2FreqModel, m_para2BwModel );
+	m_para2PeakL = para2Peak;
+	m_para2PeakR = para2Peak;
+
+	const float para3Peak = paraPeak( m_para3FreqModel, m_para3BwModel );
+	m_para3PeakL = para3Peak;
+	m_para3PeakR = para3Peak;
+
+	const float para4Peak = paraPeak( m_para4FreqModel, m_para4BwModel );
+	m_para4PeakL = para4Peak;
+	m_para4PeakR = para4Peak;
+
+	const float highShelfFreq = m_highShelfFreqModel.value();
+	const float highShelfPeak = analyser.peakBand( highShelfFreq,
+			highShelfFreq * ( 1 + m_highShelfResModel.value() * 0.5 ) );
+	m_highShelfPeakL = highShelfPeak;
+	m_highShelfPeakR = highShelfPeak;
+}
+
+
+
+
 void EqControls::loadSettings( const QDomElement &_this )
 {
 	m_inGainModel.loadSettings( _this, "Inputgain" );
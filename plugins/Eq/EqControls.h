@@ -25,6 +25,8 @@
 #ifndef EQCONTROLS_H
 #define EQCONTROLS_H
 
+#include <atomic>
+
 #include "EffectControls.h"
 #include "EqSpectrumView.h"
 
@@ -62,16 +64,17 @@ public:
 
 	gui::EffectControlDialog* createView() override;
 
-	float m_inPeakL;
-	float m_inPeakR;
-	float m_outPeakL;
-	float m_outPeakR;
-	float m_lowShelfPeakL, m_lowShelfPeakR;
-	float m_para1PeakL, m_para1PeakR;
-	float m_para2PeakL, m_para2PeakR;
-	float m_para3PeakL, m_para3PeakR;
-	float m_para4PeakL, m_para4PeakR;
-	float m_highShelfPeakL, m_highShelfPeakR;
+	// written by the audio and analysis threads, read by the GUI
+	std::atomic<float> m_inPeakL;
+	std::atomic<float> m_inPeakR;
+	std::atomic<float> m_outPeakL;
+	std::atomic<float> m_outPeakR;
+	std::atomic<float> m_lowShelfPeakL, m_lowShelfPeakR;
+	std::atomic<float> m_para1PeakL, m_para1PeakR;
+	std::atomic<float> m_para2PeakL, m_para2PeakR;
+	std::atomic<float> m_para3PeakL, m_para3PeakR;
+	std::atomic<float> m_para4PeakL, m_para4PeakR;
+	std::atomic<float> m_highShelfPeakL, m_highShelfPeakR;
 
 	EqAnalyser m_inFftBands;
 	EqAnalyser m_outFftBands;
@@ -80,6 +83,10 @@ public:
 	bool visable();
 
 private:
+	//! Measure the peaks of the filter bands from the output spectrum,
+	//! called on the analysis service threads
+	void updateBandPeaks( const EqAnalyser & analyser );
+
 	EqEffect *m_effect;
 
 	FloatModel m_inGainModel;
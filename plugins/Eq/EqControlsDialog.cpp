@@ -222,7 +222,7 @@ void EqControlsDialog::mouseDoubleClickEvent(QMouseEvent *event)
 	update();
 }
 
-EqBand* EqControlsDialog::setBand(int index, BoolModel* active, FloatModel* freq, FloatModel* res, FloatModel* gain, QColor color, QString name, float* peakL, float* peakR, BoolModel* hp12, BoolModel* hp24, BoolModel* hp48, BoolModel* lp12, BoolModel* lp24, BoolModel* lp48)
+EqBand* EqControlsDialog::setBand(int index, BoolModel* active, FloatModel* freq, FloatModel* res, FloatModel* gain, QColor color, QString name, std::atomic<float>* peakL, std::atomic<float>* peakR, BoolModel* hp12, BoolModel* hp24, BoolModel* hp48, BoolModel* lp12, BoolModel* lp24, BoolModel* lp48)
 {
 	EqBand *filterModels = m_parameterWidget->getBandModels( index );
 	filterModels->active = active;
@@ -26,6 +26,8 @@
 #define EQCONTROLSDIALOG_H
 
 
+#include <atomic>
+
 #include "EffectControlDialog.h"
 
 namespace lmms
@@ -57,7 +59,7 @@ private:
 
 	void mouseDoubleClickEvent(QMouseEvent *event) override;
 
-	EqBand *setBand( int index, BoolModel *active, FloatModel *freq, FloatModel *res, FloatModel *gain, QColor color, QString name, float *peakL, float *peakR, BoolModel *hp12, BoolModel *hp24, BoolModel *hp48, BoolModel *lp12, BoolModel *lp24, BoolModel *lp48 );
+	EqBand *setBand( int index, BoolModel *active, FloatModel *freq, FloatModel *res, FloatModel *gain, QColor color, QString name, std::atomic<float> *peakL, std::atomic<float> *peakR, BoolModel *hp12, BoolModel *hp24, BoolModel *hp48, BoolModel *lp12, BoolModel *lp24, BoolModel *lp48 );
 
 	int m_originalHeight;
 };
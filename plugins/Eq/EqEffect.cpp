@@ -24,6 +24,8 @@
 
 #include "EqEffect.h"
 
+#include <atomic>
+
 #include "Engine.h"
 #include "lmms_math.h"
 
@@ -53,6 +55,18 @@ Plugin::Descriptor PLUGIN_EXPORT eq_plugin_descriptor =
 }
 
 
+//! Raise @p peak to @p value, the GUI resets it when it shows the peak
+static void updatePeak( std::atomic<float> & peak, float value )
+{
+	if( peak.load( std::memory_order_relaxed ) < value )
+	{
+		peak.store( value, std::memory_order_relaxed );
+	}
+}
+
+
+
+
 EqEffect::EqEffect( Model *parent, const Plugin::Descriptor::SubPluginFeatures::Key *key) :
 	Effect( &eq_plugin_descriptor, parent, key ),
 	m_eqControls( this ),
@@ -161,16 +175,13 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 
 	if(m_eqControls.m_analyseInModel.value( true ) &&  outSum > 0 && m_eqControls.isViewVisible()  )
 	{
-		m_eqControls.m_inFftBands.analyze( buf, frames );
-	}
-	else
-	{
-		m_eqControls.m_inFftBands.clear();
+		// the FFT itself runs on the analysis service threads
+		m_eqControls.m_inFftBands.tap()->write( buf, frames );
 	}
 
 	gain( buf, frames, m_inGain, &m_inPeak );
-	m_eqControls.m_inPeakL = m_eqControls.m_inPeakL < m_inPeak[0] ? m_inPeak[0] : m_eqControls.m_inPeakL;
-	m_eqControls.m_inPeakR = m_eqControls.m_inPeakR < m_inPeak[1] ? m_inPeak[1] : m_eqControls.m_inPeakR;
+	updatePeak( m_eqControls.m_inPeakL, m_inPeak[0] );
+	updatePeak( m_eqControls.m_inPeakR, m_inPeak[1] );
 
 	float periodProgress = 0.0f; // percentage of period processed
 	for( fpp_t f = 0; f < frames; ++f)
@@ -265,91 +276,22 @@ bool EqEffect::processAudioBuffer( sampleFrame *buf, const fpp_t frames )
 
 	sampleFrame outPeak = { 0, 0 };
 	gain( buf, frames, outGain, &outPeak );
-	m_eqControls.m_outPeakL = m_eqControls.m_outPeakL < outPeak[0] ? outPeak[0] : m_eqControls.m_outPeakL;
-	m_eqControls.m_outPeakR = m_eqControls.m_outPeakR < outPeak[1] ? outPeak[1] : m_eqControls.m_outPeakR;
+	updatePeak( m_eqControls.m_outPeakL, outPeak[0] );
+	updatePeak( m_eqControls.m_outPeakR, outPeak[1] );
 
 	checkGate( outSum / frames );
 
 	if(m_eqControls.m_analyseOutModel.value( true ) && outSum > 0 && m_eqControls.isViewVisible() )
 	{
-		m_eqControls.m_outFftBands.analyze( buf, frames );
-		setBandPeaks( &m_eqControls.m_outFftBands , ( int )( sampleRate ) );
-	}
-	else
-	{
-		m_eqControls.m_outFftBands.clear();
+		// the band peaks are measured by the analysis as well, see
+		// EqControls::updateBandPeaks()
+		m_eqControls.m_outFftBands.tap()->write( buf, frames );
 	}
 
 	m_eqControls.m_inProgress = false;
 	return isRunning();
 }
 
-
-
-
-float EqEffect::peakBand( float minF, float maxF, EqAnalyser *fft, int sr )
-{
-	float peak = -60;
-	float *b = fft->m_bands;
-	float h = 0;
-	for( int x = 0; x < MAX_BANDS; x++, b++ )
-	{
-		if( bandToFreq( x ,sr) >= minF && bandToFreq( x,sr ) <= maxF )
-		{
-			h = 20 * ( log10( *b / fft->getEnergy() ) );
-			peak = h > peak ? h : peak;
-		}
-	}
-
-	return ( peak + 60 ) / 100;
-}
-
-
-
-
-void EqEffect::setBandPeaks( EqAnalyser *fft, int samplerate )
-{
-	m_eqControls.m_lowShelfPeakR = m_eqControls.m_lowShelfPeakL =
-			peakBand( m_eqControls.m_lowShelfFreqModel.value()
-					  * ( 1 - m_eqControls.m_lowShelfResModel.value() * 0.5 ),
-					  m_eqControls.m_lowShelfFreqModel.value(),
-					  fft , samplerate );
-
-	m_eqControls.m_para1PeakL = m_eqControls.m_para1PeakR =
-			peakBand( m_eqControls.m_para1FreqModel.value()
-					  * ( 1 - m_eqControls.m_para1BwModel.value() * 0.5 ),
-					  m_eqControls.m_para1FreqModel.value()
-					  * ( 1 + m_eqControls.m_para1BwModel.value() * 0.5 ),
-					  fft , samplerate );
-
-	m_eqControls.m_para2PeakL = m_eqControls.m_para2PeakR =
-			peakBand( m_eqControls.m_para2FreqModel.value()
-					  * ( 1 - m_eqControls.m_para2BwModel.value() * 0.5 ),
-					  m_eqControls.m_para2FreqModel.value()
-					  * ( 1 + m_eqControls.m_para2BwModel.value() * 0.5 ),
-					  fft , samplerate );
-
-	m_eqControls.m_para3PeakL = m_eqControls.m_para3PeakR =
-			peakBand( m_eqControls.m_para3FreqModel.value()
-					  * ( 1 - m_eqControls.m_para3BwModel.value() * 0.5 ),
-					  m_eqControls.m_para3FreqModel.value()
-					  * ( 1 + m_eqControls.m_para3BwModel.value() * 0.5 ),
-					  fft , samplerate );
-
-	m_eqControls.m_para4PeakL = m_eqControls.m_para4PeakR =
-			peakBand( m_eqControls.m_para4FreqModel.value()
-					  * ( 1 - m_eqControls.m_para4BwModel.value() * 0.5 ),
-					  m_eqControls.m_para4FreqModel.value()
-					  * ( 1 + m_eqControls.m_para4BwModel.value() * 0.5 ),
-					  fft , samplerate );
-
-	m_eqControls.m_highShelfPeakL = m_eqControls.m_highShelfPeakR =
-			peakBand( m_eqControls.m_highShelfFreqModel.value(),
-					  m_eqControls.m_highShelfFreqModel.value()
-					  * ( 1 + m_eqControls.m_highShelfResModel.value() * 0.5 ),
-					  fft, samplerate );
-}
-
 extern "C"
 {
 
@@ -26,6 +26,8 @@
 #include <QList>
 #include <QWidget>
 
+#include <atomic>
+
 #include "EffectControls.h"
 #include "Fader.h"
 #include "GuiApplication.h"
@@ -42,7 +44,7 @@ class EqFader : public Fader
 public:
 	Q_OBJECT
 public:
-	EqFader( FloatModel * model, const QString & name, QWidget * parent, QPixmap * backg, QPixmap * leds, QPixmap * knobpi,  float* lPeak, float* rPeak ) :
+	EqFader( FloatModel * model, const QString & name, QWidget * parent, QPixmap * backg, QPixmap * leds, QPixmap * knobpi,  std::atomic<float>* lPeak, std::atomic<float>* rPeak ) :
 		Fader( model, name, parent, backg, leds, knobpi )
 	{
 		setMinimumSize( 23, 80 );
@@ -56,7 +58,7 @@ public:
 		setPeak_R( 0 );
 	}
 
-	EqFader( FloatModel * model, const QString & name, QWidget * parent,  float* lPeak, float* rPeak ) :
+	EqFader( FloatModel * model, const QString & name, QWidget * parent,  std::atomic<float>* lPeak, std::atomic<float>* rPeak ) :
 		Fader( model, name, parent )
 	{
 		setMinimumSize( 23, 116 );
@@ -82,20 +84,21 @@ private slots:
 		const float opl = getPeak_L();
 		const float opr = getPeak_R();
 		const float fallOff = 1.07;
-		if( *m_lPeak > opl )
+		// take the peak measured since the last update
+		const float lPeak = m_lPeak->exchange( 0 );
+		if( lPeak > opl )
 		{
-			setPeak_L( *m_lPeak );
-			*m_lPeak = 0;
+			setPeak_L( lPeak );
 		}
 		else
 		{
 			setPeak_L( opl/fallOff );
 		}
 
-		if( *m_rPeak > opr )
+		const float rPeak = m_rPeak->exchange( 0 );
+		if( rPeak > opr )
 		{
-			setPeak_R( *m_rPeak );
-			*m_rPeak = 0;
+			setPeak_R( rPeak );
 		}
 		else
 		{
@@ -108,8 +111,8 @@ private slots:
 
 
 private:
-	float* m_lPeak;
-	float* m_rPeak;
+	std::atomic<float>* m_lPeak;
+	std::atomic<float>* m_rPeak;
 	FloatModel* m_model;
 
 };
@@ -29,6 +29,8 @@
 
 #include <QWidget>
 
+#include <atomic>
+
 
 namespace lmms
 {
@@ -62,8 +64,8 @@ public :
 	int x;
 	int y;
 	QString name;
-	float *peakL;
-	float *peakR;
+	std::atomic<float> *peakL;
+	std::atomic<float> *peakR;
 };
 
 
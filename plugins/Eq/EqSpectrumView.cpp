@@ -23,6 +23,9 @@
 #include "EqSpectrumView.h"
 
 #include <cmath>
+#include <cstring>
+#include <utility>
+#include <QMutexLocker>
 #include <QPainter>
 #include <QPen>
 
@@ -37,13 +40,14 @@ namespace lmms
 {
 
 
-EqAnalyser::EqAnalyser() :
+EqAnalyser::EqAnalyser( AnalysisCallback callback ) :
+	m_callback( std::move( callback ) ),
+	m_silentTime( 0 ),
 	m_framesFilledUp ( 0 ),
 	m_energy ( 0 ),
 	m_sampleRate ( 1 ),
-	m_active ( true )
+	m_publishedEnergy( 0 )
 {
-	m_inProgress=false;
 	m_specBuf = ( fftwf_complex * ) fftwf_malloc( ( FFT_BUFFER_SIZE + 1 ) * sizeof( fftwf_complex ) );
 	m_fftPlan = fftwf_plan_dft_r2c_1d( FFT_BUFFER_SIZE*2, m_buffer, m_specBuf, FFTW_MEASURE );
 
@@ -60,7 +64,10 @@ EqAnalyser::EqAnalyser() :
 								+ a2 * cos(4 * F_PI * i / ((float)FFT_BUFFER_SIZE - 1.0))
 								- a3 * cos(6 * F_PI * i / ((float)FFT_BUFFER_SIZE - 1.0)));
 	}
-	clear();
+	reset();
+	publish();
+
+	m_tap.addProcessor( this );
 }
 
 
@@ -68,6 +75,7 @@ EqAnalyser::EqAnalyser() :
 
 EqAnalyser::~EqAnalyser()
 {
+	m_tap.removeProcessor( this );
 	fftwf_destroy_plan( m_fftPlan );
 	fftwf_free( m_specBuf );
 }
@@ -75,12 +83,24 @@ EqAnalyser::~EqAnalyser()
 
 
 
-void EqAnalyser::analyze( sampleFrame *buf, const fpp_t frames )
+void EqAnalyser::analyze( const sampleFrame *buf, const fpp_t frames )
 {
-	//only analyse if the view is visible
-	if ( m_active )
+	// the effect stops writing to the tap while it's silent or the analysis
+	// is turned off, so the spectrum goes away after a while
+	if( frames == 0 )
+	{
+		m_silentTime += AnalysisService::UpdateInterval;
+		if( m_silentTime >= ClearDelay && m_energy > 0 )
+		{
+			reset();
+			publish();
+			if( m_callback ) { m_callback( *this ); }
+		}
+		return;
+	}
+	m_silentTime = 0;
+
 	{
-		m_inProgress=true;
 		const int FFT_BUFFER_SIZE = 2048;
 		fpp_t f = 0;
 		if( frames > FFT_BUFFER_SIZE )
@@ -98,7 +118,6 @@ void EqAnalyser::analyze( sampleFrame *buf, const fpp_t frames )
 
 		if( m_framesFilledUp < FFT_BUFFER_SIZE )
 		{
-			m_inProgress = false;
 			return;
 		}
 
@@ -122,60 +141,68 @@ void EqAnalyser::analyze( sampleFrame *buf, const fpp_t frames )
 		m_energy = maximum( m_bands, MAX_BANDS ) / maximum( m_buffer, FFT_BUFFER_SIZE );
 
 		m_framesFilledUp = 0;
-		m_inProgress = false;
-		m_active = false;
 	}
-}
 
-
-
-
-float EqAnalyser::getEnergy() const
-{
-	return m_energy;
+	publish();
+	if( m_callback ) { m_callback( *this ); }
 }
 
 
 
 
-int EqAnalyser::getSampleRate() const
+float EqAnalyser::peakBand( float minF, float maxF ) const
 {
-	return m_sampleRate;
+	float peak = -60;
+	for( int x = 0; x < MAX_BANDS; x++ )
+	{
+		const float freq = x * m_sampleRate / ( MAX_BANDS * 2 );
+		if( freq >= minF && freq <= maxF )
+		{
+			const float h = 20 * ( log10( m_bands[x] / m_energy ) );
+			peak = h > peak ? h : peak;
+		}
+	}
+
+	return ( peak + 60 ) / 100;
 }
 
 
 
 
-bool EqAnalyser::getActive() const
+float EqAnalyser::copyBands( float * bands )
 {
-	return m_active;
+	QMutexLocker lock( &m_publishLock );
+	memcpy( bands, m_publishedBands, sizeof( m_publishedBands ) );
+	return m_publishedEnergy;
 }
 
 
 
 
-void EqAnalyser::setActive(bool active)
+int EqAnalyser::getSampleRate() const
 {
-	m_active = active;
+	return m_sampleRate;
 }
 
 
 
 
-bool EqAnalyser::getInProgress()
+void EqAnalyser::reset()
 {
-	return m_inProgress;
+	m_framesFilledUp = 0;
+	m_energy = 0;
+	memset( m_buffer, 0, sizeof( m_buffer ) );
+	memset( m_bands, 0, sizeof( m_bands ) );
 }
 
 
 
 
-void EqAnalyser::clear()
+void EqAnalyser::publish()
 {
-	m_framesFilledUp = 0;
-	m_energy = 0;
-	memset( m_buffer, 0, sizeof( m_buffer ) );
-	memset( m_bands, 0, sizeof( m_bands ) );
+	QMutexLocker lock( &m_publishLock );
+	memcpy( m_publishedBands, m_bands, sizeof( m_bands ) );
+	m_publishedEnergy = m_energy;
 }
 
 
@@ -207,7 +234,7 @@ EqSpectrumView::EqSpectrumView(EqAnalyser *b, QWidget *_parent) :
 
 void EqSpectrumView::paintEvent(QPaintEvent *event)
 {
-	const float energy =  m_analyser->getEnergy();
+	const float energy = m_analyser->copyBands( m_bands );
 	if( energy <= 0 && m_peakSum <= 0 )
 	{		
 		//dont draw anything
@@ -220,7 +247,7 @@ void EqSpectrumView::paintEvent(QPaintEvent *event)
 	painter.setPen( QPen( m_color, 1, Qt::SolidLine, Qt::RoundCap, Qt::BevelJoin ) );
 	painter.setRenderHint(QPainter::Antialiasing, true);
 
-	if( m_analyser->getInProgress() || m_periodicalUpdate == false )
+	if( m_periodicalUpdate == false )
 	{
 		//only paint the cached path
 		painter.fillPath( m_path, QBrush( m_color ) );
@@ -230,7 +257,7 @@ void EqSpectrumView::paintEvent(QPaintEvent *event)
 	m_periodicalUpdate = false;
 	//Now we calculate the path
 	m_path = QPainterPath();
-	float *bands = m_analyser->m_bands;
+	const float *bands = m_bands;
 	float peak;
 	m_path.moveTo( 0, height() );
 	m_peakSum = 0;
@@ -301,7 +328,10 @@ float EqSpectrumView::bandToFreq( int index )
 void EqSpectrumView::periodicalUpdate()
 {
 	m_periodicalUpdate = true;
-	m_analyser->setActive( isVisible() );
+	if( isVisible() )
+	{
+		m_analyser->tap()->requestAnalysis();
+	}
 	update();
 }
 
@@ -26,6 +26,12 @@
 #include <QPainterPath>
 #include <QWidget>
 
+#include <atomic>
+#include <functional>
+
+#include <QMutex>
+
+#include "AnalysisService.h"
 #include "fft_helpers.h"
 #include "lmms_basics.h"
 
@@ -34,35 +40,58 @@ namespace lmms
 
 
 const int MAX_BANDS = 2048;
-class EqAnalyser
+//! Runs on the analysis service threads, fed by the tap from the audio thread.
+//! The audio thread only writes to the tap, everything else is done here.
+class EqAnalyser : public AnalysisProcessor
 {
 public:
-	EqAnalyser();
-	virtual ~EqAnalyser();
+	//! Called by the service threads after each analysis, e.g. to measure
+	//! the peaks of the filter bands with peakBand()
+	using AnalysisCallback = std::function<void( const EqAnalyser & )>;
 
-	float m_bands[MAX_BANDS];
-	bool getInProgress();
-	void clear();
+	//! How long the tap has to stay silent before the spectrum is cleared, in ms
+	static constexpr int ClearDelay = 250;
+
+	EqAnalyser( AnalysisCallback callback = AnalysisCallback() );
+	~EqAnalyser() override;
+
+	void analyze( const sampleFrame *buf, const fpp_t frames ) override;
 
-	void analyze( sampleFrame *buf, const fpp_t frames );
+	//! Peak of the bands between @p minF and @p maxF, scaled for the faders.
+	//! Only to be called from the analysis callback.
+	float peakBand( float minF, float maxF ) const;
 
-	float getEnergy() const;
+	//! GUI thread: copy the latest bands to @p bands, returns their energy
+	float copyBands( float * bands );
 	int getSampleRate() const;
-	bool getActive() const;
 
-	void setActive(bool active);
+	AnalysisTap * tap()
+	{
+		return &m_tap;
+	}
 
 private:
+	void reset();
+	//! Hand the bands over to copyBands()
+	void publish();
+
+	AnalysisTap m_tap;
+	AnalysisCallback m_callback;
+	float m_bands[MAX_BANDS];
+	//! Time without input since the last analysis
+	int m_silentTime;
 	fftwf_plan m_fftPlan;
 	fftwf_complex * m_specBuf;
 	float m_absSpecBuf[FFT_BUFFER_SIZE+1];
 	float m_buffer[FFT_BUFFER_SIZE*2];
 	int m_framesFilledUp;
 	float m_energy;
-	int m_sampleRate;
-	bool m_active;
-	bool m_inProgress;
+	std::atomic<int> m_sampleRate;
 	float m_fftWindow[FFT_BUFFER_SIZE];
+
+	QMutex m_publishLock;
+	float m_publishedBands[MAX_BANDS];
+	float m_publishedEnergy;
 };
 
 
@@ -88,6 +117,8 @@ private slots:
 private:
 	QColor m_color;
 	EqAnalyser *m_analyser;
+	//! The bands painted, copied from the analyser
+	float m_bands[MAX_BANDS];
 	QPainterPath m_path;
 	float m_peakSum;
 	float m_pixelsPerUnitWidth;
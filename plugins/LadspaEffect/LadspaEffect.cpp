@@ -24,6 +24,8 @@
  */
 
 
+#include <algorithm>
+
 #include <QVarLengthArray>
 #include <QMessageBox>
 
@@ -37,6 +39,7 @@
 #include "LadspaSubPluginFeatures.h"
 #include "AutomationClip.h"
 #include "MemoryManager.h"
+#include "PlanarBuffer.h"
 #include "ValueBuffer.h"
 #include "Song.h"
 
@@ -74,7 +77,8 @@ LadspaEffect::LadspaEffect( Model * _parent,
 	Effect( &ladspaeffect_plugin_descriptor, _parent, _key ),
 	m_controls( nullptr ),
 	m_maxSampleRate( 0 ),
-	m_key( LadspaSubPluginFeatures::subPluginKeyToLadspaKey( _key ) )
+	m_key( LadspaSubPluginFeatures::subPluginKeyToLadspaKey( _key ) ),
+	m_latencyPort( nullptr )
 {
 	Ladspa2LMMS * manager = Engine::getLADSPAManager();
 	if( manager->getDescription( m_key ) == nullptr )
@@ -140,17 +144,18 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 		return( false );
 	}
 
+	// the ports may still point into the buffers of the effect chain
+	connectChannels( nullptr, nullptr );
+
 	int frames = _frames;
 	sampleFrame * o_buf = nullptr;
-	QVarLengthArray<sample_t> sBuf(_frames * DEFAULT_CHANNELS);
+	QVarLengthArray<sample_t> sBuf( maxResampledFrames() * DEFAULT_CHANNELS );
 
-	if( m_maxSampleRate < Engine::audioEngine()->processingSampleRate() )
+	if( isResampling() )
 	{
 		o_buf = _buf;
 		_buf = reinterpret_cast<sampleFrame*>(sBuf.data());
-		sampleDown( o_buf, _buf, m_maxSampleRate );
-		frames = _frames * m_maxSampleRate /
-				Engine::audioEngine()->processingSampleRate();
+		frames = sampleDown( o_buf, _buf );
 	}
 
 	// Copy the LMMS audio buffer to the LADSPA input buffer and initialize
@@ -173,37 +178,8 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 					++channel;
 					break;
 				case AUDIO_RATE_INPUT:
-				{
-					ValueBuffer * vb = pp->control->valueBuffer();
-					if( vb )
-					{
-						memcpy( pp->buffer, vb->values(), frames * sizeof(float) );
-					}
-					else
-					{
-						pp->value = static_cast<LADSPA_Data>(
-											pp->control->value() / pp->scale );
-						// This only supports control rate ports, so the audio rates are
-						// treated as though they were control rate by setting the
-						// port buffer to all the same value.
-						for( fpp_t frame = 0;
-							frame < frames; ++frame )
-						{
-							pp->buffer[frame] =
-								pp->value;
-						}
-					}
-					break;
-				}
 				case CONTROL_RATE_INPUT:
-					if( pp->control == nullptr )
-					{
-						break;
-					}
-					pp->value = static_cast<LADSPA_Data>(
-										pp->control->value() / pp->scale );
-					pp->buffer[0] =
-						pp->value;
+					updateInputPort( pp, frames );
 					break;
 				case CHANNEL_OUT:
 				case AUDIO_RATE_OUTPUT:
@@ -217,10 +193,7 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 
 
 	// Process the buffers.
-	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
-	{
-		(m_descriptor->run)( m_handles[proc], frames );
-	}
+	runProcessors( frames );
 
 	// Copy the LADSPA output buffers to the LMMS buffer.
 	double out_sum = 0.0;
@@ -258,7 +231,7 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 
 	if( o_buf != nullptr )
 	{
-		sampleBack( _buf, o_buf, m_maxSampleRate );
+		sampleBack( _buf, frames, o_buf );
 	}
 
 	checkGate( out_sum / frames );
@@ -272,6 +245,223 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 
 
 
+bool LadspaEffect::processPlanarBuffers( PlanarBuffer & _in, PlanarBuffer & _out,
+							const fpp_t _frames )
+{
+	// resampling for plugins with a limited sample rate works on
+	// sampleFrames, so leave that to the adapter
+	if( isResampling() )
+	{
+		return Effect::processPlanarBuffers( _in, _out, _frames );
+	}
+
+	m_pluginMutex.lock();
+	if( !isOkay() || dontRun() || !isRunning() || !isEnabled() )
+	{
+		m_pluginMutex.unlock();
+		_out.copyFrom( _in, _frames );
+		return( false );
+	}
+
+	const int frames = _frames;
+
+	// Each channel of the planar buffers is already laid out like a
+	// LADSPA port buffer, so the plugin reads and writes them directly.
+	const ch_cnt_t outputs = connectChannels( &_in, &_out );
+	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+	{
+		for( int port = 0; port < m_portCount; ++port )
+		{
+			port_desc_t * pp = m_ports.at( proc ).at( port );
+			switch( pp->rate )
+			{
+				case AUDIO_RATE_INPUT:
+				case CONTROL_RATE_INPUT:
+					updateInputPort( pp, frames );
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	runProcessors( frames );
+
+	double out_sum = 0.0;
+	const float d = dryLevel();
+	const float w = wetLevel();
+	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	{
+		const sample_t * in = _in.channel( ch );
+		sample_t * out = _out.channel( ch );
+		if( ch >= outputs )
+		{
+			// the plugin has no output for this channel
+			std::copy( in, in + frames, out );
+			continue;
+		}
+		for( fpp_t frame = 0; frame < frames; ++frame )
+		{
+			out[frame] = d * in[frame] + w * out[frame];
+			out_sum += out[frame] * out[frame];
+		}
+	}
+
+	checkGate( out_sum / frames );
+
+	bool is_running = isRunning();
+	m_pluginMutex.unlock();
+	return( is_running );
+}
+
+
+
+
+void LadspaEffect::updateInputPort( port_desc_t * pp, int frames )
+{
+	if( pp->rate == AUDIO_RATE_INPUT )
+	{
+		ValueBuffer * vb = pp->control->valueBuffer();
+		if( vb )
+		{
+			memcpy( pp->buffer, vb->values(), frames * sizeof(float) );
+		}
+		else
+		{
+			pp->value = static_cast<LADSPA_Data>(
+								pp->control->value() / pp->scale );
+			// This only supports control rate ports, so the audio rates are
+			// treated as though they were control rate by setting the
+			// port buffer to all the same value.
+			for( fpp_t frame = 0;
+				frame < frames; ++frame )
+			{
+				pp->buffer[frame] =
+					pp->value;
+			}
+		}
+	}
+	else if( pp->control != nullptr )
+	{
+		pp->value = static_cast<LADSPA_Data>(
+							pp->control->value() / pp->scale );
+		pp->buffer[0] =
+			pp->value;
+
+		// follow automation within the period, see runProcessors()
+		ValueBuffer * vb = m_splitter.isEnabled() && !isResampling() ?
+						pp->control->valueBuffer() : nullptr;
+		if( vb )
+		{
+			m_automatedPorts.push_back( { pp, vb->values() } );
+			m_splitter.addControl( vb->values(),
+				SubBlockSplitter::DefaultTolerance * ( pp->max - pp->min ) );
+		}
+	}
+}
+
+
+
+
+void LadspaEffect::runProcessors( int frames )
+{
+	const std::size_t blocks = m_automatedPorts.empty() ? 1 : m_splitter.split( frames );
+	if( blocks == 1 )
+	{
+		for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+		{
+			(m_descriptor->run)( m_handles[proc], frames );
+		}
+	}
+	else
+	{
+		// Control ports only take one value per run, so run the plugin in
+		// blocks with the audio ports pointing into the period.
+		for( std::size_t block = 0; block < blocks; ++block )
+		{
+			const fpp_t from = m_splitter.blockStart( block );
+			const fpp_t to = m_splitter.blockEnd( block );
+			for( const auto & automated : m_automatedPorts )
+			{
+				automated.port->buffer[0] = static_cast<LADSPA_Data>(
+					automated.values[from] / automated.port->scale );
+			}
+			connectAudioPorts( from );
+			for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+			{
+				(m_descriptor->run)( m_handles[proc], to - from );
+			}
+		}
+		connectAudioPorts( 0 );
+	}
+
+	m_splitter.clear();
+	m_automatedPorts.clear();
+}
+
+
+
+
+void LadspaEffect::connectAudioPorts( fpp_t offset )
+{
+	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+	{
+		for( port_desc_t * pp : m_ports.at( proc ) )
+		{
+			switch( pp->rate )
+			{
+				case CHANNEL_IN:
+				case CHANNEL_OUT:
+				case AUDIO_RATE_INPUT:
+				case AUDIO_RATE_OUTPUT:
+					(m_descriptor->connect_port)( m_handles[proc], pp->port_id,
+						m_portLocations[proc * m_portCount + pp->port_id] + offset );
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+
+
+
+ch_cnt_t LadspaEffect::connectChannels( PlanarBuffer * _in, PlanarBuffer * _out )
+{
+	ch_cnt_t inputs = 0;
+	ch_cnt_t outputs = 0;
+	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
+	{
+		for( int port = 0; port < m_portCount; ++port )
+		{
+			port_desc_t * pp = m_ports.at( proc ).at( port );
+			LADSPA_Data * location = pp->buffer;
+			if( pp->rate == CHANNEL_IN && _in && inputs < DEFAULT_CHANNELS )
+			{
+				location = _in->channel( inputs++ );
+			}
+			else if( pp->rate == CHANNEL_OUT && _out && outputs < DEFAULT_CHANNELS )
+			{
+				location = _out->channel( outputs++ );
+			}
+
+			// the buffers of an effect chain only change when it is
+			// rearranged, so this rarely calls into the plugin
+			LADSPA_Data * & connected = m_portLocations[proc * m_portCount + port];
+			if( connected != location )
+			{
+				(m_descriptor->connect_port)( m_handles[proc], port, location );
+				connected = location;
+			}
+		}
+	}
+	return outputs;
+}
+
+
+
+
 void LadspaEffect::setControl( int _control, LADSPA_Data _value )
 {
 	if( !isOkay() )
@@ -284,9 +474,23 @@ void LadspaEffect::setControl( int _control, LADSPA_Data _value )
 
 
 
+f_cnt_t LadspaEffect::latency() const
+{
+	// reported at the rate the plugin runs at
+	const sample_rate_t sr = Engine::audioEngine()->processingSampleRate();
+	const auto frames = m_latencyPort != nullptr ?
+		static_cast<f_cnt_t>( qMax( m_latencyPort->buffer[0], 0.0f ) ) : 0;
+	return isResampling() ?
+		frames * sr / m_maxSampleRate + resamplingLatency() : frames;
+}
+
+
+
+
 void LadspaEffect::pluginInstantiation()
 {
 	m_maxSampleRate = maxSamplerate( displayName() );
+	setResamplingRate( m_maxSampleRate );
 
 	Ladspa2LMMS * manager = Engine::getLADSPAManager();
 
@@ -367,6 +571,12 @@ void LadspaEffect::pluginInstantiation()
 				else
 				{
 					p->rate = CONTROL_RATE_OUTPUT;
+					p->buffer[0] = 0;
+					const QString name = p->name.toLower();
+					if( proc == 0 && ( name == "latency" || name == "_latency" ) )
+					{
+						m_latencyPort = p;
+					}
 				}
 			}
 
@@ -474,6 +684,8 @@ void LadspaEffect::pluginInstantiation()
 		}
 		m_ports.append( ports );
 	}
+	m_automatedPorts.reserve( m_portControls.count() );
+	m_splitter.reserve( m_portControls.count() );
 
 	// Instantiate the processing units.
 	m_descriptor = manager->getDescriptor( m_key );
@@ -508,6 +720,7 @@ void LadspaEffect::pluginInstantiation()
 	}
 
 	// Connect the ports.
+	m_portLocations.assign( processorCount() * m_portCount, nullptr );
 	for( ch_cnt_t proc = 0; proc < processorCount(); proc++ )
 	{
 		for( int port = 0; port < m_portCount; port++ )
@@ -524,6 +737,7 @@ void LadspaEffect::pluginInstantiation()
 				setDontRun( true );
 				return;
 			}
+			m_portLocations[proc * m_portCount + port] = pp->buffer;
 		}
 	}
 
@@ -566,6 +780,8 @@ void LadspaEffect::pluginDestruction()
 	m_ports.clear();
 	m_handles.clear();
 	m_portControls.clear();
+	m_portLocations.clear();
+	m_latencyPort = nullptr;
 }
 
 
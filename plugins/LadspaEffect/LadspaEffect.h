@@ -26,12 +26,15 @@
 #ifndef _LADSPA_EFFECT_H
 #define _LADSPA_EFFECT_H
 
+#include <vector>
+
 #include <QMutex>
 
 #include "Effect.h"
 #include "ladspa.h"
 #include "LadspaControls.h"
 #include "LadspaManager.h"
+#include "SubBlockSplitter.h"
 
 namespace lmms
 {
@@ -49,9 +52,19 @@ public:
 
 	bool processAudioBuffer( sampleFrame * _buf,
 							const fpp_t _frames ) override;
-	
+
+	bool hasPlanarProcessing() const override
+	{
+		return true;
+	}
+
+	bool processPlanarBuffers( PlanarBuffer & _in, PlanarBuffer & _out,
+							const fpp_t _frames ) override;
+
 	void setControl( int _control, LADSPA_Data _data );
 
+	f_cnt_t latency() const override;
+
 	EffectControls * controls() override
 	{
 		return m_controls;
@@ -71,6 +84,15 @@ private:
 	void pluginInstantiation();
 	void pluginDestruction();
 
+	void updateInputPort( port_desc_t * pp, int frames );
+	void runProcessors( int frames );
+	//! Point the audio ports @p offset frames into their buffers
+	void connectAudioPorts( fpp_t offset );
+	//! Connect the channel ports to the channels of @p _in and @p _out,
+	//! or to their own buffers where they are null. Returns the number of
+	//! channels of @p _out the plugin writes to.
+	ch_cnt_t connectChannels( PlanarBuffer * _in, PlanarBuffer * _out );
+
 	static sample_rate_t maxSamplerate( const QString & _name );
 
 
@@ -87,6 +109,20 @@ private:
 
 	QVector<multi_proc_t> m_ports;
 	multi_proc_t m_portControls;
+	// where each port of each processor is connected to, which for the
+	// channel ports is either their own buffer or that of an effect chain
+	std::vector<LADSPA_Data *> m_portLocations;
+	// "latency" output of the first processor, by convention of the hosts
+	port_desc_t * m_latencyPort;
+
+	// control ports which are automated within the current period
+	struct AutomatedPort
+	{
+		port_desc_t * port;
+		const float * values;
+	} ;
+	std::vector<AutomatedPort> m_automatedPorts;
+	SubBlockSplitter m_splitter;
 
 } ;
 
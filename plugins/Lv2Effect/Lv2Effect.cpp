@@ -72,6 +72,8 @@ bool Lv2Effect::processAudioBuffer(sampleFrame *buf, const fpp_t frames)
 	if (!isEnabled() || !isRunning()) { return false; }
 	Q_ASSERT(frames <= static_cast<fpp_t>(m_tmpOutputSmps.size()));
 
+	// the ports may still be connected to the buffers of an effect chain
+	m_controls.connectBuffersToLmms(nullptr, nullptr);
 	m_controls.copyBuffersFromLmms(buf, frames);
 	m_controls.copyModelsFromLmms();
 
@@ -102,6 +104,47 @@ bool Lv2Effect::processAudioBuffer(sampleFrame *buf, const fpp_t frames)
 
 
 
+bool Lv2Effect::processPlanarBuffers(PlanarBuffer& in, PlanarBuffer& out, const fpp_t frames)
+{
+	if (!isEnabled() || !isRunning())
+	{
+		out.copyFrom(in, frames);
+		return false;
+	}
+
+	// the plugin reads and writes the buffers of the effect chain, unless
+	// its channels don't match them
+	const bool direct = m_controls.connectBuffersToLmms(&in, &out);
+	if (!direct) { m_controls.copyBuffersFromLmms(in, frames); }
+	m_controls.copyModelsFromLmms();
+
+	m_controls.run(frames);
+
+	m_controls.copyModelsToLmms();
+	if (!direct) { m_controls.copyBuffersToLmms(out, frames); }
+
+	double outSum = .0;
+	bool corrupt = wetLevel() < 0; // #3261 - if w < 0, bash w := 0, d := 1
+	const float d = corrupt ? 1 : dryLevel();
+	const float w = corrupt ? 0 : wetLevel();
+	for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+	{
+		const sample_t* dry = in.channel(ch);
+		sample_t* wet = out.channel(ch);
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			wet[f] = d * dry[f] + w * wet[f];
+			outSum += static_cast<double>(wet[f]) * wet[f];
+		}
+	}
+	checkGate(outSum / frames);
+
+	return isRunning();
+}
+
+
+
+
 extern "C"
 {
 
@@ -27,6 +27,7 @@
 
 #include "Effect.h"
 #include "Lv2FxControls.h"
+#include "PlanarBuffer.h"
 
 namespace lmms
 {
@@ -45,7 +46,10 @@ public:
 	bool isValid() const { return m_controls.isValid(); }
 
 	bool processAudioBuffer( sampleFrame* buf, const fpp_t frames ) override;
+	bool hasPlanarProcessing() const override { return true; }
+	bool processPlanarBuffers(PlanarBuffer& in, PlanarBuffer& out, const fpp_t frames) override;
 	EffectControls* controls() override { return &m_controls; }
+	f_cnt_t latency() const override { return m_controls.latency(); }
 
 	Lv2FxControls* lv2Controls() { return &m_controls; }
 	const Lv2FxControls* lv2Controls() const { return &m_controls; }
@@ -78,6 +78,7 @@ public:
 	void playNote(NotePlayHandle *nph, sampleFrame *) override;
 #endif
 	void play(sampleFrame *buf) override;
+	f_cnt_t latency() const override { return Lv2ControlBase::latency(); }
 
 	/*
 		misc
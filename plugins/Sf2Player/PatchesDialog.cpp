@@ -74,6 +74,7 @@ PatchesDialog::PatchesDialog( QWidget *pParent, Qt::WindowFlags wflags )
 
 	m_pSynth = nullptr;
 	m_iChan  = 0;
+	m_iFontId = -1;
 	m_iBank  = 0;
 	m_iProg  = 0;
 
@@ -116,7 +117,8 @@ void PatchesDialog::setup ( fluid_synth_t * pSynth, int iChan,
 						const QString & _chanName,
 						LcdSpinBoxModel * _bankModel,
 						LcdSpinBoxModel * _progModel,
-							QLabel * _patchLabel )
+							QLabel * _patchLabel,
+							int iFontId )
 {
 
 	// We'll going to changes the whole thing...
@@ -138,6 +140,7 @@ void PatchesDialog::setup ( fluid_synth_t * pSynth, int iChan,
 	// now it should be safe to set internal stuff
 	m_pSynth = pSynth;
 	m_iChan  = iChan;
+	m_iFontId = iFontId;
 
 
 	QTreeWidgetItem *pBankItem = nullptr;
@@ -145,7 +148,7 @@ void PatchesDialog::setup ( fluid_synth_t * pSynth, int iChan,
 	int cSoundFonts = ::fluid_synth_sfcount(m_pSynth);
 	for (int i = 0; i < cSoundFonts; i++) {
 		fluid_sfont_t *pSoundFont = ::fluid_synth_get_sfont(m_pSynth, i);
-		if (pSoundFont) {
+		if (isShownFont(pSoundFont)) {
 #ifdef CONFIG_FLUID_BANK_OFFSET
 			int iBankOffset = ::fluid_synth_get_bank_offset(m_pSynth, fluid_sfont_get_id(pSoundFont));
 #endif
@@ -223,6 +226,12 @@ void PatchesDialog::setBankProg ( int iBank, int iProg )
 	if (m_pSynth == nullptr)
 		return;
 
+	if (m_iFontId >= 0) {
+		// the synth is shared with other channels, don't touch them
+		::fluid_synth_program_select(m_pSynth, m_iChan, m_iFontId, iBank, iProg);
+		return;
+	}
+
 	// just select the synth's program preset...
 	::fluid_synth_bank_select(m_pSynth, m_iChan, iBank);
 	::fluid_synth_program_change(m_pSynth, m_iChan, iProg);
@@ -231,6 +240,13 @@ void PatchesDialog::setBankProg ( int iBank, int iProg )
 }
 
 
+// Whether the dialog lists the presets of the given soundfont.
+bool PatchesDialog::isShownFont ( fluid_sfont_t * pSoundFont ) const
+{
+	return pSoundFont && (m_iFontId < 0 || fluid_sfont_get_id(pSoundFont) == m_iFontId);
+}
+
+
 // Validate form fields and accept it valid.
 void PatchesDialog::accept()
 {
@@ -319,7 +335,7 @@ void PatchesDialog::bankChanged ()
 	int cSoundFonts = ::fluid_synth_sfcount(m_pSynth);
 	for (int i = 0; i < cSoundFonts && !pProgItem; i++) {
 		fluid_sfont_t *pSoundFont = ::fluid_synth_get_sfont(m_pSynth, i);
-		if (pSoundFont) {
+		if (isShownFont(pSoundFont)) {
 #ifdef CONFIG_FLUID_BANK_OFFSET
 			int iBankOffset = ::fluid_synth_get_bank_offset(m_pSynth, fluid_sfont_get_id(pSoundFont));
 #endif
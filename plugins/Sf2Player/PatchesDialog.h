@@ -53,8 +53,10 @@ public:
 	~PatchesDialog() override = default;
 
 
+	// Restrict the dialog to the soundfont with the given id if iFontId >= 0
 	void setup(fluid_synth_t *pSynth, int iChan, const QString & _chanName,
-			LcdSpinBoxModel * _bankModel, LcdSpinBoxModel * _progModel, QLabel *_patchLabel );
+			LcdSpinBoxModel * _bankModel, LcdSpinBoxModel * _progModel, QLabel *_patchLabel,
+			int iFontId = -1 );
 
 public slots:
 
@@ -74,6 +76,8 @@ protected:
 	QTreeWidgetItem *findBankItem(int iBank);
 	QTreeWidgetItem *findProgItem(int iProg);
 
+	bool isShownFont(fluid_sfont_t *pSoundFont) const;
+
 	bool validateForm();
 
 private:
@@ -82,6 +86,7 @@ private:
 	fluid_synth_t *m_pSynth;
 
 	int m_iChan;
+	int m_iFontId;
 	int m_iBank;
 	int m_iProg;
 
@@ -25,6 +25,7 @@
 
 #include "Sf2Player.h"
 
+#include <algorithm>
 #include <fluidsynth.h>
 #include <QDebug>
 #include <QDomElement>
@@ -40,6 +41,7 @@
 #include "NotePlayHandle.h"
 #include "PathUtil.h"
 #include "PixmapButton.h"
+#include "Sf2SharedSynth.h"
 #include "Song.h"
 #include "fluidsynthshims.h"
 
@@ -94,6 +96,7 @@ QMutex Sf2Instrument::s_fontsMutex;
 Sf2Instrument::Sf2Instrument( InstrumentTrack * _instrument_track ) :
 	Instrument( _instrument_track, &sf2player_plugin_descriptor ),
 	m_srcState( nullptr ),
+	m_shared( nullptr ),
 	m_synth(nullptr),
 	m_font( nullptr ),
 	m_fontId( 0 ),
@@ -124,6 +127,14 @@ Sf2Instrument::Sf2Instrument( InstrumentTrack * _instrument_track ) :
 #endif
 	m_settings = new_fluid_settings();
 
+	// Play on the shared synth if enabled, we get a synth of our own if all of
+	// its channels are taken
+	if( Sf2SharedSynth::isEnabled() )
+	{
+		m_shared = Sf2SharedSynth::attach( this );
+	}
+	m_noteEvents.reserve( 64 );
+
 	//fluid_settings_setint( m_settings, (char *) "audio.period-size", engine::audioEngine()->framesPerPeriod() );
 
 	// This sets up m_synth and updates reverb/chorus/gain
@@ -203,7 +214,14 @@ Sf2Instrument::~Sf2Instrument()
 				PlayHandle::TypeNotePlayHandle
 				| PlayHandle::TypeInstrumentPlayHandle );
 	freeFont();
-	delete_fluid_synth( m_synth );
+	if( m_shared != nullptr )
+	{
+		Sf2SharedSynth::detach( this );
+	}
+	else
+	{
+		delete_fluid_synth( m_synth );
+	}
 	delete_fluid_settings( m_settings );
 	if( m_srcState != nullptr )
 	{
@@ -277,7 +295,8 @@ void Sf2Instrument::loadFile( const QString & _file )
 		int iProg = 0;
 		fluid_sfont_t *pSoundFont = ::fluid_synth_get_sfont( m_synth, i );
 
-		if ( pSoundFont ) {
+		// the shared synth holds the soundfonts of other instruments as well
+		if ( pSoundFont && ( m_shared == nullptr || fluid_sfont_get_id( pSoundFont ) == m_fontId ) ) {
 #ifdef CONFIG_FLUID_BANK_OFFSET
 			int iBankOff = ::fluid_synth_get_bank_offset( m_synth, fluid_sfont_get_id( pSoundFont ) );
 #endif
@@ -298,8 +317,8 @@ void Sf2Instrument::loadFile( const QString & _file )
 				iBank += iBankOff;
 #endif
 
-				::fluid_synth_bank_select( m_synth, 1, iBank );
-				::fluid_synth_program_change( m_synth, 1, iProg );
+				::fluid_synth_bank_select( m_synth, m_channel, iBank );
+				::fluid_synth_program_change( m_synth, m_channel, iProg );
 				m_bankNum.setValue( iBank );
 				m_patchNum.setValue ( iProg );
 				break;
@@ -335,92 +354,119 @@ QString Sf2Instrument::nodeName() const
 
 
 
-void Sf2Instrument::freeFont()
+Sf2Font * Sf2Instrument::acquireFont( fluid_synth_t* synth, const QString& sf2File,
+				const QString& relativePath, int& fontId, bool resetPresets )
 {
-	m_synthMutex.lock();
+	QMutexLocker lock( &s_fontsMutex );
 
-	if ( m_font != nullptr )
+	// Increment Reference
+	if( s_fonts.contains( relativePath ) )
 	{
-		s_fontsMutex.lock();
-		--(m_font->refCount);
+		qDebug() << "Using existing reference to " << relativePath;
 
-		// No more references
-		if( m_font->refCount <= 0 )
-		{
-			qDebug() << "Really deleting " << m_filename;
+		Sf2Font * font = s_fonts[ relativePath ];
 
-			fluid_synth_sfunload( m_synth, m_fontId, true );
-			s_fonts.remove( m_filename );
-			delete m_font;
-		}
-		// Just remove our reference
-		else
-		{
-			qDebug() << "un-referencing " << m_filename;
+		font->refCount++;
 
-			fluid_synth_remove_sfont( m_synth, m_font->fluidFont );
-		}
-		s_fontsMutex.unlock();
+		fontId = fluid_synth_add_sfont( synth, font->fluidFont );
+		return font;
+	}
+
+	// Add to map, if doesn't exist.
+	const QByteArray sf2Ascii = PathUtil::toAbsolute( sf2File ).toLocal8Bit();
+	if( fluid_is_soundfont( sf2Ascii.constData() ) )
+	{
+		fontId = fluid_synth_sfload( synth, sf2Ascii.constData(), resetPresets );
 
-		m_font = nullptr;
+		if( fluid_synth_sfcount( synth ) > 0 )
+		{
+			// Grab this sf from the top of the stack and add to list
+			auto font = new Sf2Font( fluid_synth_get_sfont( synth, 0 ) );
+			s_fonts.insert( relativePath, font );
+			return font;
+		}
 	}
-	m_synthMutex.unlock();
+
+	return nullptr;
 }
 
 
 
-void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
+void Sf2Instrument::releaseFont( fluid_synth_t* synth, Sf2Font* font, int fontId,
+				const QString& relativePath, bool resetPresets )
 {
-	emit fileLoading();
+	QMutexLocker lock( &s_fontsMutex );
 
-	// Used for loading file
-	char * sf2Ascii = qstrdup( qPrintable( PathUtil::toAbsolute( _sf2File ) ) );
-	QString relativePath = PathUtil::toShortestRelative( _sf2File );
+	--(font->refCount);
 
-	// free reference to soundfont if one is selected
-	freeFont();
-
-	m_synthMutex.lock();
-	s_fontsMutex.lock();
+	// No more references
+	if( font->refCount <= 0 )
+	{
+		qDebug() << "Really deleting " << relativePath;
 
-	// Increment Reference
-	if( s_fonts.contains( relativePath ) )
+		fluid_synth_sfunload( synth, fontId, resetPresets );
+		s_fonts.remove( relativePath );
+		delete font;
+	}
+	// Just remove our reference
+	else
 	{
-		qDebug() << "Using existing reference to " << relativePath;
+		qDebug() << "un-referencing " << relativePath;
+
+		fluid_synth_remove_sfont( synth, font->fluidFont );
+	}
+}
 
-		m_font = s_fonts[ relativePath ];
 
-		m_font->refCount++;
 
-		m_fontId = fluid_synth_add_sfont( m_synth, m_font->fluidFont );
+void Sf2Instrument::freeFont()
+{
+	if ( m_font == nullptr )
+	{
+		return;
 	}
 
-	// Add to map, if doesn't exist.
+	if( m_shared != nullptr )
+	{
+		m_shared->removeFont( m_filename );
+	}
 	else
 	{
-		bool loaded = false;
-		if( fluid_is_soundfont( sf2Ascii ) )
-		{
-			m_fontId = fluid_synth_sfload( m_synth, sf2Ascii, true );
+		m_synthMutex.lock();
+		releaseFont( m_synth, m_font, m_fontId, m_filename, true );
+		m_synthMutex.unlock();
+	}
 
-			if( fluid_synth_sfcount( m_synth ) > 0 )
-			{
-				// Grab this sf from the top of the stack and add to list
-				m_font = new Sf2Font( fluid_synth_get_sfont( m_synth, 0 ) );
-				s_fonts.insert( relativePath, m_font );
-				loaded = true;
-			}
-		}
+	m_font = nullptr;
+}
 
-		if(!loaded)
-		{
-			collectErrorForUI( Sf2Instrument::tr( "A soundfont %1 could not be loaded." ).
-				arg( QFileInfo( _sf2File ).baseName() ) );
-		}
+
+
+void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
+{
+	emit fileLoading();
+
+	QString relativePath = PathUtil::toShortestRelative( _sf2File );
+
+	// free reference to soundfont if one is selected
+	freeFont();
+
+	if( m_shared != nullptr )
+	{
+		m_font = m_shared->addFont( _sf2File, relativePath, m_fontId );
+	}
+	else
+	{
+		m_synthMutex.lock();
+		m_font = acquireFont( m_synth, _sf2File, relativePath, m_fontId, true );
+		m_synthMutex.unlock();
 	}
 
-	s_fontsMutex.unlock();
-	m_synthMutex.unlock();
+	if( m_font == nullptr )
+	{
+		collectErrorForUI( Sf2Instrument::tr( "A soundfont %1 could not be loaded." ).
+			arg( QFileInfo( _sf2File ).baseName() ) );
+	}
 
 	if( m_fontId >= 0 )
 	{
@@ -433,8 +479,6 @@ void Sf2Instrument::openFile( const QString & _sf2File, bool updateTrackName )
 		emit fileChanged();
 	}
 
-	delete[] sf2Ascii;
-
 	if( updateTrackName || instrumentTrack()->displayName() == displayName() )
 	{
 		instrumentTrack()->setName( PathUtil::cleanName( _sf2File ) );
@@ -468,7 +512,7 @@ QString Sf2Instrument::getCurrentPatchName()
 	for( int i = 0; i < cSoundFonts; i++ )
 	{
 		fluid_sfont_t *pSoundFont = fluid_synth_get_sfont( m_synth, i );
-		if ( pSoundFont )
+		if ( pSoundFont && ( m_shared == nullptr || fluid_sfont_get_id( pSoundFont ) == m_fontId ) )
 		{
 #ifdef CONFIG_FLUID_BANK_OFFSET
 			int iBankOffset =
@@ -505,7 +549,12 @@ QString Sf2Instrument::getCurrentPatchName()
 
 void Sf2Instrument::updateGain()
 {
-	fluid_synth_set_gain( m_synth, m_gain.value() );
+	// the gain of the shared synth applies to all channels, play() scales
+	// our channel instead
+	if( m_shared == nullptr )
+	{
+		fluid_synth_set_gain( m_synth, m_gain.value() );
+	}
 }
 
 
@@ -513,6 +562,12 @@ void Sf2Instrument::updateGain()
 
 void Sf2Instrument::updateReverbOn()
 {
+	if( m_shared != nullptr )
+	{
+		// the shared reverb is always on, just control our send to it
+		fluid_synth_cc( m_synth, m_channel, 91, m_reverbOn.value() ? 127 : 0 );
+		return;
+	}
 	fluid_synth_set_reverb_on( m_synth, m_reverbOn.value() ? 1 : 0 );
 }
 
@@ -531,6 +586,11 @@ void Sf2Instrument::updateReverb()
 
 void  Sf2Instrument::updateChorusOn()
 {
+	if( m_shared != nullptr )
+	{
+		fluid_synth_cc( m_synth, m_channel, 93, m_chorusOn.value() ? 127 : 0 );
+		return;
+	}
 	fluid_synth_set_chorus_on( m_synth, m_chorusOn.value() ? 1 : 0 );
 }
 
@@ -548,6 +608,11 @@ void  Sf2Instrument::updateChorus()
 
 void Sf2Instrument::updateTuning()
 {
+	// on the shared synth every channel needs a tuning program of its own
+	const int tuningProgram = m_shared != nullptr ? m_channel : 0;
+	const int firstChannel = m_shared != nullptr ? m_channel : 0;
+	const int lastChannel = m_shared != nullptr ? m_channel : 15;
+
 	if (instrumentTrack()->microtuner()->enabledModel()->value())
 	{
 		auto centArray = std::array<double, 128>{};
@@ -560,18 +625,18 @@ void Sf2Instrument::updateTuning()
 			centArray[i] = noteHz == 0. ? 0. : 1200. * log2(noteHz / lowestHz);
 		}
 
-		fluid_synth_activate_key_tuning(m_synth, 0, 0, "", centArray.data(), true);
-		for (int chan = 0; chan < 16; chan++)
+		fluid_synth_activate_key_tuning(m_synth, 0, tuningProgram, "", centArray.data(), true);
+		for (int chan = firstChannel; chan <= lastChannel; chan++)
 		{
-		    fluid_synth_activate_tuning(m_synth, chan, 0, 0, true);
+		    fluid_synth_activate_tuning(m_synth, chan, 0, tuningProgram, true);
 		}
 	}
 	else
 	{
-		fluid_synth_activate_key_tuning(m_synth, 0, 0, "", nullptr, true);
-		for (int chan = 0; chan < 16; chan++)
+		fluid_synth_activate_key_tuning(m_synth, 0, tuningProgram, "", nullptr, true);
+		for (int chan = firstChannel; chan <= lastChannel; chan++)
 		{
-		    fluid_synth_activate_tuning(m_synth, chan, 0, 0, true);
+		    fluid_synth_activate_tuning(m_synth, chan, 0, tuningProgram, true);
 		}
 	}
 }
@@ -579,6 +644,69 @@ void Sf2Instrument::updateTuning()
 
 
 void Sf2Instrument::reloadSynth()
+{
+	QString reopenFile;
+	if( m_shared != nullptr && !m_shared->reload() )
+	{
+		// The shared synth can't run at this sample rate, we have to
+		// play on a synth of our own from now on
+		reopenFile = m_filename;
+		freeFont();
+		Sf2SharedSynth::detach( this );
+		m_shared = nullptr;
+		m_synth = nullptr;
+		m_channel = 1;
+	}
+
+	if( m_shared != nullptr )
+	{
+		m_synth = m_shared->synth();
+		m_channel = m_shared->channel( this );
+		if( m_font )
+		{
+			// The font id changes if the shared synth has been recreated
+			m_fontId = m_shared->fontId( m_filename );
+			updatePatch();
+		}
+	}
+	else
+	{
+		reloadOwnSynth();
+	}
+
+	synthMutex().lock();
+	if( Engine::audioEngine()->currentQualitySettings().interpolation >=
+			AudioEngine::qualitySettings::Interpolation_SincFastest )
+	{
+		fluid_synth_set_interp_method( m_synth, m_shared != nullptr ? m_channel : -1, FLUID_INTERP_7THORDER );
+	}
+	else
+	{
+		fluid_synth_set_interp_method( m_synth, m_shared != nullptr ? m_channel : -1, FLUID_INTERP_DEFAULT );
+	}
+	synthMutex().unlock();
+	updateReverb();
+	updateChorus();
+	updateReverbOn();
+	updateChorusOn();
+	updateGain();
+	updateTuning();
+
+	// Reset last MIDI pitch properties, which will be set to the correct values
+	// upon playing the next note
+	m_lastMidiPitch = -1;
+	m_lastMidiPitchRange = -1;
+
+	if( !reopenFile.isEmpty() )
+	{
+		openFile( reopenFile, false );
+	}
+}
+
+
+
+
+void Sf2Instrument::reloadOwnSynth()
 {
 	double tempRate;
 
@@ -614,17 +742,6 @@ void Sf2Instrument::reloadSynth()
 		m_synthMutex.unlock();
 	}
 
-	m_synthMutex.lock();
-	if( Engine::audioEngine()->currentQualitySettings().interpolation >=
-			AudioEngine::qualitySettings::Interpolation_SincFastest )
-	{
-		fluid_synth_set_interp_method( m_synth, -1, FLUID_INTERP_7THORDER );
-	}
-	else
-	{
-		fluid_synth_set_interp_method( m_synth, -1, FLUID_INTERP_DEFAULT );
-	}
-	m_synthMutex.unlock();
 	if( m_internalSampleRate < Engine::audioEngine()->processingSampleRate() )
 	{
 		m_synthMutex.lock();
@@ -640,17 +757,6 @@ void Sf2Instrument::reloadSynth()
 		}
 		m_synthMutex.unlock();
 	}
-	updateReverb();
-	updateChorus();
-	updateReverbOn();
-	updateChorusOn();
-	updateGain();
-	updateTuning();
-
-	// Reset last MIDI pitch properties, which will be set to the correct values
-	// upon playing the next note
-	m_lastMidiPitch = -1;
-	m_lastMidiPitchRange = -1;
 }
 
 
@@ -710,7 +816,7 @@ void Sf2Instrument::playNote( NotePlayHandle * _n, sampleFrame * )
 
 void Sf2Instrument::noteOn( Sf2PluginData * n )
 {
-	m_synthMutex.lock();
+	synthMutex().lock();
 
 	// get list of current voice IDs so we can easily spot the new
 	// voice after the fluid_synth_noteon() call
@@ -746,7 +852,7 @@ void Sf2Instrument::noteOn( Sf2PluginData * n )
 		}
 	}
 
-	m_synthMutex.unlock();
+	synthMutex().unlock();
 
 	m_notesRunningMutex.lock();
 	++m_notesRunning[ n->midiNote ];
@@ -763,35 +869,103 @@ void Sf2Instrument::noteOff( Sf2PluginData * n )
 
 	if( notes <= 0 )
 	{
-		m_synthMutex.lock();
+		synthMutex().lock();
 		fluid_synth_noteoff( m_synth, m_channel, n->midiNote );
-		m_synthMutex.unlock();
+		synthMutex().unlock();
 	}
 }
 
 
-void Sf2Instrument::play( sampleFrame * _working_buffer )
+
+
+QMutex & Sf2Instrument::synthMutex()
 {
-	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
+	return m_shared != nullptr ? m_shared->synthMutex() : m_synthMutex;
+}
+
 
+
+
+void Sf2Instrument::updatePitch()
+{
 	// set midi pitch for this period
 	const int currentMidiPitch = instrumentTrack()->midiPitch();
 	if( m_lastMidiPitch != currentMidiPitch )
 	{
 		m_lastMidiPitch = currentMidiPitch;
-		m_synthMutex.lock();
+		synthMutex().lock();
 		fluid_synth_pitch_bend( m_synth, m_channel, m_lastMidiPitch );
-		m_synthMutex.unlock();
+		synthMutex().unlock();
 	}
 
 	const int currentMidiPitchRange = instrumentTrack()->midiPitchRange();
 	if( m_lastMidiPitchRange != currentMidiPitchRange )
 	{
 		m_lastMidiPitchRange = currentMidiPitchRange;
-		m_synthMutex.lock();
+		synthMutex().lock();
 		fluid_synth_pitch_wheel_sens( m_synth, m_channel, m_lastMidiPitchRange );
-		m_synthMutex.unlock();
+		synthMutex().unlock();
 	}
+}
+
+
+
+
+void Sf2Instrument::collectNoteEvents( std::vector<Sf2NoteEvent>& events )
+{
+	QMutexLocker lock( &m_playingNotesMutex );
+	for( NotePlayHandle * n : m_playingNotes )
+	{
+		auto data = static_cast<Sf2PluginData*>( n->m_pluginData );
+		if( data->isNew )
+		{
+			events.push_back( { data->offset, this, data, true } );
+			// if the note is released during the same period, we have to send the noteoff as well
+			if( n->isReleased() )
+			{
+				events.push_back( { n->framesBeforeRelease(), this, data, false } );
+			}
+			data->isNew = false;
+		}
+		else
+		{
+			events.push_back( { data->offset, this, data, false } );
+		}
+	}
+	m_playingNotes.clear();
+}
+
+
+
+
+void Sf2Instrument::dispatchNoteEvent( const Sf2NoteEvent& event )
+{
+	if( event.noteOn )
+	{
+		noteOn( event.note );
+	}
+	else
+	{
+		noteOff( event.note );
+	}
+}
+
+
+void Sf2Instrument::play( sampleFrame * _working_buffer )
+{
+	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
+
+	if( m_shared != nullptr )
+	{
+		// whichever instrument comes first renders the period for all
+		m_shared->render();
+		m_shared->readChannel( m_channel, _working_buffer, frames, m_gain.value() );
+		instrumentTrack()->processAudioBuffer( _working_buffer, frames, nullptr );
+		return;
+	}
+
+	updatePitch();
+
 	// if we have no new noteons/noteoffs, just render a period and call it a day
 	if( m_playingNotes.isEmpty() )
 	{
@@ -801,53 +975,21 @@ void Sf2Instrument::play( sampleFrame * _working_buffer )
 	}
 
 	// processing loop
-	// go through noteplayhandles in processing order
-	f_cnt_t currentFrame = 0;
+	// go through the note events in processing order
+	m_noteEvents.clear();
+	collectNoteEvents( m_noteEvents );
+	std::stable_sort( m_noteEvents.begin(), m_noteEvents.end() );
 
-	while( ! m_playingNotes.isEmpty() )
+	f_cnt_t currentFrame = 0;
+	for( const Sf2NoteEvent& event : m_noteEvents )
 	{
-		// find the note with lowest offset
-		NotePlayHandle * currentNote = m_playingNotes[0];
-		for( int i = 1; i < m_playingNotes.size(); ++i )
-		{
-			auto currentData = static_cast<Sf2PluginData*>(currentNote->m_pluginData);
-			auto iData = static_cast<Sf2PluginData*>(m_playingNotes[i]->m_pluginData);
-			if( currentData->offset > iData->offset )
-			{
-				currentNote = m_playingNotes[i];
-			}
-		}
-
-		// process the current note:
 		// first see if we're synced in frame count
-		auto currentData = static_cast<Sf2PluginData*>(currentNote->m_pluginData);
-		if( currentData->offset > currentFrame )
-		{
-			renderFrames( currentData->offset - currentFrame, _working_buffer + currentFrame );
-			currentFrame = currentData->offset;
-		}
-		if( currentData->isNew )
-		{
-			noteOn( currentData );
-			if( currentNote->isReleased() ) // if the note is released during the same period, we have to process it again for noteoff
-			{
-				currentData->isNew = false;
-				currentData->offset = currentNote->framesBeforeRelease();
-			}
-			else // otherwise remove the handle
-			{
-				m_playingNotesMutex.lock();
-				m_playingNotes.remove( m_playingNotes.indexOf( currentNote ) );
-				m_playingNotesMutex.unlock();
-			}
-		}
-		else
+		if( event.offset > currentFrame )
 		{
-			noteOff( currentData );
-			m_playingNotesMutex.lock();
-			m_playingNotes.remove( m_playingNotes.indexOf( currentNote ) );
-			m_playingNotesMutex.unlock();
+			renderFrames( event.offset - currentFrame, _working_buffer + currentFrame );
+			currentFrame = event.offset;
 		}
+		dispatchNoteEvent( event );
 	}
 
 	if( currentFrame < frames )
@@ -1217,7 +1359,8 @@ void Sf2InstrumentView::showPatchDialog()
 
 	PatchesDialog pd( this );
 
-	pd.setup( k->m_synth, 1, k->instrumentTrack()->name(), &k->m_bankNum, &k->m_patchNum, m_patchLabel );
+	pd.setup( k->m_synth, k->m_channel, k->instrumentTrack()->name(), &k->m_bankNum, &k->m_patchNum, m_patchLabel,
+			k->m_shared != nullptr ? k->m_fontId : -1 );
 
 	pd.exec();
 }
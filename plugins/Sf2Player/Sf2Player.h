@@ -30,6 +30,7 @@
 #include <fluidsynth/types.h>
 #include <QMutex>
 #include <samplerate.h>
+#include <vector>
 
 #include "Instrument.h"
 #include "InstrumentView.h"
@@ -44,6 +45,7 @@ namespace lmms
 
 class Sf2Font;
 struct Sf2PluginData;
+class Sf2SharedSynth;
 class NotePlayHandle;
 
 namespace gui
@@ -55,6 +57,21 @@ class PatchesDialog;
 } // namespace gui
 
 
+// A noteon or noteoff to be sent to the synth at the given frame offset
+struct Sf2NoteEvent
+{
+	f_cnt_t offset;
+	Sf2Instrument* instrument;
+	Sf2PluginData* note;
+	bool noteOn;
+
+	bool operator<( const Sf2NoteEvent& other ) const
+	{
+		return offset < other.offset;
+	}
+} ;
+
+
 class Sf2Instrument : public Instrument
 {
 	Q_OBJECT
@@ -120,6 +137,9 @@ private:
 
 	SRC_STATE * m_srcState;
 
+	// The shared synth this instrument plays on, nullptr if it uses its own
+	Sf2SharedSynth* m_shared;
+
 	fluid_settings_t* m_settings;
 	fluid_synth_t* m_synth;
 
@@ -161,13 +181,26 @@ private:
 	QVector<NotePlayHandle *> m_playingNotes;
 	QMutex m_playingNotesMutex;
 
+	std::vector<Sf2NoteEvent> m_noteEvents;
+
 private:
+	static Sf2Font* acquireFont( fluid_synth_t* synth, const QString& sf2File,
+				const QString& relativePath, int& fontId, bool resetPresets );
+	static void releaseFont( fluid_synth_t* synth, Sf2Font* font, int fontId,
+				const QString& relativePath, bool resetPresets );
+
+	QMutex& synthMutex();
+	void reloadOwnSynth();
 	void freeFont();
 	void noteOn( Sf2PluginData * n );
 	void noteOff( Sf2PluginData * n );
+	void updatePitch();
+	void collectNoteEvents( std::vector<Sf2NoteEvent>& events );
+	void dispatchNoteEvent( const Sf2NoteEvent& event );
 	void renderFrames( f_cnt_t frames, sampleFrame * buf );
 
 	friend class gui::Sf2InstrumentView;
+	friend class Sf2SharedSynth;
 
 signals:
 	void fileLoading();
@@ -0,0 +1,412 @@
+/*
+ * Sf2SharedSynth.cpp - multi-timbral FluidSynth instance shared by Sf2Player
+ *                      instruments
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "Sf2SharedSynth.h"
+
+#include <algorithm>
+#include <fluidsynth.h>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "ConfigManager.h"
+#include "Engine.h"
+#include "InstrumentTrack.h"
+#include "Mixer.h"
+#include "NotePlayHandle.h"
+#include "Sf2Player.h"
+
+namespace lmms
+{
+
+
+Sf2SharedSynth* Sf2SharedSynth::s_instance = nullptr;
+QMutex Sf2SharedSynth::s_instanceMutex;
+
+
+
+bool Sf2SharedSynth::isEnabled()
+{
+#ifdef LMMS_HAVE_SF2_SHARED_SYNTH
+	return ConfigManager::inst()->value("sf2player", "sharedsynth", "0").toInt();
+#else
+	return false;
+#endif
+}
+
+
+
+
+Sf2SharedSynth* Sf2SharedSynth::attach(Sf2Instrument* instrument)
+{
+#ifdef LMMS_HAVE_SF2_SHARED_SYNTH
+	QMutexLocker lock(&s_instanceMutex);
+
+	if (s_instance == nullptr)
+	{
+		s_instance = new Sf2SharedSynth;
+	}
+
+	Sf2SharedSynth* shared = s_instance;
+	auto freeChannel = std::find(shared->m_channels.begin(), shared->m_channels.end(), nullptr);
+	if (freeChannel == shared->m_channels.end() || !shared->reload())
+	{
+		if (shared->m_attached == 0)
+		{
+			delete shared;
+			s_instance = nullptr;
+		}
+		return nullptr;
+	}
+
+	QMutexLocker renderLock(&shared->m_renderMutex);
+	*freeChannel = instrument;
+	++shared->m_attached;
+
+	return shared;
+#else
+	return nullptr;
+#endif
+}
+
+
+
+
+void Sf2SharedSynth::detach(Sf2Instrument* instrument)
+{
+	QMutexLocker lock(&s_instanceMutex);
+
+	Sf2SharedSynth* shared = s_instance;
+	if (shared == nullptr) { return; }
+
+	const int chan = shared->channel(instrument);
+	if (chan < 0) { return; }
+
+	{
+		QMutexLocker renderLock(&shared->m_renderMutex);
+		shared->m_channels[chan] = nullptr;
+		--shared->m_attached;
+	}
+
+	// the next instrument on this channel must not inherit anything
+	fluid_synth_all_sounds_off(shared->m_synth, chan);
+	fluid_synth_unset_program(shared->m_synth, chan);
+
+	if (shared->m_attached == 0)
+	{
+		delete shared;
+		s_instance = nullptr;
+	}
+}
+
+
+
+
+Sf2SharedSynth::Sf2SharedSynth() :
+	m_settings(new_fluid_settings()),
+	m_synth(nullptr),
+	m_sampleRate(0),
+	m_renderedPeriod(-1),
+	m_attached(0),
+	m_frames(Engine::audioEngine()->framesPerPeriod()),
+	m_dryBuffer(2 * MaxChannels * m_frames),
+	m_effectsBuffer(2 * m_frames),
+	m_effectsReturn(m_frames)
+{
+	m_channels.fill(nullptr);
+	m_events.reserve(256);
+
+	// one MIDI channel and one stereo audio group per instrument, but only
+	// a single set of effects
+	fluid_settings_setint(m_settings, "synth.midi-channels", MaxChannels);
+	fluid_settings_setint(m_settings, "synth.audio-channels", MaxChannels);
+	fluid_settings_setint(m_settings, "synth.audio-groups", MaxChannels);
+	fluid_settings_setint(m_settings, "synth.effects-groups", 1);
+	fluid_settings_setint(m_settings, "synth.polyphony", 1024);
+	fluid_settings_setint(m_settings, "synth.cpu-cores", qBound(1, QThread::idealThreadCount() / 2, 8));
+	// the instruments apply their gain when fetching their channel
+	fluid_settings_setnum(m_settings, "synth.gain", 1.0);
+
+	createSynth();
+}
+
+
+
+
+Sf2SharedSynth::~Sf2SharedSynth()
+{
+	for (auto it = m_fonts.begin(); it != m_fonts.end(); ++it)
+	{
+		fluid_synth_remove_sfont(m_synth, it->font->fluidFont);
+	}
+	delete_fluid_synth(m_synth);
+	delete_fluid_settings(m_settings);
+}
+
+
+
+
+int Sf2SharedSynth::channel(const Sf2Instrument* instrument) const
+{
+	auto it = std::find(m_channels.begin(), m_channels.end(), instrument);
+	return it != m_channels.end() ? static_cast<int>(it - m_channels.begin()) : -1;
+}
+
+
+
+
+void Sf2SharedSynth::createSynth()
+{
+	double rate;
+	fluid_settings_setnum(m_settings, "synth.sample-rate", Engine::audioEngine()->processingSampleRate());
+	fluid_settings_getnum(m_settings, "synth.sample-rate", &rate);
+	m_sampleRate = static_cast<sample_rate_t>(rate);
+
+	m_synth = new_fluid_synth(m_settings);
+}
+
+
+
+
+bool Sf2SharedSynth::reload()
+{
+	QMutexLocker lock(&m_synthMutex);
+
+	const sample_rate_t rate = Engine::audioEngine()->processingSampleRate();
+	if (m_sampleRate != rate)
+	{
+		// keep the soundfonts, programs are reselected by the instruments
+		for (auto it = m_fonts.begin(); it != m_fonts.end(); ++it)
+		{
+			fluid_synth_remove_sfont(m_synth, it->font->fluidFont);
+		}
+		delete_fluid_synth(m_synth);
+
+		createSynth();
+
+		for (auto it = m_fonts.begin(); it != m_fonts.end(); ++it)
+		{
+			it->id = fluid_synth_add_sfont(m_synth, it->font->fluidFont);
+		}
+	}
+
+	// we have no resampler per audio group
+	return m_sampleRate == rate;
+}
+
+
+
+
+Sf2Font* Sf2SharedSynth::addFont(const QString& sf2File, const QString& relativePath, int& fontId)
+{
+	Sf2Font* font = nullptr;
+	{
+		QMutexLocker lock(&m_synthMutex);
+
+		auto it = m_fonts.find(relativePath);
+		if (it != m_fonts.end())
+		{
+			++it->users;
+			fontId = it->id;
+			return it->font;
+		}
+
+		// don't reset the presets, that would throw away the programs of
+		// all other channels
+		font = Sf2Instrument::acquireFont(m_synth, sf2File, relativePath, fontId, false);
+		if (font == nullptr) { return nullptr; }
+
+		m_fonts.insert(relativePath, LoadedFont{font, fontId, 1});
+	}
+	restorePrograms();
+
+	return font;
+}
+
+
+
+
+void Sf2SharedSynth::removeFont(const QString& relativePath)
+{
+	{
+		QMutexLocker lock(&m_synthMutex);
+
+		auto it = m_fonts.find(relativePath);
+		if (it == m_fonts.end() || --it->users > 0) { return; }
+
+		Sf2Instrument::releaseFont(m_synth, it->font, it->id, relativePath, false);
+		m_fonts.erase(it);
+	}
+	restorePrograms();
+}
+
+
+
+
+int Sf2SharedSynth::fontId(const QString& relativePath) const
+{
+	auto it = m_fonts.find(relativePath);
+	return it != m_fonts.end() ? it->id : -1;
+}
+
+
+
+
+void Sf2SharedSynth::restorePrograms()
+{
+	// FluidSynth reselects the programs of all channels by bank and program
+	// number whenever the soundfont stack changes, which may pick a preset
+	// from the wrong soundfont
+	for (Sf2Instrument* instrument : m_channels)
+	{
+		if (instrument != nullptr)
+		{
+			instrument->updatePatch();
+		}
+	}
+}
+
+
+
+
+void Sf2SharedSynth::render()
+{
+	QMutexLocker lock(&m_renderMutex);
+
+	const long period = AutomatableModel::periodCounter();
+	if (period == m_renderedPeriod) { return; }
+	m_renderedPeriod = period;
+
+	// all instruments must have queued the notes of this period before the
+	// first event is dispatched
+	m_events.clear();
+	for (Sf2Instrument* instrument : m_channels)
+	{
+		if (instrument != nullptr)
+		{
+			processNotes(instrument);
+			instrument->updatePitch();
+			instrument->collectNoteEvents(m_events);
+		}
+	}
+	std::stable_sort(m_events.begin(), m_events.end());
+
+	std::fill(m_dryBuffer.begin(), m_dryBuffer.end(), 0.0f);
+	std::fill(m_effectsBuffer.begin(), m_effectsBuffer.end(), 0.0f);
+
+	f_cnt_t currentFrame = 0;
+	for (const Sf2NoteEvent& event : m_events)
+	{
+		const f_cnt_t offset = std::min<f_cnt_t>(event.offset, m_frames);
+		if (offset > currentFrame)
+		{
+			renderFrames(currentFrame, offset - currentFrame);
+			currentFrame = offset;
+		}
+		event.instrument->dispatchNoteEvent(event);
+	}
+	if (currentFrame < m_frames)
+	{
+		renderFrames(currentFrame, m_frames - currentFrame);
+	}
+
+	const float* effectsLeft = m_effectsBuffer.data();
+	const float* effectsRight = effectsLeft + m_frames;
+	for (f_cnt_t f = 0; f < m_frames; ++f)
+	{
+		m_effectsReturn[f][0] = effectsLeft[f];
+		m_effectsReturn[f][1] = effectsRight[f];
+	}
+	Engine::mixer()->mixToChannel(m_effectsReturn.data(), 0);
+}
+
+
+
+
+void Sf2SharedSynth::readChannel(int chan, sampleFrame* buffer, fpp_t frames, float gain) const
+{
+	const float* left = m_dryBuffer.data() + 2 * chan * m_frames;
+	const float* right = left + m_frames;
+	for (fpp_t f = 0; f < frames; ++f)
+	{
+		buffer[f][0] = left[f] * gain;
+		buffer[f][1] = right[f] * gain;
+	}
+}
+
+
+
+
+void Sf2SharedSynth::processNotes(Sf2Instrument* instrument)
+{
+	// same as InstrumentPlayHandle::play(), but for an instrument whose
+	// play handle might not have been run yet
+	ConstNotePlayHandleList nphv = NotePlayHandle::nphsOfInstrumentTrack(instrument->instrumentTrack(), true);
+
+	bool nphsLeft;
+	do
+	{
+		nphsLeft = false;
+		for (const NotePlayHandle* constNotePlayHandle : nphv)
+		{
+			auto notePlayHandle = const_cast<NotePlayHandle*>(constNotePlayHandle);
+			if (notePlayHandle->state() != ThreadableJob::ProcessingState::Done &&
+				!notePlayHandle->isFinished())
+			{
+				nphsLeft = true;
+				notePlayHandle->process();
+			}
+		}
+	}
+	while (nphsLeft);
+}
+
+
+
+
+void Sf2SharedSynth::renderFrames(f_cnt_t offset, f_cnt_t frames)
+{
+#ifdef LMMS_HAVE_SF2_SHARED_SYNTH
+	for (int chan = 0; chan < MaxChannels; ++chan)
+	{
+		// unused channels don't play any voices, skip mixing them
+		float* left = m_channels[chan] != nullptr ? m_dryBuffer.data() + 2 * chan * m_frames + offset : nullptr;
+		m_dryPointers[2 * chan] = left;
+		m_dryPointers[2 * chan + 1] = left != nullptr ? left + m_frames : nullptr;
+	}
+
+	// reverb and chorus are both mixed into the effects return
+	float* effectsLeft = m_effectsBuffer.data() + offset;
+	float* effectsRight = effectsLeft + m_frames;
+	float* effects[] = { effectsLeft, effectsRight, effectsLeft, effectsRight };
+
+	QMutexLocker lock(&m_synthMutex);
+	fluid_synth_process(m_synth, frames, 4, effects, 2 * MaxChannels, m_dryPointers.data());
+#endif
+}
+
+
+} // namespace lmms
@@ -0,0 +1,150 @@
+/*
+ * Sf2SharedSynth.h - multi-timbral FluidSynth instance shared by Sf2Player
+ *                    instruments
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SF2_SHARED_SYNTH_H
+#define SF2_SHARED_SYNTH_H
+
+#include <array>
+#include <vector>
+#include <fluidsynth/types.h>
+#include <fluidsynth/version.h>
+#include <QMap>
+#include <QMutex>
+
+#include "lmms_basics.h"
+
+// rendering audio groups into separate buffers needs fluid_synth_process()
+// as introduced with FluidSynth 2.1
+#if FLUIDSYNTH_VERSION_MAJOR > 2 || (FLUIDSYNTH_VERSION_MAJOR == 2 && FLUIDSYNTH_VERSION_MINOR >= 1)
+#define LMMS_HAVE_SF2_SHARED_SYNTH
+#endif
+
+namespace lmms
+{
+
+class Sf2Font;
+class Sf2Instrument;
+struct Sf2NoteEvent;
+
+
+/**
+	\brief One FluidSynth instance playing the instruments of many Sf2Player tracks
+
+	Every attached instrument gets a MIDI channel of its own. Each channel is
+	rendered to its own audio group, which the instrument passes on to its
+	track's AudioPort, so tracks still have their own effect chain and mixer
+	channel. Reverb and chorus are a single effects unit shared by all
+	channels; its output is mixed into the master channel.
+
+	The synth renders each period only once: whichever attached instrument
+	is played first also processes the notes of all others, dispatches
+	their note events in time order and renders all channels at once.
+	FluidSynth spreads the voices over its own worker threads while doing so.
+*/
+class Sf2SharedSynth
+{
+public:
+	//! How many instruments can share the synth
+	static constexpr int MaxChannels = 64;
+
+	//! Whether instruments should use the shared synth, see SetupDialog
+	static bool isEnabled();
+
+	//! Attach an instrument, creating the synth if needed. Returns nullptr
+	//! if the synth is not available or has no free channel left.
+	static Sf2SharedSynth* attach(Sf2Instrument* instrument);
+	//! Detach an instrument, the last one deletes the synth
+	static void detach(Sf2Instrument* instrument);
+
+	fluid_synth_t* synth() const { return m_synth; }
+	QMutex& synthMutex() { return m_synthMutex; }
+
+	int channel(const Sf2Instrument* instrument) const;
+
+	//! Recreate the synth if the processing sample rate has changed.
+	//! Returns false if the synth cannot run at the processing sample rate.
+	bool reload();
+
+	//! Load a soundfont or add a reference to an already loaded one.
+	//! Returns nullptr if the soundfont could not be loaded.
+	Sf2Font* addFont(const QString& sf2File, const QString& relativePath, int& fontId);
+	void removeFont(const QString& relativePath);
+	int fontId(const QString& relativePath) const;
+
+	//! Render the current period unless another instrument already did
+	void render();
+	//! Fetch the dry output of an instrument's channel
+	void readChannel(int chan, sampleFrame* buffer, fpp_t frames, float gain) const;
+
+private:
+	Sf2SharedSynth();
+	~Sf2SharedSynth();
+
+	void createSynth();
+	//! Reselect the instruments' programs after the soundfont stack changed
+	void restorePrograms();
+	void processNotes(Sf2Instrument* instrument);
+	void renderFrames(f_cnt_t offset, f_cnt_t frames);
+
+	static Sf2SharedSynth* s_instance;
+	static QMutex s_instanceMutex;
+
+	struct LoadedFont
+	{
+		Sf2Font* font = nullptr;
+		int id = -1;
+		int users = 0;
+	};
+
+	fluid_settings_t* m_settings;
+	fluid_synth_t* m_synth;
+	sample_rate_t m_sampleRate;
+
+	//! Protects the synth against being recreated and keeps voice lookups
+	//! consistent with noteons
+	QMutex m_synthMutex;
+	//! Serializes render()
+	QMutex m_renderMutex;
+	long m_renderedPeriod;
+
+	QMap<QString, LoadedFont> m_fonts;
+
+	std::array<Sf2Instrument*, MaxChannels> m_channels;
+	int m_attached;
+
+	std::vector<Sf2NoteEvent> m_events;
+
+	fpp_t m_frames;
+	//! Planar dry output, two buffers per channel
+	std::vector<float> m_dryBuffer;
+	std::array<float*, 2 * MaxChannels> m_dryPointers;
+	std::vector<float> m_effectsBuffer;
+	std::vector<sampleFrame> m_effectsReturn;
+} ;
+
+
+} // namespace lmms
+
+#endif // SF2_SHARED_SYNTH_H
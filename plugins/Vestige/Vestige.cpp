@@ -408,6 +408,7 @@ void VestigeInstrument::play( sampleFrame * _buf )
 	}
 
 	m_plugin->process( nullptr, _buf );
+	m_latency = m_plugin->latency();
 
 	instrumentTrack()->processAudioBuffer( _buf, frames, nullptr );
 
@@ -27,6 +27,8 @@
 #define _VESTIGE_H
 
 
+#include <atomic>
+
 #include <QMdiSubWindow>
 #include <QMutex>
 
@@ -75,6 +77,11 @@ public:
 		return IsSingleStreamed | IsMidiBased;
 	}
 
+	virtual f_cnt_t latency() const
+	{
+		return m_latency;
+	}
+
 	virtual bool handleMidiEvent( const MidiEvent& event, const TimePos& time, f_cnt_t offset = 0 );
 
 	virtual gui::PluginView* instantiateView( QWidget * _parent );
@@ -90,6 +97,8 @@ private:
 
 	VstPlugin * m_plugin;
 	QMutex m_pluginMutex;
+	// taken from the plugin while playing, as it may be replaced
+	std::atomic<f_cnt_t> m_latency{ 0 };
 
 	QString m_pluginDLL;
 	QMdiSubWindow * m_subWindow;
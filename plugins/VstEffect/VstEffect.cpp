@@ -95,6 +95,7 @@ bool VstEffect::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames )
 		if (m_pluginMutex.tryLock(Engine::getSong()->isExporting() ? -1 : 0))
 		{
 			m_plugin->process( buf, buf );
+			m_latency = m_plugin->latency();
 			m_pluginMutex.unlock();
 		}
 
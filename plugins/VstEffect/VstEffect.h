@@ -25,6 +25,8 @@
 #ifndef _VST_EFFECT_H
 #define _VST_EFFECT_H
 
+#include <atomic>
+
 #include <QMutex>
 #include <QSharedPointer>
 
@@ -53,6 +55,11 @@ public:
 		return &m_vstControls;
 	}
 
+	f_cnt_t latency() const override
+	{
+		return m_latency;
+	}
+
 
 private:
 	void openPlugin( const QString & _plugin );
@@ -61,6 +68,8 @@ private:
 	QSharedPointer<VstPlugin> m_plugin;
 	QMutex m_pluginMutex;
 	EffectKey m_key;
+	// taken from the plugin while processing, as it may be replaced
+	std::atomic<f_cnt_t> m_latency{ 0 };
 
 	VstEffectControls m_vstControls;
 
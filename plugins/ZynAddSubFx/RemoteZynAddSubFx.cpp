@@ -58,6 +58,7 @@ public:
 	{
 		Nio::start();
 
+		enableAudioSync();
 		setInputCount( 0 );
 		sendMessage( IdInitDone );
 		waitForMessage( IdInitDone );
@@ -67,6 +68,7 @@ public:
 
 	~RemoteZynAddSubFx() override
 	{
+		disableAudioSync();
 		m_messageThread.join();
 		Nio::stop();
 	}
@@ -146,6 +148,12 @@ public:
 		LocalZynAddSubFx::processAudio( _out );
 	}
 
+	void processSynced() override
+	{
+		const auto lock = std::lock_guard{m_master->mutex};
+		RemotePluginClient::processSynced();
+	}
+
 	void guiLoop();
 
 private:
@@ -25,6 +25,8 @@
 #ifndef ZYNADDSUBFX_H
 #define ZYNADDSUBFX_H
 
+#include <atomic>
+
 #include <QMap>
 #include <QMutex>
 
@@ -93,6 +95,11 @@ public:
 
 	gui::PluginView* instantiateView( QWidget * _parent ) override;
 
+	f_cnt_t latency() const override
+	{
+		return m_latency;
+	}
+
 
 private slots:
 	void reloadPlugin();
@@ -116,6 +123,8 @@ private:
 	QMutex m_pluginMutex;
 	LocalZynAddSubFx * m_plugin;
 	ZynAddSubFxRemotePlugin * m_remotePlugin;
+	// taken from the remote plugin while playing, as it may be replaced
+	std::atomic<f_cnt_t> m_latency{ 0 };
 
 	FloatModel m_portamentoModel;
 	FloatModel m_filterFreqModel;
@@ -0,0 +1,312 @@
+/*
+ * AnalysisService.cpp - off-audio-thread analysis of audio signals for meters,
+ *                       scopes and spectrum displays
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AnalysisService.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include "denormals.h"
+#include "Engine.h"
+#include "MixHelpers.h"
+
+namespace lmms
+{
+
+
+namespace
+{
+
+void updateMaximum(std::atomic<float>& target, float value)
+{
+	float current = target.load(std::memory_order_relaxed);
+	while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+
+
+
+AnalysisTap::AnalysisTap() :
+	m_buffer(BufferSize),
+	m_reader(m_buffer),
+	m_scratch(BufferSize),
+	m_active(false),
+	m_lastRequest(0),
+	m_peakLeft(0.0f),
+	m_peakRight(0.0f),
+	m_rmsLeft(0.0f),
+	m_rmsRight(0.0f),
+	m_hasNewPeaks(false)
+{
+	if (AnalysisService* service = Engine::analysisService())
+	{
+		service->registerTap(this);
+	}
+}
+
+
+
+
+AnalysisTap::~AnalysisTap()
+{
+	if (AnalysisService* service = Engine::analysisService())
+	{
+		service->unregisterTap(this);
+	}
+}
+
+
+
+
+void AnalysisTap::requestAnalysis()
+{
+	m_lastRequest.store(AnalysisService::now(), std::memory_order_relaxed);
+	if (!m_active.exchange(true, std::memory_order_acq_rel))
+	{
+		if (AnalysisService* service = Engine::analysisService())
+		{
+			service->wakeUp();
+		}
+	}
+}
+
+
+
+
+bool AnalysisTap::takePeaks(float& left, float& right)
+{
+	if (!m_hasNewPeaks.exchange(false, std::memory_order_acq_rel))
+	{
+		return false;
+	}
+	left = m_peakLeft.exchange(0.0f, std::memory_order_relaxed);
+	right = m_peakRight.exchange(0.0f, std::memory_order_relaxed);
+	return true;
+}
+
+
+
+
+void AnalysisTap::addProcessor(AnalysisProcessor* processor)
+{
+	QMutexLocker lock(&m_processorsLock);
+	if (!m_processors.contains(processor))
+	{
+		m_processors.push_back(processor);
+	}
+}
+
+
+
+
+void AnalysisTap::removeProcessor(AnalysisProcessor* processor)
+{
+	QMutexLocker lock(&m_processorsLock);
+	m_processors.removeAll(processor);
+}
+
+
+
+
+bool AnalysisTap::process(qint64 now)
+{
+	// another service thread is already working on this tap
+	if (m_busy.test_and_set(std::memory_order_acquire)) { return isActive(); }
+
+	if (isActive() && now - m_lastRequest.load(std::memory_order_relaxed) > AnalysisService::KeepAliveTime)
+	{
+		// nobody has been looking for a while, stop accepting data
+		m_active.store(false, std::memory_order_release);
+	}
+
+	std::size_t frames = 0;
+	{
+		auto input = m_reader.read_max(m_buffer.capacity());
+		frames = std::min(input.size(), m_scratch.size());
+		for (std::size_t f = 0; f < frames; ++f)
+		{
+			m_scratch[f] = input[f];
+		}
+	}
+
+	const bool active = isActive();
+	if (active)
+	{
+		if (frames > 0)
+		{
+			float peakLeft = 0.0f;
+			float peakRight = 0.0f;
+			MixHelpers::peak(m_scratch.data(), static_cast<int>(frames), peakLeft, peakRight);
+
+			double sumLeft = 0.0;
+			double sumRight = 0.0;
+			for (std::size_t f = 0; f < frames; ++f)
+			{
+				sumLeft += m_scratch[f][0] * m_scratch[f][0];
+				sumRight += m_scratch[f][1] * m_scratch[f][1];
+			}
+			updateMaximum(m_peakLeft, peakLeft);
+			updateMaximum(m_peakRight, peakRight);
+			m_rmsLeft.store(std::sqrt(sumLeft / frames), std::memory_order_relaxed);
+			m_rmsRight.store(std::sqrt(sumRight / frames), std::memory_order_relaxed);
+			m_hasNewPeaks.store(true, std::memory_order_release);
+		}
+
+		QMutexLocker lock(&m_processorsLock);
+		for (AnalysisProcessor* processor : m_processors)
+		{
+			processor->analyze(m_scratch.data(), frames);
+		}
+	}
+
+	m_busy.clear(std::memory_order_release);
+	return active;
+}
+
+
+
+
+AnalysisService::AnalysisService() :
+	m_quit(false),
+	m_wakeRequested(false)
+{
+	// analysis runs at GUI rate, a few threads are plenty
+	const int numWorkers = qBound(1, QThread::idealThreadCount() / 4, 4);
+	for (int i = 0; i < numWorkers; ++i)
+	{
+		auto worker = new Worker(this);
+		worker->start(QThread::LowPriority);
+		m_workers.push_back(worker);
+	}
+}
+
+
+
+
+AnalysisService::~AnalysisService()
+{
+	m_quit = true;
+	wakeUp();
+	for (Worker* worker : m_workers)
+	{
+		worker->wait();
+		delete worker;
+	}
+}
+
+
+
+
+void AnalysisService::registerTap(AnalysisTap* tap)
+{
+	QWriteLocker lock(&m_tapsLock);
+	m_taps.push_back(tap);
+}
+
+
+
+
+void AnalysisService::unregisterTap(AnalysisTap* tap)
+{
+	// waits until no worker is processing taps anymore
+	QWriteLocker lock(&m_tapsLock);
+	m_taps.removeAll(tap);
+}
+
+
+
+
+void AnalysisService::wakeUp()
+{
+	QMutexLocker lock(&m_idleMutex);
+	m_wakeRequested = true;
+	m_idleCondition.wakeAll();
+}
+
+
+
+
+qint64 AnalysisService::now()
+{
+	using namespace std::chrono;
+	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+
+
+
+bool AnalysisService::processTaps()
+{
+	const qint64 time = now();
+	bool anyActive = false;
+
+	QReadLocker lock(&m_tapsLock);
+	for (AnalysisTap* tap : m_taps)
+	{
+		anyActive = tap->process(time) || anyActive;
+	}
+	return anyActive;
+}
+
+
+
+
+AnalysisService::Worker::Worker(AnalysisService* service) :
+	m_service(service)
+{
+	setObjectName("AnalysisService::Worker");
+}
+
+
+
+
+void AnalysisService::Worker::run()
+{
+	disable_denormals();
+
+	while (!m_service->m_quit)
+	{
+		const bool anyActive = m_service->processTaps();
+
+		QMutexLocker lock(&m_service->m_idleMutex);
+		if (!m_service->m_wakeRequested && !m_service->m_quit)
+		{
+			// sleep until some view asks for analysis again
+			m_service->m_idleCondition.wait(&m_service->m_idleMutex,
+				anyActive ? UpdateInterval : ULONG_MAX);
+		}
+		m_service->m_wakeRequested = false;
+	}
+}
+
+
+} // namespace lmms
@@ -30,6 +30,7 @@
 
 #include "AudioEngineWorkerThread.h"
 #include "AudioPort.h"
+#include "Controller.h"
 #include "Mixer.h"
 #include "Song.h"
 #include "EnvelopeAndLfoParameters.h"
@@ -37,6 +38,7 @@
 #include "ConfigManager.h"
 #include "SamplePlayHandle.h"
 #include "MemoryHelper.h"
+#include "ThreadConfiguration.h"
 
 // platform-specific audio-interface-classes
 #include "AudioAlsa.h"
@@ -67,19 +69,22 @@ namespace lmms
 using LocklessListElement = LocklessList<PlayHandle*>::Element;
 
 static thread_local bool s_renderingThread;
+//! Whether the calling thread got the render thread settings already
+static thread_local bool s_renderThreadConfigured;
 
 
 
 
-AudioEngine::AudioEngine( bool renderOnly ) :
+AudioEngine::AudioEngine( bool renderOnly, fpp_t renderBlockSize ) :
 	m_renderOnly( renderOnly ),
+	m_planarBuffers( ConfigManager::inst()->value( "audioengine", "planarbuffers", "1" ).toInt() ),
 	m_framesPerPeriod( DEFAULT_BUFFER_SIZE ),
 	m_inputBufferRead( 0 ),
 	m_inputBufferWrite( 1 ),
 	m_outputBufferRead(nullptr),
 	m_outputBufferWrite(nullptr),
 	m_workers(),
-	m_numWorkers( QThread::idealThreadCount()-1 ),
+	m_numWorkers( ThreadConfiguration::current().effectiveWorkers() ),
 	m_newPlayHandles( PlayHandle::MaxNumber ),
 	m_qualitySettings( qualitySettings::Mode_Draft ),
 	m_masterGain( 1.0f ),
@@ -88,6 +93,7 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	m_oldAudioDev( nullptr ),
 	m_audioDevStartFailed( false ),
 	m_profiler(),
+	m_outputTap(),
 	m_metronomeActive(false),
 	m_clearSignal( false ),
 	m_changesSignal( false ),
@@ -132,6 +138,15 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 			m_framesPerPeriod = DEFAULT_BUFFER_SIZE;
 		}
 	}
+	else if( renderBlockSize > 0 )
+	{
+		// without realtime constraints, larger periods save the
+		// per-period overhead of the render loop. Notes are placed by
+		// their offsets, but parameters read through value() only
+		// change once per period, so main() only asks for large
+		// periods if nothing is automated.
+		m_framesPerPeriod = qBound( MINIMUM_BUFFER_SIZE, renderBlockSize, MAXIMUM_RENDER_BLOCK_SIZE );
+	}
 
 	// allocte the FIFO from the determined size
 	m_fifo = new Fifo( fifoSize );
@@ -146,6 +161,28 @@ AudioEngine::AudioEngine( bool renderOnly ) :
 	BufferManager::clear(m_outputBufferRead, m_framesPerPeriod);
 	BufferManager::clear(m_outputBufferWrite, m_framesPerPeriod);
 
+	const ThreadConfiguration & threads = ThreadConfiguration::current();
+	m_profiler.addConfiguration( "workers", QString::number( m_numWorkers ) );
+	m_profiler.addConfiguration( "worker settings", QString( "cpus %1, %2" ).arg(
+		threads.worker.cpus.isEmpty() ? "any" : ThreadConfiguration::cpuListToString( threads.worker.cpus ),
+		ThreadConfiguration::priorityToString( threads.worker ) ) );
+	m_profiler.addConfiguration( "render settings", QString( "cpus %1, %2" ).arg(
+		threads.render.cpus.isEmpty() ? "any" : ThreadConfiguration::cpuListToString( threads.render.cpus ),
+		ThreadConfiguration::priorityToString( threads.render ) ) );
+	if( threads.lockMemory )
+	{
+		QString error;
+		if( ThreadConfiguration::lockProcessMemory( error ) )
+		{
+			m_profiler.addConfiguration( "memory", "locked" );
+		}
+		else
+		{
+			m_profiler.addConfiguration( "memory", QString( "not locked (%1)" ).arg( error ) );
+			qWarning( "Notice: could not lock memory: %s", qPrintable( error ) );
+		}
+	}
+
 	for( int i = 0; i < m_numWorkers+1; ++i )
 	{
 		auto wt = new AudioEngineWorkerThread(this);
@@ -218,7 +255,13 @@ void AudioEngine::initDevices()
 
 void AudioEngine::startProcessing(bool needsFifo)
 {
-	if (needsFifo)
+	// synchronous devices render right from their process callback, which
+	// must never wait for changes in model - these are instead kept from
+	// running concurrently by renderNextBufferSynchronously()
+	const bool synchronous = needsFifo && m_audioDev->isSynchronous();
+	m_waitingForWrite = synchronous;
+
+	if (needsFifo && !synchronous)
 	{
 		m_fifoWriter = new fifoWriter( this, m_fifo );
 		m_fifoWriter->start( QThread::HighPriority );
@@ -252,6 +295,8 @@ void AudioEngine::stopProcessing()
 	{
 		m_audioDev->stopProcessing();
 	}
+
+	m_waitingForWrite = false;
 }
 
 
@@ -336,6 +381,15 @@ void AudioEngine::pushInputFrames( sampleFrame * _ab, const f_cnt_t _frames )
 
 const surroundSampleFrame * AudioEngine::renderNextBuffer()
 {
+	if( !s_renderThreadConfigured )
+	{
+		// the render thread may belong to the audio device, so it can
+		// only be set up from here
+		s_renderThreadConfigured = true;
+		m_profiler.addConfiguration( "render thread",
+			ThreadConfiguration::applyToCurrentThread( ThreadConfiguration::current().render ) );
+	}
+
 	m_profiler.startPeriod();
 
 	s_renderingThread = true;
@@ -388,6 +442,10 @@ const surroundSampleFrame * AudioEngine::renderNextBuffer()
 		e = next;
 	}
 
+	// STAGE 0: evaluate all controllers, so instruments and effects only
+	// read their value buffers
+	Controller::evaluateControllers();
+
 	// STAGE 1: run and render all play handles
 	AudioEngineWorkerThread::fillJobQueue<PlayHandleList>( m_playHandles );
 	AudioEngineWorkerThread::startAndWaitForJobs();
@@ -426,6 +484,7 @@ const surroundSampleFrame * AudioEngine::renderNextBuffer()
 	// STAGE 3: do master mix in mixer
 	mixer->masterMix(m_outputBufferWrite);
 
+	m_outputTap.write(m_outputBufferWrite, m_framesPerPeriod);
 
 	emit nextAudioBuffer(m_outputBufferRead);
 
@@ -446,6 +505,34 @@ const surroundSampleFrame * AudioEngine::renderNextBuffer()
 
 
 
+const surroundSampleFrame * AudioEngine::renderNextBufferSynchronously()
+{
+	// a change in model is in progress - most are done quickly, so wait
+	// for it, but only for a part of the period, so the realtime thread of
+	// the audio device can't be blocked by a long one and the period is
+	// dropped then
+	const int timeout = qMax<int>( 1,
+		m_framesPerPeriod * 1000 / ( 2 * processingSampleRate() ) );
+	if( !m_doChangesMutex.tryLock( timeout ) )
+	{
+		return nullptr;
+	}
+
+	const surroundSampleFrame * buffer = nullptr;
+	if( m_isProcessing )
+	{
+		renderNextBuffer();
+		buffer = m_outputBufferWrite;
+	}
+
+	m_doChangesMutex.unlock();
+
+	return buffer;
+}
+
+
+
+
 void AudioEngine::swapBuffers()
 {
 	m_inputBufferWrite = (m_inputBufferWrite + 1) % 2;
@@ -534,7 +621,9 @@ void AudioEngine::clearInternal()
 	// TODO: m_midiClient->noteOffAll();
 	for (auto ph : m_playHandles)
 	{
-		if (ph->type() != PlayHandle::TypeInstrumentPlayHandle)
+		// these live as long as their instrument or frozen track
+		if (ph->type() != PlayHandle::TypeInstrumentPlayHandle
+			&& ph->type() != PlayHandle::TypeFrozenStemHandle)
 		{
 			m_playHandlesToRemove.push_back(ph);
 		}
@@ -544,32 +633,6 @@ void AudioEngine::clearInternal()
 
 
 
-AudioEngine::StereoSample AudioEngine::getPeakValues(sampleFrame * ab, const f_cnt_t frames) const
-{
-	sample_t peakLeft = 0.0f;
-	sample_t peakRight = 0.0f;
-
-	for (f_cnt_t f = 0; f < frames; ++f)
-	{
-		float const absLeft = qAbs(ab[f][0]);
-		float const absRight = qAbs(ab[f][1]);
-		if (absLeft > peakLeft)
-		{
-			peakLeft = absLeft;
-		}
-
-		if (absRight > peakRight)
-		{
-			peakRight = absRight;
-		}
-	}
-
-	return StereoSample(peakLeft, peakRight);
-}
-
-
-
-
 void AudioEngine::changeQuality(const struct qualitySettings & qs)
 {
 	// don't delete the audio-device
@@ -1247,17 +1310,6 @@ void AudioEngine::fifoWriter::run()
 {
 	disable_denormals();
 
-#if 0
-#if defined(LMMS_BUILD_LINUX) || defined(LMMS_BUILD_FREEBSD)
-#ifdef LMMS_HAVE_SCHED_H
-	cpu_set_t mask;
-	CPU_ZERO( &mask );
-	CPU_SET( 0, &mask );
-	sched_setaffinity( 0, sizeof( mask ), &mask );
-#endif
-#endif
-#endif
-
 	const fpp_t frames = m_audioEngine->framesPerPeriod();
 	while( m_writing )
 	{
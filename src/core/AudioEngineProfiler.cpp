@@ -30,7 +30,8 @@ namespace lmms
 AudioEngineProfiler::AudioEngineProfiler() :
 	m_periodTimer(),
 	m_cpuLoad( 0 ),
-	m_outputFile()
+	m_outputFile(),
+	m_configurationWritten( 0 )
 {
 }
 
@@ -45,6 +46,15 @@ void AudioEngineProfiler::finishPeriod( sample_rate_t sampleRate, fpp_t framesPe
 
 	if( m_outputFile.isOpen() )
 	{
+		// never block the render thread for this
+		if( m_configurationMutex.tryLock() )
+		{
+			for( ; m_configurationWritten < m_configuration.size(); ++m_configurationWritten )
+			{
+				m_outputFile.write( QString( "# %1\n" ).arg( m_configuration[m_configurationWritten] ).toUtf8() );
+			}
+			m_configurationMutex.unlock();
+		}
 		m_outputFile.write( QString( "%1\n" ).arg( periodElapsed ).toLatin1() );
 	}
 }
@@ -56,6 +66,17 @@ void AudioEngineProfiler::setOutputFile( const QString& outputFile )
 	m_outputFile.close();
 	m_outputFile.setFileName( outputFile );
 	m_outputFile.open( QFile::WriteOnly | QFile::Truncate );
+
+	QMutexLocker lock( &m_configurationMutex );
+	m_configurationWritten = 0;
+}
+
+
+
+void AudioEngineProfiler::addConfiguration( const QString& name, const QString& value )
+{
+	QMutexLocker lock( &m_configurationMutex );
+	m_configuration << QString( "%1: %2" ).arg( name, value );
 }
 
 } // namespace lmms
@@ -32,6 +32,7 @@
 #include "AudioEngine.h"
 #include "MemoryManager.h"
 #include "ThreadableJob.h"
+#include "ThreadConfiguration.h"
 
 #if __SSE__
 #include <xmmintrin.h>
@@ -116,6 +117,8 @@ void AudioEngineWorkerThread::JobQueue::wait()
 
 AudioEngineWorkerThread::AudioEngineWorkerThread( AudioEngine* audioEngine ) :
 	QThread( audioEngine ),
+	m_audioEngine( audioEngine ),
+	m_index( workerThreads.size() ),
 	m_quit( false )
 {
 	// initialize global static data
@@ -170,6 +173,9 @@ void AudioEngineWorkerThread::run()
 	MemoryManager::ThreadGuard mmThreadGuard; Q_UNUSED(mmThreadGuard);
 	disable_denormals();
 
+	m_audioEngine->profiler().addConfiguration( QString( "worker %1" ).arg( m_index ),
+		ThreadConfiguration::applyToCurrentThread( ThreadConfiguration::current().worker, m_index ) );
+
 	QMutex m;
 	while( m_quit == false )
 	{
@@ -56,12 +56,21 @@ AutomatableModel::AutomatableModel(
 	m_controllerConnection( nullptr ),
 	m_valueBuffer( static_cast<int>( Engine::audioEngine()->framesPerPeriod() ) ),
 	m_lastUpdatedPeriod( -1 ),
+	m_automationStepsPeriod( -1 ),
+	m_automationStartValue( 0.0f ),
 	m_hasSampleExactData(false),
 	m_useControllerValue(true)
 
 {
 	m_value = fittedValue( val );
 	setInitValue( val );
+
+	// Song sets automated values once per tick at most, reserve that many
+	// steps so that setAutomatedValue() doesn't allocate on the audio thread
+	const float minFramesPerTick = Engine::audioEngine()->baseSampleRate() * 60.0f * 4
+					/ DefaultTicksPerBar / MaxTempo;
+	m_automationSteps.reserve( static_cast<std::size_t>(
+		Engine::audioEngine()->framesPerPeriod() / minFramesPerTick ) + 2 );
 }
 
 
@@ -292,6 +301,16 @@ void AutomatableModel::loadSettings( const QDomElement& element, const QString&
 
 
 
+bool AutomatableModel::isSavedAutomated( const QDomElement& element, const QString& name )
+{
+	// automated models are saved with their ID, so the clips can find them
+	return element.firstChildElement( name ).hasAttribute( "id" )
+		|| !element.firstChildElement( "connection" ).firstChildElement( name ).isNull();
+}
+
+
+
+
 void AutomatableModel::setValue( const float value )
 {
 	m_oldValue = m_value;
@@ -373,7 +392,7 @@ void AutomatableModel::roundAt( T& value, const T& where ) const
 
 
 
-void AutomatableModel::setAutomatedValue( const float value )
+void AutomatableModel::setAutomatedValue( const float value, const fpp_t frameOffset )
 {
 	setUseControllerValue(false);
 
@@ -387,13 +406,23 @@ void AutomatableModel::setAutomatedValue( const float value )
 
 	if( oldValue != m_value )
 	{
+		m_valueBufferMutex.lock();
+		if( m_automationStepsPeriod != s_periodCounter )
+		{
+			m_automationSteps.clear();
+			m_automationStepsPeriod = s_periodCounter;
+			m_automationStartValue = oldValue;
+		}
+		m_automationSteps.push_back( { frameOffset, m_value } );
+		m_valueBufferMutex.unlock();
+
 		// notify linked models
 		for (const auto& linkedModel : m_linkedModels)
 		{
 			if (!(linkedModel->controllerConnection()) && linkedModel->m_setValueDepth < 1 &&
 					linkedModel->fittedValue(m_value) != linkedModel->m_value)
 			{
-				linkedModel->setAutomatedValue(value);
+				linkedModel->setAutomatedValue(value, frameOffset);
 			}
 		}
 		m_valueChanged = true;
@@ -667,6 +696,15 @@ ValueBuffer * AutomatableModel::valueBuffer()
 		}
 	}
 
+	if( followsAutomationSteps() )
+	{
+		fillFromAutomationSteps();
+		m_oldValue = val;
+		m_lastUpdatedPeriod = s_periodCounter;
+		m_hasSampleExactData = true;
+		return &m_valueBuffer;
+	}
+
 	if( m_oldValue != val )
 	{
 		m_valueBuffer.interpolate( m_oldValue, val );
@@ -684,6 +722,55 @@ ValueBuffer * AutomatableModel::valueBuffer()
 }
 
 
+bool AutomatableModel::followsAutomationSteps() const
+{
+	// a single change at the start of the period is interpolated over the
+	// whole period below, just like any other change of the value
+	return m_automationStepsPeriod == s_periodCounter
+		&& ( m_automationSteps.size() > 1
+			|| ( !m_automationSteps.empty() && m_automationSteps.front().frameOffset > 0 ) );
+}
+
+
+
+
+void AutomatableModel::fillFromAutomationSteps()
+{
+	// Hold the value of the previous period until the first step. Each step
+	// is then reached at the next one (or the end of the period), the same
+	// way a value set once per period is reached at the end of the period.
+	float * values = m_valueBuffer.values();
+	const int length = m_valueBuffer.length();
+
+	float previous = m_automationStartValue;
+	int frame = 0;
+	for( std::size_t i = 0; i < m_automationSteps.size(); ++i )
+	{
+		const int begin = qMin<int>( m_automationSteps[i].frameOffset, length );
+		const int end = i + 1 < m_automationSteps.size()
+			? qMin<int>( m_automationSteps[i + 1].frameOffset, length )
+			: length;
+
+		for( ; frame < begin; ++frame )
+		{
+			values[frame] = previous;
+		}
+		for( ; frame < end; ++frame )
+		{
+			values[frame] = linearInterpolate( previous, m_automationSteps[i].value,
+							static_cast<float>( frame - begin ) / ( end - begin ) );
+		}
+		previous = m_automationSteps[i].value;
+	}
+	for( ; frame < length; ++frame )
+	{
+		values[frame] = previous;
+	}
+}
+
+
+
+
 void AutomatableModel::unlinkControllerConnection()
 {
 	if( m_controllerConnection )
@@ -56,7 +56,9 @@ AutomationClip::AutomationClip( AutomationTrack * _auto_track ) :
 	m_progressionType( DiscreteProgression ),
 	m_dragging( false ),
 	m_isRecording( false ),
-	m_lastRecordedValue( 0 )
+	m_lastRecordedValue( 0 ),
+	m_curveGenerations(),
+	m_curveGeneration( 0 )
 {
 	changeLength( TimePos( 1, 0 ) );
 	if( getTrack() )
@@ -87,7 +89,9 @@ AutomationClip::AutomationClip( const AutomationClip & _clip_to_copy ) :
 	m_autoTrack( _clip_to_copy.m_autoTrack ),
 	m_objects( _clip_to_copy.m_objects ),
 	m_tension( _clip_to_copy.m_tension ),
-	m_progressionType( _clip_to_copy.m_progressionType )
+	m_progressionType( _clip_to_copy.m_progressionType ),
+	m_curveGenerations(),
+	m_curveGeneration( 0 )
 {
 	// Locks the mutex of the copied AutomationClip to make sure it
 	// doesn't change while it's being copied
@@ -156,6 +160,7 @@ void AutomationClip::setProgressionType(
 		_new_progression_type == CubicHermiteProgression )
 	{
 		m_progressionType = _new_progression_type;
+		invalidateCurves();
 		emit dataChanged();
 	}
 }
@@ -173,6 +178,7 @@ void AutomationClip::setTension( QString _new_tension )
 	if( ok && nt > -0.01 && nt < 1.01 )
 	{
 		m_tension = nt;
+		invalidateCurves();
 	}
 }
 
@@ -556,15 +562,24 @@ float AutomationClip::valueAt( timeMap::const_iterator v, int offset ) const
 {
 	QMutexLocker m(&m_clipMutex);
 
+	return valueAt(v, offset, m_progressionType, m_tension);
+}
+
+
+
+
+float AutomationClip::valueAt( timeMap::const_iterator v, int offset,
+				ProgressionTypes progression, float tension )
+{
 	// We never use it with offset 0, but doesn't hurt to return a correct
 	// value if we do
 	if (offset == 0) { return INVAL(v); }
 
-	if (m_progressionType == DiscreteProgression)
+	if (progression == DiscreteProgression)
 	{
 		return OUTVAL(v);
 	}
-	else if( m_progressionType == LinearProgression )
+	else if( progression == LinearProgression )
 	{
 		float slope =
 			(INVAL(v + 1) - OUTVAL(v))
@@ -584,8 +599,8 @@ float AutomationClip::valueAt( timeMap::const_iterator v, int offset ) const
 		// tangents _m1 and _m2
 		int numValues = (POS(v + 1) - POS(v));
 		float t = (float) offset / (float) numValues;
-		float m1 = OUTTAN(v) * numValues * m_tension;
-		float m2 = INTAN(v + 1) * numValues * m_tension;
+		float m1 = OUTTAN(v) * numValues * tension;
+		float m2 = INTAN(v + 1) * numValues * tension;
 
 		auto t2 = pow(t, 2);
 		auto t3 = pow(t, 3);
@@ -623,6 +638,23 @@ float *AutomationClip::valuesAfter( const TimePos & _time ) const
 
 
 
+std::shared_ptr<const AutomationCurve> AutomationClip::curve( float ticksPerPixel ) const
+{
+	const int level = AutomationCurve::levelFor(ticksPerPixel);
+	const int generation = m_curveGeneration.load(std::memory_order_relaxed);
+
+	// a change while building only costs a rebuild on the next paint
+	if (!m_curves[level] || m_curveGenerations[level] != generation)
+	{
+		m_curves[level] = std::make_shared<const AutomationCurve>(*this, level);
+		m_curveGenerations[level] = generation;
+	}
+	return m_curves[level];
+}
+
+
+
+
 void AutomationClip::flipY(int min, int max)
 {
 	QMutexLocker m(&m_clipMutex);
@@ -1045,6 +1077,7 @@ void AutomationClip::clear()
 	QMutexLocker m(&m_clipMutex);
 
 	m_timeMap.clear();
+	invalidateCurves();
 
 	emit dataChanged();
 }
@@ -1116,6 +1149,9 @@ void AutomationClip::generateTangents(timeMap::iterator it, int numToGenerate)
 {
 	QMutexLocker m(&m_clipMutex);
 
+	// every change of the nodes ends up here
+	invalidateCurves();
+
 	if( m_timeMap.size() < 2 && numToGenerate > 0 )
 	{
 		it.value().setInTangent(0);
@@ -0,0 +1,95 @@
+/*
+ * AutomationCurve.cpp - polyline of the values of an automation clip
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "AutomationCurve.h"
+
+#include <QMutexLocker>
+
+#include "AutomationClip.h"
+
+namespace lmms
+{
+
+
+AutomationCurve::AutomationCurve(const AutomationClip& clip, int level) :
+	m_ticksPerPoint(ticksPerPoint(level))
+{
+	// copying the map is cheap since it's implicitly shared, so the lock
+	// is released before sampling
+	AutomationClip::timeMap nodes;
+	AutomationClip::ProgressionTypes progression;
+	float tension;
+	{
+		QMutexLocker m(&clip.m_clipMutex);
+		nodes = clip.m_timeMap;
+		progression = clip.m_progressionType;
+		tension = clip.m_tension;
+	}
+
+	if (nodes.size() < 2) { return; }
+
+	m_segments.reserve(nodes.size() - 1);
+	for (auto it = nodes.cbegin(); it + 1 != nodes.cend(); ++it)
+	{
+		const int length = POS(it + 1) - POS(it);
+		Segment segment{POS(it), POS(it + 1), static_cast<int>(m_points.size()), 0};
+
+		// the views always started a segment at the inValue of its node
+		m_points.push_back({POS(it), INVAL(it)});
+		if (length > 1)
+		{
+			m_points.push_back({POS(it) + 1, AutomationClip::valueAt(it, 1, progression, tension)});
+			if (progression == AutomationClip::CubicHermiteProgression)
+			{
+				for (int offset = m_ticksPerPoint; offset < length; offset += m_ticksPerPoint)
+				{
+					if (offset == 1) { continue; }
+					m_points.push_back({POS(it) + offset, AutomationClip::valueAt(it, offset, progression, tension)});
+				}
+			}
+		}
+		// a discrete segment keeps the outValue up to the next node
+		m_points.push_back({POS(it + 1),
+			progression == AutomationClip::DiscreteProgression ? OUTVAL(it) : INVAL(it + 1)});
+
+		segment.count = static_cast<int>(m_points.size()) - segment.first;
+		m_segments.push_back(segment);
+	}
+}
+
+
+
+
+int AutomationCurve::levelFor(float ticksPerPixel)
+{
+	int level = 0;
+	while (level + 1 < Resolutions && ticksPerPoint(level + 1) <= ticksPerPixel)
+	{
+		++level;
+	}
+	return level;
+}
+
+
+} // namespace lmms
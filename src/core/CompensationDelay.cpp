@@ -0,0 +1,114 @@
+/*
+ * CompensationDelay.cpp - delay line aligning signals of different latency
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "CompensationDelay.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+
+CompensationDelay::CompensationDelay() :
+	m_requested( 0 ),
+	m_delay( 0 ),
+	m_position( 0 ),
+	m_pending( 0 )
+{
+}
+
+
+
+
+void CompensationDelay::setDelay( f_cnt_t frames )
+{
+	frames = std::max<f_cnt_t>( frames, 0 );
+	m_requested.store( frames, std::memory_order_relaxed );
+	frames = std::min<f_cnt_t>( frames, m_line.size() );
+	if( frames == m_delay )
+	{
+		return;
+	}
+
+	m_delay = frames;
+	m_position = 0;
+	m_pending = 0;
+	std::fill( m_line.begin(), m_line.begin() + frames, sampleFrame{} );
+}
+
+
+
+
+void CompensationDelay::reserve()
+{
+	if( needsReserve() )
+	{
+		m_line.resize( m_requested.load( std::memory_order_relaxed ) );
+		setDelay( m_requested.load( std::memory_order_relaxed ) );
+	}
+}
+
+
+
+
+void CompensationDelay::clear()
+{
+	// the line is silent once the last input has left it
+	if( m_pending > 0 )
+	{
+		std::fill( m_line.begin(), m_line.begin() + m_delay, sampleFrame{} );
+		m_pending = 0;
+	}
+}
+
+
+
+
+void CompensationDelay::process( sampleFrame * buf, fpp_t frames, bool hasInput )
+{
+	if( m_delay == 0 )
+	{
+		return;
+	}
+
+	m_pending = hasInput ? m_delay : std::max<f_cnt_t>( m_pending - frames, 0 );
+
+	// swap the buffer with the line in up to two contiguous chunks per
+	// pass through the line
+	f_cnt_t done = 0;
+	while( done < frames )
+	{
+		const f_cnt_t chunk = std::min<f_cnt_t>( frames - done, m_delay - m_position );
+		std::swap_ranges( buf + done, buf + done + chunk, m_line.begin() + m_position );
+		done += chunk;
+		m_position += chunk;
+		if( m_position == m_delay )
+		{
+			m_position = 0;
+		}
+	}
+}
+
+
+} // namespace lmms
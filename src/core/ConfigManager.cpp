@@ -305,6 +305,8 @@ void ConfigManager::createWorkingDir()
 	QDir().mkpath(userProjectsDir());
 	QDir().mkpath(userTemplateDir());
 	QDir().mkpath(userSamplesDir());
+	QDir().mkpath(userRecordingsDir());
+	QDir().mkpath(userFreezeDir());
 	QDir().mkpath(userPresetsDir());
 	QDir().mkpath(userGigDir());
 	QDir().mkpath(userSf2Dir());
@@ -25,10 +25,13 @@
  */
 
 #include <QDomElement>
+#include <QHash>
+#include <QMutexLocker>
 #include <QVector>
 
 
 #include "AudioEngine.h"
+#include "AudioEngineWorkerThread.h"
 #include "ControllerConnection.h"
 #include "ControllerDialog.h"
 #include "LfoController.h"
@@ -41,6 +44,9 @@ namespace lmms
 
 long Controller::s_periods = 0;
 QVector<Controller *> Controller::s_controllers;
+QVector<ControllerVector> Controller::s_evaluationLevels;
+bool Controller::s_evaluationOrderChanged = false;
+QMutex Controller::s_evaluationMutex;
 
 
 
@@ -53,9 +59,11 @@ Controller::Controller( ControllerTypes _type, Model * _parent,
 	m_connectionCount( 0 ),
 	m_type( _type )
 {
-	if( _type != DummyController && _type != MidiController )
+	if( isEvaluatedPerPeriod() )
 	{
+		QMutexLocker lock( &s_evaluationMutex );
 		s_controllers.append( this );
+		s_evaluationOrderChanged = true;
 		// Determine which name to use
 		for ( uint i=s_controllers.size(); ; i++ )
 		{
@@ -86,10 +94,16 @@ Controller::Controller( ControllerTypes _type, Model * _parent,
 
 Controller::~Controller()
 {
+	QMutexLocker lock( &s_evaluationMutex );
 	int idx = s_controllers.indexOf( this );
 	if( idx >= 0 )
 	{
 		s_controllers.remove( idx );
+		for( ControllerVector & level : s_evaluationLevels )
+		{
+			level.removeAll( this );
+		}
+		s_evaluationOrderChanged = true;
 	}
 
 	m_valueBuffer.clear();
@@ -101,19 +115,16 @@ Controller::~Controller()
 // Get current value, with an offset into the current buffer for sample exactness
 float Controller::currentValue( int _offset )
 {
-	if( _offset == 0 || isSampleExact() )
-	{
-		m_currentValue = fittedValue( value( _offset ) );
-	}
-	
-	return m_currentValue;
+	// controllers that are not sample exact keep their value for the
+	// whole period
+	return fittedValue( value( isSampleExact() ? _offset : 0 ) );
 }
 
 
 
 float Controller::value( int offset )
 {
-	if( m_bufferLastUpdated != s_periods )
+	if( m_bufferLastUpdated != s_periods && !isEvaluatedPerPeriod() )
 	{
 		updateValueBuffer();
 	}
@@ -123,7 +134,7 @@ float Controller::value( int offset )
 
 ValueBuffer * Controller::valueBuffer()
 {
-	if( m_bufferLastUpdated != s_periods )
+	if( m_bufferLastUpdated != s_periods && !isEvaluatedPerPeriod() )
 	{
 		updateValueBuffer();
 	}
@@ -138,6 +149,16 @@ void Controller::updateValueBuffer()
 }
 
 
+
+void Controller::doProcessing()
+{
+	if( m_bufferLastUpdated != s_periods )
+	{
+		updateValueBuffer();
+	}
+}
+
+
 // Get position in frames
 unsigned int Controller::runningFrames()
 {
@@ -171,6 +192,99 @@ void Controller::triggerFrameCounter()
 
 
 
+void Controller::evaluateControllers()
+{
+	QMutexLocker lock( &s_evaluationMutex );
+
+	if( s_evaluationOrderChanged )
+	{
+		updateEvaluationOrder();
+	}
+
+	for( const ControllerVector & level : s_evaluationLevels )
+	{
+		if( level.size() > 1 )
+		{
+			AudioEngineWorkerThread::fillJobQueue<ControllerVector>( level );
+			AudioEngineWorkerThread::startAndWaitForJobs();
+		}
+		else if( !level.isEmpty() && level.first()->requiresProcessing() )
+		{
+			// not worth waking up the worker threads
+			level.first()->doProcessing();
+		}
+	}
+}
+
+
+
+void Controller::updateEvaluationOrder()
+{
+	// a controller's level is the length of the longest chain of
+	// controllers connected to its models; a connection cycle is cut off
+	// after as many passes as there are controllers
+	QHash<Controller *, int> levels;
+	for( Controller * controller : s_controllers )
+	{
+		levels.insert( controller, 0 );
+	}
+
+	int maxLevel = 0;
+	for( int pass = 0; pass < s_controllers.size(); ++pass )
+	{
+		bool changed = false;
+		for( Controller * controller : s_controllers )
+		{
+			int & level = levels[controller];
+			for( Controller * input : controller->inputs() )
+			{
+				const int inputLevel = levels.value( input, -1 );
+				if( inputLevel >= level )
+				{
+					level = inputLevel + 1;
+					maxLevel = qMax( maxLevel, level );
+					changed = true;
+				}
+			}
+		}
+		if( !changed )
+		{
+			break;
+		}
+	}
+
+	s_evaluationLevels.clear();
+	s_evaluationLevels.resize( s_controllers.isEmpty() ? 0 : maxLevel + 1 );
+	for( Controller * controller : s_controllers )
+	{
+		s_evaluationLevels[levels.value( controller )].append( controller );
+	}
+
+	s_evaluationOrderChanged = false;
+}
+
+
+
+ControllerVector Controller::inputs() const
+{
+	ControllerVector result;
+	for( QObject * c : children() )
+	{
+		auto am = qobject_cast<AutomatableModel*>( c );
+		if( am != nullptr && am->controllerConnection() != nullptr )
+		{
+			Controller * input = am->controllerConnection()->getController();
+			if( input != nullptr && !result.contains( input ) )
+			{
+				result.append( input );
+			}
+		}
+	}
+	return result;
+}
+
+
+
 void Controller::resetFrameCounter()
 {
 	for (Controller * controller : s_controllers)
@@ -306,7 +420,10 @@ gui::ControllerDialog * Controller::createDialog( QWidget * _parent )
 
 void Controller::addConnection( ControllerConnection * )
 {
+	QMutexLocker lock( &s_evaluationMutex );
 	m_connectionCount++;
+	// the connected model might belong to another controller
+	s_evaluationOrderChanged = true;
 }
 
 
@@ -314,8 +431,10 @@ void Controller::addConnection( ControllerConnection * )
 
 void Controller::removeConnection( ControllerConnection * )
 {
+	QMutexLocker lock( &s_evaluationMutex );
 	m_connectionCount--;
 	Q_ASSERT( m_connectionCount >= 0 );
+	s_evaluationOrderChanged = true;
 }
 
 
@@ -0,0 +1,380 @@
+/*
+ * DiskRecorder.cpp - streams recorded audio to files on a background thread
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "DiskRecorder.h"
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRegExp>
+
+#include "ConfigManager.h"
+
+namespace lmms
+{
+
+
+//! Frames the writer thread moves from a ring to the file at once
+static constexpr std::size_t ScratchFrames = 4096;
+
+
+
+
+DiskRecorder::Take::Take(const QString& name, sample_rate_t sampleRate, Format format) :
+	m_name(name),
+	m_sampleRate(sampleRate),
+	m_format(format),
+	m_ring(static_cast<std::size_t>(sampleRate) * RingSeconds),
+	m_reader(m_ring),
+	m_sf(nullptr),
+	m_failed(false),
+	m_framesRecorded(0),
+	m_framesDropped(0),
+	m_finishing(false),
+	m_closed(false)
+{
+}
+
+
+
+
+DiskRecorder::Take::~Take()
+{
+	close();
+}
+
+
+
+
+void DiskRecorder::Take::write(const sampleFrame* buf, f_cnt_t frames)
+{
+	const auto written = static_cast<f_cnt_t>(m_ring.write(buf, frames));
+	m_framesRecorded += written;
+	m_framesDropped += frames - written;
+}
+
+
+
+
+bool DiskRecorder::Take::open()
+{
+	SF_INFO info = {};
+	info.samplerate = m_sampleRate;
+	info.channels = DEFAULT_CHANNELS;
+	switch (m_format)
+	{
+		case Format::Wave64:
+			info.format = SF_FORMAT_W64 | SF_FORMAT_FLOAT;
+			break;
+		case Format::Flac:
+			info.format = SF_FORMAT_FLAC | SF_FORMAT_PCM_24;
+			break;
+		default:
+			info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+			break;
+	}
+
+	m_fileName = uniqueFileName(m_name, m_format);
+	m_file.setFileName(m_fileName);
+
+	// use the file handle for unicode file names on Windows
+	if (!m_file.open(QIODevice::WriteOnly)
+		|| (m_sf = sf_open_fd(m_file.handle(), SFM_WRITE, &info, false)) == nullptr)
+	{
+		qWarning("DiskRecorder: can't write %s: %s", qPrintable(m_fileName),
+			m_file.isOpen() ? sf_strerror(nullptr) : qPrintable(m_file.errorString()));
+		m_failed = true;
+		return false;
+	}
+
+	// keep the header valid after every write, in case we crash
+	if (m_format != Format::Flac)
+	{
+		sf_command(m_sf, SFC_SET_UPDATE_HEADER_AUTO, nullptr, SF_TRUE);
+	}
+	sf_set_string(m_sf, SF_STR_SOFTWARE, "LMMS");
+	return true;
+}
+
+
+
+
+bool DiskRecorder::Take::flush(std::vector<sampleFrame>& scratch)
+{
+	std::size_t frames = 0;
+	{
+		auto input = m_reader.read_max(scratch.size());
+		frames = input.size();
+		for (std::size_t f = 0; f < frames; ++f)
+		{
+			scratch[f] = input[f];
+		}
+	}
+
+	// files are only created for takes which actually received data
+	if (frames > 0 && !m_sf && !m_failed)
+	{
+		open();
+	}
+
+	if (frames > 0 && m_sf)
+	{
+		const auto written = sf_writef_float(m_sf, scratch[0].data(), frames);
+		if (written != static_cast<sf_count_t>(frames) && !m_failed)
+		{
+			qWarning("DiskRecorder: error writing %s: %s", qPrintable(m_fileName), sf_strerror(m_sf));
+			m_failed = true;
+		}
+	}
+	return frames > 0;
+}
+
+
+
+
+void DiskRecorder::Take::close()
+{
+	if (!m_sf && !m_file.isOpen())
+	{
+		return;
+	}
+
+	if (m_sf)
+	{
+		sf_close(m_sf);
+		m_sf = nullptr;
+	}
+	m_file.close();
+
+	if (m_framesDropped > 0)
+	{
+		qWarning("DiskRecorder: %s is missing %d frames, the disk was too slow",
+			qPrintable(m_fileName), static_cast<int>(m_framesDropped));
+	}
+}
+
+
+
+
+DiskRecorder::Writer::Writer(DiskRecorder* recorder) :
+	m_recorder(recorder)
+{
+}
+
+
+
+
+void DiskRecorder::Writer::run()
+{
+	std::vector<sampleFrame> scratch(ScratchFrames);
+	while (true)
+	{
+		const bool quit = m_recorder->m_quit;
+		const bool wrote = m_recorder->processTakes(scratch);
+
+		if (quit && !wrote)
+		{
+			QMutexLocker lock(&m_recorder->m_takesLock);
+			if (m_recorder->m_takes.empty()) { break; }
+		}
+
+		// nothing is signalled from the audio thread, so it never blocks
+		if (!wrote)
+		{
+			m_recorder->m_wake.tryAcquire(1, PollInterval);
+		}
+	}
+}
+
+
+
+
+DiskRecorder::DiskRecorder() :
+	m_format(Format::Wave),
+	m_writer(this),
+	m_quit(false)
+{
+	const QString format = ConfigManager::inst()->value("audioengine", "recordformat");
+	if (format == "w64") { m_format = Format::Wave64; }
+	else if (format == "flac") { m_format = Format::Flac; }
+
+	m_writer.start(QThread::HighPriority);
+}
+
+
+
+
+DiskRecorder::~DiskRecorder()
+{
+	{
+		QMutexLocker lock(&m_takesLock);
+		for (const TakePtr& take : m_takes)
+		{
+			take->m_finishing = true;
+		}
+	}
+	m_quit = true;
+	m_wake.release();
+	m_writer.wait();
+
+	// nobody is left to take the files over
+	m_finished.clear();
+}
+
+
+
+
+DiskRecorder::TakePtr DiskRecorder::startTake(const QString& name, sample_rate_t sampleRate,
+												FinishedCallback onFinished)
+{
+	auto take = std::make_shared<Take>(name, sampleRate, m_format);
+	take->m_onFinished = std::move(onFinished);
+
+	QMutexLocker lock(&m_takesLock);
+	m_takes.push_back(take);
+	return take;
+}
+
+
+
+
+void DiskRecorder::finishTake(const TakePtr& take)
+{
+	take->m_finishing.store(true, std::memory_order_release);
+	m_wake.release();
+}
+
+
+
+
+void DiskRecorder::waitForTake(const TakePtr& take)
+{
+	QMutexLocker lock(&m_closedLock);
+	while (!take->m_closed)
+	{
+		m_closedCondition.wait(&m_closedLock);
+	}
+}
+
+
+
+
+QString DiskRecorder::fileExtension(Format format)
+{
+	switch (format)
+	{
+		case Format::Wave64: return "w64";
+		case Format::Flac: return "flac";
+		default: return "wav";
+	}
+}
+
+
+
+
+void DiskRecorder::deliverFinishedTakes()
+{
+	std::vector<TakePtr> finished;
+	{
+		QMutexLocker lock(&m_finishedLock);
+		finished.swap(m_finished);
+	}
+
+	for (const TakePtr& take : finished)
+	{
+		take->m_onFinished(*take);
+	}
+}
+
+
+
+
+bool DiskRecorder::processTakes(std::vector<sampleFrame>& scratch)
+{
+	std::vector<TakePtr> takes;
+	{
+		QMutexLocker lock(&m_takesLock);
+		takes = m_takes;
+	}
+
+	bool wrote = false;
+	for (const TakePtr& take : takes)
+	{
+		// no data arrives after finishing was set, so once that was seen,
+		// an empty ring means the take is complete
+		const bool finishing = take->m_finishing.load(std::memory_order_acquire);
+		if (take->flush(scratch))
+		{
+			wrote = true;
+			continue;
+		}
+		if (!finishing) { continue; }
+
+		take->close();
+		{
+			QMutexLocker lock(&m_takesLock);
+			m_takes.erase(std::find(m_takes.begin(), m_takes.end(), take));
+		}
+		{
+			QMutexLocker lock(&m_closedLock);
+			take->m_closed = true;
+			m_closedCondition.wakeAll();
+		}
+		if (take->m_onFinished)
+		{
+			QMutexLocker lock(&m_finishedLock);
+			m_finished.push_back(take);
+			QMetaObject::invokeMethod(this, "deliverFinishedTakes", Qt::QueuedConnection);
+		}
+	}
+	return wrote;
+}
+
+
+
+
+QString DiskRecorder::uniqueFileName(const QString& name, Format format)
+{
+	const QString dir = ConfigManager::inst()->userRecordingsDir();
+	QDir().mkpath(dir);
+
+	QString base = name;
+	base.replace(QRegExp("[^\\w\\- ]"), "_");
+	if (base.isEmpty()) { base = "take"; }
+	base += QDateTime::currentDateTime().toString("-yyyyMMdd-hhmmss");
+
+	const QString extension = "." + fileExtension(format);
+	QString fileName = dir + base + extension;
+	for (int i = 2; QFileInfo::exists(fileName); ++i)
+	{
+		fileName = dir + base + QString("-%1").arg(i) + extension;
+	}
+	return fileName;
+}
+
+
+} // namespace lmms
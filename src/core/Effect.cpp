@@ -23,12 +23,16 @@
  *
  */
 
+#include <algorithm>
+
 #include <QDomElement>
 
 #include "Effect.h"
+#include "BufferManager.h"
 #include "EffectChain.h"
 #include "EffectControls.h"
 #include "EffectView.h"
+#include "PlanarBuffer.h"
 
 #include "ConfigManager.h"
 
@@ -50,11 +54,10 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	m_wetDryModel( 1.0f, -1.0f, 1.0f, 0.01f, this, tr( "Wet/Dry mix" ) ),
 	m_gateModel( 0.0f, 0.0f, 1.0f, 0.01f, this, tr( "Gate" ) ),
 	m_autoQuitModel( 1.0f, 1.0f, 8000.0f, 100.0f, 1.0f, this, tr( "Decay" ) ),
-	m_autoQuitDisabled( false )
+	m_autoQuitDisabled( false ),
+	m_resampleFifoFrames( 0 ),
+	m_resampleHeadroom( 0 )
 {
-	m_srcState[0] = m_srcState[1] = nullptr;
-	reinitSRC();
-	
 	if( ConfigManager::inst()->value( "ui", "disableautoquit").toInt() )
 	{
 		m_autoQuitDisabled = true;
@@ -66,13 +69,6 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 
 Effect::~Effect()
 {
-	for (const auto& state : m_srcState)
-	{
-		if (state != nullptr)
-		{
-			src_delete(state);
-		}
-	}
 }
 
 
@@ -115,6 +111,20 @@ void Effect::loadSettings( const QDomElement & _this )
 
 
 
+bool Effect::processPlanarBuffers( PlanarBuffer & _in, PlanarBuffer & _out,
+							const fpp_t _frames )
+{
+	sampleFrame * buf = BufferManager::acquire();
+	_in.toInterleaved( buf, _frames );
+	const bool running = processAudioBuffer( buf, _frames );
+	_out.fromInterleaved( buf, _frames );
+	BufferManager::release( buf );
+	return running;
+}
+
+
+
+
 Effect * Effect::instantiate( const QString& pluginName,
 				Model * _parent,
 				Descriptor::SubPluginFeatures::Key * _key )
@@ -173,47 +183,82 @@ gui::PluginView * Effect::instantiateView( QWidget * _parent )
 	
 
 
-void Effect::reinitSRC()
+void Effect::setResamplingRate( sample_rate_t _sr )
 {
-	for (auto& state : m_srcState)
+	const sample_rate_t sr = Engine::audioEngine()->processingSampleRate();
+	if( _sr == 0 || _sr >= sr )
 	{
-		if (state != nullptr)
-		{
-			src_delete(state);
-		}
-		int error;
-		const int currentInterpolation = Engine::audioEngine()->currentQualitySettings().libsrcInterpolation();
-		if((state = src_new(currentInterpolation, DEFAULT_CHANNELS, &error)) == nullptr)
-		{
-			qFatal( "Error: src_new() failed in effect.cpp!\n" );
-		}
+		m_resampleDown.reset();
+		m_resampleBack.reset();
+		m_resampleFifo.clear();
+		m_resampleFifoFrames = 0;
+		m_resampleHeadroom = 0;
+		return;
 	}
+
+	m_resampleDown = std::make_unique<PolyphaseResampler>( sr, _sr );
+	m_resampleBack = std::make_unique<PolyphaseResampler>( _sr, sr );
+
+	// the number of frames sampleDown() returns differs by one from period
+	// to period, which sampleBack() turns into up to ceil(sr / _sr) frames
+	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+	m_resampleHeadroom = static_cast<f_cnt_t>( ( sr + _sr - 1 ) / _sr ) + 2;
+	m_resampleFifo.assign( fpp + m_resampleHeadroom +
+			m_resampleBack->maxOutput( maxResampledFrames() ), sampleFrame{} );
+	m_resampleFifoFrames = m_resampleHeadroom;
 }
 
 
 
 
-void Effect::resample( int _i, const sampleFrame * _src_buf,
-							sample_rate_t _src_sr,
-				sampleFrame * _dst_buf, sample_rate_t _dst_sr,
-								f_cnt_t _frames )
+f_cnt_t Effect::sampleDown( const sampleFrame * _src_buf, sampleFrame * _dst_buf )
 {
-	if( m_srcState[_i] == nullptr )
-	{
-		return;
-	}
-	m_srcData[_i].input_frames = _frames;
-	m_srcData[_i].output_frames = Engine::audioEngine()->framesPerPeriod();
-	m_srcData[_i].data_in = const_cast<float*>(_src_buf[0].data());
-	m_srcData[_i].data_out = _dst_buf[0].data ();
-	m_srcData[_i].src_ratio = (double) _dst_sr / _src_sr;
-	m_srcData[_i].end_of_input = 0;
-	int error;
-	if( ( error = src_process( m_srcState[_i], &m_srcData[_i] ) ) )
+	return m_resampleDown->process( _src_buf,
+			Engine::audioEngine()->framesPerPeriod(), _dst_buf );
+}
+
+
+
+
+void Effect::sampleBack( const sampleFrame * _src_buf, f_cnt_t _frames,
+							sampleFrame * _dst_buf )
+{
+	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+	sampleFrame * fifo = m_resampleFifo.data();
+	m_resampleFifoFrames += m_resampleBack->process( _src_buf, _frames,
+						fifo + m_resampleFifoFrames );
+
+	const f_cnt_t frames = qMin<f_cnt_t>( fpp, m_resampleFifoFrames );
+	std::copy( fifo, fifo + frames, _dst_buf );
+	// only if the headroom doesn't suffice, which it should
+	std::fill( _dst_buf + frames, _dst_buf + fpp, sampleFrame{} );
+
+	m_resampleFifoFrames -= frames;
+	std::copy( fifo + frames, fifo + frames + m_resampleFifoFrames, fifo );
+}
+
+
+
+
+f_cnt_t Effect::maxResampledFrames() const
+{
+	return m_resampleDown ?
+		m_resampleDown->maxOutput( Engine::audioEngine()->framesPerPeriod() ) : 0;
+}
+
+
+
+
+f_cnt_t Effect::resamplingLatency() const
+{
+	if( !isResampling() )
 	{
-		qFatal( "Effect::resample(): error while resampling: %s\n",
-							src_strerror( error ) );
+		return 0;
 	}
+	// the latency of sampleBack() is given at the rate of the effect
+	const double back = m_resampleBack->latency() * m_resampleBack->ratio();
+	return static_cast<f_cnt_t>( m_resampleDown->latency() + back + 0.5 ) +
+							m_resampleHeadroom;
 }
 
 } // namespace lmms
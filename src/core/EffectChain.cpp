@@ -24,12 +24,18 @@
  */
 
 
+#include <utility>
+
 #include <QDomElement>
 
 #include "EffectChain.h"
+#include "AudioEngine.h"
 #include "Effect.h"
 #include "DummyEffect.h"
+#include "Engine.h"
 #include "MixHelpers.h"
+#include "Plugin.h"
+#include "PluginLoaderThread.h"
 
 namespace lmms
 {
@@ -38,8 +44,22 @@ namespace lmms
 EffectChain::EffectChain( Model * _parent ) :
 	Model( _parent ),
 	SerializingObject(),
-	m_enabledModel( false, nullptr, tr( "Effects enabled" ) )
+	m_enabledModel( false, nullptr, tr( "Effects enabled" ) ),
+	m_holdingEffects( false )
 {
+	for( auto & buffer : m_planarBuffers )
+	{
+		buffer.reserve( Engine::audioEngine()->framesPerPeriod() );
+	}
+
+	// the effects of a disabled chain may not have been instantiated while
+	// loading, which only happens if the chain was neither automated nor
+	// controlled. Automation added since enables it on another thread,
+	// which the automatic connection queues.
+	connect( &m_enabledModel, &BoolModel::dataChanged, this, [this]
+	{
+		if( m_enabledModel.value() ) { loadPendingEffects(); }
+	} );
 }
 
 
@@ -56,6 +76,20 @@ EffectChain::~EffectChain()
 void EffectChain::saveSettings( QDomDocument & _doc, QDomElement & _this )
 {
 	m_enabledModel.saveSettings( _doc, _this, "enabled" );
+
+	if( hasPendingEffects() )
+	{
+		// save them just as they were loaded
+		const QDomElement pending = m_pendingEffects.documentElement();
+		_this.setAttribute( "numofeffects", pending.attribute( "numofeffects" ) );
+		for( QDomElement ef = pending.firstChildElement( "effect" ); !ef.isNull();
+			ef = ef.nextSiblingElement( "effect" ) )
+		{
+			_this.appendChild( _doc.importNode( ef, true ) );
+		}
+		return;
+	}
+
 	_this.setAttribute( "numofeffects", m_effects.count() );
 
 	for( Effect* effect : m_effects)
@@ -81,6 +115,35 @@ void EffectChain::loadSettings( const QDomElement & _this )
 
 	m_enabledModel.loadSettings( _this, "enabled" );
 
+	// a disabled chain doesn't need its effects until it's enabled, unless
+	// automation or a controller may enable it or refers to an effect
+	if( !m_enabledModel.value() && _this.attribute( "numofeffects" ).toInt() > 0
+		&& Plugin::deferInstantiation() && Plugin::canDeferInstantiation( _this ) )
+	{
+		m_pendingEffects.appendChild( m_pendingEffects.importNode( _this, true ) );
+	}
+	else
+	{
+		loadEffects( _this );
+	}
+
+	emit dataChanged();
+}
+
+
+
+
+void EffectChain::loadEffects( const QDomElement & _this )
+{
+	m_effects += createEffects( _this, this );
+}
+
+
+
+
+EffectChain::EffectList EffectChain::createEffects( const QDomElement & _this, EffectChain * chain )
+{
+	EffectList effects;
 	const int plugin_cnt = _this.attribute( "numofeffects" ).toInt();
 
 	QDomNode node = _this.firstChild();
@@ -94,7 +157,7 @@ void EffectChain::loadSettings( const QDomElement & _this )
 			const QString name = effectData.attribute( "name" );
 			EffectKey key( effectData.elementsByTagName( "key" ).item( 0 ).toElement() );
 
-			Effect* e = Effect::instantiate( name.toUtf8(), this, &key );
+			Effect* e = Effect::instantiate( name.toUtf8(), chain, &key );
 
 			if( e != nullptr && e->isOkay() && e->nodeName() == node.nodeName() )
 			{
@@ -103,14 +166,136 @@ void EffectChain::loadSettings( const QDomElement & _this )
 			else
 			{
 				delete e;
-				e = new DummyEffect( parentModel(), effectData );
+				e = new DummyEffect( chain ? chain->parentModel() : nullptr, effectData );
 			}
 
-			m_effects.push_back( e );
+			effects.push_back( e );
 			++fx_loaded;
 		}
 		node = node.nextSibling();
 	}
+	return effects;
+}
+
+
+
+
+void EffectChain::instantiatePendingEffects()
+{
+	m_holdingEffects = false;
+	if( m_effectLoader )
+	{
+		// they are on their way already
+		adoptLoadedEffects();
+		return;
+	}
+	if( !hasPendingEffects() )
+	{
+		return;
+	}
+
+	// the chain keeps processing while the effects are created
+	const EffectList effects = createEffects( m_pendingEffects.documentElement(), this );
+	m_pendingEffects = QDomDocument();
+
+	Engine::audioEngine()->requestChangeInModel();
+	m_effects += effects;
+	Engine::audioEngine()->doneChangeInModel();
+
+	emit dataChanged();
+}
+
+
+
+
+void EffectChain::loadPendingEffects()
+{
+	if( !hasPendingEffects() || m_holdingEffects || m_effectLoader )
+	{
+		return;
+	}
+
+	const QDomElement pending = m_pendingEffects.documentElement();
+	for( QDomElement ef = pending.firstChildElement( "effect" ); !ef.isNull();
+		ef = ef.nextSiblingElement( "effect" ) )
+	{
+		if( !PluginLoaderThread::canLoad( ef.attribute( "name" ) ) )
+		{
+			// only the main thread can tell the user it's missing
+			instantiatePendingEffects();
+			return;
+		}
+	}
+
+	// the loader works on its own copy, the settings are implicitly shared
+	m_effectLoader = std::make_unique<PluginLoaderThread>(
+		[state = m_pendingEffects.cloneNode( true ).toDocument()]
+	{
+		const EffectList effects = createEffects( state.documentElement(), nullptr );
+		return std::vector<Plugin*>( effects.begin(), effects.end() );
+	} );
+	connect( m_effectLoader.get(), SIGNAL(finished()), this, SLOT(effectsLoaded()) );
+	m_effectLoader->start();
+}
+
+
+
+
+void EffectChain::effectsLoaded()
+{
+	// the effects may have been replaced since the loader was started
+	if( m_effectLoader && sender() == m_effectLoader.get() )
+	{
+		adoptLoadedEffects();
+	}
+}
+
+
+
+
+void EffectChain::adoptLoadedEffects()
+{
+	EffectList effects;
+	for( Plugin* plugin : m_effectLoader->takePlugins() )
+	{
+		auto effect = static_cast<Effect*>( plugin );
+		if( dynamic_cast<DummyEffect*>( effect ) )
+		{
+			effect->setParent( parentModel() );
+		}
+		else
+		{
+			effect->m_parent = this;
+			effect->setParent( this );
+		}
+		effects.push_back( effect );
+	}
+	m_effectLoader.reset();
+	m_pendingEffects = QDomDocument();
+
+	Engine::audioEngine()->requestChangeInModel();
+	m_effects += effects;
+	Engine::audioEngine()->doneChangeInModel();
+
+	emit dataChanged();
+}
+
+
+
+
+void EffectChain::holdEffects( const QDomElement & _this )
+{
+	emit aboutToClear();
+	deleteEffects();
+
+	m_pendingEffects = QDomDocument();
+	m_effectLoader.reset();
+	if( _this.attribute( "numofeffects" ).toInt() > 0 )
+	{
+		m_pendingEffects.appendChild( m_pendingEffects.importNode( _this, true ) );
+	}
+	m_holdingEffects = true;
+	m_enabledModel.loadSettings( _this, "enabled" );
 
 	emit dataChanged();
 }
@@ -190,16 +375,57 @@ bool EffectChain::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames, b
 
 	MixHelpers::sanitize( _buf, _frames );
 
+	const bool planarBuffers = Engine::audioEngine()->usesPlanarBuffers();
+	for (auto& buffer : m_planarBuffers)
+	{
+		if (planarBuffers && buffer.capacity() < _frames)
+		{
+			buffer.reserve(_frames);
+		}
+	}
+
+	// the signal is only converted where an effect working on planar
+	// buffers follows one working on sampleFrames or vice versa
+	PlanarBuffer* in = &m_planarBuffers[0];
+	PlanarBuffer* out = &m_planarBuffers[1];
+	bool planar = false;
 	bool moreEffects = false;
 	for (const auto& effect : m_effects)
 	{
-		if (hasInputNoise || effect->isRunning())
+		if (!hasInputNoise && !effect->isRunning())
+		{
+			continue;
+		}
+
+		if (planarBuffers && effect->hasPlanarProcessing())
 		{
+			if (!planar)
+			{
+				in->fromInterleaved(_buf, _frames);
+				planar = true;
+			}
+			moreEffects |= effect->processPlanarBuffers(*in, *out, _frames);
+			MixHelpers::sanitize(*out, _frames);
+			// the output is the input of the next effect
+			std::swap(in, out);
+		}
+		else
+		{
+			if (planar)
+			{
+				in->toInterleaved(_buf, _frames);
+				planar = false;
+			}
 			moreEffects |= effect->processAudioBuffer(_buf, _frames);
 			MixHelpers::sanitize(_buf, _frames);
 		}
 	}
 
+	if (planar)
+	{
+		in->toInterleaved(_buf, _frames);
+	}
+
 	return moreEffects;
 }
 
@@ -222,10 +448,45 @@ void EffectChain::startRunning()
 
 
 
+f_cnt_t EffectChain::latency() const
+{
+	if( m_enabledModel.value() == false )
+	{
+		return 0;
+	}
+
+	f_cnt_t latency = 0;
+	for (const auto& effect : m_effects)
+	{
+		if (effect->isEnabled())
+		{
+			latency += effect->latency();
+		}
+	}
+	return latency;
+}
+
+
+
+
 void EffectChain::clear()
 {
 	emit aboutToClear();
 
+	deleteEffects();
+
+	m_pendingEffects = QDomDocument();
+	m_effectLoader.reset();
+	m_holdingEffects = false;
+
+	m_enabledModel.setValue( false );
+}
+
+
+
+
+void EffectChain::deleteEffects()
+{
 	Engine::audioEngine()->requestChangeInModel();
 
 	while( m_effects.count() )
@@ -236,8 +497,6 @@ void EffectChain::clear()
 	}
 
 	Engine::audioEngine()->doneChangeInModel();
-
-	m_enabledModel.setValue( false );
 }
 
 
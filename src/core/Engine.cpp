@@ -24,8 +24,10 @@
 
 
 #include "Engine.h"
+#include "AnalysisService.h"
 #include "AudioEngine.h"
 #include "ConfigManager.h"
+#include "DiskRecorder.h"
 #include "Mixer.h"
 #include "Ladspa2LMMS.h"
 #include "Lv2Manager.h"
@@ -33,7 +35,9 @@
 #include "Plugin.h"
 #include "PresetPreviewPlayHandle.h"
 #include "ProjectJournal.h"
+#include "SampleIndex.h"
 #include "Song.h"
+#include "TrackFreezer.h"
 #include "BandLimitedWave.h"
 #include "Oscillator.h"
 
@@ -46,6 +50,10 @@ Mixer * Engine::s_mixer = nullptr;
 PatternStore * Engine::s_patternStore = nullptr;
 Song * Engine::s_song = nullptr;
 ProjectJournal * Engine::s_projectJournal = nullptr;
+AnalysisService * Engine::s_analysisService = nullptr;
+DiskRecorder * Engine::s_diskRecorder = nullptr;
+SampleIndex * Engine::s_sampleIndex = nullptr;
+TrackFreezer * Engine::s_trackFreezer = nullptr;
 #ifdef LMMS_HAVE_LV2
 Lv2Manager * Engine::s_lv2Manager = nullptr;
 #endif
@@ -55,7 +63,7 @@ void* Engine::s_dndPluginKey = nullptr;
 
 
 
-void Engine::init( bool renderOnly )
+void Engine::init( bool renderOnly, fpp_t renderBlockSize )
 {
 	Engine *engine = inst();
 
@@ -67,10 +75,17 @@ void Engine::init( bool renderOnly )
 
 	emit engine->initProgress(tr("Initializing data structures"));
 	s_projectJournal = new ProjectJournal;
-	s_audioEngine = new AudioEngine( renderOnly );
+	s_analysisService = new AnalysisService;
+	s_diskRecorder = new DiskRecorder;
+	if( !renderOnly && ConfigManager::inst()->value( "ui", "indexsamplelibrary", "1" ).toInt() )
+	{
+		s_sampleIndex = new SampleIndex;
+	}
+	s_audioEngine = new AudioEngine( renderOnly, renderBlockSize );
 	s_song = new Song;
 	s_mixer = new Mixer;
 	s_patternStore = new PatternStore;
+	s_trackFreezer = new TrackFreezer;
 
 #ifdef LMMS_HAVE_LV2
 	s_lv2Manager = new Lv2Manager;
@@ -101,10 +116,14 @@ void Engine::destroy()
 
 	s_song->clearProject();
 
+	deleteHelper( &s_trackFreezer );
+
 	deleteHelper( &s_patternStore );
 
 	deleteHelper( &s_mixer );
 	deleteHelper( &s_audioEngine );
+	// after the audio engine, which finishes the takes still recording
+	deleteHelper( &s_diskRecorder );
 
 #ifdef LMMS_HAVE_LV2
 	deleteHelper( &s_lv2Manager );
@@ -116,6 +135,9 @@ void Engine::destroy()
 
 	deleteHelper( &s_song );
 
+	deleteHelper( &s_analysisService );
+	deleteHelper( &s_sampleIndex );
+
 	delete ConfigManager::inst();
 
 	// The oscillator FFT plans remain throughout the application lifecycle
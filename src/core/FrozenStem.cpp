@@ -0,0 +1,292 @@
+/*
+ * FrozenStem.cpp - plays the rendered output of a frozen track
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "FrozenStem.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <QMutexLocker>
+
+#include "AudioEngine.h"
+#include "Engine.h"
+#include "SampleStream.h"
+#include "Song.h"
+#include "TimePos.h"
+#include "Track.h"
+
+namespace lmms
+{
+
+
+FrozenStem::FrozenStem(Track* track, const QString& key, const QString& file, mix_ch_t channel, QThreadPool* pool) :
+	PlayHandle(TypeFrozenStemHandle),
+	m_track(track),
+	m_key(key),
+	m_file(file),
+	m_sampleRate(Engine::audioEngine()->processingSampleRate()),
+	m_pool(pool),
+	m_audioPort(track->name(), false, nullptr, nullptr, track->getMutedModel()),
+	m_stream(nullptr),
+	m_requestedFrame(-1),
+	m_position(-1),
+	m_behind(0),
+	m_jumpOffset(-1),
+	m_jumpFrame(0)
+{
+	m_audioPort.setNextMixerChannel(channel);
+	setAudioPort(&m_audioPort);
+}
+
+
+
+
+FrozenStem::~FrozenStem()
+{
+	for (const auto& stream : m_streams)
+	{
+		stream->cancel();
+	}
+}
+
+
+
+
+void FrozenStem::prepare(f_cnt_t frame)
+{
+	QMutexLocker lock(&m_streamsLock);
+	if (hasPrepared(frame)) { return; }
+
+	// drop the oldest prepared streams
+	const SampleStream* playing = m_stream.load(std::memory_order_acquire);
+	const auto isPrepared = [playing](const std::shared_ptr<SampleStream>& stream)
+	{
+		return !stream->isCancelled() && stream.get() != playing;
+	};
+	auto prepared = std::count_if(m_streams.begin(), m_streams.end(), isPrepared);
+	for (auto it = m_streams.begin(); it != m_streams.end() && prepared >= MaxPrepared; ++it)
+	{
+		if (isPrepared(*it))
+		{
+			(*it)->cancel();
+			--prepared;
+		}
+	}
+
+	addStream(frame);
+	m_streams.back()->decodeAhead(m_pool);
+}
+
+
+
+
+void FrozenStem::decodeAhead()
+{
+	QMutexLocker lock(&m_streamsLock);
+
+	// the audio thread doesn't touch the streams it dropped anymore
+	const SampleStream* playing = m_stream.load(std::memory_order_acquire);
+	m_streams.erase(std::remove_if(m_streams.begin(), m_streams.end(),
+		[playing](const std::shared_ptr<SampleStream>& stream)
+		{
+			return stream->isCancelled() && stream.get() != playing;
+		}), m_streams.end());
+
+	const f_cnt_t requested = m_requestedFrame.load(std::memory_order_relaxed);
+	if (requested >= 0 && !hasPrepared(requested))
+	{
+		addStream(requested);
+	}
+
+	for (const auto& stream : m_streams)
+	{
+		stream->decodeAhead(m_pool);
+	}
+}
+
+
+
+
+void FrozenStem::sync(const TimePos& start, f_cnt_t offset)
+{
+	const auto frame = static_cast<f_cnt_t>(start.getTicks() * Engine::framesPerTick());
+	// ticks don't begin on whole frames, so allow for rounding
+	if (m_position < 0 || std::abs(m_position + offset - frame) > 2)
+	{
+		m_jumpOffset = offset;
+		m_jumpFrame = frame;
+	}
+}
+
+
+
+
+void FrozenStem::play(sampleFrame* buffer)
+{
+	const Song* song = Engine::getSong();
+	// exports play the song too, they just don't count as playing
+	if (!(song->isPlaying() || song->isExporting()) || song->playMode() != Song::Mode_PlaySong)
+	{
+		dropStream();
+		m_requestedFrame.store(-1, std::memory_order_relaxed);
+		m_position = -1;
+		m_jumpOffset = -1;
+		return;
+	}
+
+	// the stream for the last jump may have been prepared meanwhile
+	takeStream();
+
+	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+	f_cnt_t done = 0;
+	if (m_jumpOffset >= 0)
+	{
+		// the frames before the jump continue where the song came from
+		done = std::min<f_cnt_t>(m_jumpOffset, fpp);
+		read(buffer, done);
+		seek(m_jumpFrame);
+		m_jumpOffset = -1;
+	}
+	read(buffer + done, fpp - done);
+}
+
+
+
+
+void FrozenStem::seek(f_cnt_t frame)
+{
+	dropStream();
+	m_position = frame;
+	m_behind = 0;
+	m_requestedFrame.store(frame, std::memory_order_relaxed);
+	takeStream();
+}
+
+
+
+
+void FrozenStem::takeStream()
+{
+	const f_cnt_t frame = m_requestedFrame.load(std::memory_order_relaxed);
+	if (frame < 0 || m_stream.load(std::memory_order_relaxed) != nullptr) { return; }
+
+	// playback never waits for the GUI, exports must not miss anything
+	// and start the stream themselves
+	const bool exporting = Engine::getSong()->isExporting();
+	if (exporting) { m_streamsLock.lock(); }
+	else if (!m_streamsLock.tryLock()) { return; }
+
+	if (exporting && !hasPrepared(frame)) { addStream(frame); }
+
+	auto it = std::find_if(m_streams.begin(), m_streams.end(),
+		[frame](const std::shared_ptr<SampleStream>& stream)
+		{
+			return stream->startFrame() == frame && !stream->isCancelled();
+		});
+	if (it != m_streams.end())
+	{
+		m_stream.store(it->get(), std::memory_order_release);
+		m_requestedFrame.store(-1, std::memory_order_relaxed);
+		// drop what should have been played while there was no stream
+		m_behind = m_position - frame;
+	}
+	m_streamsLock.unlock();
+}
+
+
+
+
+void FrozenStem::dropStream()
+{
+	if (SampleStream* stream = m_stream.load(std::memory_order_relaxed))
+	{
+		stream->cancel();
+		m_stream.store(nullptr, std::memory_order_release);
+	}
+}
+
+
+
+
+void FrozenStem::read(sampleFrame* dst, f_cnt_t frames)
+{
+	if (frames <= 0) { return; }
+	SampleStream* stream = m_stream.load(std::memory_order_relaxed);
+	if (m_position < 0 || !stream)
+	{
+		std::fill(dst, dst + frames, sampleFrame{});
+		if (m_position >= 0) { m_position += frames; }
+		return;
+	}
+
+	// drop what should have been played while the stream was starting
+	while (m_behind > 0)
+	{
+		const f_cnt_t dropped = stream->read(dst, std::min(m_behind, frames));
+		if (dropped == 0) { break; }
+		m_behind -= dropped;
+	}
+
+	f_cnt_t count = stream->read(dst, frames);
+	// an export must not miss anything, it waits for the decoder instead
+	while (count < frames && m_behind == 0 && Engine::getSong()->isExporting() && !stream->isFinished())
+	{
+		stream->waitForFrames();
+		count += stream->read(dst + count, frames - count);
+	}
+
+	if (count < frames)
+	{
+		std::fill(dst + count, dst + frames, sampleFrame{});
+		if (!stream->isFinished())
+		{
+			m_behind += frames - count;
+		}
+	}
+	m_position += frames;
+}
+
+
+
+
+bool FrozenStem::hasPrepared(f_cnt_t frame) const
+{
+	const SampleStream* playing = m_stream.load(std::memory_order_acquire);
+	return std::any_of(m_streams.begin(), m_streams.end(),
+		[frame, playing](const std::shared_ptr<SampleStream>& stream)
+		{
+			return stream->startFrame() == frame && !stream->isCancelled() && stream.get() != playing;
+		});
+}
+
+
+
+
+void FrozenStem::addStream(f_cnt_t frame)
+{
+	m_streams.push_back(std::make_shared<SampleStream>(m_file, m_sampleRate, frame));
+}
+
+
+} // namespace lmms
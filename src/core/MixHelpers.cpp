@@ -24,13 +24,10 @@
 
 #include "MixHelpers.h"
 
-#ifdef LMMS_DEBUG
-#include <cstdio>
-#endif
-
 #include <cmath>
-#include <QtGlobal>
 
+#include "MixKernels.h"
+#include "PlanarBuffer.h"
 #include "ValueBuffer.h"
 
 
@@ -41,6 +38,19 @@ static bool s_NaNHandler;
 namespace lmms::MixHelpers
 {
 
+// sampleFrames are plain arrays of floats, stored without padding
+static_assert( sizeof( sampleFrame ) == DEFAULT_CHANNELS * sizeof( float ) );
+
+static inline float* samples( sampleFrame* frames )
+{
+	return reinterpret_cast<float*>( frames );
+}
+
+static inline const float* samples( const sampleFrame* frames )
+{
+	return reinterpret_cast<const float*>( frames );
+}
+
 /*! \brief Function for applying MIXOP on all sample frames */
 template<typename MIXOP>
 static inline void run( sampleFrame* dst, const sampleFrame* src, int frames, const MIXOP& OP )
@@ -66,17 +76,7 @@ static inline void run( sampleFrame* dst, const sample_t* srcLeft, const sample_
 
 bool isSilent( const sampleFrame* src, int frames )
 {
-	const float silenceThreshold = 0.0000001f;
-
-	for( int i = 0; i < frames; ++i )
-	{
-		if( fabsf( src[i][0] ) >= silenceThreshold || fabsf( src[i][1] ) >= silenceThreshold )
-		{
-			return false;
-		}
-	}
-
-	return true;
+	return MixKernels::kernels().isSilent( samples( src ), frames * DEFAULT_CHANNELS );
 }
 
 bool useNaNHandler()
@@ -97,71 +97,50 @@ bool sanitize( sampleFrame * src, int frames )
 		return false;
 	}
 
-	bool found = false;
-	for( int f = 0; f < frames; ++f )
-	{
-		for( int c = 0; c < 2; ++c )
-		{
-			if( std::isinf( src[f][c] ) || std::isnan( src[f][c] ) )
-			{
-				#ifdef LMMS_DEBUG
-					// TODO don't use printf here
-					printf("Bad data, clearing buffer. frame: ");
-					printf("%d: value %f\n", f, src[f][c]);
-				#endif
-				for( int f = 0; f < frames; ++f )
-				{
-					for( int c = 0; c < 2; ++c )
-					{
-						src[f][c] = 0.0f;
-					}
-				}
-				found = true;
-				return found;
-			}
-			else
-			{
-				src[f][c] = qBound( -1000.0f, src[f][c], 1000.0f );
-			}
-		}
-	}
-	return found;
+	return MixKernels::kernels().sanitize( samples( src ), frames * DEFAULT_CHANNELS );
 }
 
 
-struct AddOp
+bool sanitize( PlanarBuffer & buffer, int frames )
 {
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+	if( !useNaNHandler() )
 	{
-		dst[0] += src[0];
-		dst[1] += src[1];
+		return false;
 	}
-} ;
+
+	bool found = false;
+	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	{
+		found |= MixKernels::kernels().sanitize( buffer.channel( ch ), frames );
+	}
+	if( found )
+	{
+		buffer.clear( frames );
+	}
+	return found;
+}
+
 
 void add( sampleFrame* dst, const sampleFrame* src, int frames )
 {
-	run<>( dst, src, frames, AddOp() );
+	MixKernels::kernels().add( samples( dst ), samples( src ), frames * DEFAULT_CHANNELS );
 }
 
 
 
-struct AddMultipliedOp
+void peak( const sampleFrame* src, int frames, float& peakLeft, float& peakRight )
 {
-	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+	float peaks[2] = { peakLeft, peakRight };
+	MixKernels::kernels().peak( samples( src ), frames * DEFAULT_CHANNELS, peaks );
+	peakLeft = peaks[0];
+	peakRight = peaks[1];
+}
 
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
-	{
-		dst[0] += src[0] * m_coeff;
-		dst[1] += src[1] * m_coeff;
-	}
-
-	const float m_coeff;
-} ;
 
 
 void addMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
+	MixKernels::kernels().addMultiplied( samples( dst ), samples( src ), coeffSrc, frames * DEFAULT_CHANNELS );
 }
 
 
@@ -241,19 +220,6 @@ void addSanitizedMultipliedByBuffers( sampleFrame* dst, const sampleFrame* src,
 }
 
 
-struct AddSanitizedMultipliedOp
-{
-	AddSanitizedMultipliedOp( float coeff ) : m_coeff( coeff ) { }
-
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
-	{
-		dst[0] += ( std::isinf( src[0] ) || std::isnan( src[0] ) ) ? 0.0f : src[0] * m_coeff;
-		dst[1] += ( std::isinf( src[1] ) || std::isnan( src[1] ) ) ? 0.0f : src[1] * m_coeff;
-	}
-
-	const float m_coeff;
-};
-
 void addSanitizedMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames )
 {
 	if ( !useNaNHandler() )
@@ -262,7 +228,8 @@ void addSanitizedMultiplied( sampleFrame* dst, const sampleFrame* src, float coe
 		return;
 	}
 
-	run<>( dst, src, frames, AddSanitizedMultipliedOp(coeffSrc) );
+	MixKernels::kernels().addSanitizedMultiplied( samples( dst ), samples( src ), coeffSrc,
+							frames * DEFAULT_CHANNELS );
 }
 
 
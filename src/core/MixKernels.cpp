@@ -0,0 +1,283 @@
+/*
+ * MixKernels.cpp - scalar reference kernels and runtime kernel selection
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "lmmsconfig.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#define LMMS_HAVE_SIMD_MIX_KERNELS
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace lmms::MixKernels
+{
+
+namespace
+{
+
+
+// The loops MixHelpers and AudioDevice used before the kernels were
+// introduced. They define the results all other implementations must give.
+
+bool isFinite(float x)
+{
+	return !std::isinf(x) && !std::isnan(x);
+}
+
+void add(float* dst, const float* src, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		dst[i] += src[i];
+	}
+}
+
+void addMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		dst[i] += src[i] * coeff;
+	}
+}
+
+void addSanitizedMultiplied(float* dst, const float* src, float coeff, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		dst[i] += isFinite(src[i]) ? src[i] * coeff : 0.0f;
+	}
+}
+
+bool sanitize(float* data, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (!isFinite(data[i]))
+		{
+			std::fill(data, data + count, 0.0f);
+			return true;
+		}
+		data[i] = std::max(-SanitizeLimit, std::min(SanitizeLimit, data[i]));
+	}
+	return false;
+}
+
+bool isSilent(const float* data, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (std::abs(data[i]) >= SilenceThreshold)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void peak(const float* data, std::size_t count, float* peaks)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		peaks[i & 1] = std::max(peaks[i & 1], std::abs(data[i]));
+	}
+}
+
+void convertToS16(const float* src, std::size_t count, float gain, int16_t* dst, bool swapBytes)
+{
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		float clipped = src[i] * gain;
+		if (clipped > 1.0f) { clipped = 1.0f; }
+		else if (clipped < -1.0f) { clipped = -1.0f; }
+		const auto value = static_cast<int16_t>(clipped * 32767.0f);
+		dst[i] = swapBytes ? static_cast<int16_t>((value & 0x00ff) << 8 | (value & 0xff00) >> 8) : value;
+	}
+}
+
+void deinterleave(const float* src, float* left, float* right, std::size_t frames)
+{
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		left[f] = src[2 * f];
+		right[f] = src[2 * f + 1];
+	}
+}
+
+void interleave(const float* left, const float* right, float* dst, std::size_t frames)
+{
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		dst[2 * f] = left[f];
+		dst[2 * f + 1] = right[f];
+	}
+}
+
+const KernelTable s_scalarKernels = {
+	&add,
+	&addMultiplied,
+	&addSanitizedMultiplied,
+	&sanitize,
+	&isSilent,
+	&peak,
+	&convertToS16,
+	&deinterleave,
+	&interleave
+};
+
+
+
+
+bool cpuSupports(InstructionSet set)
+{
+#ifdef LMMS_HAVE_SIMD_MIX_KERNELS
+#if defined(__GNUC__)
+	// also checks whether the OS saves the wider registers
+	__builtin_cpu_init();
+	switch (set)
+	{
+		case InstructionSet::Scalar: return true;
+		case InstructionSet::Sse2: return __builtin_cpu_supports("sse2");
+		case InstructionSet::Avx2: return __builtin_cpu_supports("avx2");
+		case InstructionSet::Avx512: return __builtin_cpu_supports("avx512f");
+	}
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	const bool sse2 = info[3] & (1 << 26);
+	const bool osSavesRegisters = info[2] & (1 << 27);
+	const bool avx = info[2] & (1 << 28);
+	const unsigned long long enabledStates = osSavesRegisters ? _xgetbv(0) : 0;
+
+	bool avx2 = false;
+	bool avx512 = false;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = avx && (info[1] & (1 << 5)) && (enabledStates & 0x06) == 0x06;
+		avx512 = (info[1] & (1 << 16)) && (enabledStates & 0xe6) == 0xe6;
+	}
+
+	switch (set)
+	{
+		case InstructionSet::Scalar: return true;
+		case InstructionSet::Sse2: return sse2;
+		case InstructionSet::Avx2: return avx2;
+		case InstructionSet::Avx512: return avx512;
+	}
+#endif
+#endif
+	return set == InstructionSet::Scalar;
+}
+
+
+
+
+InstructionSet selectInstructionSet()
+{
+	InstructionSet limit = InstructionSet::Avx512;
+	if (const char* requested = std::getenv("LMMS_MIX_KERNELS"))
+	{
+		for (auto set : { InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Avx512 })
+		{
+			if (std::strcmp(requested, name(set)) == 0) { limit = set; }
+		}
+	}
+
+	for (auto set : { InstructionSet::Avx512, InstructionSet::Avx2, InstructionSet::Sse2 })
+	{
+		if (set <= limit && kernels(set) != nullptr) { return set; }
+	}
+	return InstructionSet::Scalar;
+}
+
+
+} // namespace
+
+
+
+
+const KernelTable& kernels()
+{
+	static const KernelTable& selected = *kernels(instructionSet());
+	return selected;
+}
+
+
+
+
+InstructionSet instructionSet()
+{
+	static const InstructionSet selected = selectInstructionSet();
+	return selected;
+}
+
+
+
+
+const KernelTable* kernels(InstructionSet set)
+{
+	if (!cpuSupports(set)) { return nullptr; }
+
+	switch (set)
+	{
+		case InstructionSet::Scalar: return &s_scalarKernels;
+#ifdef LMMS_HAVE_SIMD_MIX_KERNELS
+		case InstructionSet::Sse2: return detail::sse2Kernels();
+		case InstructionSet::Avx2: return detail::avx2Kernels();
+		case InstructionSet::Avx512: return detail::avx512Kernels();
+#else
+		default: break;
+#endif
+	}
+	return nullptr;
+}
+
+
+
+
+const char* name(InstructionSet set)
+{
+	switch (set)
+	{
+		case InstructionSet::Scalar: return "scalar";
+		case InstructionSet::Sse2: return "sse2";
+		case InstructionSet::Avx2: return "avx2";
+		case InstructionSet::Avx512: return "avx512";
+	}
+	return "unknown";
+}
+
+
+} // namespace lmms::MixKernels
@@ -0,0 +1,110 @@
+/*
+ * MixKernelsAvx2.cpp - MixKernels for AVX2
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <immintrin.h>
+
+#include "MixKernelsSimd.h"
+
+namespace lmms::MixKernels
+{
+
+namespace
+{
+
+
+struct Avx2
+{
+	using Reg = __m256;
+	static constexpr std::size_t Width = 8;
+
+	static Reg load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Reg x) { _mm256_storeu_ps(p, x); }
+	static Reg set1(float x) { return _mm256_set1_ps(x); }
+	static Reg zero() { return _mm256_setzero_ps(); }
+
+	static Reg add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+	static Reg mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+	static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+	static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+
+	static Reg abs(Reg x)
+	{
+		return _mm256_and_ps(x, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+	}
+
+	static Reg finiteMask(Reg x)
+	{
+		// the exponent of infinities and NaNs is all ones
+		return _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(0x7f800000),
+								_mm256_castps_si256(abs(x))));
+	}
+
+	static Reg zeroNonFinite(Reg x, Reg s) { return _mm256_and_ps(x, finiteMask(s)); }
+	static bool anyNonFinite(Reg x) { return _mm256_movemask_ps(finiteMask(x)) != 0xff; }
+
+	static bool anyGreaterEqual(Reg a, Reg b)
+	{
+		return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ)) != 0;
+	}
+
+	static void storeS16(int16_t* p, Reg x, bool swapBytes)
+	{
+		const __m256i values = _mm256_cvttps_epi32(x);
+		__m128i samples = _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+		if (swapBytes)
+		{
+			samples = _mm_or_si128(_mm_slli_epi16(samples, 8), _mm_srli_epi16(samples, 8));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p), samples);
+	}
+
+	static void deinterleave(Reg a, Reg b, Reg& even, Reg& odd)
+	{
+		// the shuffles work within 128 bit lanes, reorder their 64 bit halves
+		even = _mm256_castpd_ps(_mm256_permute4x64_pd(
+			_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+		odd = _mm256_castpd_ps(_mm256_permute4x64_pd(
+			_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+
+	static void interleave(Reg left, Reg right, Reg& first, Reg& second)
+	{
+		const Reg low = _mm256_unpacklo_ps(left, right);
+		const Reg high = _mm256_unpackhi_ps(left, right);
+		first = _mm256_permute2f128_ps(low, high, 0x20);
+		second = _mm256_permute2f128_ps(low, high, 0x31);
+	}
+} ;
+
+
+} // namespace
+
+
+const KernelTable* detail::avx2Kernels()
+{
+	return SimdKernels<Avx2>::table();
+}
+
+
+} // namespace lmms::MixKernels
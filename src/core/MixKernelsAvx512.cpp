@@ -0,0 +1,106 @@
+/*
+ * MixKernelsAvx512.cpp - MixKernels for AVX-512
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <immintrin.h>
+
+#include "MixKernelsSimd.h"
+
+namespace lmms::MixKernels
+{
+
+namespace
+{
+
+
+//! Only uses AVX-512F, available on all CPUs with AVX-512
+struct Avx512
+{
+	using Reg = __m512;
+	static constexpr std::size_t Width = 16;
+
+	static Reg load(const float* p) { return _mm512_loadu_ps(p); }
+	static void store(float* p, Reg x) { _mm512_storeu_ps(p, x); }
+	static Reg set1(float x) { return _mm512_set1_ps(x); }
+	static Reg zero() { return _mm512_setzero_ps(); }
+
+	static Reg add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+	static Reg mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+	static Reg min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+	static Reg max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+
+	static Reg abs(Reg x)
+	{
+		// _mm512_and_ps needs AVX-512DQ
+		return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32(0x7fffffff)));
+	}
+
+	static __mmask16 finiteMask(Reg x)
+	{
+		// the exponent of infinities and NaNs is all ones
+		return _mm512_cmplt_epi32_mask(_mm512_castps_si512(abs(x)), _mm512_set1_epi32(0x7f800000));
+	}
+
+	static Reg zeroNonFinite(Reg x, Reg s) { return _mm512_maskz_mov_ps(finiteMask(s), x); }
+	static bool anyNonFinite(Reg x) { return finiteMask(x) != 0xffff; }
+	static bool anyGreaterEqual(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GE_OQ) != 0; }
+
+	static void storeS16(int16_t* p, Reg x, bool swapBytes)
+	{
+		__m256i samples = _mm512_cvtsepi32_epi16(_mm512_cvttps_epi32(x));
+		if (swapBytes)
+		{
+			samples = _mm256_or_si256(_mm256_slli_epi16(samples, 8), _mm256_srli_epi16(samples, 8));
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), samples);
+	}
+
+	static void deinterleave(Reg a, Reg b, Reg& even, Reg& odd)
+	{
+		// indices from 16 on select from b
+		const __m512i evenIndices = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+		const __m512i oddIndices = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+		even = _mm512_permutex2var_ps(a, evenIndices, b);
+		odd = _mm512_permutex2var_ps(a, oddIndices, b);
+	}
+
+	static void interleave(Reg left, Reg right, Reg& first, Reg& second)
+	{
+		const __m512i firstIndices = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+		const __m512i secondIndices = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+		first = _mm512_permutex2var_ps(left, firstIndices, right);
+		second = _mm512_permutex2var_ps(left, secondIndices, right);
+	}
+} ;
+
+
+} // namespace
+
+
+const KernelTable* detail::avx512Kernels()
+{
+	return SimdKernels<Avx512>::table();
+}
+
+
+} // namespace lmms::MixKernels
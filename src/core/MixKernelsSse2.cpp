@@ -0,0 +1,100 @@
+/*
+ * MixKernelsSse2.cpp - MixKernels for SSE2
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <emmintrin.h>
+
+#include "MixKernelsSimd.h"
+
+namespace lmms::MixKernels
+{
+
+namespace
+{
+
+
+struct Sse2
+{
+	using Reg = __m128;
+	static constexpr std::size_t Width = 4;
+
+	static Reg load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Reg x) { _mm_storeu_ps(p, x); }
+	static Reg set1(float x) { return _mm_set1_ps(x); }
+	static Reg zero() { return _mm_setzero_ps(); }
+
+	static Reg add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+	static Reg mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+	static Reg min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+	static Reg max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+
+	static Reg abs(Reg x)
+	{
+		return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+	}
+
+	static Reg finiteMask(Reg x)
+	{
+		// the exponent of infinities and NaNs is all ones
+		return _mm_castsi128_ps(_mm_cmplt_epi32(_mm_castps_si128(abs(x)), _mm_set1_epi32(0x7f800000)));
+	}
+
+	static Reg zeroNonFinite(Reg x, Reg s) { return _mm_and_ps(x, finiteMask(s)); }
+	static bool anyNonFinite(Reg x) { return _mm_movemask_ps(finiteMask(x)) != 0xf; }
+	static bool anyGreaterEqual(Reg a, Reg b) { return _mm_movemask_ps(_mm_cmpge_ps(a, b)) != 0; }
+
+	static void storeS16(int16_t* p, Reg x, bool swapBytes)
+	{
+		const __m128i values = _mm_cvttps_epi32(x);
+		__m128i samples = _mm_packs_epi32(values, values);
+		if (swapBytes)
+		{
+			samples = _mm_or_si128(_mm_slli_epi16(samples, 8), _mm_srli_epi16(samples, 8));
+		}
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(p), samples);
+	}
+
+	static void deinterleave(Reg a, Reg b, Reg& even, Reg& odd)
+	{
+		even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+	}
+
+	static void interleave(Reg left, Reg right, Reg& first, Reg& second)
+	{
+		first = _mm_unpacklo_ps(left, right);
+		second = _mm_unpackhi_ps(left, right);
+	}
+} ;
+
+
+} // namespace
+
+
+const KernelTable* detail::sse2Kernels()
+{
+	return SimdKernels<Sse2>::table();
+}
+
+
+} // namespace lmms::MixKernels
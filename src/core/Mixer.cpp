@@ -24,9 +24,12 @@
 
 #include <QDomElement>
 
+#include "AudioDevice.h"
 #include "AudioEngine.h"
 #include "AudioEngineWorkerThread.h"
+#include "AudioPort.h"
 #include "BufferManager.h"
+#include "ConfigManager.h"
 #include "Mixer.h"
 #include "MixHelpers.h"
 #include "Song.h"
@@ -62,8 +65,6 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_fxChain( nullptr ),
 	m_hasInput( false ),
 	m_stillRunning( false ),
-	m_peakLeft( 0.0f ),
-	m_peakRight( 0.0f ),
 	m_buffer( new sampleFrame[Engine::audioEngine()->framesPerPeriod()] ),
 	m_muteModel( false, _parent ),
 	m_soloModel( false, _parent ),
@@ -72,6 +73,9 @@ MixerChannel::MixerChannel( int idx, Model * _parent ) :
 	m_lock(),
 	m_channelIndex( idx ),
 	m_queued( false ),
+	m_inputLatency( 0 ),
+	m_latency( 0 ),
+	m_latencyUpdated( false ),
 	m_hasColor( false ),
 	m_dependenciesMet(0)
 {
@@ -128,42 +132,56 @@ void MixerChannel::doProcessing()
 			FloatModel * sendModel = senderRoute->amount();
 			if( ! sendModel ) qFatal( "Error: no send model found from %d to %d", senderRoute->senderIndex(), m_channelIndex );
 
-			if( sender->m_hasInput || sender->m_stillRunning )
+			const bool senderActive = sender->m_hasInput || sender->m_stillRunning;
+			CompensationDelay * compensation = senderRoute->compensation();
+			if( senderActive || compensation->isPending() )
 			{
 				// figure out if we're getting sample-exact input
 				ValueBuffer * sendBuf = sendModel->valueBuffer();
 				ValueBuffer * volBuf = sender->m_volumeModel.valueBuffer();
 
-				// mix it's output with this one's output
+				// mix it's output with this one's output, going through a
+				// temporary buffer if the route has to be delayed
 				sampleFrame * ch_buf = sender->m_buffer;
+				sampleFrame * target = m_buffer;
+				if( compensation->delay() > 0 )
+				{
+					target = BufferManager::acquire();
+					BufferManager::clear( target, fpp );
+				}
 
 				// use sample-exact mixing if sample-exact values are available
 				if( ! volBuf && ! sendBuf ) // neither volume nor send has sample-exact data...
 				{
 					const float v = sender->m_volumeModel.value() * sendModel->value();
-					MixHelpers::addSanitizedMultiplied( m_buffer, ch_buf, v, fpp );
+					MixHelpers::addSanitizedMultiplied( target, ch_buf, v, fpp );
 				}
 				else if( volBuf && sendBuf ) // both volume and send have sample-exact data
 				{
-					MixHelpers::addSanitizedMultipliedByBuffers( m_buffer, ch_buf, volBuf, sendBuf, fpp );
+					MixHelpers::addSanitizedMultipliedByBuffers( target, ch_buf, volBuf, sendBuf, fpp );
 				}
 				else if( volBuf ) // volume has sample-exact data but send does not
 				{
 					const float v = sendModel->value();
-					MixHelpers::addSanitizedMultipliedByBuffer( m_buffer, ch_buf, v, volBuf, fpp );
+					MixHelpers::addSanitizedMultipliedByBuffer( target, ch_buf, v, volBuf, fpp );
 				}
 				else // vice versa
 				{
 					const float v = sender->m_volumeModel.value();
-					MixHelpers::addSanitizedMultipliedByBuffer( m_buffer, ch_buf, v, sendBuf, fpp );
+					MixHelpers::addSanitizedMultipliedByBuffer( target, ch_buf, v, sendBuf, fpp );
+				}
+
+				if( target != m_buffer )
+				{
+					compensation->process( target, fpp, senderActive );
+					MixHelpers::add( m_buffer, target, fpp );
+					BufferManager::release( target );
 				}
 				m_hasInput = true;
 			}
 		}
 
 
-		const float v = m_volumeModel.value();
-
 		if( m_hasInput )
 		{
 			// only start fxchain when we have input...
@@ -172,13 +190,8 @@ void MixerChannel::doProcessing()
 
 		m_stillRunning = m_fxChain.processAudioBuffer( m_buffer, fpp, m_hasInput );
 
-		AudioEngine::StereoSample peakSamples = Engine::audioEngine()->getPeakValues(m_buffer, fpp);
-		m_peakLeft = qMax( m_peakLeft, peakSamples.left * v );
-		m_peakRight = qMax( m_peakRight, peakSamples.right * v );
-	}
-	else
-	{
-		m_peakLeft = m_peakRight = 0.0f;
+		// peaks are measured by the analysis service, not here
+		m_analysisTap.write( m_buffer, fpp );
 	}
 
 	// increment dependency counter of all receivers
@@ -190,11 +203,16 @@ void MixerChannel::doProcessing()
 Mixer::Mixer() :
 	Model( nullptr ),
 	JournallingObject(),
-	m_mixerChannels()
+	m_mixerChannels(),
+	m_delayCompensation( ConfigManager::inst()->value( "audioengine", "delaycompensation", "1" ).toInt() ),
+	m_reservePending( false )
 {
 	// create master channel
 	createChannel();
 	m_lastSoloed = -1;
+
+	connect( this, SIGNAL(compensationDelaysTooShort()),
+			this, SLOT(reserveCompensationDelays()), Qt::QueuedConnection );
 }
 
 
@@ -224,6 +242,8 @@ int Mixer::createChannel()
 	// reset channel state
 	clearChannel( index );
 
+	emit channelsChanged();
+
 	return index;
 }
 
@@ -365,6 +385,8 @@ void Mixer::deleteChannel( int index )
 	}
 
 	Engine::audioEngine()->doneChangeInModel();
+
+	emit channelsChanged();
 }
 
 
@@ -595,6 +617,108 @@ void Mixer::prepareMasterMix()
 {
 	BufferManager::clear( m_mixerChannels[0]->m_buffer,
 					Engine::audioEngine()->framesPerPeriod() );
+
+	updateLatencyCompensation();
+}
+
+
+
+
+void Mixer::updateLatencyCompensation()
+{
+	// plugins may change their latency at any time, so this runs every
+	// period - delays are only touched when the latencies actually change
+	const QVector<AudioPort *> & ports = Engine::audioEngine()->audioPorts();
+
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		ch->m_inputLatency = 0;
+		ch->m_latencyUpdated = false;
+	}
+
+	m_portLatencies.resize( ports.size() );
+	for( int i = 0; i < ports.size(); ++i )
+	{
+		m_portLatencies[i] = ports[i]->latency();
+		const mix_ch_t target = ports[i]->nextMixerChannel();
+		if( target >= 0 && target < numChannels() )
+		{
+			MixerChannel * ch = m_mixerChannels[target];
+			ch->m_inputLatency = qMax( ch->m_inputLatency, m_portLatencies[i] );
+		}
+	}
+
+	for( MixerChannel * ch : m_mixerChannels )
+	{
+		updateChannelLatency( ch );
+	}
+
+	// delay every input to the latency of the slowest one of its channel
+	for( int i = 0; i < ports.size(); ++i )
+	{
+		const mix_ch_t target = ports[i]->nextMixerChannel();
+		const bool valid = target >= 0 && target < numChannels();
+		ports[i]->setCompensation( m_delayCompensation && valid
+			? m_mixerChannels[target]->m_inputLatency - m_portLatencies[i] : 0 );
+	}
+
+	bool tooShort = false;
+	for( int i = 0; i < ports.size(); ++i )
+	{
+		tooShort = tooShort || ports[i]->needsCompensationReserve();
+	}
+	for( MixerRoute * route : m_mixerRoutes )
+	{
+		route->compensation()->setDelay( m_delayCompensation
+			? route->receiver()->m_inputLatency - route->sender()->m_latency : 0 );
+		tooShort = tooShort || route->compensation()->needsReserve();
+	}
+
+	if( tooShort && !m_reservePending.exchange( true ) )
+	{
+		emit compensationDelaysTooShort();
+	}
+}
+
+
+
+
+void Mixer::reserveCompensationDelays()
+{
+	Engine::audioEngine()->requestChangeInModel();
+	// don't ask for what is done right here
+	m_reservePending = true;
+	updateLatencyCompensation();
+	for( AudioPort * port : Engine::audioEngine()->audioPorts() )
+	{
+		port->reserveCompensation();
+	}
+	for( MixerRoute * route : m_mixerRoutes )
+	{
+		route->compensation()->reserve();
+	}
+	m_reservePending = false;
+	Engine::audioEngine()->doneChangeInModel();
+}
+
+
+
+
+void Mixer::updateChannelLatency( MixerChannel * ch )
+{
+	if( ch->m_latencyUpdated )
+	{
+		return;
+	}
+	ch->m_latencyUpdated = true;
+
+	// senders come first, there are no loops in the mixer
+	for( MixerRoute * route : ch->m_receives )
+	{
+		updateChannelLatency( route->sender() );
+		ch->m_inputLatency = qMax<f_cnt_t>( ch->m_inputLatency, route->sender()->m_latency );
+	}
+	ch->m_latency = ch->m_inputLatency + ch->m_fxChain.latency();
 }
 
 
@@ -616,6 +740,11 @@ void Mixer::masterMix( sampleFrame * _buf )
 		ch->m_muted = ch->m_muteModel.value();
 		if( ch->m_muted ) // instantly "process" muted channels
 		{
+			// don't play what was delayed before muting once unmuted
+			for( MixerRoute * route : ch->m_receives )
+			{
+				route->compensation()->clear();
+			}
 			ch->processed();
 			ch->done();
 		}
@@ -662,6 +791,10 @@ void Mixer::masterMix( sampleFrame * _buf )
 		: m_mixerChannels[0]->m_volumeModel.value();
 	MixHelpers::addSanitizedMultiplied( _buf, m_mixerChannels[0]->m_buffer, v, fpp );
 
+	// let the audio device pick up individual channel outputs before
+	// they get cleared
+	Engine::audioEngine()->audioDev()->processExtOutputs();
+
 	// clear all channel buffers and
 	// reset channel process state
 	for( int i = 0; i < numChannels(); ++i)
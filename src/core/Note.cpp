@@ -37,26 +37,24 @@ namespace lmms
 Note::Note( const TimePos & length, const TimePos & pos,
 		int key, volume_t volume, panning_t panning,
 						DetuningHelper * detuning ) :
-	m_selected( false ),
+	m_detuning( nullptr ),
+	m_key( qBound( 0, key, NumKeys ) ),
+	m_length( length ),
+	m_pos( pos ),
 	m_oldKey( qBound( 0, key, NumKeys ) ),
 	m_oldPos( pos ),
 	m_oldLength( length ),
-	m_isPlaying( false ),
-	m_key( qBound( 0, key, NumKeys ) ),
 	m_volume( qBound( MinVolume, volume, MaxVolume ) ),
 	m_panning( qBound( PanningLeft, panning, PanningRight ) ),
-	m_length( length ),
-	m_pos( pos ),
-	m_detuning( nullptr )
+	m_selected( false ),
+	m_isPlaying( false )
 {
+	// the detuning is only created once it's edited, most notes never need
+	// one and it's much larger than the note itself
 	if( detuning )
 	{
 		m_detuning = sharedObject::ref( detuning );
 	}
-	else
-	{
-		createDetuning();
-	}
 }
 
 
@@ -64,17 +62,17 @@ Note::Note( const TimePos & length, const TimePos & pos,
 
 Note::Note( const Note & note ) :
 	SerializingObject( note ),
-	m_selected( note.m_selected ),
+	m_detuning( nullptr ),
+	m_key( note.m_key),
+	m_length( note.m_length ),
+	m_pos( note.m_pos ),
 	m_oldKey( note.m_oldKey ),
 	m_oldPos( note.m_oldPos ),
 	m_oldLength( note.m_oldLength ),
-	m_isPlaying( note.m_isPlaying ),
-	m_key( note.m_key),
 	m_volume( note.m_volume ),
 	m_panning( note.m_panning ),
-	m_length( note.m_length ),
-	m_pos( note.m_pos ),
-	m_detuning( nullptr )
+	m_selected( note.m_selected ),
+	m_isPlaying( note.m_isPlaying )
 {
 	if( note.m_detuning )
 	{
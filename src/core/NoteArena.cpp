@@ -0,0 +1,88 @@
+/*
+ * NoteArena.cpp - contiguous storage for the notes of a clip
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NoteArena.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+
+NoteArena::NoteArena() :
+	m_used(0)
+{
+}
+
+
+
+
+void NoteArena::clear()
+{
+	m_blocks.clear();
+	m_used = 0;
+	m_free.clear();
+	m_free.shrink_to_fit();
+}
+
+
+
+
+std::size_t NoteArena::capacity() const
+{
+	std::size_t slots = 0;
+	for (const Block& block : m_blocks)
+	{
+		slots += block.size;
+	}
+	return slots * sizeof(Slot);
+}
+
+
+
+
+void* NoteArena::allocate()
+{
+	if (!m_free.empty())
+	{
+		void* slot = m_free.back();
+		m_free.pop_back();
+		return slot;
+	}
+
+	if (m_blocks.empty() || m_used == m_blocks.back().size)
+	{
+		// small clips stay small, large ones need few blocks
+		const std::size_t size = m_blocks.empty()
+			? FirstBlockSize
+			: std::min(m_blocks.back().size * 2, MaxBlockSize);
+		m_blocks.push_back({std::make_unique<Slot[]>(size), size});
+		m_used = 0;
+	}
+
+	return &m_blocks.back().slots[m_used++];
+}
+
+
+} // namespace lmms
@@ -0,0 +1,171 @@
+/*
+ * NoteIndex.cpp - finds the notes of a clip by position and key
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "NoteIndex.h"
+
+#include <algorithm>
+
+namespace lmms
+{
+
+
+NoteIndex::NoteIndex(const NoteVector& notes) :
+	m_notes(notes),
+	m_maxLength(),
+	m_valid(false)
+{
+}
+
+
+
+
+NoteVector NoteIndex::notesInRange(tick_t from, tick_t to, int lowKey, int highKey)
+{
+	if (!m_valid) { build(); }
+
+	lowKey = std::max(lowKey, 0);
+	highKey = std::min(highKey, NumKeys - 1);
+
+	std::vector<const Entry*> found;
+	for (int key = lowKey; key <= highKey; ++key)
+	{
+		const std::vector<Entry>& entries = m_keys[key];
+		// no note of this key starting earlier can reach the range
+		auto it = std::lower_bound(entries.begin(), entries.end(), from - m_maxLength[key],
+			[](const Entry& entry, tick_t pos) { return entry.pos < pos; });
+		for (; it != entries.end() && it->pos <= to; ++it)
+		{
+			if (it->end >= from) { found.push_back(&*it); }
+		}
+	}
+
+	// callers rely on the order of the notes, e.g. to find the topmost one
+	std::sort(found.begin(), found.end(), [](const Entry* a, const Entry* b) { return a->order < b->order; });
+
+	NoteVector result;
+	result.reserve(static_cast<int>(found.size()));
+	for (const Entry* entry : found)
+	{
+		result.push_back(entry->note);
+	}
+	return result;
+}
+
+
+
+
+void NoteIndex::update(const NoteVector& notes)
+{
+	// a rebuild costs a pass over all notes, moving an entry a pass over the
+	// notes of its keys
+	if (!m_valid || notes.size() > m_notes.size() / 16)
+	{
+		m_valid = false;
+		return;
+	}
+
+	if (m_locations.empty()) { locateNotes(); }
+
+	const auto byPos = [](const Entry& entry, tick_t pos) { return entry.pos < pos; };
+	for (Note* note : notes)
+	{
+		const auto location = m_locations.find(note);
+		if (location == m_locations.end())
+		{
+			// not one of the indexed notes
+			m_valid = false;
+			return;
+		}
+
+		std::vector<Entry>& oldEntries = m_keys[location->second.key];
+		auto it = std::lower_bound(oldEntries.begin(), oldEntries.end(), location->second.pos, byPos);
+		while (it->note != note) { ++it; }
+		Entry entry = *it;
+		oldEntries.erase(it);
+
+		const int key = qBound(0, note->key(), NumKeys - 1);
+		const tick_t length = note->length() < 0 ? StepNoteLength : static_cast<tick_t>(note->length());
+		entry.pos = note->pos();
+		entry.end = entry.pos + length;
+
+		std::vector<Entry>& entries = m_keys[key];
+		entries.insert(std::lower_bound(entries.begin(), entries.end(), entry.pos, byPos), entry);
+		m_maxLength[key] = std::max(m_maxLength[key], length);
+		location->second = {key, entry.pos};
+	}
+}
+
+
+
+
+void NoteIndex::build()
+{
+	for (std::vector<Entry>& entries : m_keys)
+	{
+		entries.clear();
+	}
+	m_maxLength.fill(0);
+	m_locations.clear();
+
+	for (int i = 0; i < m_notes.size(); ++i)
+	{
+		Note* note = m_notes[i];
+		const int key = qBound(0, note->key(), NumKeys - 1);
+		const tick_t pos = note->pos();
+		const tick_t length = note->length() < 0 ? StepNoteLength : static_cast<tick_t>(note->length());
+
+		m_keys[key].push_back({pos, pos + length, i, note});
+		m_maxLength[key] = std::max(m_maxLength[key], length);
+	}
+
+	// the notes are only unsorted while they are being moved
+	for (std::vector<Entry>& entries : m_keys)
+	{
+		const auto byPos = [](const Entry& a, const Entry& b) { return a.pos < b.pos; };
+		if (!std::is_sorted(entries.begin(), entries.end(), byPos))
+		{
+			std::stable_sort(entries.begin(), entries.end(), byPos);
+		}
+	}
+
+	m_valid = true;
+}
+
+
+
+
+void NoteIndex::locateNotes()
+{
+	m_locations.reserve(m_notes.size());
+	for (int key = 0; key < NumKeys; ++key)
+	{
+		for (const Entry& entry : m_keys[key])
+		{
+			m_locations[entry.note] = {key, entry.pos};
+		}
+	}
+}
+
+
+} // namespace lmms
@@ -0,0 +1,89 @@
+/*
+ * PlanarBuffer.cpp - stereo audio buffer with one contiguous array per channel
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PlanarBuffer.h"
+
+#include <algorithm>
+
+#include "MixKernels.h"
+
+namespace lmms
+{
+
+
+PlanarBuffer::PlanarBuffer( fpp_t frames ) :
+	m_capacity( 0 )
+{
+	reserve( frames );
+}
+
+
+
+
+void PlanarBuffer::reserve( fpp_t frames )
+{
+	m_capacity = frames;
+	m_samples.assign( static_cast<std::size_t>( frames ) * DEFAULT_CHANNELS, 0.0f );
+}
+
+
+
+
+void PlanarBuffer::clear( fpp_t frames )
+{
+	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	{
+		std::fill( channel( ch ), channel( ch ) + frames, 0.0f );
+	}
+}
+
+
+
+
+void PlanarBuffer::copyFrom( const PlanarBuffer & src, fpp_t frames )
+{
+	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	{
+		std::copy( src.channel( ch ), src.channel( ch ) + frames, channel( ch ) );
+	}
+}
+
+
+
+
+void PlanarBuffer::fromInterleaved( const sampleFrame * src, fpp_t frames )
+{
+	MixKernels::kernels().deinterleave( src[0].data(), channel( 0 ), channel( 1 ), frames );
+}
+
+
+
+
+void PlanarBuffer::toInterleaved( sampleFrame * dst, fpp_t frames ) const
+{
+	MixKernels::kernels().interleave( channel( 0 ), channel( 1 ), dst[0].data(), frames );
+}
+
+
+} // namespace lmms
@@ -29,6 +29,7 @@
 #include <QLibrary>
 #include <QMessageBox>
 
+#include "ConfigManager.h"
 #include "embed.h"
 #include "Engine.h"
 #include "GuiApplication.h"
@@ -253,6 +254,30 @@ Plugin * Plugin::instantiate(const QString& pluginName, Model * parent,
 
 
 
+bool Plugin::deferInstantiation()
+{
+	return Engine::getSong()->isLoadingProject()
+		&& ConfigManager::inst()->value("app", "lazyplugins", "1").toInt();
+}
+
+
+
+
+bool Plugin::canDeferInstantiation(const QDomElement& state)
+{
+	for (QDomElement child = state.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+	{
+		if (child.hasAttribute("id") || child.nodeName() == "connection" || !canDeferInstantiation(child))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+
 void Plugin::collectErrorForUI( QString errMsg )
 {
 	Engine::getSong()->collectError( errMsg );
@@ -0,0 +1,86 @@
+/*
+ * PluginLoaderThread.cpp - instantiate plugins in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PluginLoaderThread.h"
+
+#include <QLibrary>
+
+#include "Plugin.h"
+#include "PluginFactory.h"
+
+namespace lmms
+{
+
+
+PluginLoaderThread::PluginLoaderThread(LoadFunction load, QObject* parent) :
+	QThread(parent),
+	m_load(std::move(load)),
+	m_targetThread(thread())
+{
+}
+
+
+
+
+PluginLoaderThread::~PluginLoaderThread()
+{
+	for (Plugin* plugin : takePlugins())
+	{
+		delete plugin;
+	}
+}
+
+
+
+
+std::vector<Plugin*> PluginLoaderThread::takePlugins()
+{
+	wait();
+	return std::move(m_plugins);
+}
+
+
+
+
+bool PluginLoaderThread::canLoad(const QString& pluginName)
+{
+	// Plugin::instantiate() shows a message box if the plugin is missing
+	const PluginFactory::PluginInfo pi = getPluginFactory()->pluginInfo(pluginName.toUtf8());
+	return !pi.isNull() && pi.library->resolve("lmms_plugin_main") != nullptr;
+}
+
+
+
+
+void PluginLoaderThread::run()
+{
+	m_plugins = m_load();
+	for (Plugin* plugin : m_plugins)
+	{
+		plugin->moveToThread(m_targetThread);
+	}
+}
+
+
+} // namespace lmms
@@ -0,0 +1,163 @@
+/*
+ * PolyphaseResampler.cpp - streaming rational sample rate converter
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "PolyphaseResampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+#include "lmms_constants.h"
+
+namespace lmms
+{
+
+
+PolyphaseResampler::PolyphaseResampler(sample_rate_t srcRate, sample_rate_t dstRate, int taps) :
+	m_taps(std::max(taps, 2)),
+	m_up(1),
+	m_down(1),
+	m_pos(0),
+	m_time(0)
+{
+	const auto divisor = std::gcd(srcRate, dstRate);
+	if (divisor > 0)
+	{
+		m_up = static_cast<int>(dstRate / divisor);
+		m_down = static_cast<int>(srcRate / divisor);
+	}
+	// when decimating, the filter has to span as many frames of the output
+	// as it does of the input when interpolating
+	m_taps *= (m_down + m_up - 1) / m_up;
+
+	// prototype at the upsampled rate, cut off a little below the lower
+	// Nyquist frequency so that the transition band doesn't alias
+	const int length = m_up * m_taps;
+	const double cutoff = 0.95 * 0.5 / std::max(m_up, m_down);
+	const double center = (length - 1) / 2.;
+	std::vector<double> prototype(length);
+	for (int i = 0; i < length; ++i)
+	{
+		const double x = i - center;
+		const double sinc = x == 0. ? 1. : std::sin(2. * D_PI * cutoff * x) / (D_PI * x * 2. * cutoff);
+		// 4 term Blackman-Harris window
+		const double w = 2. * D_PI * (i + 0.5) / length;
+		const double window = 0.35875 - 0.48829 * std::cos(w) + 0.14128 * std::cos(2. * w)
+			- 0.01168 * std::cos(3. * w);
+		prototype[i] = sinc * window;
+	}
+
+	// output frame n lies at n * M / L input frames; with i = n * M / L and
+	// p = n * M % L, it is the sum of prototype[p + k * L] * in[i - k]
+	m_phases.resize(length);
+	for (int phase = 0; phase < m_up; ++phase)
+	{
+		double sum = 0.;
+		for (int k = 0; k < m_taps; ++k)
+		{
+			sum += prototype[phase + k * m_up];
+		}
+		for (int k = 0; k < m_taps; ++k)
+		{
+			// every phase passes DC with unity gain
+			m_phases[phase * m_taps + m_taps - 1 - k] =
+				static_cast<float>(prototype[phase + k * m_up] / sum);
+		}
+	}
+
+	for (auto& history : m_history)
+	{
+		history.resize(2 * m_taps);
+	}
+	reset();
+}
+
+
+
+
+f_cnt_t PolyphaseResampler::process(const sampleFrame* src, f_cnt_t frames, sampleFrame* dst)
+{
+	f_cnt_t out = 0;
+	for (f_cnt_t f = 0; f < frames; ++f)
+	{
+		for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		{
+			m_history[ch][m_pos] = src[f][ch];
+			m_history[ch][m_pos + m_taps] = src[f][ch];
+		}
+		m_pos = m_pos + 1 < m_taps ? m_pos + 1 : 0;
+
+		// all output frames up to this input frame can be computed now
+		for (; m_time < m_up; m_time += m_down)
+		{
+			const float* coefficients = m_phases.data() + m_time * m_taps;
+			for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+			{
+				const float* history = m_history[ch].data() + m_pos;
+				float sum = 0.f;
+				for (int k = 0; k < m_taps; ++k)
+				{
+					sum += coefficients[k] * history[k];
+				}
+				dst[out][ch] = sum;
+			}
+			++out;
+		}
+		m_time -= m_up;
+	}
+	return out;
+}
+
+
+
+
+f_cnt_t PolyphaseResampler::maxOutput(f_cnt_t frames) const
+{
+	return static_cast<f_cnt_t>((static_cast<std::int64_t>(frames) * m_up + m_down - 1) / m_down) + 1;
+}
+
+
+
+
+double PolyphaseResampler::latency() const
+{
+	return (m_up * m_taps - 1) / (2. * m_up);
+}
+
+
+
+
+void PolyphaseResampler::reset()
+{
+	for (auto& history : m_history)
+	{
+		std::fill(history.begin(), history.end(), 0.f);
+	}
+	m_pos = 0;
+	m_time = 0;
+}
+
+
+} // namespace lmms
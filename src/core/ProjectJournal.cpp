@@ -24,6 +24,9 @@
 
 #include <cstdlib>
 
+#include <QCoreApplication>
+#include <QThread>
+
 #include "ProjectJournal.h"
 #include "Engine.h"
 #include "JournallingObject.h"
@@ -54,7 +57,7 @@ void ProjectJournal::undo()
 	while( !m_undoCheckPoints.isEmpty() )
 	{
 		CheckPoint c = m_undoCheckPoints.pop();
-		JournallingObject *jo = m_joIDs[c.joID];
+		JournallingObject *jo = journallingObject( c.joID );
 
 		if( jo )
 		{
@@ -79,7 +82,7 @@ void ProjectJournal::redo()
 	while( !m_redoCheckPoints.isEmpty() )
 	{
 		CheckPoint c = m_redoCheckPoints.pop();
-		JournallingObject *jo = m_joIDs[c.joID];
+		JournallingObject *jo = journallingObject( c.joID );
 
 		if( jo )
 		{
@@ -111,7 +114,9 @@ bool ProjectJournal::canRedo() const
 
 void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 {
-	if( isJournalling() )
+	// plugins loaded in the background restore their state on another
+	// thread, which isn't an edit to undo
+	if( isJournalling() && QThread::currentThread() == QCoreApplication::instance()->thread() )
 	{
 		m_redoCheckPoints.clear();
 
@@ -131,6 +136,7 @@ void ProjectJournal::addJournalCheckPoint( JournallingObject *jo )
 
 jo_id_t ProjectJournal::allocID( JournallingObject * _obj )
 {
+	QMutexLocker idLock( &m_idLock );
 	jo_id_t id;
 	for( jo_id_t tid = rand(); m_joIDs.contains( id = tid % EO_ID_MSB
 							| EO_ID_MSB ); tid++ )
@@ -150,6 +156,7 @@ void ProjectJournal::reallocID( const jo_id_t _id, JournallingObject * _obj )
 	//printf("realloc %d %d\n", _id, _obj );
 //	if( m_joIDs.contains( _id ) )
 	{
+		QMutexLocker idLock( &m_idLock );
 		m_joIDs[_id] = _obj;
 	}
 }
@@ -175,6 +182,7 @@ void ProjectJournal::clearJournal()
 	m_undoCheckPoints.clear();
 	m_redoCheckPoints.clear();
 
+	QMutexLocker idLock( &m_idLock );
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); )
 	{
 		if( it.value() == nullptr )
@@ -190,6 +198,7 @@ void ProjectJournal::clearJournal()
 
 void ProjectJournal::stopAllJournalling()
 {
+	QMutexLocker idLock( &m_idLock );
 	for( JoIdMap::Iterator it = m_joIDs.begin(); it != m_joIDs.end(); ++it)
 	{
 		if( it.value() != nullptr )
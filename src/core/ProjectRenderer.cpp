@@ -24,11 +24,17 @@
 
 
 #include <QFile>
+#include <QFileInfo>
+
+#include <memory>
 
 #include "ProjectRenderer.h"
+#include "Mixer.h"
 #include "Song.h"
 #include "PerfLog.h"
 
+#include "AudioEncoderPipeline.h"
+
 #include "AudioFileWave.h"
 #include "AudioFileOgg.h"
 #include "AudioFileMP3.h"
@@ -82,27 +88,48 @@ ProjectRenderer::ProjectRenderer( const AudioEngine::qualitySettings & qualitySe
 					const OutputSettings & outputSettings,
 					ExportFileFormats exportFileFormat,
 					const QString & outputFilename ) :
+	ProjectRenderer( qualitySettings, outputSettings, { ExportTarget{ exportFileFormat, outputFilename } } )
+{
+}
+
+
+
+
+ProjectRenderer::ProjectRenderer( const AudioEngine::qualitySettings & qualitySettings,
+					const OutputSettings & outputSettings,
+					const QVector<ExportTarget> & targets ) :
 	QThread( Engine::audioEngine() ),
-	m_fileDev( nullptr ),
+	m_pipeline( nullptr ),
 	m_qualitySettings( qualitySettings ),
 	m_progress( 0 ),
 	m_abort( false )
 {
-	AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[exportFileFormat].m_getDevInst;
+	auto pipeline = std::make_unique<AudioEncoderPipeline>( DEFAULT_CHANNELS, Engine::audioEngine() );
 
-	if (audioEncoderFactory)
+	for( const ExportTarget & target : targets )
 	{
-		bool successful = false;
+		AudioFileDeviceInstantiaton audioEncoderFactory = fileEncodeDevices[target.format].m_getDevInst;
+		if( !audioEncoderFactory )
+		{
+			return;
+		}
 
-		m_fileDev = audioEncoderFactory(
-					outputFilename, outputSettings, DEFAULT_CHANNELS,
+		bool successful = false;
+		AudioFileDevice * encoder = audioEncoderFactory(
+					target.path, outputSettings, DEFAULT_CHANNELS,
 					Engine::audioEngine(), successful );
+		// hand it over before checking, so it gets cleaned up either way
+		pipeline->addEncoder( encoder );
 		if( !successful )
 		{
-			delete m_fileDev;
-			m_fileDev = nullptr;
+			return;
 		}
 	}
+
+	if( pipeline->hasEncoders() )
+	{
+		m_pipeline = pipeline.release();
+	}
 }
 
 
@@ -138,6 +165,22 @@ QString ProjectRenderer::getFileExtensionFromFormat(
 
 
 
+QString ProjectRenderer::pathForFormat( const QString & path, ExportFileFormats fmt )
+{
+	const QString suffix = "." + QFileInfo( path ).suffix();
+	for( int i = 0; i < NumFileFormats; ++i )
+	{
+		if( suffix.compare( fileEncodeDevices[i].m_extension, Qt::CaseInsensitive ) == 0 )
+		{
+			return path.left( path.length() - suffix.length() ) + getFileExtensionFromFormat( fmt );
+		}
+	}
+	return path + getFileExtensionFromFormat( fmt );
+}
+
+
+
+
 void ProjectRenderer::startProcessing()
 {
 
@@ -145,7 +188,10 @@ void ProjectRenderer::startProcessing()
 	{
 		// Have to do audio engine stuff with GUI-thread affinity in order to
 		// make slots connected to sampleRateChanged()-signals being called immediately.
-		Engine::audioEngine()->setAudioDevice( m_fileDev, m_qualitySettings, false, false );
+		Engine::audioEngine()->setAudioDevice( m_pipeline, m_qualitySettings, false, false );
+		// the delays must be right from the first period on, the render
+		// thread can't grow them
+		Engine::mixer()->reserveCompensationDelays();
 
 		start(
 #ifndef LMMS_BUILD_WIN32
@@ -160,17 +206,6 @@ void ProjectRenderer::startProcessing()
 void ProjectRenderer::run()
 {
 	MemoryManager::ThreadGuard mmThreadGuard; Q_UNUSED(mmThreadGuard);
-#if 0
-#if defined(LMMS_BUILD_LINUX) || defined(LMMS_BUILD_FREEBSD)
-#ifdef LMMS_HAVE_SCHED_H
-	cpu_set_t mask;
-	CPU_ZERO( &mask );
-	CPU_SET( 0, &mask );
-	sched_setaffinity( 0, sizeof( mask ), &mask );
-#endif
-#endif
-#endif
-
 	PerfLogTimer perfLog("Project Render");
 
 	Engine::getSong()->startExport();
@@ -182,10 +217,22 @@ void ProjectRenderer::run()
 	// Now start processing
 	Engine::audioEngine()->startProcessing(false);
 
+	const auto song = Engine::getSong();
+	const auto& range = song->exportRange();
+
 	// Continually track and emit progress percentage to listeners.
-	while (!Engine::getSong()->isExportDone() && !m_abort)
+	while (!m_abort && !(range ? m_pipeline->isOutputWindowComplete() : song->isExportDone()))
 	{
-		m_fileDev->processNextBuffer();
+		if (range)
+		{
+			// write nothing before the song reaches the range and stop
+			// exactly at its end, no matter where the periods begin
+			const f_cnt_t begin = song->exportBeginFrame();
+			const f_cnt_t end = song->exportEndFrame();
+			m_pipeline->setOutputWindow(begin < 0 ? -1 : outputFrames(begin),
+				end < 0 ? -1 : outputFrames(end) + range->overlapFrames);
+		}
+		m_pipeline->processNextBuffer();
 		const int nprog = Engine::getSong()->getExportProgress();
 		if (m_progress != nprog)
 		{
@@ -199,19 +246,36 @@ void ProjectRenderer::run()
 
 	Engine::getSong()->stopExport();
 
+	// let the encoders catch up, the export is only done when all periods
+	// are encoded
+	m_pipeline->finish();
+
 	perfLog.end();
 
-	// If the user aborted export-process, the file has to be deleted.
-	const QString f = m_fileDev->outputFile();
+	// If the user aborted export-process, the files have to be deleted.
 	if( m_abort )
 	{
-		QFile( f ).remove();
+		for( const QString & f : m_pipeline->outputFiles() )
+		{
+			QFile( f ).remove();
+		}
 	}
 }
 
 
 
 
+f_cnt_t ProjectRenderer::outputFrames( f_cnt_t processedFrames ) const
+{
+	// the pipeline resamples from the processing rate, which includes
+	// the oversampling
+	return static_cast<f_cnt_t>( static_cast<double>( processedFrames ) * m_pipeline->sampleRate()
+		/ Engine::audioEngine()->processingSampleRate() );
+}
+
+
+
+
 void ProjectRenderer::abortProcessing()
 {
 	m_abort = true;
@@ -35,6 +35,7 @@
 
 #include "BufferManager.h"
 #include "AudioEngine.h"
+#include "ConfigManager.h"
 #include "Engine.h"
 #include "Song.h"
 
@@ -143,7 +144,15 @@ RemotePlugin::RemotePlugin() :
 	m_commMutex(QMutex::Recursive),
 #endif
 	m_splitChannels( false ),
+	m_pipelined( ConfigManager::inst()->value( "audioengine", "pipelineremoteplugins", "0" ).toInt() ),
+	m_periodPending( false ),
+	m_periodsDone( 0 ),
 	m_audioBufferSize( 0 ),
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	m_audioSyncReady( false ),
+	m_pendingSynced( false ),
+	m_pendingRequest( 0 ),
+#endif
 	m_inputCount( DEFAULT_CHANNELS ),
 	m_outputCount( DEFAULT_CHANNELS )
 {
@@ -199,6 +208,12 @@ RemotePlugin::~RemotePlugin()
 		if( isRunning() )
 		{
 			lock();
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+			if (m_audioSync)
+			{
+				m_audioSync->requestQuit();
+			}
+#endif
 			sendMessage( IdQuit );
 
 			m_process.waitForFinished( 1000 );
@@ -312,6 +327,7 @@ bool RemotePlugin::init(const QString &pluginExecutable,
 
 	sendMessage(message(IdSyncKey).addString(Engine::getSong()->syncKey()));
 	resizeSharedProcessingMemory();
+	setupAudioSync();
 
 	if( waitForInitDoneMsg )
 	{
@@ -331,6 +347,7 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 
 	if( m_failed || !isRunning() )
 	{
+		m_periodPending = false;
 		if( _out_buf != nullptr )
 		{
 			BufferManager::clear( _out_buf, frames );
@@ -357,11 +374,96 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 		return false;
 	}
 
+	const bool pipelined = m_pipelined && !Engine::getSong()->isExporting();
+
+	// collect the period handed over last time
+	bool haveOutput = false;
+	if (m_periodPending)
+	{
+		m_periodPending = false;
+		if (!waitForPeriod())
+		{
+			if( _out_buf != nullptr )
+			{
+				BufferManager::clear( _out_buf, frames );
+			}
+			return false;
+		}
+		// when switching back from pipelined mode (e.g. for exporting),
+		// the result is dropped so the output is not delayed anymore
+		if (pipelined && _out_buf != nullptr && m_outputCount > 0)
+		{
+			readOutputs( _out_buf, frames );
+			haveOutput = true;
+		}
+	}
+
+	writeInputs( _in_buf, frames );
+
+	if (pipelined)
+	{
+		// let the plugin run while the engine does other work, the result
+		// is picked up next period
+		m_periodPending = startPeriod();
+		if( !haveOutput && _out_buf != nullptr )
+		{
+			BufferManager::clear( _out_buf, frames );
+		}
+		return haveOutput;
+	}
+
+	lock();
+	if( !startPeriod() )
+	{
+		unlock();
+		if( _out_buf != nullptr )
+		{
+			BufferManager::clear( _out_buf, frames );
+		}
+		return false;
+	}
+
+	if( _out_buf == nullptr || m_outputCount == 0 )
+	{
+		// nobody needs the result, collect it next time
+		m_periodPending = true;
+		unlock();
+		return false;
+	}
+
+	const bool done = waitForPeriod();
+	unlock();
+	if( !done )
+	{
+		BufferManager::clear( _out_buf, frames );
+		return false;
+	}
+
+	readOutputs( _out_buf, frames );
+
+	return true;
+}
+
+
+
+
+f_cnt_t RemotePlugin::latency() const
+{
+	// process() doesn't pipeline while exporting
+	return m_pipelined && !Engine::getSong()->isExporting()
+		? Engine::audioEngine()->framesPerPeriod() : 0;
+}
+
+
+
+
+void RemotePlugin::writeInputs( const sampleFrame * inBuf, fpp_t frames )
+{
 	memset( m_audioBuffer.get(), 0, m_audioBufferSize );
 
 	ch_cnt_t inputs = qMin<ch_cnt_t>( m_inputCount, DEFAULT_CHANNELS );
 
-	if( _in_buf != nullptr && inputs > 0 )
+	if( inBuf != nullptr && inputs > 0 )
 	{
 		if( m_splitChannels )
 		{
@@ -370,13 +472,13 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 				for( fpp_t frame = 0; frame < frames; ++frame )
 				{
 					m_audioBuffer[ch * frames + frame] =
-							_in_buf[frame][ch];
+							inBuf[frame][ch];
 				}
 			}
 		}
 		else if( inputs == DEFAULT_CHANNELS )
 		{
-			memcpy( m_audioBuffer.get(), _in_buf, frames * BYTES_PER_FRAME );
+			memcpy( m_audioBuffer.get(), inBuf, frames * BYTES_PER_FRAME );
 		}
 		else
 		{
@@ -385,24 +487,18 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 			{
 				for( fpp_t frame = 0; frame < frames; ++frame )
 				{
-					o[frame][ch] = _in_buf[frame][ch];
+					o[frame][ch] = inBuf[frame][ch];
 				}
 			}
 		}
 	}
+}
 
-	lock();
-	sendMessage( IdStartProcessing );
 
-	if( m_failed || _out_buf == nullptr || m_outputCount == 0 )
-	{
-		unlock();
-		return false;
-	}
 
-	waitForMessage( IdProcessingDone );
-	unlock();
 
+void RemotePlugin::readOutputs( sampleFrame * outBuf, fpp_t frames ) const
+{
 	const ch_cnt_t outputs = qMin<ch_cnt_t>( m_outputCount,
 							DEFAULT_CHANNELS );
 	if( m_splitChannels )
@@ -411,33 +507,102 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 		{
 			for( fpp_t frame = 0; frame < frames; ++frame )
 			{
-				_out_buf[frame][ch] = m_audioBuffer[( m_inputCount+ch )*
+				outBuf[frame][ch] = m_audioBuffer[( m_inputCount+ch )*
 								frames + frame];
 			}
 		}
 	}
 	else if( outputs == DEFAULT_CHANNELS )
 	{
-		memcpy( _out_buf, m_audioBuffer.get() + m_inputCount * frames,
+		memcpy( outBuf, m_audioBuffer.get() + m_inputCount * frames,
 						frames * BYTES_PER_FRAME );
 	}
 	else
 	{
 		auto o = (sampleFrame*)(m_audioBuffer.get() + m_inputCount * frames);
 		// clear buffer, if plugin didn't fill up both channels
-		BufferManager::clear( _out_buf, frames );
+		BufferManager::clear( outBuf, frames );
 
 		for( ch_cnt_t ch = 0; ch <
 				qMin<int>( DEFAULT_CHANNELS, outputs ); ++ch )
 		{
 			for( fpp_t frame = 0; frame < frames; ++frame )
 			{
-				_out_buf[frame][ch] = o[frame][ch];
+				outBuf[frame][ch] = o[frame][ch];
 			}
 		}
 	}
+}
 
-	return true;
+
+
+
+bool RemotePlugin::startPeriod()
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	m_pendingSynced = m_audioSyncReady.load(std::memory_order_acquire);
+	if (m_pendingSynced)
+	{
+		m_pendingRequest = m_audioSync->requestProcessing();
+		return true;
+	}
+#endif
+
+	lock();
+	// a period abandoned after a failure must not be collected for this one
+	m_periodsDone = 0;
+	sendMessage( IdStartProcessing );
+	unlock();
+
+	return !m_failed;
+}
+
+
+
+
+bool RemotePlugin::waitForPeriod()
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	if (m_pendingSynced)
+	{
+		// wake up regularly to notice a remote process that has gone away
+		while (!m_audioSync->waitForProcessing(m_pendingRequest, 100))
+		{
+			if (m_failed || isInvalid() || !isRunning())
+			{
+				return false;
+			}
+		}
+
+		// there's no reply to wait for anymore, so pick up whatever else the
+		// plugin sent, unless another thread is already talking to it
+		if (messagesLeft() && m_commMutex.tryLock())
+		{
+			fetchAndProcessAllMessages();
+			unlock();
+		}
+		return true;
+	}
+#endif
+
+	// the reply may already have been received by another thread waiting
+	// for a message while the lock was released since startPeriod()
+	lock();
+	while( m_periodsDone == 0 && !isInvalid() )
+	{
+		if( fetchAndProcessNextMessage().id == IdUndefined )
+		{
+			break;
+		}
+	}
+	const bool done = m_periodsDone > 0;
+	if( done )
+	{
+		--m_periodsDone;
+	}
+	unlock();
+
+	return done;
 }
 
 
@@ -446,6 +611,19 @@ bool RemotePlugin::process( const sampleFrame * _in_buf, sampleFrame * _out_buf
 void RemotePlugin::processMidiEvent( const MidiEvent & _e,
 							const f_cnt_t _offset )
 {
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	if (m_audioSyncReady.load(std::memory_order_acquire))
+	{
+		const auto event = RemotePluginMidiEvent{_e.type(), _e.channel(), _e.param(0), _e.param(1), _offset};
+		QMutexLocker midiLock(&m_midiEventLock);
+		if (m_audioSync->pushMidiEvent(event))
+		{
+			return;
+		}
+		// the queue is full, a late event is still better than a lost one
+	}
+#endif
+
 	message m( IdMidiEvent );
 	m.addInt( _e.type() );
 	m.addInt( _e.channel() );
@@ -494,6 +672,28 @@ void RemotePlugin::resizeSharedProcessingMemory()
 
 
 
+void RemotePlugin::setupAudioSync()
+{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+	m_audioSyncReady = false;
+	try
+	{
+		m_audioSync.create(QUuid::createUuid().toString().toStdString());
+	}
+	catch (const std::runtime_error& error)
+	{
+		qWarning() << "Failed to allocate shared audio sync data, using messages:" << error.what();
+		m_audioSync.detach();
+		return;
+	}
+	// clients that don't support the handshake just ignore the key
+	sendMessage(message(IdChangeAudioSyncKey).addString(m_audioSync.key()));
+#endif
+}
+
+
+
+
 void RemotePlugin::processFinished( int exitCode,
 					QProcess::ExitStatus exitStatus )
 {
@@ -564,7 +764,16 @@ bool RemotePlugin::processMessage( const message & _m )
 						_m.getString( 0 ).c_str() );
 			break;
 
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+		case IdAudioSyncReady:
+			m_audioSyncReady = true;
+			break;
+#endif
+
 		case IdProcessingDone:
+			++m_periodsDone;
+			break;
+
 		case IdQuit:
 		default:
 			break;
@@ -39,10 +39,19 @@ RenderManager::RenderManager(
 		const OutputSettings & outputSettings,
 		ProjectRenderer::ExportFileFormats fmt,
 		QString outputPath) :
+	RenderManager(qualitySettings, outputSettings, QVector<ProjectRenderer::ExportFileFormats>{fmt}, outputPath)
+{
+}
+
+RenderManager::RenderManager(
+		const AudioEngine::qualitySettings & qualitySettings,
+		const OutputSettings & outputSettings,
+		const QVector<ProjectRenderer::ExportFileFormats> & formats,
+		QString outputPath) :
 	m_qualitySettings(qualitySettings),
 	m_oldQualitySettings( Engine::audioEngine()->currentQualitySettings() ),
 	m_outputSettings(outputSettings),
-	m_format(fmt),
+	m_formats(formats),
 	m_outputPath(outputPath)
 {
 	Engine::audioEngine()->storeAudioDevice();
@@ -140,11 +149,18 @@ void RenderManager::renderProject()
 
 void RenderManager::render(QString outputPath)
 {
+	// the first format keeps the path as it is
+	QVector<ProjectRenderer::ExportTarget> targets;
+	for (auto format : m_formats)
+	{
+		const QString path = targets.isEmpty() ? outputPath : ProjectRenderer::pathForFormat(outputPath, format);
+		targets.push_back({format, path});
+	}
+
 	m_activeRenderer = std::make_unique<ProjectRenderer>(
 			m_qualitySettings,
 			m_outputSettings,
-			m_format,
-			outputPath);
+			targets);
 
 	if( m_activeRenderer->isReady() )
 	{
@@ -180,7 +196,7 @@ void RenderManager::restoreMutedState()
 // Determine the output path for a track when rendering tracks individually
 QString RenderManager::pathForTrack(const Track *track, int num)
 {
-	QString extension = ProjectRenderer::getFileExtensionFromFormat( m_format );
+	QString extension = ProjectRenderer::getFileExtensionFromFormat( m_formats.front() );
 	QString name = track->name();
 	name = name.remove(QRegExp(FILENAME_FILTER));
 	name = QString( "%1_%2%3" ).arg( num ).arg( name ).arg( extension );
@@ -27,10 +27,13 @@
 
 #include <algorithm>
 
+#include <QDataStream>
+#include <QDateTime>
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QPainter>
+#include <QReadLocker>
 
 
 #include <sndfile.h>
@@ -58,6 +61,7 @@
 #include "GuiApplication.h"
 #include "Note.h"
 #include "PathUtil.h"
+#include "WaveformOverview.h"
 
 #include "FileDialog.h"
 
@@ -183,6 +187,10 @@ void swap(SampleBuffer& first, SampleBuffer& second) noexcept
 		first.m_varLock.lockForWrite();
 	}
 
+	// the overviews are connected to their buffers, rebuild them on demand
+	first.resetOverview();
+	second.resetOverview();
+
 	first.m_audioFile.swap(second.m_audioFile);
 	swap(first.m_origData, second.m_origData);
 	swap(first.m_data, second.m_data);
@@ -216,6 +224,7 @@ SampleBuffer& SampleBuffer::operator=(SampleBuffer that)
 
 SampleBuffer::~SampleBuffer()
 {
+	resetOverview();
 	MM_FREE(m_origData);
 	MM_FREE(m_data);
 }
@@ -240,6 +249,7 @@ void SampleBuffer::update(bool keepSettings)
 	{
 		Engine::audioEngine()->requestChangeInModel();
 		m_varLock.lockForWrite();
+		resetOverview();
 		MM_FREE(m_data);
 	}
 
@@ -1025,11 +1035,11 @@ void SampleBuffer::visualize(
 	f_cnt_t toFrame
 )
 {
+	QReadLocker lock(&m_varLock);
+
 	if (m_frames == 0) { return; }
 
 	const bool focusOnRange = toFrame <= m_frames && 0 <= fromFrame && fromFrame < toFrame;
-	//TODO: If the clip QRect is not being used we should remove it
-	//p.setClipRect(clip);
 	const int w = dr.width();
 	const int h = dr.height();
 
@@ -1045,11 +1055,17 @@ void SampleBuffer::visualize(
 	const int totalPoints = nbFrames > w
 		? w
 		: nbFrames;
-	std::vector<QPointF> fEdgeMax(totalPoints);
-	std::vector<QPointF> fEdgeMin(totalPoints);
-	std::vector<QPointF> fRmsMax(totalPoints);
-	std::vector<QPointF> fRmsMin(totalPoints);
-	int curPixel = 0;
+	// Only compute the points within the clip rect, with one extra point on
+	// each side to make up for rounding
+	const int firstPoint = qBound(0,
+		static_cast<int>(static_cast<double>(clip.left() - dr.x()) * totalPoints / w) - 1, totalPoints);
+	const int lastPoint = qBound(firstPoint,
+		static_cast<int>(static_cast<double>(clip.right() + 1 - dr.x()) * totalPoints / w) + 1, totalPoints);
+
+	std::vector<QPointF> fEdgeMax(lastPoint - firstPoint);
+	std::vector<QPointF> fEdgeMin(lastPoint - firstPoint);
+	std::vector<QPointF> fRmsMax(lastPoint - firstPoint);
+	std::vector<QPointF> fRmsMin(lastPoint - firstPoint);
 	const int xb = dr.x();
 	const int first = focusOnRange ? fromFrame : 0;
 	const int last = focusOnRange ? toFrame - 1 : m_frames - 1;
@@ -1061,56 +1077,74 @@ void SampleBuffer::visualize(
 	const int lastVisibleFrame = focusOnRange
 		? fromFrame + visibleFrames - 1
 		: visibleFrames - 1;
+	const auto framesPerPoint = static_cast<f_cnt_t>(std::ceil(fpp));
 
-	for (double frame = first; frame <= last && frame <= lastVisibleFrame; frame += fpp)
+	// Below one block per point, reading the frames is just as fast
+	std::shared_ptr<WaveformOverview> overview;
+	if (framesPerPoint >= WaveformOverview::BlockSize)
 	{
-		float maxData = -1;
-		float minData = 1;
-
-		auto rmsData = std::array<float, 2>{};
-
-		// Find maximum and minimum samples within range
-		for (int i = 0; i < fpp && frame + i <= last; ++i)
+		overview = std::atomic_load(&m_overview);
+		if (!overview)
 		{
-			for (int j = 0; j < 2; ++j)
-			{
-				auto curData = m_data[static_cast<int>(frame) + i][j];
+			overview = std::make_shared<WaveformOverview>(m_data, m_frames);
+			connect(overview.get(), SIGNAL(ready()), this, SIGNAL(overviewUpdated()), Qt::QueuedConnection);
+			std::atomic_store(&m_overview, overview);
+
+			const bool saveOverview = !m_audioFile.isEmpty() &&
+				ConfigManager::inst()->value("ui", "savewaveformoverview").toInt();
+			overview->buildInBackground(
+				saveOverview ? PathUtil::toAbsolute(m_audioFile) + ".lmmspeaks" : QString(),
+				saveOverview ? overviewStamp() : QByteArray());
+		}
+	}
+	// While the overview is being built, only look at this many frames per
+	// point; the view is redrawn with the exact values once it is ready
+	const f_cnt_t previewStride = std::max(1, framesPerPoint / WaveformOverview::BlockSize);
 
-				if (curData > maxData) { maxData = curData; }
-				if (curData < minData) { minData = curData; }
+	int curPoint = 0;
+	for (int point = firstPoint; point < lastPoint; ++point, ++curPoint)
+	{
+		const double frame = first + point * fpp;
+		if (frame > last || frame > lastVisibleFrame) { break; }
 
-				rmsData[j] += curData * curData;
-			}
+		const auto from = static_cast<f_cnt_t>(frame);
+		const f_cnt_t to = std::min(from + framesPerPoint, last + 1);
+
+		WaveformOverview::Peak peak;
+		if (!overview || !overview->peak(from, to, peak))
+		{
+			peak = WaveformOverview::scan(m_data, from, to, previewStride);
 		}
+		const float maxData = peak.max;
+		const float minData = peak.min;
 
-		const float trueRmsData = (rmsData[0] + rmsData[1]) / 2 / fpp;
+		const float trueRmsData = peak.squares / 2 / peak.frames;
 		const float sqrtRmsData = sqrt(trueRmsData);
 		const float maxRmsData = qBound(minData, sqrtRmsData, maxData);
 		const float minRmsData = qBound(minData, -sqrtRmsData, maxData);
 
-		// If nbFrames >= w, we can use curPixel to calculate X
+		// If nbFrames >= w, we can use the point to calculate X
 		// but if nbFrames < w, we need to calculate it proportionally
 		// to the total number of points
 		auto x = nbFrames >= w
-			? xb + curPixel
-			: xb + ((static_cast<double>(curPixel) / nbFrames) * w);
+			? xb + point
+			: xb + ((static_cast<double>(point) / nbFrames) * w);
 		// Partial Y calculation
 		auto py = ySpace * m_amplification;
-		fEdgeMax[curPixel] = QPointF(x, (yb - (maxData * py)));
-		fEdgeMin[curPixel] = QPointF(x, (yb - (minData * py)));
-		fRmsMax[curPixel] = QPointF(x, (yb - (maxRmsData * py)));
-		fRmsMin[curPixel] = QPointF(x, (yb - (minRmsData * py)));
-		++curPixel;
+		fEdgeMax[curPoint] = QPointF(x, (yb - (maxData * py)));
+		fEdgeMin[curPoint] = QPointF(x, (yb - (minData * py)));
+		fRmsMax[curPoint] = QPointF(x, (yb - (maxRmsData * py)));
+		fRmsMin[curPoint] = QPointF(x, (yb - (minRmsData * py)));
 	}
 
-	for (int i = 0; i < totalPoints; ++i)
+	for (int i = 0; i < curPoint; ++i)
 	{
 		p.drawLine(fEdgeMax[i], fEdgeMin[i]);
 	}
 
 	p.setPen(p.pen().color().lighter(123));
 
-	for (int i = 0; i < totalPoints; ++i)
+	for (int i = 0; i < curPoint; ++i)
 	{
 		p.drawLine(fRmsMax[i], fRmsMin[i]);
 	}
@@ -1119,6 +1153,34 @@ void SampleBuffer::visualize(
 
 
 
+void SampleBuffer::resetOverview()
+{
+	std::shared_ptr<WaveformOverview> overview = std::atomic_exchange(&m_overview, std::shared_ptr<WaveformOverview>());
+	if (overview)
+	{
+		overview->disconnect(this);
+		// a build job may still hold the overview, make sure it stops
+		// reading m_data
+		overview->cancel();
+	}
+}
+
+
+
+
+QByteArray SampleBuffer::overviewStamp() const
+{
+	// the overview is built from the decoded and resampled data
+	const QFileInfo file(PathUtil::toAbsolute(m_audioFile));
+	QByteArray stamp;
+	QDataStream stream(&stamp, QIODevice::WriteOnly);
+	stream << file.size() << file.lastModified() << m_sampleRate << m_reversed;
+	return stamp;
+}
+
+
+
+
 QString SampleBuffer::openAudioFile() const
 {
 	gui::FileDialog ofd(nullptr, tr("Open audio file"));
@@ -1555,7 +1617,11 @@ void SampleBuffer::setReversed(bool on)
 {
 	Engine::audioEngine()->requestChangeInModel();
 	m_varLock.lockForWrite();
-	if (m_reversed != on) { std::reverse(m_data, m_data + m_frames); }
+	if (m_reversed != on)
+	{
+		resetOverview();
+		std::reverse(m_data, m_data + m_frames);
+	}
 	m_reversed = on;
 	m_varLock.unlock();
 	Engine::audioEngine()->doneChangeInModel();
@@ -25,6 +25,7 @@
 #include "SampleClip.h"
 
 #include <QDomElement>
+#include <QPointer>
 
 #include "SampleBuffer.h"
 #include "SampleClipView.h"
@@ -71,6 +72,9 @@ SampleClip::SampleClip( Track * _track ) :
 			this, SLOT(playbackPositionChanged()), Qt::DirectConnection );
 	//care about Clip position
 	connect( this, SIGNAL(positionChanged()), this, SLOT(updateTrackClips()));
+	//prepare the take to record into while armed, on this thread
+	connect( &m_recordModel, SIGNAL(dataChanged()), this, SLOT(updateRecordTake()));
+	connect( Engine::audioEngine(), SIGNAL(sampleRateChanged()), this, SLOT(updateRecordTake()));
 
 	switch( getTrack()->trackContainer()->type() )
 	{
@@ -110,6 +114,11 @@ SampleClip::~SampleClip()
 	Engine::audioEngine()->requestChangeInModel();
 	sharedObject::unref( m_sampleBuffer );
 	Engine::audioEngine()->doneChangeInModel();
+
+	if( m_recordTake )
+	{
+		Engine::diskRecorder()->finishTake( m_recordTake );
+	}
 }
 
 
@@ -177,6 +186,48 @@ void SampleClip::toggleRecord()
 
 
 
+void SampleClip::updateRecordTake()
+{
+	const sample_rate_t sampleRate = Engine::audioEngine()->inputSampleRate();
+
+	DiskRecorder::TakePtr unused;
+	Engine::audioEngine()->requestChangeInModel();
+	if( m_recordTake && ( !isRecord() || m_recordTake->sampleRate() != sampleRate ) )
+	{
+		unused = std::move( m_recordTake );
+	}
+	const bool prepare = isRecord() && !m_recordTake;
+	Engine::audioEngine()->doneChangeInModel();
+
+	// no recording has used it, so it doesn't create a file
+	if( unused )
+	{
+		Engine::diskRecorder()->finishTake( unused );
+	}
+
+	if( prepare )
+	{
+		// the clip may be gone by the time the file is complete
+		QPointer<SampleClip> clip = this;
+		DiskRecorder::TakePtr take = Engine::diskRecorder()->startTake(
+			getTrack()->name(), sampleRate,
+			[clip]( const DiskRecorder::Take & take )
+			{
+				if( clip && take.isValid() )
+				{
+					clip->setSampleFile( take.fileName() );
+				}
+			} );
+
+		Engine::audioEngine()->requestChangeInModel();
+		m_recordTake = std::move( take );
+		Engine::audioEngine()->doneChangeInModel();
+	}
+}
+
+
+
+
 void SampleClip::playbackPositionChanged()
 {
 	Engine::audioEngine()->removePlayHandlesOfTypes( getTrack(), PlayHandle::TypeSamplePlayHandle );
@@ -0,0 +1,622 @@
+/*
+ * SampleIndex.cpp - background index of sample libraries for instant search
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QReadLocker>
+#include <QRegExp>
+#include <QSaveFile>
+#include <QWriteLocker>
+
+#include <sndfile.h>
+
+#include "ConfigManager.h"
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr quint32 CacheFileMagic = 0x4c4d5349; // "LMSI"
+constexpr quint32 CacheFileVersion = 1;
+
+//! Frames decoded at once while computing peaks
+constexpr sf_count_t PeakBlockFrames = 4096;
+//! Longer files are indexed without peaks, decoding them would hold up the
+//! rest of the scan
+constexpr int MaxPeakSeconds = 600;
+
+constexpr int PrefixScore = 400;
+constexpr int WordPrefixScore = 300;
+constexpr int SubstringScore = 200;
+constexpr int FuzzyScore = 100;
+constexpr int DirectoryScore = 50;
+
+
+//! How well @p key matches @p word, -1 if it doesn't
+int matchScore(const QString& key, const QString& word)
+{
+	if (key.startsWith(word)) { return PrefixScore; }
+
+	int index = key.indexOf(word);
+	if (index >= 0)
+	{
+		for (; index >= 0; index = key.indexOf(word, index + 1))
+		{
+			if (!key[index - 1].isLetterOrNumber()) { return WordPrefixScore; }
+		}
+		return SubstringScore;
+	}
+
+	// all characters in order, with as few gaps as possible. Short words
+	// would match nearly everything this way.
+	if (word.length() < 3) { return -1; }
+	int first = -1;
+	int position = -1;
+	for (const QChar c : word)
+	{
+		position = key.indexOf(c, position + 1);
+		if (position < 0) { return -1; }
+		if (first < 0) { first = position; }
+	}
+	const int gaps = position - first + 1 - word.length();
+	return std::max(1, FuzzyScore - gaps);
+}
+
+
+QDataStream& operator<<(QDataStream& stream, const SampleIndex::Entry& entry)
+{
+	stream << entry.path << static_cast<quint8>(entry.type) << entry.size << entry.modified
+		<< static_cast<qint32>(entry.frames) << static_cast<quint32>(entry.sampleRate);
+	stream.writeRawData(reinterpret_cast<const char*>(entry.peaks.data()), SampleIndex::PeakCount);
+	return stream;
+}
+
+
+QDataStream& operator>>(QDataStream& stream, SampleIndex::Entry& entry)
+{
+	quint8 type = 0;
+	qint32 frames = 0;
+	quint32 sampleRate = 0;
+	stream >> entry.path >> type >> entry.size >> entry.modified >> frames >> sampleRate;
+	stream.readRawData(reinterpret_cast<char*>(entry.peaks.data()), SampleIndex::PeakCount);
+
+	entry.key = QFileInfo(entry.path).fileName().toLower();
+	entry.type = static_cast<SampleIndex::Type>(type);
+	entry.frames = frames;
+	entry.sampleRate = sampleRate;
+	return stream;
+}
+
+} // namespace
+
+
+
+
+SampleIndex::Scanner::Scanner(SampleIndex* index) :
+	m_index(index)
+{
+}
+
+
+
+
+void SampleIndex::Scanner::run()
+{
+	if (m_index->load())
+	{
+		m_index->markChanged(true);
+	}
+
+	while (!m_index->m_quit)
+	{
+		Job job;
+		bool haveJob = false;
+		{
+			QMutexLocker lock(&m_index->m_jobsLock);
+			if (!m_index->m_jobs.empty())
+			{
+				job = m_index->m_jobs.front();
+				m_index->m_jobs.pop_front();
+				haveJob = true;
+			}
+		}
+
+		if (!haveJob)
+		{
+			if (m_index->m_scanning)
+			{
+				m_index->m_scanning = false;
+				m_index->markChanged(true);
+				if (m_index->m_dirty && m_index->save()) { m_index->m_dirty = false; }
+			}
+			m_index->m_wake.acquire();
+			continue;
+		}
+
+		m_index->m_scanning = true;
+		m_index->scanDirectory(job);
+		m_index->markChanged(false);
+	}
+
+	if (m_index->m_dirty) { m_index->save(); }
+}
+
+
+
+
+SampleIndex::SampleIndex() :
+	m_scanner(this),
+	m_scanning(false),
+	m_quit(false),
+	m_dirty(false),
+	m_lastChange(0)
+{
+	connect(&m_watcher, SIGNAL(directoryChanged(const QString&)),
+			this, SLOT(directoryChanged(const QString&)));
+}
+
+
+
+
+SampleIndex::~SampleIndex()
+{
+	m_quit = true;
+	m_wake.release();
+	m_scanner.wait();
+}
+
+
+
+
+void SampleIndex::addRoot(const QString& path)
+{
+	const QString root = directoryPath(path);
+	if (!QFileInfo(root).isDir()) { return; }
+
+	enqueue(root, true);
+	if (!m_scanner.isRunning())
+	{
+		m_scanner.start(QThread::LowPriority);
+	}
+}
+
+
+
+
+std::vector<SampleIndex::Entry> SampleIndex::search(const QString& text, const QStringList& roots, int limit) const
+{
+#if (QT_VERSION >= QT_VERSION_CHECK(5,14,0))
+	const QStringList words = text.toLower().split(QRegExp("\\s+"), Qt::SkipEmptyParts);
+#else
+	const QStringList words = text.toLower().split(QRegExp("\\s+"), QString::SkipEmptyParts);
+#endif
+	if (words.isEmpty()) { return {}; }
+
+	QStringList rootPaths;
+	for (const QString& root : roots)
+	{
+		rootPaths << directoryPath(root);
+	}
+
+	struct Match
+	{
+		int score;
+		const Entry* entry;
+	} ;
+	std::vector<Match> matches;
+
+	QReadLocker lock(&m_lock);
+	for (auto dir = m_directories.cbegin(); dir != m_directories.cend(); ++dir)
+	{
+		const auto root = std::find_if(rootPaths.cbegin(), rootPaths.cend(),
+			[&dir](const QString& r) { return dir.key().startsWith(r); });
+		if (root == rootPaths.cend()) { continue; }
+		const QString relativePath = dir.key().mid(root->length()).toLower();
+
+		for (const Entry& entry : dir->files)
+		{
+			int score = 0;
+			for (const QString& word : words)
+			{
+				int wordScore = matchScore(entry.key, word);
+				if (wordScore < 0 && relativePath.contains(word)) { wordScore = DirectoryScore; }
+				if (wordScore < 0) { score = -1; break; }
+				score += wordScore;
+			}
+			if (score >= 0) { matches.push_back({score, &entry}); }
+		}
+	}
+
+	const auto count = std::min<std::size_t>(matches.size(), std::max(limit, 0));
+	std::partial_sort(matches.begin(), matches.begin() + count, matches.end(),
+		[](const Match& a, const Match& b)
+		{
+			if (a.score != b.score) { return a.score > b.score; }
+			if (a.entry->key.length() != b.entry->key.length())
+			{
+				return a.entry->key.length() < b.entry->key.length();
+			}
+			return a.entry->key < b.entry->key;
+		});
+
+	std::vector<Entry> result;
+	result.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		result.push_back(*matches[i].entry);
+	}
+	return result;
+}
+
+
+
+
+bool SampleIndex::entry(const QString& path, Entry& result) const
+{
+	const QFileInfo info(path);
+	const QString filePath = info.absoluteFilePath();
+
+	QReadLocker lock(&m_lock);
+	const auto dir = m_directories.constFind(directoryPath(info.absolutePath()));
+	if (dir == m_directories.cend()) { return false; }
+
+	const auto it = std::find_if(dir->files.cbegin(), dir->files.cend(),
+		[&filePath](const Entry& e) { return e.path == filePath; });
+	if (it == dir->files.cend()) { return false; }
+
+	result = *it;
+	return true;
+}
+
+
+
+
+SampleIndex::Type SampleIndex::typeOf(const QString& fileName)
+{
+	const QString ext = QFileInfo(fileName).suffix().toLower();
+	if (ext == "mmp" || ext == "mmpz" || ext == "mpt") { return Type::Project; }
+	if (ext == "xpf" || ext == "xml" || ext == "xiz") { return Type::Preset; }
+	if (ext == "mid" || ext == "midi" || ext == "rmi") { return Type::Midi; }
+	if (ext == "sf2" || ext == "sf3") { return Type::SoundFont; }
+	// DrumSynth files are rendered by SampleBuffer, libsndfile can't read them
+	if (ext == "ds") { return Type::Sample; }
+	return Type::Unknown;
+}
+
+
+
+
+void SampleIndex::directoryChanged(const QString& path)
+{
+	// the watcher drops removed directories by itself
+	if (!QFileInfo::exists(path))
+	{
+		m_watched.remove(path);
+	}
+	enqueue(path, false);
+}
+
+
+
+
+void SampleIndex::watchDirectories(const QStringList& paths)
+{
+	for (const QString& path : paths)
+	{
+		if (m_watched.size() >= MaxWatchedDirectories) { return; }
+		if (!m_watched.contains(path) && m_watcher.addPath(path))
+		{
+			m_watched.insert(path);
+		}
+	}
+}
+
+
+
+
+void SampleIndex::enqueue(const QString& path, bool recursive)
+{
+	const QString dir = directoryPath(path);
+	{
+		QMutexLocker lock(&m_jobsLock);
+		// directories often change several times in a row, e.g. while
+		// files are being copied into them
+		const bool queued = std::any_of(m_jobs.cbegin(), m_jobs.cend(),
+			[&dir, recursive](const Job& job) { return job.path == dir && (job.recursive || !recursive); });
+		if (queued && !recursive) { return; }
+		m_jobs.push_back({dir, recursive});
+	}
+	m_wake.release();
+}
+
+
+
+
+void SampleIndex::scanDirectory(const Job& job)
+{
+	const QDir dir(job.path);
+	if (!dir.exists())
+	{
+		removeDirectory(job.path);
+		return;
+	}
+
+	// files which didn't change are taken over from the last scan
+	QHash<QString, Entry> known;
+	QStringList knownSubdirectories;
+	{
+		QReadLocker lock(&m_lock);
+		const auto it = m_directories.constFind(job.path);
+		if (it != m_directories.cend())
+		{
+			for (const Entry& entry : it->files)
+			{
+				known.insert(entry.path, entry);
+			}
+			knownSubdirectories = it->subdirectories;
+		}
+	}
+
+	const QString canonicalPath = directoryPath(dir.canonicalPath());
+	Directory result;
+	bool changed = false;
+	for (const QFileInfo& info : dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::Name))
+	{
+		if (m_quit) { return; }
+
+		if (info.isDir())
+		{
+			// don't follow links back into a parent
+			if (info.isSymLink() && canonicalPath.startsWith(directoryPath(info.canonicalFilePath())))
+			{
+				continue;
+			}
+			result.subdirectories << info.fileName();
+			continue;
+		}
+
+		const auto it = known.find(info.absoluteFilePath());
+		if (it != known.end() && it->size == info.size()
+			&& it->modified == info.lastModified().toMSecsSinceEpoch())
+		{
+			result.files.push_back(*it);
+		}
+		else
+		{
+			result.files.push_back(probe(info));
+			changed = true;
+		}
+		if (it != known.end()) { known.erase(it); }
+	}
+	changed = changed || !known.isEmpty() || result.subdirectories != knownSubdirectories;
+
+	for (const QString& subdirectory : knownSubdirectories)
+	{
+		if (!result.subdirectories.contains(subdirectory))
+		{
+			removeDirectory(job.path + subdirectory + "/");
+		}
+	}
+
+	QStringList scan;
+	for (const QString& subdirectory : result.subdirectories)
+	{
+		// new directories are scanned completely, even if only their parent
+		// was reported as changed
+		if (job.recursive || !knownSubdirectories.contains(subdirectory))
+		{
+			scan << job.path + subdirectory + "/";
+		}
+	}
+
+	{
+		QWriteLocker lock(&m_lock);
+		m_directories.insert(job.path, std::move(result));
+	}
+	if (changed) { m_dirty = true; }
+
+	for (const QString& path : scan)
+	{
+		enqueue(path, true);
+	}
+	QMetaObject::invokeMethod(this, "watchDirectories", Qt::QueuedConnection,
+		Q_ARG(QStringList, QStringList(job.path)));
+}
+
+
+
+
+SampleIndex::Entry SampleIndex::probe(const QFileInfo& info) const
+{
+	Entry entry;
+	entry.path = info.absoluteFilePath();
+	entry.key = info.fileName().toLower();
+	entry.type = typeOf(entry.key);
+	entry.size = info.size();
+	entry.modified = info.lastModified().toMSecsSinceEpoch();
+	if (entry.type != Type::Unknown) { return entry; }
+
+	// use the file handle for unicode file names on Windows
+	QFile f(entry.path);
+	SF_INFO sfInfo = {};
+	SNDFILE* sf = nullptr;
+	if (!f.open(QIODevice::ReadOnly)
+		|| (sf = sf_open_fd(f.handle(), SFM_READ, &sfInfo, false)) == nullptr)
+	{
+		return entry;
+	}
+
+	entry.type = Type::Sample;
+	entry.frames = static_cast<f_cnt_t>(sfInfo.frames);
+	entry.sampleRate = static_cast<sample_rate_t>(sfInfo.samplerate);
+
+	if (sfInfo.frames > 0 && sfInfo.frames <= static_cast<sf_count_t>(sfInfo.samplerate) * MaxPeakSeconds)
+	{
+		std::array<float, PeakCount> peaks = {};
+		std::vector<float> buf(PeakBlockFrames * sfInfo.channels);
+		sf_count_t frame = 0;
+		sf_count_t read = 0;
+		while (!m_quit && (read = sf_readf_float(sf, buf.data(), PeakBlockFrames)) > 0)
+		{
+			for (sf_count_t f = 0; f < read; ++f, ++frame)
+			{
+				const auto part = std::min<sf_count_t>(frame * PeakCount / sfInfo.frames, PeakCount - 1);
+				for (int ch = 0; ch < sfInfo.channels; ++ch)
+				{
+					peaks[part] = std::max(peaks[part], std::abs(buf[f * sfInfo.channels + ch]));
+				}
+			}
+		}
+		for (int part = 0; part < PeakCount; ++part)
+		{
+			entry.peaks[part] = static_cast<quint8>(std::lround(std::min(peaks[part], 1.0f) * 255));
+		}
+	}
+
+	sf_close(sf);
+	return entry;
+}
+
+
+
+
+void SampleIndex::removeDirectory(const QString& path)
+{
+	QWriteLocker lock(&m_lock);
+	for (auto it = m_directories.begin(); it != m_directories.end();)
+	{
+		if (it.key().startsWith(path))
+		{
+			it = m_directories.erase(it);
+			m_dirty = true;
+		}
+		else { ++it; }
+	}
+}
+
+
+
+
+void SampleIndex::markChanged(bool force)
+{
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	if (force || now - m_lastChange >= ChangeInterval)
+	{
+		m_lastChange = now;
+		emit changed();
+	}
+}
+
+
+
+
+bool SampleIndex::load()
+{
+	QFile file(cacheFile());
+	if (!file.open(QIODevice::ReadOnly)) { return false; }
+
+	QDataStream stream(&file);
+	quint32 magic = 0;
+	quint32 version = 0;
+	stream >> magic >> version;
+	if (magic != CacheFileMagic || version != CacheFileVersion) { return false; }
+
+	QHash<QString, Directory> directories;
+	quint32 directoryCount = 0;
+	stream >> directoryCount;
+	for (quint32 d = 0; d < directoryCount && stream.status() == QDataStream::Ok; ++d)
+	{
+		QString path;
+		Directory directory;
+		quint32 fileCount = 0;
+		stream >> path >> directory.subdirectories >> fileCount;
+		directory.files.resize(fileCount);
+		for (Entry& entry : directory.files)
+		{
+			stream >> entry;
+		}
+		directories.insert(path, std::move(directory));
+	}
+	if (stream.status() != QDataStream::Ok) { return false; }
+
+	QWriteLocker lock(&m_lock);
+	m_directories = std::move(directories);
+	return true;
+}
+
+
+
+
+bool SampleIndex::save() const
+{
+	QSaveFile file(cacheFile());
+	if (!file.open(QIODevice::WriteOnly)) { return false; }
+
+	QDataStream stream(&file);
+	stream << CacheFileMagic << CacheFileVersion;
+	{
+		QReadLocker lock(&m_lock);
+		stream << static_cast<quint32>(m_directories.size());
+		for (auto dir = m_directories.cbegin(); dir != m_directories.cend(); ++dir)
+		{
+			stream << dir.key() << dir->subdirectories << static_cast<quint32>(dir->files.size());
+			for (const Entry& entry : dir->files)
+			{
+				stream << entry;
+			}
+		}
+	}
+	return stream.status() == QDataStream::Ok && file.commit();
+}
+
+
+
+
+QString SampleIndex::cacheFile()
+{
+	return ConfigManager::inst()->workingDir() + "sampleindex.cache";
+}
+
+
+
+
+QString SampleIndex::directoryPath(const QString& path)
+{
+	const QString dir = QDir::cleanPath(QDir(path).absolutePath());
+	return dir.endsWith('/') ? dir : dir + '/';
+}
+
+
+} // namespace lmms
@@ -29,6 +29,7 @@
 #include "Note.h"
 #include "PatternTrack.h"
 #include "SampleClip.h"
+#include "SampleStream.h"
 #include "SampleTrack.h"
 
 namespace lmms
@@ -74,9 +75,35 @@ SamplePlayHandle::SamplePlayHandle( SampleClip* clip ) :
 
 
 
+SamplePlayHandle::SamplePlayHandle( std::shared_ptr<SampleStream> stream ) :
+	PlayHandle( TypeSamplePlayHandle ),
+	m_sampleBuffer( nullptr ),
+	m_stream( std::move( stream ) ),
+	m_doneMayReturnTrue( true ),
+	m_frame( 0 ),
+	m_ownAudioPort( true ),
+	m_defaultVolumeModel( DefaultVolume, MinVolume, MaxVolume, 1 ),
+	m_volumeModel( &m_defaultVolumeModel ),
+	m_track( nullptr ),
+	m_patternTrack( nullptr )
+{
+	setAudioPort( new AudioPort( "SamplePlayHandle", false ) );
+}
+
+
+
+
 SamplePlayHandle::~SamplePlayHandle()
 {
-	sharedObject::unref( m_sampleBuffer );
+	if( m_stream )
+	{
+		// the decoder finishes on its own, don't wait for it here
+		m_stream->cancel();
+	}
+	else
+	{
+		sharedObject::unref( m_sampleBuffer );
+	}
 	if( m_ownAudioPort )
 	{
 		delete audioPort();
@@ -89,6 +116,11 @@ SamplePlayHandle::~SamplePlayHandle()
 void SamplePlayHandle::play( sampleFrame * buffer )
 {
 	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+	if( m_stream )
+	{
+		playStream( buffer, fpp );
+		return;
+	}
 	//play( 0, _try_parallelizing );
 	if( framesDone() >= totalFrames() )
 	{
@@ -127,8 +159,27 @@ void SamplePlayHandle::play( sampleFrame * buffer )
 
 
 
+void SamplePlayHandle::playStream( sampleFrame * buffer, fpp_t frames )
+{
+	const fpp_t start = framesDone() == 0 ? offset() : 0;
+	memset( buffer, 0, sizeof( sampleFrame ) * start );
+
+	// frames the decoder hasn't delivered yet are played as silence
+	const f_cnt_t read = m_stream->read( buffer + start, frames - start );
+	memset( buffer + start + read, 0, sizeof( sampleFrame ) * ( frames - start - read ) );
+
+	m_frame += read;
+}
+
+
+
+
 bool SamplePlayHandle::isFinished() const
 {
+	if( m_stream )
+	{
+		return m_stream->isFinished() && m_doneMayReturnTrue == true;
+	}
 	return framesDone() >= totalFrames() && m_doneMayReturnTrue == true;
 }
 
@@ -145,6 +196,10 @@ bool SamplePlayHandle::isFromTrack( const Track * _track ) const
 
 f_cnt_t SamplePlayHandle::totalFrames() const
 {
+	if( m_stream )
+	{
+		return m_stream->totalFrames();
+	}
 	return ( m_sampleBuffer->endFrame() - m_sampleBuffer->startFrame() ) *
 			( Engine::audioEngine()->processingSampleRate() / m_sampleBuffer->sampleRate() );
 }
@@ -24,12 +24,11 @@
 
 
 #include "SampleRecordHandle.h"
+
 #include "AudioEngine.h"
 #include "Engine.h"
 #include "PatternTrack.h"
-#include "SampleBuffer.h"
 #include "SampleClip.h"
-#include "debug.h"
 
 
 namespace lmms
@@ -38,7 +37,7 @@ namespace lmms
 
 SampleRecordHandle::SampleRecordHandle( SampleClip* clip ) :
 	PlayHandle( TypeSamplePlayHandle ),
-	m_framesRecorded( 0 ),
+	m_take( clip->takeRecordTake() ),
 	m_minLength( clip->length() ),
 	m_track( clip->getTrack() ),
 	m_patternTrack( nullptr ),
@@ -51,18 +50,13 @@ SampleRecordHandle::SampleRecordHandle( SampleClip* clip ) :
 
 SampleRecordHandle::~SampleRecordHandle()
 {
-	if( !m_buffers.empty() )
-	{
-		SampleBuffer* sb;
-		createSampleBuffer( &sb );
-		m_clip->setSampleBuffer( sb );
-	}
-	
-	while( !m_buffers.empty() )
+	// the rest of the take is written in the background, so stopping
+	// doesn't stall - the clip gets the file once it is complete
+	if( m_take )
 	{
-		delete[] m_buffers.front().first;
-		m_buffers.erase( m_buffers.begin() );
+		Engine::diskRecorder()->finishTake( m_take );
 	}
+
 	m_clip->setRecord( false );
 }
 
@@ -71,12 +65,16 @@ SampleRecordHandle::~SampleRecordHandle()
 
 void SampleRecordHandle::play( sampleFrame * /*_working_buffer*/ )
 {
+	if( !m_take )
+	{
+		return;
+	}
+
 	const sampleFrame * recbuf = Engine::audioEngine()->inputBuffer();
 	const f_cnt_t frames = Engine::audioEngine()->inputBufferFrames();
-	writeBuffer( recbuf, frames );
-	m_framesRecorded += frames;
+	m_take->write( recbuf, frames );
 
-	TimePos len = (tick_t)( m_framesRecorded / Engine::framesPerTick() );
+	TimePos len = (tick_t)( framesRecorded() / Engine::framesPerTick() );
 	if( len > m_minLength )
 	{
 //		m_clip->changeLength( len );
@@ -105,50 +103,7 @@ bool SampleRecordHandle::isFromTrack( const Track * _track ) const
 
 f_cnt_t SampleRecordHandle::framesRecorded() const
 {
-	return( m_framesRecorded );
-}
-
-
-
-
-void SampleRecordHandle::createSampleBuffer( SampleBuffer** sampleBuf )
-{
-	const f_cnt_t frames = framesRecorded();
-	// create buffer to store all recorded buffers in
-	auto data = new sampleFrame[frames];
-	// make sure buffer is cleaned up properly at the end...
-	sampleFrame * data_ptr = data;
-
-
-	assert( data != nullptr );
-
-	// now copy all buffers into big buffer
-	for( bufferList::const_iterator it = m_buffers.begin(); it != m_buffers.end(); ++it )
-	{
-		memcpy( data_ptr, ( *it ).first, ( *it ).second *
-							sizeof( sampleFrame ) );
-		data_ptr += ( *it ).second;
-	}
-	// create according sample-buffer out of big buffer
-	*sampleBuf = new SampleBuffer( data, frames );
-	( *sampleBuf)->setSampleRate( Engine::audioEngine()->inputSampleRate() );
-	delete[] data;
-}
-
-
-
-
-void SampleRecordHandle::writeBuffer( const sampleFrame * _ab, const f_cnt_t _frames )
-{
-	auto buf = new sampleFrame[_frames];
-	for( f_cnt_t frame = 0; frame < _frames; ++frame )
-	{
-		for( ch_cnt_t chnl = 0; chnl < DEFAULT_CHANNELS; ++chnl )
-		{
-			buf[frame][chnl] = _ab[frame][chnl];
-		}
-	}
-	m_buffers.push_back( qMakePair( buf, _frames ) );
+	return m_take ? m_take->framesRecorded() : 0;
 }
 
 
@@ -0,0 +1,362 @@
+/*
+ * SampleStream.cpp - decodes a sample file in the background while it plays
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SampleStream.h"
+
+#include <algorithm>
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+#include <samplerate.h>
+#include <sndfile.h>
+
+#include "PathUtil.h"
+#include "SampleBuffer.h"
+
+namespace lmms
+{
+
+
+class SampleStream::DecodeJob : public QRunnable
+{
+public:
+	//! Decode until the whole file is decoded or just what fits into the ring
+	DecodeJob(std::shared_ptr<SampleStream> stream, bool wholeFile) :
+		m_stream(std::move(stream)),
+		m_wholeFile(wholeFile)
+	{
+	}
+
+	void run() override
+	{
+		bool done = m_stream->decodeWhatFits();
+		while (!done && m_wholeFile)
+		{
+			// nothing is signalled from the audio thread, so it never blocks
+			QThread::msleep(PollInterval);
+			done = m_stream->decodeWhatFits();
+		}
+		if (done) { m_stream->finishDecoding(); }
+
+		m_stream->m_decoding.store(false, std::memory_order_release);
+		m_stream->notifyReaders();
+	}
+
+private:
+	//! Keeps the stream alive even if the play handle was deleted meanwhile
+	std::shared_ptr<SampleStream> m_stream;
+	const bool m_wholeFile;
+} ;
+
+
+
+
+//! Where decoding continues, kept while the ring is full
+struct SampleStream::Decoder
+{
+	~Decoder()
+	{
+		if (resampler) { src_delete(resampler); }
+		if (sf) { sf_close(sf); }
+	}
+
+	// use the file handle for unicode file names on Windows
+	QFile file;
+	SNDFILE* sf = nullptr;
+	SF_INFO info = {};
+	SRC_STATE* resampler = nullptr;
+	double ratio = 1;
+
+	std::vector<float> raw;
+	std::vector<sampleFrame> in;
+	std::vector<sampleFrame> out;
+	//! Most frames a step writes to the ring
+	f_cnt_t stepFrames = 0;
+	//! Frames of the current block in "in" and how many were resampled
+	f_cnt_t frames = 0;
+	f_cnt_t used = 0;
+	bool haveBlock = false;
+	//! Whether the current block is the last one of the file
+	bool last = false;
+
+	//! Files libsndfile can't read are loaded as a whole by SampleBuffer and
+	//! resampled block by block just the same
+	std::unique_ptr<SampleBuffer> buffer;
+	f_cnt_t bufferFrame = 0;
+} ;
+
+
+
+
+SampleStream::SampleStream(const QString& file, sample_rate_t sampleRate, f_cnt_t startFrame) :
+	m_file(PathUtil::toAbsolute(file)),
+	m_sampleRate(sampleRate),
+	m_startFrame(startFrame),
+	m_ring(static_cast<std::size_t>(sampleRate) * RingSeconds),
+	m_reader(m_ring),
+	m_totalFrames(0),
+	m_decoded(false),
+	m_cancelled(false),
+	m_decoding(false)
+{
+}
+
+
+
+
+SampleStream::~SampleStream()
+{
+	cancel();
+}
+
+
+
+
+void SampleStream::start(QThreadPool* pool)
+{
+	m_decoding.store(true, std::memory_order_relaxed);
+	(pool ? pool : QThreadPool::globalInstance())->start(new DecodeJob(shared_from_this(), true));
+}
+
+
+
+
+bool SampleStream::decodeAhead(QThreadPool* pool)
+{
+	if (m_decoded.load(std::memory_order_acquire) || isCancelled())
+	{
+		return false;
+	}
+	// there's no point in starting a job which can't write a block
+	if (m_ring.free() < static_cast<std::size_t>(BlockFrames))
+	{
+		return true;
+	}
+	if (!m_decoding.exchange(true, std::memory_order_acq_rel))
+	{
+		pool->start(new DecodeJob(shared_from_this(), false));
+	}
+	return true;
+}
+
+
+
+
+void SampleStream::waitForFrames()
+{
+	if (!m_decoding.exchange(true, std::memory_order_acq_rel))
+	{
+		// nothing decodes, so do it here
+		if (decodeWhatFits()) { finishDecoding(); }
+		m_decoding.store(false, std::memory_order_release);
+		return;
+	}
+
+	QMutexLocker lock(&m_waitLock);
+	while (m_reader.empty() && !m_decoded.load(std::memory_order_acquire)
+		&& m_decoding.load(std::memory_order_acquire))
+	{
+		m_framesWritten.wait(&m_waitLock);
+	}
+}
+
+
+
+
+f_cnt_t SampleStream::read(sampleFrame* dst, f_cnt_t frames)
+{
+	auto input = m_reader.read_max(frames);
+	const auto count = static_cast<f_cnt_t>(input.size());
+	for (f_cnt_t f = 0; f < count; ++f)
+	{
+		dst[f] = input[f];
+	}
+	return count;
+}
+
+
+
+
+bool SampleStream::decodeWhatFits()
+{
+	if (!m_decoder)
+	{
+		m_decoder = std::make_unique<Decoder>();
+		if (!openDecoder()) { return true; }
+	}
+	Decoder& d = *m_decoder;
+
+	while (!isCancelled())
+	{
+		if (!d.haveBlock)
+		{
+			if (d.last) { return true; }
+
+			if (d.buffer)
+			{
+				d.frames = std::min(BlockFrames, d.buffer->frames() - d.bufferFrame);
+				std::copy_n(d.buffer->data() + d.bufferFrame, d.frames, d.in.begin());
+				d.bufferFrame += d.frames;
+				d.last = d.bufferFrame >= d.buffer->frames();
+			}
+			else
+			{
+				d.frames = static_cast<f_cnt_t>(sf_readf_float(d.sf, d.raw.data(), BlockFrames));
+				d.last = d.frames < BlockFrames;
+
+				// mono files are played on both channels, additional ones are dropped
+				for (f_cnt_t f = 0; f < d.frames; ++f)
+				{
+					const float* frame = d.raw.data() + f * d.info.channels;
+					d.in[f][0] = frame[0];
+					d.in[f][1] = d.info.channels > 1 ? frame[1] : frame[0];
+				}
+			}
+			d.used = 0;
+			d.haveBlock = true;
+		}
+
+		if (m_ring.free() < static_cast<std::size_t>(d.stepFrames)) { return false; }
+
+		if (!d.resampler)
+		{
+			write(d.in.data(), d.frames);
+			d.haveBlock = false;
+			continue;
+		}
+
+		// with end_of_input set, the resampler is drained until it doesn't
+		// generate anything more
+		SRC_DATA data = {};
+		data.data_in = d.in[0].data() + d.used * DEFAULT_CHANNELS;
+		data.input_frames = d.frames - d.used;
+		data.data_out = d.out[0].data();
+		data.output_frames = static_cast<long>(d.out.size());
+		data.src_ratio = d.ratio;
+		data.end_of_input = d.last;
+		if (const int error = src_process(d.resampler, &data))
+		{
+			qWarning("SampleStream: error while resampling %s: %s",
+				qPrintable(m_file), src_strerror(error));
+			cancel();
+			break;
+		}
+		d.used += data.input_frames_used;
+		write(d.out.data(), data.output_frames_gen);
+		if (data.output_frames_gen == 0 && d.used >= d.frames) { d.haveBlock = false; }
+	}
+	return true;
+}
+
+
+
+
+bool SampleStream::openDecoder()
+{
+	Decoder& d = *m_decoder;
+	d.file.setFileName(m_file);
+	if (d.file.open(QIODevice::ReadOnly))
+	{
+		d.sf = sf_open_fd(d.file.handle(), SFM_READ, &d.info, false);
+	}
+
+	sample_rate_t fileRate;
+	if (d.sf != nullptr)
+	{
+		fileRate = d.info.samplerate;
+	}
+	else
+	{
+		// SampleBuffer keeps the rate of files it decodes itself, e.g. the
+		// DrumSynth ones rendered at the processing rate
+		d.buffer = std::make_unique<SampleBuffer>(m_file);
+		if (d.buffer->frames() == 0) { return false; }
+		fileRate = d.buffer->sampleRate();
+	}
+
+	d.ratio = static_cast<double>(m_sampleRate) / fileRate;
+	int error = 0;
+	if (fileRate != m_sampleRate
+		&& (d.resampler = src_new(SRC_SINC_MEDIUM_QUALITY, DEFAULT_CHANNELS, &error)) == nullptr)
+	{
+		qWarning("SampleStream: can't resample %s: %s", qPrintable(m_file), src_strerror(error));
+		return false;
+	}
+
+	const auto startFrame = static_cast<f_cnt_t>(m_startFrame / d.ratio);
+	if (d.buffer)
+	{
+		m_totalFrames.store(static_cast<f_cnt_t>(d.buffer->frames() * d.ratio), std::memory_order_relaxed);
+		// past the end, there's nothing to play
+		if (startFrame >= d.buffer->frames()) { return false; }
+		d.bufferFrame = startFrame;
+	}
+	else
+	{
+		m_totalFrames.store(static_cast<f_cnt_t>(d.info.frames * d.ratio), std::memory_order_relaxed);
+		if (startFrame > 0 && sf_seek(d.sf, startFrame, SEEK_SET) < 0) { return false; }
+		d.raw.resize(static_cast<std::size_t>(BlockFrames) * d.info.channels);
+	}
+
+	d.in.resize(BlockFrames);
+	d.out.resize(static_cast<std::size_t>(BlockFrames * d.ratio) + 1);
+	d.stepFrames = d.resampler ? static_cast<f_cnt_t>(d.out.size()) : BlockFrames;
+	return true;
+}
+
+
+
+
+void SampleStream::finishDecoding()
+{
+	m_decoder.reset();
+	m_decoded.store(true, std::memory_order_release);
+}
+
+
+
+
+void SampleStream::write(const sampleFrame* buf, f_cnt_t frames)
+{
+	m_ring.write(buf, frames);
+	notifyReaders();
+}
+
+
+
+
+void SampleStream::notifyReaders()
+{
+	// taking the lock makes sure a reader which found nothing to read is
+	// waiting already
+	QMutexLocker lock(&m_waitLock);
+	m_framesWritten.wakeAll();
+}
+
+
+} // namespace lmms
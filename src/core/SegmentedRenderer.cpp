@@ -0,0 +1,449 @@
+/*
+ * SegmentedRenderer.cpp - renders a project in segments, each in its own LMMS
+ *                         process, and splices them into one file
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SegmentedRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QThread>
+
+#include <sndfile.h>
+
+#include "AudioFileDevice.h"
+#include "Engine.h"
+
+
+namespace lmms
+{
+
+namespace
+{
+
+//! Frames read and encoded at once while splicing
+constexpr f_cnt_t ChunkFrames = 4096;
+
+//! A file opened for reading with libsndfile
+class SoundFile
+{
+public:
+	explicit SoundFile(const QString & path) :
+		m_file(path),
+		m_sndFile(nullptr),
+		m_info()
+	{
+		if (m_file.open(QIODevice::ReadOnly))
+		{
+			m_sndFile = sf_open_fd(m_file.handle(), SFM_READ, &m_info, false);
+		}
+	}
+
+	~SoundFile()
+	{
+		if (m_sndFile) { sf_close(m_sndFile); }
+	}
+
+	bool isOpen() const { return m_sndFile != nullptr; }
+	f_cnt_t frames() const { return static_cast<f_cnt_t>(m_info.frames); }
+	int channels() const { return m_info.channels; }
+	sample_rate_t sampleRate() const { return static_cast<sample_rate_t>(m_info.samplerate); }
+
+	//! Read the next frames, mapping the file's channels onto a surround frame
+	bool read(surroundSampleFrame * frames, f_cnt_t count)
+	{
+		m_samples.resize(static_cast<std::size_t>(count) * m_info.channels);
+		if (sf_readf_float(m_sndFile, m_samples.data(), count) != count) { return false; }
+
+		for (f_cnt_t f = 0; f < count; ++f)
+		{
+			for (ch_cnt_t ch = 0; ch < SURROUND_CHANNELS; ++ch)
+			{
+				frames[f][ch] = m_samples[f * m_info.channels + ch % m_info.channels];
+			}
+		}
+		return true;
+	}
+
+private:
+	QFile m_file;
+	SNDFILE * m_sndFile;
+	SF_INFO m_info;
+	std::vector<float> m_samples;
+} ;
+
+} // namespace
+
+
+
+
+SegmentedRenderer::SegmentedRenderer(
+		const AudioEngine::qualitySettings & qualitySettings,
+		const OutputSettings & outputSettings,
+		const QVector<ProjectRenderer::ExportFileFormats> & formats,
+		const QString & outputPath,
+		const Settings & settings) :
+	m_qualitySettings(qualitySettings),
+	m_outputSettings(outputSettings),
+	m_formats(formats),
+	m_outputPath(outputPath),
+	m_settings(settings),
+	m_nextSegment(0),
+	m_running(0),
+	m_done(0),
+	m_failed(false)
+{
+}
+
+
+
+
+SegmentedRenderer::~SegmentedRenderer()
+{
+	abortProcessing();
+}
+
+
+
+
+void SegmentedRenderer::render()
+{
+	if (!m_tempDir.isValid())
+	{
+		fail("Could not create a directory for the segments");
+		return;
+	}
+
+	// split at bar boundaries, so that every segment starts on a tick
+	const bar_t firstBar = m_settings.begin.getBar();
+	const bar_t bars = m_settings.end.getBar() - firstBar;
+	if (bars < 1)
+	{
+		// there's no --range for less than a bar
+		fail("The range to render is empty");
+		return;
+	}
+	const int count = std::max(1, std::min(m_settings.segments, bars));
+	for (int i = 0; i < count; ++i)
+	{
+		Segment segment;
+		segment.begin = TimePos(firstBar + bars * i / count, 0);
+		segment.end = TimePos(firstBar + bars * (i + 1) / count, 0);
+		segment.path = m_tempDir.filePath(QString("segment-%1.wav").arg(i + 1));
+		m_segments.push_back(std::move(segment));
+	}
+
+	// more processes than cores would only compete for them
+	const int parallel = std::max(1, QThread::idealThreadCount());
+	while (m_running < parallel && m_nextSegment < m_segments.size())
+	{
+		startNextSegment();
+	}
+}
+
+
+
+
+void SegmentedRenderer::abortProcessing()
+{
+	m_failed = true;
+	for (auto& segment : m_segments)
+	{
+		if (segment.process && segment.process->state() != QProcess::NotRunning)
+		{
+			segment.process->kill();
+			segment.process->waitForFinished();
+		}
+	}
+}
+
+
+
+
+void SegmentedRenderer::updateConsoleProgress()
+{
+	fprintf(stderr, "\rRendered %d of %d segments  ", m_done, static_cast<int>(m_segments.size()));
+	fflush(stderr);
+}
+
+
+
+
+SegmentedRenderer::Difference SegmentedRenderer::compare(const QString & reference, const QString & file,
+															double threshold)
+{
+	Difference result;
+
+	SoundFile a(reference);
+	SoundFile b(file);
+	if (!a.isOpen() || !b.isOpen())
+	{
+		result.error = QString("Could not open %1").arg(a.isOpen() ? file : reference);
+		return result;
+	}
+	if (a.channels() != b.channels() || a.sampleRate() != b.sampleRate())
+	{
+		result.error = "The files differ in their channels or sample rate";
+		return result;
+	}
+
+	result.sampleRate = a.sampleRate();
+	result.frames = std::min(a.frames(), b.frames());
+	result.lengthDifference = b.frames() - a.frames();
+
+	const int channels = std::min<int>(a.channels(), SURROUND_CHANNELS);
+	std::vector<surroundSampleFrame> bufferA(ChunkFrames);
+	std::vector<surroundSampleFrame> bufferB(ChunkFrames);
+	double sumOfSquares = 0.0;
+
+	for (f_cnt_t position = 0; position < result.frames; position += ChunkFrames)
+	{
+		const f_cnt_t chunk = std::min(ChunkFrames, result.frames - position);
+		if (!a.read(bufferA.data(), chunk) || !b.read(bufferB.data(), chunk))
+		{
+			result.error = "Could not read the files";
+			return result;
+		}
+
+		for (f_cnt_t f = 0; f < chunk; ++f)
+		{
+			for (int ch = 0; ch < channels; ++ch)
+			{
+				const double difference = std::abs(static_cast<double>(bufferA[f][ch]) - bufferB[f][ch]);
+				result.peak = std::max(result.peak, difference);
+				sumOfSquares += difference * difference;
+				if (result.firstDifferentFrame < 0 && difference > threshold)
+				{
+					result.firstDifferentFrame = position + f;
+				}
+			}
+		}
+	}
+
+	if (result.frames > 0)
+	{
+		result.rms = std::sqrt(sumOfSquares / (static_cast<double>(result.frames) * channels));
+	}
+	return result;
+}
+
+
+
+
+void SegmentedRenderer::segmentFinished(std::size_t index, int exitCode, QProcess::ExitStatus exitStatus)
+{
+	--m_running;
+	if (m_failed) { return; }
+
+	if (exitStatus != QProcess::NormalExit || exitCode != EXIT_SUCCESS)
+	{
+		const QByteArray output = m_segments[index].process->readAllStandardError();
+		fail(QString("Rendering segment %1 failed:\n%2").arg(index + 1).arg(QString::fromLocal8Bit(output)));
+		return;
+	}
+
+	++m_done;
+	if (m_nextSegment < m_segments.size())
+	{
+		startNextSegment();
+	}
+	else if (m_done == static_cast<int>(m_segments.size()))
+	{
+		if (splice())
+		{
+			m_tempDir.remove();
+			emit finished(true);
+		}
+	}
+}
+
+
+
+
+QStringList SegmentedRenderer::argumentsFor(const Segment & segment) const
+{
+	static const char * const interpolations[] = { "linear", "sincfastest", "sincmedium", "sincbest" };
+
+	QStringList arguments = m_settings.extraArguments;
+	arguments << "render" << m_settings.projectFile
+		<< "--range" << QString("%1:%2").arg(segment.begin.getBar() + 1).arg(segment.end.getBar())
+		<< "--preroll" << QString::number(m_settings.preRollBars)
+		<< "--output" << segment.path
+		<< "--format" << "wav"
+		<< "--float"
+		<< "--samplerate" << QString::number(m_outputSettings.getSampleRate())
+		<< "--interpolation" << interpolations[m_qualitySettings.interpolation]
+		<< "--oversampling" << QString::number(m_qualitySettings.sampleRateMultiplier())
+		<< "--blocksize" << QString::number(Engine::audioEngine()->framesPerPeriod());
+
+	// the last segment has nothing to crossfade into
+	if (&segment != &m_segments.back() && m_settings.crossfadeFrames > 0)
+	{
+		arguments << "--overlap" << QString::number(m_settings.crossfadeFrames);
+	}
+	return arguments;
+}
+
+
+
+
+void SegmentedRenderer::startNextSegment()
+{
+	const std::size_t index = m_nextSegment++;
+	Segment & segment = m_segments[index];
+
+	segment.process = std::make_unique<QProcess>();
+	segment.process->setStandardOutputFile(QProcess::nullDevice());
+	connect(segment.process.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+		[this, index](int exitCode, QProcess::ExitStatus exitStatus) { segmentFinished(index, exitCode, exitStatus); });
+	connect(segment.process.get(), &QProcess::errorOccurred, this, [this, index](QProcess::ProcessError error) {
+		if (error == QProcess::FailedToStart && !m_failed)
+		{
+			fail(QString("Could not start the process for segment %1").arg(index + 1));
+		}
+	});
+
+	++m_running;
+	segment.process->start(QCoreApplication::applicationFilePath(), argumentsFor(segment));
+}
+
+
+
+
+bool SegmentedRenderer::splice()
+{
+	std::vector<std::unique_ptr<AudioFileDevice>> encoders;
+	for (auto format : m_formats)
+	{
+		const AudioFileDeviceInstantiaton factory = ProjectRenderer::fileEncodeDevices[format].m_getDevInst;
+		if (!factory)
+		{
+			fail("The output format is not supported by this build");
+			return false;
+		}
+
+		// the first format keeps the path as it is
+		const QString path = encoders.empty() ? m_outputPath : ProjectRenderer::pathForFormat(m_outputPath, format);
+		bool successful = false;
+		encoders.emplace_back(factory(path, m_outputSettings, DEFAULT_CHANNELS, Engine::audioEngine(),
+			successful));
+		if (!successful)
+		{
+			fail(QString("Could not open %1 for writing").arg(path));
+			return false;
+		}
+	}
+
+	// the segments already have the master gain applied
+	const auto encode = [this, &encoders](const surroundSampleFrame * frames, f_cnt_t count)
+	{
+		for (const auto& encoder : encoders)
+		{
+			encoder->encodeBuffer(frames, static_cast<fpp_t>(count), 1.0f, m_outputSettings.getSampleRate());
+		}
+	};
+
+	QStringList files;
+	for (const auto& segment : m_segments)
+	{
+		files << segment.path;
+	}
+	const QString error = spliceFiles(files, m_settings.crossfadeFrames, encode);
+	if (!error.isEmpty())
+	{
+		fail(error);
+		return false;
+	}
+	return true;
+}
+
+
+
+
+QString SegmentedRenderer::spliceFiles(const QStringList & files, f_cnt_t crossfadeFrames,
+										const EncodeFunction & encode)
+{
+	std::vector<surroundSampleFrame> buffer(ChunkFrames);
+	// the frames the previous segment rendered past its end
+	std::vector<surroundSampleFrame> overlap;
+
+	for (int i = 0; i < files.size(); ++i)
+	{
+		const QString readError = QString("Could not read segment %1").arg(i + 1);
+		SoundFile file(files[i]);
+		if (!file.isOpen()) { return readError; }
+
+		const f_cnt_t length = file.frames();
+		const f_cnt_t fade = std::min(static_cast<f_cnt_t>(overlap.size()), length);
+		const f_cnt_t nextOverlap = i + 1 < files.size()
+			? std::min(crossfadeFrames, length - fade) : 0;
+
+		// crossfade linearly, as both sides render the same material
+		for (f_cnt_t position = 0; position < fade; position += ChunkFrames)
+		{
+			const f_cnt_t chunk = std::min(ChunkFrames, fade - position);
+			if (!file.read(buffer.data(), chunk)) { return readError; }
+
+			for (f_cnt_t f = 0; f < chunk; ++f)
+			{
+				const float in = (position + f + 0.5f) / fade;
+				for (ch_cnt_t ch = 0; ch < SURROUND_CHANNELS; ++ch)
+				{
+					buffer[f][ch] = overlap[position + f][ch] * (1.0f - in) + buffer[f][ch] * in;
+				}
+			}
+			encode(buffer.data(), chunk);
+		}
+
+		for (f_cnt_t position = fade; position < length - nextOverlap; position += ChunkFrames)
+		{
+			const f_cnt_t chunk = std::min(ChunkFrames, length - nextOverlap - position);
+			if (!file.read(buffer.data(), chunk)) { return readError; }
+			encode(buffer.data(), chunk);
+		}
+
+		overlap.resize(nextOverlap);
+		if (nextOverlap > 0 && !file.read(overlap.data(), nextOverlap)) { return readError; }
+	}
+
+	return QString();
+}
+
+
+
+
+void SegmentedRenderer::fail(const QString & message)
+{
+	abortProcessing();
+	m_tempDir.remove();
+	fprintf(stderr, "\n%s\n", message.toLocal8Bit().constData());
+	emit finished(false);
+}
+
+
+} // namespace lmms
@@ -97,6 +97,9 @@ Song::Song() :
 	m_elapsedBars( 0 ),
 	m_loopRenderCount(1),
 	m_loopRenderRemaining(1),
+	m_exportFrames(0),
+	m_exportBeginFrame(-1),
+	m_exportEndFrame(-1),
 	m_oldAutomatedValues()
 {
 	for (double& millisecondsElapsed : m_elapsedMilliSeconds) { millisecondsElapsed = 0; }
@@ -335,10 +338,18 @@ void Song::processNextBuffer()
 			m_vstSyncController.update();
 		}
 
+		if (m_exporting && static_cast<f_cnt_t>(frameOffsetInTick) == 0)
+		{
+			// Remember the exact frames at which the export begins and ends
+			const f_cnt_t frame = m_exportFrames + frameOffsetInPeriod;
+			if (m_exportBeginFrame < 0 && getPlayPos() >= m_exportOutputBegin) { m_exportBeginFrame = frame; }
+			if (m_exportEndFrame < 0 && getPlayPos() >= m_exportSongEnd) { m_exportEndFrame = frame; }
+		}
+
 		if (static_cast<f_cnt_t>(frameOffsetInTick) == 0)
 		{
 			// First frame of tick: process automation and play tracks
-			processAutomations(trackList, getPlayPos(), framesToPlay);
+			processAutomations(trackList, getPlayPos(), framesToPlay, frameOffsetInPeriod);
 			for (const auto track : trackList)
 			{
 				track->play(getPlayPos(), framesToPlay, frameOffsetInPeriod, clipNum);
@@ -353,10 +364,12 @@ void Song::processNextBuffer()
 		m_elapsedBars = m_playPos[Mode_PlaySong].getBar();
 		m_elapsedTicks = (m_playPos[Mode_PlaySong].getTicks() % ticksPerBar()) / 48;
 	}
+
+	if (m_exporting) { m_exportFrames += framesPerPeriod; }
 }
 
 
-void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp_t)
+void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp_t, f_cnt_t frameOffsetInPeriod)
 {
 	AutomatedValueMap values;
 
@@ -424,7 +437,9 @@ void Song::processAutomations(const TrackList &tracklist, TimePos timeStart, fpp
 	{
 		if (! recordedModels.contains(it.key()))
 		{
-			it.key()->setAutomatedValue(it.value());
+			// periods longer than a tick get a value for each tick, see
+			// AutomatableModel::valueBuffer()
+			it.key()->setAutomatedValue(it.value(), static_cast<fpp_t>(frameOffsetInPeriod));
 		}
 		else if (!it.key()->useControllerValue())
 		{
@@ -718,7 +733,14 @@ void Song::startExport()
 	m_exporting = true;
 	updateLength();
 
-	if (m_renderBetweenMarkers)
+	if (m_exportRange)
+	{
+		m_exportSongBegin = m_exportLoopBegin = m_exportLoopEnd = m_exportRange->preRollBegin;
+		m_exportSongEnd = m_exportRange->end;
+
+		m_playPos[Mode_PlaySong].setTicks( m_exportRange->preRollBegin.getTicks() );
+	}
+	else if (m_renderBetweenMarkers)
 	{
 		m_exportSongBegin = m_exportLoopBegin = m_playPos[Mode_PlaySong].m_timeLine->loopBegin();
 		m_exportSongEnd = m_exportLoopEnd = m_playPos[Mode_PlaySong].m_timeLine->loopEnd();
@@ -757,6 +779,10 @@ void Song::startExport()
 		* m_loopRenderCount + (m_exportSongEnd - m_exportLoopEnd);
 	m_loopRenderRemaining = m_loopRenderCount;
 
+	m_exportOutputBegin = m_exportRange ? m_exportRange->begin : m_exportSongBegin;
+	m_exportFrames = 0;
+	m_exportBeginFrame = m_exportEndFrame = -1;
+
 	playSong();
 
 	m_vstSyncController.setPlaybackState( true );
@@ -1467,7 +1493,10 @@ void Song::removeController( Controller * controller )
 		m_controllers.remove( index );
 
 		emit controllerRemoved( controller );
+		// the audio engine might be evaluating it
+		Engine::audioEngine()->requestChangeInModel();
 		delete controller;
+		Engine::audioEngine()->doneChangeInModel();
 
 		this->setModified();
 	}
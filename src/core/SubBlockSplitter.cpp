@@ -0,0 +1,101 @@
+/*
+ * SubBlockSplitter.cpp - splits periods where automated controls change
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "SubBlockSplitter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "AudioEngine.h"
+#include "ConfigManager.h"
+#include "Engine.h"
+
+namespace lmms
+{
+
+
+SubBlockSplitter::SubBlockSplitter() :
+	SubBlockSplitter(static_cast<fpp_t>(ConfigManager::inst()->value("audioengine", "subblockframes",
+		QString::number(DefaultBlockFrames)).toInt()))
+{
+}
+
+
+
+
+SubBlockSplitter::SubBlockSplitter(fpp_t blockFrames) :
+	m_blockFrames(blockFrames > 0 ? std::clamp(blockFrames, MinBlockFrames, MaxBlockFrames) : 0)
+{
+	// render-only engines may run periods of up to MAXIMUM_RENDER_BLOCK_SIZE
+	m_bounds.reserve(Engine::audioEngine()->framesPerPeriod() / MinBlockFrames + 2);
+}
+
+
+
+
+void SubBlockSplitter::reserve(std::size_t controls)
+{
+	m_controls.reserve(controls);
+}
+
+
+
+
+void SubBlockSplitter::addControl(const float* values, float tolerance)
+{
+	m_controls.push_back({values, tolerance});
+}
+
+
+
+
+std::size_t SubBlockSplitter::split(fpp_t frames)
+{
+	m_bounds.clear();
+	m_bounds.push_back(0);
+
+	if (isEnabled() && !m_controls.empty())
+	{
+		fpp_t start = 0;
+		for (fpp_t frame = m_blockFrames; frame < frames; frame += m_blockFrames)
+		{
+			const bool moved = std::any_of(m_controls.begin(), m_controls.end(),
+				[start, frame](const Control& c)
+				{
+					return std::abs(c.values[frame] - c.values[start]) > c.tolerance;
+				});
+			if (moved)
+			{
+				m_bounds.push_back(frame);
+				start = frame;
+			}
+		}
+	}
+
+	m_bounds.push_back(frames);
+	return m_bounds.size() - 1;
+}
+
+
+} // namespace lmms
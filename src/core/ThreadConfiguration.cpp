@@ -0,0 +1,310 @@
+/*
+ * ThreadConfiguration.cpp - worker count, CPU affinity and scheduling policy
+ *                           of the audio threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ThreadConfiguration.h"
+
+#include <cerrno>
+#include <cstring>
+#include <optional>
+
+#include <QStringList>
+#include <QThread>
+
+#include "ConfigManager.h"
+#include "lmmsconfig.h"
+
+#ifdef LMMS_BUILD_WIN32
+#include <windows.h>
+#endif
+
+#ifdef LMMS_HAVE_SCHED_H
+#include <sched.h>
+#endif
+
+#ifdef LMMS_HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#ifdef LMMS_HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+namespace lmms
+{
+
+
+// read on first use, the configuration file is loaded late in main()
+static std::optional<ThreadConfiguration> s_current;
+
+
+
+
+ThreadConfiguration ThreadConfiguration::fromConfig( const QMap<QString, QString> & overrides )
+{
+	const auto value = [&overrides]( const QString & key )
+	{
+		return overrides.contains( key ) ? overrides[key] :
+			ConfigManager::inst()->value( "audioengine", key );
+	};
+
+	ThreadConfiguration configuration;
+
+	bool ok = false;
+	const int workers = value( "workers" ).toInt( &ok );
+	if( ok && workers >= -1 )
+	{
+		configuration.workers = workers;
+	}
+
+	// invalid values are ignored, main() rejects them on the command line
+	parseCpuList( value( "rendercpus" ), configuration.render.cpus );
+	parseCpuList( value( "workercpus" ), configuration.worker.cpus );
+	parsePriority( value( "renderpriority" ), configuration.render );
+	parsePriority( value( "workerpriority" ), configuration.worker );
+	configuration.lockMemory = value( "lockmemory" ).toInt();
+
+	return configuration;
+}
+
+
+
+
+const ThreadConfiguration & ThreadConfiguration::current()
+{
+	if( !s_current )
+	{
+		s_current = fromConfig();
+	}
+	return *s_current;
+}
+
+
+
+
+void ThreadConfiguration::setCurrent( const ThreadConfiguration & configuration )
+{
+	s_current = configuration;
+}
+
+
+
+
+int ThreadConfiguration::effectiveWorkers() const
+{
+	// the render thread processes jobs as well, so one core is taken
+	return workers >= 0 ? workers : qMax( 0, QThread::idealThreadCount() - 1 );
+}
+
+
+
+
+bool ThreadConfiguration::parseCpuList( const QString & text, QList<int> & cpus )
+{
+	QList<int> result;
+	for( const QString & part : text.split( ',' ) )
+	{
+		if( part.trimmed().isEmpty() )
+		{
+			continue;
+		}
+		const QStringList bounds = part.trimmed().split( '-' );
+		bool firstOk = false, lastOk = false;
+		const int first = bounds.front().toInt( &firstOk );
+		const int last = bounds.back().toInt( &lastOk );
+		if( bounds.size() > 2 || !firstOk || !lastOk || first < 0 || last < first )
+		{
+			return false;
+		}
+		for( int cpu = first; cpu <= last; ++cpu )
+		{
+			if( !result.contains( cpu ) )
+			{
+				result.push_back( cpu );
+			}
+		}
+	}
+
+	cpus = result;
+	return true;
+}
+
+
+
+
+QString ThreadConfiguration::cpuListToString( const QList<int> & cpus )
+{
+	QStringList parts;
+	for( int cpu : cpus )
+	{
+		parts << QString::number( cpu );
+	}
+	return parts.join( ',' );
+}
+
+
+
+
+bool ThreadConfiguration::parsePriority( const QString & text, ThreadSettings & settings )
+{
+	if( text.isEmpty() )
+	{
+		return true;
+	}
+
+	const QStringList parts = text.trimmed().toLower().split( ':' );
+	ThreadSettings result = settings;
+	if( parts.front() == "default" ) { result.policy = Policy::Default; }
+	else if( parts.front() == "fifo" ) { result.policy = Policy::Fifo; }
+	else if( parts.front() == "rr" ) { result.policy = Policy::RoundRobin; }
+	else { return false; }
+
+	result.priority = 0;
+	if( parts.size() == 2 )
+	{
+		bool ok = false;
+		result.priority = parts.back().toInt( &ok );
+		if( !ok || result.priority < 0 )
+		{
+			return false;
+		}
+	}
+	else if( parts.size() > 2 )
+	{
+		return false;
+	}
+
+	settings = result;
+	return true;
+}
+
+
+
+
+QString ThreadConfiguration::priorityToString( const ThreadSettings & settings )
+{
+	switch( settings.policy )
+	{
+		case Policy::Fifo:
+			return QString( "fifo:%1" ).arg( settings.priority );
+		case Policy::RoundRobin:
+			return QString( "rr:%1" ).arg( settings.priority );
+		default:
+			return "default";
+	}
+}
+
+
+
+
+QString ThreadConfiguration::applyToCurrentThread( const ThreadSettings & settings, int index )
+{
+	QStringList report;
+
+	if( !settings.cpus.isEmpty() )
+	{
+		QList<int> cpus = settings.cpus;
+		if( index >= 0 )
+		{
+			cpus = { settings.cpus[index % settings.cpus.size()] };
+		}
+
+		QString error;
+#if defined(LMMS_BUILD_LINUX) || defined(LMMS_BUILD_FREEBSD)
+#ifdef LMMS_HAVE_SCHED_H
+		cpu_set_t mask;
+		CPU_ZERO( &mask );
+		for( int cpu : cpus )
+		{
+			if( cpu < CPU_SETSIZE ) { CPU_SET( cpu, &mask ); }
+		}
+		// on Linux, 0 stands for the calling thread
+		if( sched_setaffinity( 0, sizeof( mask ), &mask ) != 0 )
+		{
+			error = strerror( errno );
+		}
+#else
+		error = "not supported";
+#endif
+#elif defined(LMMS_BUILD_WIN32)
+		DWORD_PTR mask = 0;
+		for( int cpu : cpus )
+		{
+			if( cpu < static_cast<int>( sizeof( mask ) * 8 ) ) { mask |= DWORD_PTR( 1 ) << cpu; }
+		}
+		if( SetThreadAffinityMask( GetCurrentThread(), mask ) == 0 )
+		{
+			error = QString( "error %1" ).arg( GetLastError() );
+		}
+#else
+		error = "not supported";
+#endif
+		report << ( error.isEmpty()
+			? QString( "cpus %1" ).arg( cpuListToString( cpus ) )
+			: QString( "cpus %1 failed (%2)" ).arg( cpuListToString( cpus ), error ) );
+	}
+
+	if( settings.policy != Policy::Default )
+	{
+		QString applied = priorityToString( settings );
+#if defined(LMMS_HAVE_PTHREAD_H) && defined(LMMS_HAVE_SCHED_H) && !defined(LMMS_BUILD_WIN32)
+		const int policy = settings.policy == Policy::Fifo ? SCHED_FIFO : SCHED_RR;
+		const int min = sched_get_priority_min( policy );
+		const int max = sched_get_priority_max( policy );
+		sched_param param;
+		param.sched_priority = settings.priority > 0
+			? qBound( min, settings.priority, max ) : ( min + max ) / 2;
+		applied = QString( "%1:%2" ).arg( settings.policy == Policy::Fifo ? "fifo" : "rr" )
+			.arg( param.sched_priority );
+
+		const int result = pthread_setschedparam( pthread_self(), policy, &param );
+		report << ( result == 0 ? applied : QString( "%1 failed (%2)" ).arg( applied, strerror( result ) ) );
+#else
+		report << QString( "%1 failed (not supported)" ).arg( applied );
+#endif
+	}
+
+	return report.isEmpty() ? QString( "unchanged" ) : report.join( ", " );
+}
+
+
+
+
+bool ThreadConfiguration::lockProcessMemory( QString & error )
+{
+#ifdef LMMS_HAVE_SYS_MMAN_H
+	if( mlockall( MCL_CURRENT | MCL_FUTURE ) != 0 )
+	{
+		error = strerror( errno );
+		return false;
+	}
+	return true;
+#else
+	error = "not supported";
+	return false;
+#endif
+}
+
+
+} // namespace lmms
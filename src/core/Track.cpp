@@ -36,6 +36,7 @@
 #include "AutomationTrack.h"
 #include "ConfigManager.h"
 #include "Engine.h"
+#include "FrozenStem.h"
 #include "InstrumentTrack.h"
 #include "PatternStore.h"
 #include "PatternTrack.h"
@@ -66,7 +67,8 @@ Track::Track( TrackTypes type, TrackContainer * tc ) :
 	m_simpleSerializingMode( false ),
 	m_clips(),        /*!< The clips (segments) */
 	m_color( 0, 0, 0 ),
-	m_hasColor( false )
+	m_hasColor( false ),
+	m_frozenStem( nullptr )
 {
 	m_trackContainer->addTrack( this );
 	m_height = -1;
@@ -81,6 +83,11 @@ Track::Track( TrackTypes type, TrackContainer * tc ) :
  */
 Track::~Track()
 {
+	if( m_frozenStem )
+	{
+		Engine::audioEngine()->removePlayHandle( m_frozenStem );
+	}
+
 	lock();
 	emit destroyedTrack();
 
@@ -213,6 +220,11 @@ void Track::saveSettings( QDomDocument & doc, QDomElement & element )
 	{
 		element.setAttribute( "color", m_color.name() );
 	}
+
+	if( m_frozenStem )
+	{
+		element.setAttribute( "frozen", m_frozenStem->key() );
+	}
 	
 	QDomElement tsDe = doc.createElement( nodeName() );
 	// let actual track (InstrumentTrack, PatternTrack, SampleTrack etc.) save its settings
@@ -263,6 +275,8 @@ void Track::loadSettings( const QDomElement & element )
 	// Get the mutedBeforeSolo value so we can recover the muted state if any solo was active.
 	// Older project files that didn't have this attribute will set the value to false (issue 5562)
 	m_mutedBeforeSolo = QVariant( element.attribute( "mutedBeforeSolo", "0" ) ).toBool();
+	// read before the track specific settings, see TrackFreezer
+	m_savedFreezeKey = element.attribute( "frozen" );
 
 	if( element.hasAttribute( "color" ) )
 	{
@@ -0,0 +1,995 @@
+/*
+ * TrackFreezer.cpp - renders tracks to stems which are played instead
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "TrackFreezer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <sndfile.h>
+
+#include "AudioDevice.h"
+#include "AudioEngine.h"
+#include "AudioPort.h"
+#include "AutomationClip.h"
+#include "ConfigManager.h"
+#include "EffectChain.h"
+#include "Engine.h"
+#include "FrozenStem.h"
+#include "InstrumentTrack.h"
+#include "MemoryManager.h"
+#include "PatternStore.h"
+#include "PatternTrack.h"
+#include "ProjectJournal.h"
+#include "Song.h"
+#include "TimeLineWidget.h"
+
+namespace lmms
+{
+
+
+namespace
+{
+
+//! Instrument tracks whose output makes up the stem of @p track
+QVector<InstrumentTrack*> sourceTracks(Track* track)
+{
+	QVector<InstrumentTrack*> sources;
+	if (track->type() == Track::InstrumentTrack)
+	{
+		sources << static_cast<InstrumentTrack*>(track);
+	}
+	else if (track->type() == Track::PatternTrack)
+	{
+		for (Track* patternTrack : Engine::patternStore()->tracks())
+		{
+			if (patternTrack->type() == Track::InstrumentTrack)
+			{
+				sources << static_cast<InstrumentTrack*>(patternTrack);
+			}
+		}
+	}
+	return sources;
+}
+
+
+
+
+//! @p track and the tracks it plays, which make up its state
+QVector<Track*> stateTracks(Track* track)
+{
+	QVector<Track*> tracks{track};
+	if (track->type() == Track::PatternTrack)
+	{
+		for (Track* patternTrack : Engine::patternStore()->tracks())
+		{
+			tracks << patternTrack;
+		}
+	}
+	return tracks;
+}
+
+
+
+
+bool hasControllers(const QDomElement& element)
+{
+	return !element.elementsByTagName("connection").isEmpty();
+}
+
+
+
+
+//! Whether @p element saves a model which is automated right now
+bool isAutomatedModel(const QDomElement& element)
+{
+	if (!element.hasAttribute("id")) { return false; }
+	const auto id = ProjectJournal::idFromSave(element.attribute("id").toUInt());
+	const auto model = dynamic_cast<AutomatableModel*>(Engine::projectJournal()->journallingObject(id));
+	return model && model->isAutomated();
+}
+
+
+
+
+bool hasAutomatedModels(const QDomElement& element)
+{
+	if (isAutomatedModel(element)) { return true; }
+	for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement())
+	{
+		if (hasAutomatedModels(child)) { return true; }
+	}
+	return false;
+}
+
+
+
+
+//! Feed @p element to @p hash in a form which only changes with what it
+//! sounds like, @p frozenTrack being the saved track to be frozen
+void addElement(QCryptographicHash& hash, const QDomElement& element, const QDomElement& frozenTrack)
+{
+	// settings of the track which don't change its output
+	static const QStringList trackAttributes{"name", "muted", "solo", "mutedBeforeSolo",
+		"trackheight", "color", "frozen"};
+
+	const bool isFrozenTrack = element == frozenTrack;
+	// the value of an automated model is whatever it was when it was saved
+	const bool automated = isAutomatedModel(element);
+
+	QStringList attributes;
+	const QDomNamedNodeMap map = element.attributes();
+	for (int i = 0; i < map.count(); ++i)
+	{
+		const QDomAttr attribute = map.item(i).toAttr();
+		// IDs only link models and clips within the project
+		if (attribute.name() == "id" || (automated && attribute.name() == "value")
+			|| (isFrozenTrack && trackAttributes.contains(attribute.name())))
+		{
+			continue;
+		}
+		attributes << attribute.name() + '=' + attribute.value();
+	}
+	// attributes are saved in any order
+	attributes.sort();
+
+	hash.addData(element.tagName().toUtf8());
+	hash.addData(attributes.join('\n').toUtf8());
+
+	for (QDomNode node = element.firstChild(); !node.isNull(); node = node.nextSibling())
+	{
+		if (node.isElement())
+		{
+			const QDomElement child = node.toElement();
+			if (child.tagName() == "journallingObject"
+				|| (isFrozenTrack && (child.tagName() == "muted" || child.tagName() == "solo")))
+			{
+				continue;
+			}
+			addElement(hash, child, frozenTrack);
+		}
+		else if (node.isText())
+		{
+			hash.addData(node.nodeValue().toUtf8());
+		}
+	}
+	hash.addData("/", 1);
+}
+
+} // namespace
+
+
+
+
+//! Collects the output of the source tracks into the stem while the song
+//! is rendered. Installed as the audio device, so it is called every period
+//! before the mixer channels are cleared.
+class TrackFreezer::StemWriter : public AudioDevice
+{
+public:
+	StemWriter(const QString& file, const QVector<AudioPort*>& ports);
+	~StemWriter() override;
+
+	bool isOpen() const
+	{
+		return m_sf != nullptr;
+	}
+
+	void processExtOutputs() override;
+
+	//! Write the rest of the stem and close it, returns whether all of it
+	//! was written
+	bool finish();
+
+private:
+	//! Move the first @p frames of the mix to the file
+	void write(f_cnt_t frames);
+
+	QFile m_file;
+	SNDFILE* m_sf;
+
+	const QVector<AudioPort*> m_ports;
+	//! Frames each port lags behind the song, taken from the first period
+	std::vector<f_cnt_t> m_delays;
+	f_cnt_t m_maxDelay;
+
+	//! The stem from frame m_written on, as far as any port got
+	std::vector<sampleFrame> m_mix;
+	f_cnt_t m_written;
+	f_cnt_t m_rendered;
+	bool m_failed;
+} ;
+
+
+
+
+TrackFreezer::StemWriter::StemWriter(const QString& file, const QVector<AudioPort*>& ports) :
+	AudioDevice(DEFAULT_CHANNELS, Engine::audioEngine()),
+	m_file(file),
+	m_sf(nullptr),
+	m_ports(ports),
+	m_maxDelay(0),
+	m_written(0),
+	m_rendered(0),
+	m_failed(false)
+{
+	SF_INFO info = {};
+	info.samplerate = Engine::audioEngine()->processingSampleRate();
+	info.channels = DEFAULT_CHANNELS;
+	info.format = SF_FORMAT_W64 | SF_FORMAT_FLOAT;
+
+	// use the file handle for unicode file names on Windows
+	if (!m_file.open(QIODevice::WriteOnly)
+		|| (m_sf = sf_open_fd(m_file.handle(), SFM_WRITE, &info, false)) == nullptr)
+	{
+		qWarning("TrackFreezer: can't write %s: %s", qPrintable(file),
+			m_file.isOpen() ? sf_strerror(nullptr) : qPrintable(m_file.errorString()));
+	}
+}
+
+
+
+
+TrackFreezer::StemWriter::~StemWriter()
+{
+	if (m_sf) { sf_close(m_sf); }
+}
+
+
+
+
+void TrackFreezer::StemWriter::processExtOutputs()
+{
+	const fpp_t fpp = audioEngine()->framesPerPeriod();
+
+	if (m_delays.empty())
+	{
+		// the ports are delayed by their latency and the compensation lining
+		// them up with their mixer channel, which the stem mustn't include
+		for (AudioPort* port : m_ports)
+		{
+			m_delays.push_back(port->latency() + port->compensation());
+			m_maxDelay = std::max(m_maxDelay, m_delays.back());
+		}
+	}
+
+	m_mix.resize(m_rendered + fpp - m_written);
+	for (int i = 0; i < m_ports.size(); ++i)
+	{
+		// a muted port keeps its last buffer
+		if (m_ports[i]->isMuted()) { continue; }
+
+		const sampleFrame* buffer = m_ports[i]->buffer();
+		for (fpp_t f = 0; f < fpp; ++f)
+		{
+			const f_cnt_t frame = m_rendered + f - m_delays[i];
+			if (frame < m_written) { continue; }
+			m_mix[frame - m_written][0] += buffer[f][0];
+			m_mix[frame - m_written][1] += buffer[f][1];
+		}
+	}
+	m_rendered += fpp;
+
+	// what all ports have delivered is complete
+	write(m_rendered - m_maxDelay - m_written);
+}
+
+
+
+
+bool TrackFreezer::StemWriter::finish()
+{
+	if (!m_sf) { return false; }
+
+	write(m_mix.size());
+	sf_close(m_sf);
+	m_sf = nullptr;
+	m_file.close();
+	return !m_failed;
+}
+
+
+
+
+void TrackFreezer::StemWriter::write(f_cnt_t frames)
+{
+	frames = std::min<f_cnt_t>(frames, m_mix.size());
+	if (frames <= 0 || !m_sf) { return; }
+
+	if (sf_writef_float(m_sf, m_mix.front().data(), frames) != frames)
+	{
+		m_failed = true;
+	}
+	m_mix.erase(m_mix.begin(), m_mix.begin() + frames);
+	m_written += frames;
+}
+
+
+
+
+//! Renders the song like ProjectRenderer, with the track playing alone
+class TrackFreezer::RenderThread : public QThread
+{
+public:
+	RenderThread(TrackFreezer* freezer, StemWriter* writer) :
+		m_freezer(freezer),
+		m_writer(writer),
+		m_abort(false),
+		m_written(false)
+	{
+	}
+
+	void abort()
+	{
+		m_abort = true;
+	}
+
+	//! Whether the whole stem was written, valid once the thread finished
+	bool isWritten() const
+	{
+		return m_written;
+	}
+
+private:
+	void run() override;
+
+	TrackFreezer* m_freezer;
+	StemWriter* m_writer;
+	std::atomic<bool> m_abort;
+	bool m_written;
+} ;
+
+
+
+
+void TrackFreezer::RenderThread::run()
+{
+	MemoryManager::ThreadGuard mmThreadGuard; Q_UNUSED(mmThreadGuard);
+
+	Song* song = Engine::getSong();
+	song->startExport();
+	// Skip first empty buffer.
+	Engine::audioEngine()->nextBuffer();
+	Engine::audioEngine()->startProcessing(false);
+
+	int progress = 0;
+	while (!m_abort && !song->isExportDone())
+	{
+		m_writer->processNextBuffer();
+		const int current = song->getExportProgress();
+		if (current != progress)
+		{
+			progress = current;
+			emit m_freezer->progressChanged(progress);
+		}
+	}
+
+	Engine::audioEngine()->stopProcessing();
+	song->stopExport();
+
+	m_written = m_writer->finish() && !m_abort;
+}
+
+
+
+
+struct TrackFreezer::Render
+{
+	QPointer<Track> track;
+	QString key;
+	QDomDocument state;
+	//! The stem is renamed to its final name once it is complete
+	QString partFile;
+	//! Mute state of the tracks silenced while rendering
+	std::vector<std::pair<QPointer<Track>, bool>> muted;
+	std::unique_ptr<RenderThread> thread;
+} ;
+
+
+
+
+TrackFreezer::TrackFreezer()
+{
+	// streams only take a thread while there's room in their rings, see
+	// FrozenStem::decodeAhead()
+	m_streamPool.setMaxThreadCount(std::min(QThread::idealThreadCount(), MaxDecoderThreads));
+
+	m_decodeTimer.setInterval(FrozenStem::DecodeInterval);
+	connect(&m_decodeTimer, SIGNAL(timeout()), this, SLOT(decodeStems()));
+
+	m_checkTimer.setSingleShot(true);
+	m_checkTimer.setInterval(CheckDelay);
+	connect(&m_checkTimer, SIGNAL(timeout()), this, SLOT(checkFrozenTracks()));
+
+	Song* song = Engine::getSong();
+	connect(song, SIGNAL(tempoChanged(lmms::bpm_t)), this, SLOT(scheduleCheck()));
+	connect(song, SIGNAL(timeSignatureChanged(int,int)), this, SLOT(scheduleCheck()));
+	connect(song, SIGNAL(playbackStateChanged()), this, SLOT(scheduleCheck()));
+	connect(song, SIGNAL(projectLoaded()), this, SLOT(restoreFrozenTracks()));
+	connect(song, SIGNAL(stopped()), this, SLOT(prepareStems()));
+	connect(song, SIGNAL(playbackPositionChanged()), this, SLOT(prepareStems()));
+	connect(Engine::audioEngine(), SIGNAL(sampleRateChanged()), this, SLOT(scheduleCheck()));
+	connect(Engine::patternStore(), SIGNAL(trackAdded(lmms::Track*)), this, SLOT(scheduleCheck()));
+}
+
+
+
+
+TrackFreezer::~TrackFreezer()
+{
+	if (m_render)
+	{
+		m_render->thread->abort();
+		m_render->thread->wait();
+		renderFinished();
+	}
+}
+
+
+
+
+bool TrackFreezer::canFreeze(Track* track, QString* reason) const
+{
+	const auto fail = [reason](const QString& why)
+	{
+		if (reason) { *reason = why; }
+		return false;
+	};
+
+	const Song* song = Engine::getSong();
+	if (isRendering())
+	{
+		return fail(tr("Another track is being frozen."));
+	}
+	if (song->isExporting())
+	{
+		return fail(tr("The song is being exported."));
+	}
+	if (track->isFrozen())
+	{
+		return fail(tr("The track is frozen already."));
+	}
+	if (track->trackContainer() != song)
+	{
+		return fail(tr("Only tracks of the song editor can be frozen."));
+	}
+
+	const QVector<InstrumentTrack*> sources = sourceTracks(track);
+	if (sources.isEmpty())
+	{
+		return fail(track->type() == Track::PatternTrack
+			? tr("The pattern doesn't contain any instrument tracks.")
+			: tr("Only instrument and pattern tracks can be frozen."));
+	}
+	for (InstrumentTrack* source : sources)
+	{
+		// the stem feeds a single mixer channel
+		if (source->mixerChannelModel()->value() != sources.first()->mixerChannelModel()->value())
+		{
+			return fail(tr("The instrument tracks of the pattern don't use the same mixer channel."));
+		}
+	}
+
+	// the stem only follows the song position
+	if (Engine::getSong()->tempoModel().isAutomatedOrControlled())
+	{
+		return fail(tr("The tempo is automated."));
+	}
+	const QDomDocument state = trackState(track);
+	if (hasControllers(state.documentElement()))
+	{
+		return fail(tr("The track is controlled by a controller."));
+	}
+	if (track->type() == Track::InstrumentTrack)
+	{
+		// the models of the instrument and effects are gone while frozen
+		const QDomElement settings = state.documentElement().firstChildElement("track")
+			.firstChildElement(static_cast<InstrumentTrack*>(track)->nodeName());
+		if (hasAutomatedModels(settings.firstChildElement("instrument"))
+			|| hasAutomatedModels(settings.firstChildElement("fxchain")))
+		{
+			return fail(tr("The instrument or effects of the track are automated."));
+		}
+	}
+	return true;
+}
+
+
+
+
+void TrackFreezer::freeze(Track* track)
+{
+	if (!canFreeze(track))
+	{
+		emit finished(false);
+		return;
+	}
+
+	const QDomDocument state = trackState(track);
+	const QString key = keyOf(state);
+	if (hasStem(key))
+	{
+		const bool frozen = applyFreeze(track, key, state);
+		if (frozen) { Engine::getSong()->setModified(); }
+		emit finished(frozen);
+		return;
+	}
+
+	QVector<AudioPort*> ports;
+	for (InstrumentTrack* source : sourceTracks(track))
+	{
+		// instruments of muted tracks may not have been instantiated, but
+		// the render can't wait for unmuting to do that
+		if (!source->isMuted()) { source->instantiatePendingInstrument(); }
+		ports << source->audioPort();
+	}
+
+	auto render = std::make_unique<Render>();
+	render->track = track;
+	render->key = key;
+	render->state = state;
+	render->partFile = stemFile(key) + ".part";
+
+	auto writer = new StemWriter(render->partFile, ports);
+	if (!writer->isOpen())
+	{
+		delete writer;
+		QFile::remove(render->partFile);
+		emit finished(false);
+		return;
+	}
+
+	// play the track alone, without touching the undo history
+	Song* song = Engine::getSong();
+	for (Track* other : song->tracks())
+	{
+		if (other->type() == Track::AutomationTrack || other->type() == Track::HiddenAutomationTrack)
+		{
+			continue;
+		}
+		render->muted.emplace_back(other, other->isMuted());
+		other->getMutedModel()->saveJournallingState(false);
+		other->setMuted(other != track);
+		other->getMutedModel()->restoreJournallingState();
+	}
+
+	song->setExportLoop(false);
+	song->setRenderBetweenMarkers(false);
+	song->setLoopRenderCount(1);
+	song->clearExportRange();
+
+	Engine::audioEngine()->storeAudioDevice();
+	Engine::audioEngine()->setAudioDevice(writer, Engine::audioEngine()->currentQualitySettings(), false, false);
+
+	render->thread = std::make_unique<RenderThread>(this, writer);
+	connect(render->thread.get(), SIGNAL(finished()), this, SLOT(renderFinished()));
+	m_render = std::move(render);
+	m_render->thread->start();
+}
+
+
+
+
+void TrackFreezer::unfreeze(Track* track)
+{
+	if (!track->isFrozen()) { return; }
+
+	thaw(track);
+	Engine::getSong()->setModified();
+	watchFrozenTracks();
+}
+
+
+
+
+void TrackFreezer::abort()
+{
+	if (m_render) { m_render->thread->abort(); }
+}
+
+
+
+
+QString TrackFreezer::stateKey(Track* track)
+{
+	return keyOf(trackState(track));
+}
+
+
+
+
+QString TrackFreezer::stemFile(const QString& key)
+{
+	return ConfigManager::inst()->userFreezeDir() + key + ".w64";
+}
+
+
+
+
+bool TrackFreezer::hasStem(const QString& key)
+{
+	return !key.isEmpty() && QFileInfo::exists(stemFile(key));
+}
+
+
+
+
+void TrackFreezer::prepareStems()
+{
+	const Song* song = Engine::getSong();
+	const Song::PlayPos& pos = song->getPlayPos(Song::Mode_PlaySong);
+
+	QVector<f_cnt_t> frames;
+	if (!song->isPlaying())
+	{
+		frames << static_cast<f_cnt_t>(pos.getTicks() * Engine::framesPerTick());
+	}
+	if (pos.m_timeLine && pos.m_timeLine->loopPointsEnabled())
+	{
+		frames << static_cast<f_cnt_t>(pos.m_timeLine->loopBegin().getTicks() * Engine::framesPerTick());
+	}
+
+	for (Track* track : frozenTracks())
+	{
+		for (f_cnt_t frame : frames)
+		{
+			track->frozenStem()->prepare(frame);
+		}
+	}
+}
+
+
+
+
+void TrackFreezer::restoreFrozenTracks()
+{
+	for (Track* track : Engine::getSong()->tracks())
+	{
+		const QString savedKey = track->savedFreezeKey();
+		if (track->isFrozen() || !hasStem(savedKey)) { continue; }
+
+		const QDomDocument state = trackState(track);
+		if (keyOf(state) == savedKey && applyFreeze(track, savedKey, state)) { continue; }
+
+		// the stem doesn't match anymore, e.g. since a plugin changed, so
+		// the plugins held back while loading are needed after all
+		if (track->type() == Track::InstrumentTrack)
+		{
+			auto instrumentTrack = static_cast<InstrumentTrack*>(track);
+			if (!instrumentTrack->isMuted()) { instrumentTrack->instantiatePendingInstrument(); }
+			instrumentTrack->audioPort()->effects()->instantiatePendingEffects();
+		}
+	}
+	watchFrozenTracks();
+}
+
+
+
+
+void TrackFreezer::scheduleCheck()
+{
+	if (!frozenTracks().isEmpty()) { m_checkTimer.start(); }
+}
+
+
+
+
+void TrackFreezer::decodeStems()
+{
+	const QVector<Track*> tracks = frozenTracks();
+	if (tracks.isEmpty())
+	{
+		m_decodeTimer.stop();
+		return;
+	}
+
+	// have the streams the audio thread took ready again for the next time
+	prepareStems();
+	for (Track* track : tracks)
+	{
+		track->frozenStem()->decodeAhead();
+	}
+}
+
+
+
+
+void TrackFreezer::checkFrozenTracks()
+{
+	const Song* song = Engine::getSong();
+	if (isRendering() || song->isLoadingProject() || song->isExporting()) { return; }
+
+	for (Track* track : frozenTracks())
+	{
+		// the plugins were loaded behind our back, e.g. by replacing them
+		bool loaded = false;
+		if (track->type() == Track::InstrumentTrack)
+		{
+			auto instrumentTrack = static_cast<InstrumentTrack*>(track);
+			loaded = instrumentTrack->instrument()
+				|| !instrumentTrack->audioPort()->effects()->isHoldingEffects();
+		}
+		if (loaded || stateKey(track) != track->frozenStem()->key())
+		{
+			thaw(track);
+		}
+	}
+	watchFrozenTracks();
+}
+
+
+
+
+void TrackFreezer::renderFinished()
+{
+	const std::unique_ptr<Render> render = std::move(m_render);
+	const bool written = render->thread->isWritten();
+
+	// deletes the stem writer
+	Engine::audioEngine()->restoreAudioDevice();
+
+	for (const auto& muted : render->muted)
+	{
+		if (!muted.first) { continue; }
+		muted.first->getMutedModel()->saveJournallingState(false);
+		muted.first->setMuted(muted.second);
+		muted.first->getMutedModel()->restoreJournallingState();
+	}
+
+	bool frozen = false;
+	if (written && render->track && QFile::rename(render->partFile, stemFile(render->key)))
+	{
+		frozen = applyFreeze(render->track, render->key, render->state);
+		if (frozen) { Engine::getSong()->setModified(); }
+		pruneCache();
+	}
+	QFile::remove(render->partFile);
+
+	emit finished(frozen);
+}
+
+
+
+
+QDomDocument TrackFreezer::trackState(Track* track)
+{
+	Song* song = Engine::getSong();
+
+	QDomDocument state;
+	QDomElement root = state.createElement("freezestate");
+	root.setAttribute("samplerate", Engine::audioEngine()->processingSampleRate());
+	root.setAttribute("tempo", song->getTempo());
+	root.setAttribute("timesig_numerator", song->getTimeSigModel().getNumerator());
+	root.setAttribute("timesig_denominator", song->getTimeSigModel().getDenominator());
+	root.setAttribute("masterpitch", song->masterPitch());
+	state.appendChild(root);
+
+	track->saveState(state, root);
+
+	if (track->type() == Track::PatternTrack)
+	{
+		// the pattern store tracks only count as far as the pattern goes
+		const int index = static_cast<PatternTrack*>(track)->patternIndex();
+		QDomElement pattern = state.createElement("pattern");
+		pattern.setAttribute("index", index);
+		for (Track* patternTrack : Engine::patternStore()->tracks())
+		{
+			patternTrack->setSimpleSerializing();
+			QDomElement element = patternTrack->saveState(state, pattern);
+			if (index < patternTrack->numOfClips())
+			{
+				patternTrack->getClip(index)->saveState(state, element);
+			}
+		}
+		root.appendChild(pattern);
+	}
+
+	// automation of the volume, panning and so on plays along with the song
+	QVector<AutomationClip*> clips;
+	for (Track* stateTrack : stateTracks(track))
+	{
+		for (const AutomatableModel* model : stateTrack->findChildren<AutomatableModel*>())
+		{
+			for (AutomationClip* clip : AutomationClip::clipsForModel(model))
+			{
+				if (!clips.contains(clip)) { clips << clip; }
+			}
+		}
+	}
+	QDomElement automation = state.createElement("automation");
+	for (AutomationClip* clip : clips)
+	{
+		clip->saveState(state, automation);
+	}
+	root.appendChild(automation);
+
+	return state;
+}
+
+
+
+
+QString TrackFreezer::keyOf(const QDomDocument& state)
+{
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	const QDomElement root = state.documentElement();
+	addElement(hash, root, root.firstChildElement("track"));
+	return QString::fromLatin1(hash.result().toHex());
+}
+
+
+
+
+bool TrackFreezer::applyFreeze(Track* track, const QString& key, const QDomDocument& state)
+{
+	const QVector<InstrumentTrack*> sources = sourceTracks(track);
+	if (sources.isEmpty()) { return false; }
+
+	auto stem = new FrozenStem(track, key, stemFile(key), sources.first()->mixerChannelModel()->value(),
+		&m_streamPool);
+	// deletes the stem if it fails
+	if (!Engine::audioEngine()->addPlayHandle(stem)) { return false; }
+
+	Engine::audioEngine()->requestChangeInModel();
+	track->m_frozenStem = stem;
+	Engine::audioEngine()->doneChangeInModel();
+
+	if (track->type() == Track::InstrumentTrack)
+	{
+		static_cast<InstrumentTrack*>(track)->unloadPlugins(state.documentElement().firstChildElement("track"));
+	}
+
+	emit track->frozenChanged();
+	watchFrozenTracks();
+	prepareStems();
+	if (!m_decodeTimer.isActive()) { m_decodeTimer.start(); }
+	return true;
+}
+
+
+
+
+void TrackFreezer::thaw(Track* track)
+{
+	FrozenStem* stem = track->m_frozenStem;
+
+	Engine::audioEngine()->requestChangeInModel();
+	track->m_frozenStem = nullptr;
+	Engine::audioEngine()->doneChangeInModel();
+	Engine::audioEngine()->removePlayHandle(stem);
+
+	if (track->type() == Track::InstrumentTrack)
+	{
+		auto instrumentTrack = static_cast<InstrumentTrack*>(track);
+		// a muted track instantiates its instrument when it's unmuted
+		if (!instrumentTrack->isMuted()) { instrumentTrack->instantiatePendingInstrument(); }
+		instrumentTrack->audioPort()->effects()->instantiatePendingEffects();
+	}
+
+	emit track->frozenChanged();
+}
+
+
+
+
+QVector<Track*> TrackFreezer::frozenTracks() const
+{
+	QVector<Track*> tracks;
+	for (Track* track : Engine::getSong()->tracks())
+	{
+		if (track->isFrozen()) { tracks << track; }
+	}
+	return tracks;
+}
+
+
+
+
+void TrackFreezer::watchFrozenTracks()
+{
+	for (const auto& connection : m_watches)
+	{
+		disconnect(connection);
+	}
+	m_watches.clear();
+
+	const auto watch = [this](auto sender, auto signal)
+	{
+		m_watches.push_back(connect(sender, signal, this, &TrackFreezer::scheduleCheck));
+	};
+
+	for (Track* track : frozenTracks())
+	{
+		for (Track* stateTrack : stateTracks(track))
+		{
+			watch(stateTrack, &Track::clipAdded);
+			for (Clip* clip : stateTrack->getClips())
+			{
+				watch(clip, &Clip::dataChanged);
+				watch(clip, &Clip::positionChanged);
+				watch(clip, &Clip::lengthChanged);
+				watch(clip, &Clip::destroyedClip);
+			}
+
+			for (AutomatableModel* model : stateTrack->findChildren<AutomatableModel*>())
+			{
+				const QVector<AutomationClip*> clips = AutomationClip::clipsForModel(model);
+				// automated values change all the time while playing, the
+				// automation itself changes when its clips do
+				if (clips.isEmpty()) { watch(model, &AutomatableModel::dataChanged); }
+				for (AutomationClip* clip : clips)
+				{
+					watch(clip, &AutomationClip::dataChanged);
+				}
+			}
+
+			if (stateTrack->type() == Track::InstrumentTrack)
+			{
+				auto instrumentTrack = static_cast<InstrumentTrack*>(stateTrack);
+				watch(instrumentTrack, &InstrumentTrack::instrumentChanged);
+				watch(instrumentTrack->audioPort()->effects(), &EffectChain::dataChanged);
+			}
+		}
+	}
+}
+
+
+
+
+void TrackFreezer::pruneCache()
+{
+	const qint64 limit = ConfigManager::inst()->value("app", "freezecachesize",
+		QString::number(DefaultCacheSize)).toLongLong() * 1024 * 1024;
+
+	// stems the project refers to stay, whatever their age
+	QStringList used;
+	for (Track* track : Engine::getSong()->tracks())
+	{
+		if (track->isFrozen()) { used << track->frozenStem()->key(); }
+		if (!track->savedFreezeKey().isEmpty()) { used << track->savedFreezeKey(); }
+	}
+
+	const QFileInfoList stems = QDir(ConfigManager::inst()->userFreezeDir())
+		.entryInfoList(QStringList{"*.w64"}, QDir::Files, QDir::Time);
+	qint64 size = 0;
+	for (const QFileInfo& stem : stems)
+	{
+		if (size + stem.size() > limit && !used.contains(stem.completeBaseName()))
+		{
+			QFile::remove(stem.filePath());
+			continue;
+		}
+		size += stem.size();
+	}
+}
+
+
+} // namespace lmms
@@ -0,0 +1,305 @@
+/*
+ * WaveformOverview.cpp - multi-resolution peak and RMS summary of sample data
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "WaveformOverview.h"
+
+#include <algorithm>
+#include <QDataStream>
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThreadPool>
+
+namespace lmms
+{
+
+namespace
+{
+
+constexpr quint32 CacheFileMagic = 0x4c4d504b; // "LMPK"
+constexpr quint32 CacheFileVersion = 1;
+
+//! How many blocks are built between two checks for cancellation
+constexpr f_cnt_t BlocksPerChunk = 64;
+
+
+class BuildJob : public QRunnable
+{
+public:
+	BuildJob(std::shared_ptr<WaveformOverview> overview, const QString& cacheFile, const QByteArray& stamp) :
+		m_overview(std::move(overview)),
+		m_cacheFile(cacheFile),
+		m_stamp(stamp)
+	{
+	}
+
+	void run() override
+	{
+		if (m_cacheFile.isEmpty() || !m_overview->load(m_cacheFile, m_stamp))
+		{
+			m_overview->build();
+			if (!m_cacheFile.isEmpty() && m_overview->isComplete())
+			{
+				m_overview->save(m_cacheFile, m_stamp);
+			}
+		}
+		if (m_overview->isComplete())
+		{
+			emit m_overview->ready();
+		}
+	}
+
+private:
+	//! Keeps the overview alive even if its owner dropped it in the meantime
+	std::shared_ptr<WaveformOverview> m_overview;
+	QString m_cacheFile;
+	QByteArray m_stamp;
+} ;
+
+} // namespace
+
+
+
+
+void WaveformOverview::Peak::add(const Peak& other)
+{
+	min = std::min(min, other.min);
+	max = std::max(max, other.max);
+	squares += other.squares;
+	frames += other.frames;
+}
+
+
+
+
+WaveformOverview::WaveformOverview(const sampleFrame* data, f_cnt_t frames) :
+	m_data(data),
+	m_frames(frames),
+	m_builtBlocks(0),
+	m_cancelled(false)
+{
+	// the coarsest level has a single entry
+	std::size_t size = (frames + BlockSize - 1) / BlockSize;
+	m_levels.emplace_back(size);
+	while (size > 1)
+	{
+		size = (size + LevelFactor - 1) / LevelFactor;
+		m_levels.emplace_back(size);
+	}
+}
+
+
+
+
+WaveformOverview::~WaveformOverview()
+{
+	cancel();
+}
+
+
+
+
+void WaveformOverview::buildInBackground(const QString& cacheFile, const QByteArray& stamp)
+{
+	QThreadPool::globalInstance()->start(new BuildJob(shared_from_this(), cacheFile, stamp),
+						QThread::LowestPriority);
+}
+
+
+
+
+void WaveformOverview::build()
+{
+	QMutexLocker lock(&m_buildMutex);
+
+	const f_cnt_t blockCount = blocks();
+	for (f_cnt_t block = m_builtBlocks.load(std::memory_order_relaxed); block < blockCount;)
+	{
+		if (m_cancelled.load(std::memory_order_relaxed)) { return; }
+
+		const f_cnt_t chunkEnd = std::min(block + BlocksPerChunk, blockCount);
+		for (; block < chunkEnd; ++block)
+		{
+			const f_cnt_t from = block * BlockSize;
+			m_levels[0][block] = scan(m_data, from, std::min(from + BlockSize, m_frames));
+			propagate(block);
+		}
+		m_builtBlocks.store(block, std::memory_order_release);
+	}
+}
+
+
+
+
+void WaveformOverview::cancel()
+{
+	m_cancelled.store(true, std::memory_order_relaxed);
+	// wait for a running build to notice
+	QMutexLocker lock(&m_buildMutex);
+}
+
+
+
+
+bool WaveformOverview::peak(f_cnt_t from, f_cnt_t to, Peak& result) const
+{
+	std::size_t lo = std::max(from, 0) / BlockSize;
+	std::size_t hi = (std::min(to, m_frames) + BlockSize - 1) / BlockSize;
+	if (lo >= hi || hi > static_cast<std::size_t>(m_builtBlocks.load(std::memory_order_acquire)))
+	{
+		return false;
+	}
+
+	result = Peak();
+	// take whole entries of the coarsest level possible, so at most
+	// 2 * (LevelFactor - 1) entries are added per level
+	for (std::size_t level = 0; lo < hi; ++level)
+	{
+		const std::vector<Peak>& entries = m_levels[level];
+		if (level + 1 == m_levels.size())
+		{
+			for (; lo < hi; ++lo) { result.add(entries[lo]); }
+			break;
+		}
+
+		for (; lo < hi && lo % LevelFactor != 0; ++lo) { result.add(entries[lo]); }
+		// the last entry of the next level may cover less than LevelFactor entries
+		for (; lo < hi && hi % LevelFactor != 0 && hi != entries.size(); --hi) { result.add(entries[hi - 1]); }
+
+		lo /= LevelFactor;
+		hi = (hi + LevelFactor - 1) / LevelFactor;
+	}
+
+	return true;
+}
+
+
+
+
+WaveformOverview::Peak WaveformOverview::scan(const sampleFrame* data, f_cnt_t from, f_cnt_t to, f_cnt_t stride)
+{
+	Peak result;
+	for (f_cnt_t frame = from; frame < to; frame += stride)
+	{
+		for (int ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+		{
+			const float value = data[frame][ch];
+			result.min = std::min(result.min, value);
+			result.max = std::max(result.max, value);
+			result.squares += value * value;
+		}
+		++result.frames;
+	}
+	return result;
+}
+
+
+
+
+bool WaveformOverview::save(const QString& file, const QByteArray& stamp) const
+{
+	QSaveFile out(file);
+	if (!out.open(QIODevice::WriteOnly)) { return false; }
+
+	QDataStream stream(&out);
+	stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+	stream << CacheFileMagic << CacheFileVersion << stamp << static_cast<qint32>(m_frames);
+
+	// coarser levels are cheap to recompute from the finest one
+	for (const Peak& entry : m_levels[0])
+	{
+		stream << entry.min << entry.max << entry.squares;
+	}
+
+	return stream.status() == QDataStream::Ok && out.commit();
+}
+
+
+
+
+bool WaveformOverview::load(const QString& file, const QByteArray& stamp)
+{
+	QMutexLocker lock(&m_buildMutex);
+	if (m_cancelled.load(std::memory_order_relaxed)) { return false; }
+
+	QFile in(file);
+	if (!in.open(QIODevice::ReadOnly)) { return false; }
+
+	QDataStream stream(&in);
+	stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+	quint32 magic, version;
+	QByteArray fileStamp;
+	qint32 frames;
+	stream >> magic >> version;
+	if (magic != CacheFileMagic || version != CacheFileVersion) { return false; }
+	stream >> fileStamp >> frames;
+	if (fileStamp != stamp || frames != m_frames) { return false; }
+
+	for (std::size_t block = 0; block < m_levels[0].size(); ++block)
+	{
+		Peak& entry = m_levels[0][block];
+		stream >> entry.min >> entry.max >> entry.squares;
+		entry.frames = std::min(BlockSize, m_frames - static_cast<f_cnt_t>(block) * BlockSize);
+	}
+	if (stream.status() != QDataStream::Ok) { return false; }
+
+	const f_cnt_t blockCount = blocks();
+	for (f_cnt_t block = 0; block < blockCount; ++block)
+	{
+		propagate(block);
+	}
+	m_builtBlocks.store(blockCount, std::memory_order_release);
+
+	return true;
+}
+
+
+
+
+void WaveformOverview::propagate(f_cnt_t block)
+{
+	std::size_t index = block;
+	for (std::size_t level = 1; level < m_levels.size(); ++level)
+	{
+		// a parent is computed once its last child is
+		const std::vector<Peak>& children = m_levels[level - 1];
+		if ((index + 1) % LevelFactor != 0 && index + 1 != children.size()) { return; }
+
+		const std::size_t parent = index / LevelFactor;
+		const std::size_t end = std::min(children.size(), (parent + 1) * LevelFactor);
+		Peak result;
+		for (std::size_t child = parent * LevelFactor; child < end; ++child)
+		{
+			result.add(children[child]);
+		}
+		m_levels[level][parent] = result;
+
+		index = parent;
+	}
+}
+
+
+} // namespace lmms
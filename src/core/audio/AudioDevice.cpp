@@ -28,6 +28,7 @@
 #include "AudioEngine.h"
 #include "ConfigManager.h"
 #include "debug.h"
+#include "MixKernels.h"
 
 namespace lmms
 {
@@ -182,6 +183,13 @@ void AudioDevice::renamePort( AudioPort * )
 
 
 
+void AudioDevice::processExtOutputs()
+{
+}
+
+
+
+
 fpp_t AudioDevice::resample( const surroundSampleFrame * _src,
 						const fpp_t _frames,
 						surroundSampleFrame * _dst,
@@ -215,7 +223,14 @@ int AudioDevice::convertToS16( const surroundSampleFrame * _ab,
 								int_sample_t * _output_buffer,
 								const bool _convert_endian )
 {
-	if( _convert_endian )
+	if( channels() == SURROUND_CHANNELS )
+	{
+		// the frames are contiguous, convert them all in one go
+		MixKernels::kernels().convertToS16( reinterpret_cast<const float *>( _ab ),
+							_frames * channels(), _master_gain,
+							_output_buffer, _convert_endian );
+	}
+	else if( _convert_endian )
 	{
 		int_sample_t temp;
 		for( fpp_t frame = 0; frame < _frames; ++frame )
@@ -0,0 +1,207 @@
+/*
+ * AudioEncoderPipeline.cpp - audio device which feeds the rendered output to
+ *                            several file encoders running on their own threads
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <algorithm>
+
+#include "AudioEncoderPipeline.h"
+#include "AudioEngine.h"
+#include "AudioFileDevice.h"
+
+namespace lmms
+{
+
+
+AudioEncoderPipeline::AudioEncoderPipeline(ch_cnt_t channels, AudioEngine* audioEngine) :
+	AudioDevice(channels, audioEngine),
+	m_freeSlots(QueueCapacity),
+	m_writeIndex(0),
+	m_running(false),
+	m_framesWritten(0),
+	m_windowBegin(0),
+	m_windowEnd(-1)
+{
+	// resampling never yields more frames than a period holds, as the
+	// pipeline runs at the processing rate divided by the oversampling
+	for (auto& slot : m_slots)
+	{
+		slot.frames.resize(audioEngine->framesPerPeriod());
+	}
+	setSampleRate(0);
+}
+
+
+
+
+AudioEncoderPipeline::~AudioEncoderPipeline()
+{
+	finish();
+}
+
+
+
+
+void AudioEncoderPipeline::addEncoder(AudioFileDevice* encoder)
+{
+	m_encoders.emplace_back(encoder);
+	setSampleRate(std::max(sampleRate(), encoder->sampleRate()));
+}
+
+
+
+
+QStringList AudioEncoderPipeline::outputFiles() const
+{
+	QStringList files;
+	for (const auto& encoder : m_encoders)
+	{
+		files << encoder->outputFile();
+	}
+	return files;
+}
+
+
+
+
+void AudioEncoderPipeline::startProcessing()
+{
+	AudioDevice::startProcessing();
+
+	if (m_running || m_encoders.empty()) { return; }
+
+	m_writeIndex = 0;
+	m_framesWritten = 0;
+	for (const auto& encoder : m_encoders)
+	{
+		m_threads.emplace_back(std::make_unique<EncoderThread>(this, encoder.get()));
+		m_threads.back()->start();
+	}
+	m_running = true;
+}
+
+
+
+
+void AudioEncoderPipeline::finish()
+{
+	if (!m_running) { return; }
+
+	m_freeSlots.acquire();
+	Slot& slot = m_slots[m_writeIndex];
+	slot.count = 0;
+	publish(slot);
+
+	for (const auto& thread : m_threads)
+	{
+		thread->wait();
+	}
+	m_threads.clear();
+	m_running = false;
+}
+
+
+
+
+void AudioEncoderPipeline::writeBuffer(const surroundSampleFrame* buffer, const fpp_t frames,
+										const float masterGain)
+{
+	if (!m_running) { return; }
+
+	const f_cnt_t position = m_framesWritten;
+	m_framesWritten += frames;
+
+	if (m_windowBegin < 0) { return; }
+	const f_cnt_t first = std::max<f_cnt_t>(m_windowBegin - position, 0);
+	const f_cnt_t last = m_windowEnd < 0 ? frames : std::min<f_cnt_t>(m_windowEnd - position, frames);
+	if (first >= last) { return; }
+
+	// blocks while the slowest encoder is QueueCapacity periods behind
+	m_freeSlots.acquire();
+	Slot& slot = m_slots[m_writeIndex];
+	std::copy(buffer + first, buffer + last, slot.frames.begin());
+	slot.count = static_cast<fpp_t>(last - first);
+	slot.masterGain = masterGain;
+	publish(slot);
+	m_writeIndex = (m_writeIndex + 1) % QueueCapacity;
+}
+
+
+
+
+void AudioEncoderPipeline::publish(Slot& slot)
+{
+	slot.pending.store(static_cast<int>(m_threads.size()), std::memory_order_relaxed);
+	for (const auto& thread : m_threads)
+	{
+		thread->slotFilled();
+	}
+}
+
+
+
+
+void AudioEncoderPipeline::release(Slot& slot)
+{
+	if (slot.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		m_freeSlots.release();
+	}
+}
+
+
+
+
+AudioEncoderPipeline::EncoderThread::EncoderThread(AudioEncoderPipeline* pipeline, AudioFileDevice* encoder) :
+	m_pipeline(pipeline),
+	m_encoder(encoder),
+	m_filledSlots(0)
+{
+}
+
+
+
+
+void AudioEncoderPipeline::EncoderThread::run()
+{
+	const sample_rate_t sourceRate = m_pipeline->sampleRate();
+	int index = 0;
+	while (true)
+	{
+		m_filledSlots.acquire();
+		Slot& slot = m_pipeline->m_slots[index];
+		if (slot.count == 0)
+		{
+			m_pipeline->release(slot);
+			return;
+		}
+
+		m_encoder->encodeBuffer(slot.frames.data(), slot.count, slot.masterGain, sourceRate);
+
+		m_pipeline->release(slot);
+		index = (index + 1) % QueueCapacity;
+	}
+}
+
+
+} // namespace lmms
@@ -81,6 +81,30 @@ AudioFileDevice::~AudioFileDevice()
 
 
 
+void AudioFileDevice::encodeBuffer( const surroundSampleFrame * buffer, const fpp_t frames,
+					const float masterGain, const sample_rate_t sourceRate )
+{
+	if( sourceRate == sampleRate() )
+	{
+		writeBuffer( buffer, frames, masterGain );
+		return;
+	}
+
+	// only grows during the first periods
+	if( m_resampleBuffer.size() < static_cast<size_t>( frames ) )
+	{
+		m_resampleBuffer.resize( frames );
+	}
+	const fpp_t resampled = resample( buffer, frames, m_resampleBuffer.data(), sourceRate, sampleRate() );
+	if( resampled > 0 )
+	{
+		writeBuffer( m_resampleBuffer.data(), resampled, masterGain );
+	}
+}
+
+
+
+
 int AudioFileDevice::writeData( const void* data, int len )
 {
 	if( m_outputFile.isOpen() )
@@ -24,6 +24,7 @@
 
 #include <QtGlobal>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 
@@ -96,7 +97,8 @@ void AudioFileFlac::writeBuffer(surroundSampleFrame const* _ab, fpp_t const fram
 
 	if (depth == OutputSettings::Depth_24Bit || depth == OutputSettings::Depth_32Bit) // Float encoding
 	{
-		auto buf = std::vector<sample_t>(frames * channels());
+		auto& buf = m_floatBuffer;
+		buf.resize(std::max(buf.size(), static_cast<size_t>(frames * channels())));
 		for(fpp_t frame = 0; frame < frames; ++frame)
 		{
 			for(ch_cnt_t channel=0; channel<channels(); ++channel)
@@ -111,7 +113,8 @@ void AudioFileFlac::writeBuffer(surroundSampleFrame const* _ab, fpp_t const fram
 	}
 	else // integer PCM encoding
 	{
-		auto buf = std::vector<int_sample_t>(frames * channels());
+		auto& buf = m_intBuffer;
+		buf.resize(std::max(buf.size(), static_cast<size_t>(frames * channels())));
 		convertToS16(_ab, frames, master_gain, buf.data(), !isLittleEndian());
 		sf_writef_short(m_sf, static_cast<short*>(buf.data()), frames);
 	}
@@ -194,9 +194,9 @@ void AudioFileOgg::writeBuffer( const surroundSampleFrame * _ab,
 {
 	int eos = 0;
 
-	float * * buffer = vorbis_analysis_buffer( &m_vd, _frames *
-							BYTES_PER_SAMPLE *
-								channels() );
+	// the size is in frames, a larger one only makes libvorbis grow its
+	// analysis buffer further
+	float * * buffer = vorbis_analysis_buffer( &m_vd, _frames );
 	for( fpp_t frame = 0; frame < _frames; ++frame )
 	{
 		for( ch_cnt_t chnl = 0; chnl < channels(); ++chnl )
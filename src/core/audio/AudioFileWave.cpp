@@ -23,6 +23,8 @@
  *
  */
 
+#include <algorithm>
+
 #include "AudioFileWave.h"
 #include "endian_handling.h"
 #include "AudioEngine.h"
@@ -104,7 +106,8 @@ void AudioFileWave::writeBuffer( const surroundSampleFrame * _ab,
 
 	if( bitDepth == OutputSettings::Depth_32Bit || bitDepth == OutputSettings::Depth_24Bit )
 	{
-		auto buf = new float[_frames * channels()];
+		m_floatBuffer.resize( std::max( m_floatBuffer.size(), static_cast<size_t>( _frames * channels() ) ) );
+		float * buf = m_floatBuffer.data();
 		for( fpp_t frame = 0; frame < _frames; ++frame )
 		{
 			for( ch_cnt_t chnl = 0; chnl < channels(); ++chnl )
@@ -114,16 +117,15 @@ void AudioFileWave::writeBuffer( const surroundSampleFrame * _ab,
 			}
 		}
 		sf_writef_float( m_sf, buf, _frames );
-		delete[] buf;
 	}
 	else
 	{
-		auto buf = new int_sample_t[_frames * channels()];
+		m_intBuffer.resize( std::max( m_intBuffer.size(), static_cast<size_t>( _frames * channels() ) ) );
+		int_sample_t * buf = m_intBuffer.data();
 		convertToS16( _ab, _frames, _master_gain, buf,
 							!isLittleEndian() );
 
 		sf_writef_short( m_sf, buf, _frames );
-		delete[] buf;
 	}
 }
 
@@ -29,20 +29,46 @@
 #include <QLineEdit>
 #include <QLabel>
 #include <QMessageBox>
+#include <QMutexLocker>
+#include <QTimer>
 
+#include "denormals.h"
 #include "Engine.h"
 #include "GuiApplication.h"
 #include "gui_templates.h"
+#include "AudioPort.h"
 #include "ConfigManager.h"
 #include "LcdSpinBox.h"
+#include "LedCheckBox.h"
 #include "MainWindow.h"
 #include "AudioEngine.h"
 #include "MidiJack.h"
+#include "Mixer.h"
 
 
 namespace lmms
 {
 
+// enough for the output FIFO and a few periods in flight
+static const std::size_t ExtOutputBufferSize = 4 * 4096;
+
+
+AudioJack::ExtOutput::ExtOutput( AudioPort * _port, int _mixerChannel ) :
+	port( _port ),
+	mixerChannel( _mixerChannel ),
+	ports{ nullptr, nullptr },
+	portBuffers{ nullptr, nullptr },
+	portCycle( ~quint64( 0 ) ),
+	running( false ),
+	buffer( ExtOutputBufferSize ),
+	reader( buffer ),
+	firstPeriod( -1 )
+{
+}
+
+
+
+
 AudioJack::AudioJack( bool & _success_ful, AudioEngine*  _audioEngine ) :
 	AudioDevice( qBound<int>(
 		DEFAULT_CHANNELS,
@@ -54,7 +80,21 @@ AudioJack::AudioJack( bool & _success_ful, AudioEngine*  _audioEngine ) :
 	m_tempOutBufs( new jack_default_audio_sample_t *[channels()] ),
 	m_outBuf( new surroundSampleFrame[audioEngine()->framesPerPeriod()] ),
 	m_framesDoneInCurBuf( 0 ),
-	m_framesToDoInCurBuf( 0 )
+	m_framesToDoInCurBuf( 0 ),
+	m_mixerOutputsEnabled( ConfigManager::inst()->value( "audiojack",
+						"mixeroutputs" ).toInt() ),
+	m_trackOutputsEnabled( ConfigManager::inst()->value( "audiojack",
+						"trackoutputs" ).toInt() ),
+	m_synchronous( ConfigManager::inst()->value( "audiojack",
+						"synchronous" ).toInt() ),
+	m_renderInCallback( false ),
+	m_directOutputOffset( -1 ),
+	m_extOutputs( nullptr ),
+	m_silence( audioEngine()->framesPerPeriod() ),
+	m_renderedPeriods( 0 ),
+	m_currentPeriod( -1 ),
+	m_extOutputsInSync( false ),
+	m_callbackCount( 0 )
 {
 	m_stopped = true;
 
@@ -64,6 +104,15 @@ AudioJack::AudioJack( bool & _success_ful, AudioEngine*  _audioEngine ) :
 		connect( this, SIGNAL(zombified()),
 				this, SLOT(restartAfterZombified()),
 				Qt::QueuedConnection );
+
+		if( m_mixerOutputsEnabled && Engine::mixer() )
+		{
+			connect( Engine::mixer(), SIGNAL(channelsChanged()),
+					this, SLOT(updateExtOutputs()),
+					Qt::QueuedConnection );
+			QMetaObject::invokeMethod( this, "updateExtOutputs",
+						Qt::QueuedConnection );
+		}
 	}
 
 }
@@ -74,19 +123,17 @@ AudioJack::AudioJack( bool & _success_ful, AudioEngine*  _audioEngine ) :
 AudioJack::~AudioJack()
 {
 	stopProcessing();
-#ifdef AUDIO_PORT_SUPPORT
-	while( m_portMap.size() )
+
+	if( m_client != nullptr && m_active )
 	{
-		unregisterPort( m_portMap.begin().key() );
+		jack_deactivate( m_client );
 	}
-#endif
+
+	// the process callback is not running anymore
+	clearExtOutputs();
 
 	if( m_client != nullptr )
 	{
-		if( m_active )
-		{
-			jack_deactivate( m_client );
-		}
 		jack_client_close( m_client );
 	}
 
@@ -100,10 +147,22 @@ AudioJack::~AudioJack()
 
 void AudioJack::restartAfterZombified()
 {
+	// the ports of the external outputs died together with the old client,
+	// recreate them for the new one
+	{
+		QMutexLocker lock( &m_extOutputsLock );
+		for( auto it = m_portOutputs.begin(); it != m_portOutputs.end(); ++it )
+		{
+			m_pendingPorts.push_back( it.key() );
+		}
+	}
+	clearExtOutputs();
+
 	if( initJackClient() )
 	{
 		m_active = false;
 		startProcessing();
+		updateExtOutputs();
 		QMessageBox::information(gui::getGUI()->mainWindow(),
 			tr( "JACK client restarted" ),
 			tr( "LMMS was kicked by JACK for some reason. "
@@ -179,6 +238,7 @@ bool AudioJack::initJackClient()
 		setSampleRate( jack_get_sample_rate( m_client ) );
 	}
 
+	m_outputPorts.clear();
 	for( ch_cnt_t ch = 0; ch < channels(); ++ch )
 	{
 		QString name = QString( "master out " ) +
@@ -203,6 +263,20 @@ bool AudioJack::initJackClient()
 
 void AudioJack::startProcessing()
 {
+	m_renderInCallback = isSynchronous();
+	if( m_renderInCallback && m_client != nullptr )
+	{
+		// lock JACK's buffer size to whole periods, so each callback
+		// renders exactly what it outputs
+		const fpp_t fpp = audioEngine()->framesPerPeriod();
+		if( jack_get_buffer_size( m_client ) % fpp != 0 &&
+			jack_set_buffer_size( m_client, fpp ) )
+		{
+			printf( "cannot set JACK buffer size to %d frames, periods "
+				"will be split across callbacks\n", fpp );
+		}
+	}
+
 	if( m_active || m_client == nullptr )
 	{
 		m_stopped = false;
@@ -218,11 +292,6 @@ void AudioJack::startProcessing()
 	m_active = true;
 
 
-	// try to sync JACK's and LMMS's buffer-size
-//	jack_set_buffer_size( m_client, audioEngine()->framesPerPeriod() );
-
-
-
 	const char * * ports = jack_get_ports( m_client, nullptr, nullptr,
 						JackPortIsPhysical |
 						JackPortIsInput );
@@ -256,6 +325,23 @@ void AudioJack::startProcessing()
 void AudioJack::stopProcessing()
 {
 	m_stopped = true;
+
+	if( m_renderInCallback )
+	{
+		// wait for a period being rendered in the callback right now
+		audioEngine()->requestChangeInModel();
+		audioEngine()->doneChangeInModel();
+	}
+}
+
+
+
+
+bool AudioJack::isSynchronous() const
+{
+	// the engine's output can't be resampled when rendering in the callback
+	return m_synchronous &&
+		sampleRate() == Engine::audioEngine()->processingSampleRate();
 }
 
 
@@ -281,20 +367,22 @@ void AudioJack::applyQualitySettings()
 
 void AudioJack::registerPort( AudioPort * _port )
 {
-#ifdef AUDIO_PORT_SUPPORT
-	// make sure, port is not already registered
-	unregisterPort( _port );
-	const QString name[2] = { _port->name() + " L",
-					_port->name() + " R" } ;
+	// only ports of tracks are worth an output of their own, short-lived
+	// ports (e.g. of SamplePlayHandles) don't have an effect chain
+	if( !m_trackOutputsEnabled || _port->effects() == nullptr )
+	{
+		return;
+	}
 
-	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	// this can be called from any thread, so defer registering the JACK
+	// ports to the GUI thread
+	QMutexLocker lock( &m_extOutputsLock );
+	if( !m_pendingPorts.contains( _port ) && !m_portOutputs.contains( _port ) )
 	{
-		m_portMap[_port].ports[ch] = jack_port_register( m_client,
-						name[ch].toLatin1().constData(),
-						JACK_DEFAULT_AUDIO_TYPE,
-							JackPortIsOutput, 0 );
+		m_pendingPorts.push_back( _port );
+		QMetaObject::invokeMethod( this, "updateExtOutputs",
+						Qt::QueuedConnection );
 	}
-#endif
 }
 
 
@@ -302,98 +390,410 @@ void AudioJack::registerPort( AudioPort * _port )
 
 void AudioJack::unregisterPort( AudioPort * _port )
 {
-#ifdef AUDIO_PORT_SUPPORT
-	if( m_portMap.contains( _port ) )
+	if( !m_trackOutputsEnabled || _port->effects() == nullptr )
 	{
-		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+		return;
+	}
+
+	QMutexLocker lock( &m_extOutputsLock );
+	m_pendingPorts.removeAll( _port );
+
+	ExtOutput * output = m_portOutputs.take( _port );
+	if( output != nullptr )
+	{
+		// the port is about to be destroyed, so the rendering thread must
+		// not see it anymore once we return
+		publishExtOutputs( { output } );
+	}
+}
+
+
+
+
+void AudioJack::renamePort( AudioPort * _port )
+{
+	QMutexLocker lock( &m_extOutputsLock );
+	ExtOutput * output = m_portOutputs.value( _port );
+	if( output != nullptr )
+	{
+		setExtOutputName( output, _port->name() );
+	}
+}
+
+
+
+
+void AudioJack::updateExtOutputs()
+{
+	if( m_client == nullptr )
+	{
+		return;
+	}
+
+	QMutexLocker lock( &m_extOutputsLock );
+	bool changed = false;
+	QVector<ExtOutput *> removed;
+
+	// one output per mixer channel except master, which is already
+	// provided by the master outputs
+	const int mixerChannels = m_mixerOutputsEnabled && Engine::mixer() ?
+					Engine::mixer()->numChannels() - 1 : 0;
+	while( m_mixerOutputs.size() > mixerChannels )
+	{
+		removed.push_back( m_mixerOutputs.takeLast() );
+	}
+	while( m_mixerOutputs.size() < mixerChannels )
+	{
+		const int channel = m_mixerOutputs.size() + 1;
+		ExtOutput * output = createExtOutput(
+				QString( "mixer %1" ).arg( channel ), nullptr, channel );
+		if( output == nullptr )
 		{
-			if( m_portMap[_port].ports[ch] != nullptr )
+			break;
+		}
+		m_mixerOutputs.push_back( output );
+		changed = true;
+	}
+
+	for( AudioPort * port : m_pendingPorts )
+	{
+		ExtOutput * output = createExtOutput( port->name(), port, -1 );
+		if( output != nullptr )
+		{
+			m_portOutputs[port] = output;
+			changed = true;
+		}
+	}
+	m_pendingPorts.clear();
+
+	if( changed || !removed.isEmpty() )
+	{
+		publishExtOutputs( removed );
+	}
+}
+
+
+
+
+AudioJack::ExtOutput * AudioJack::createExtOutput( const QString & _name,
+						AudioPort * _port, int _mixerChannel )
+{
+	auto output = new ExtOutput( _port, _mixerChannel );
+	const QString name = uniquePortName( _name );
+	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	{
+		const QString portName = name + ( ch == 0 ? " L" : " R" );
+		output->ports[ch] = jack_port_register( m_client,
+						portName.toUtf8().constData(),
+						JACK_DEFAULT_AUDIO_TYPE,
+						JackPortIsOutput, 0 );
+		if( output->ports[ch] == nullptr )
+		{
+			printf( "no more JACK-ports available!\n" );
+			if( ch > 0 )
 			{
-				jack_port_unregister( m_client,
-						m_portMap[_port].ports[ch] );
+				jack_port_unregister( m_client, output->ports[0] );
 			}
+			delete output;
+			return nullptr;
 		}
-		m_portMap.erase( m_portMap.find( _port ) );
 	}
-#endif
+	return output;
 }
 
 
 
 
-void AudioJack::renamePort( AudioPort * _port )
+void AudioJack::setExtOutputName( ExtOutput * _output, const QString & _name )
 {
-#ifdef AUDIO_PORT_SUPPORT
-	if( m_portMap.contains( _port ) )
+	if( _name + " L" == jack_port_short_name( _output->ports[0] ) )
 	{
-		const QString name[2] = { _port->name() + " L",
-					_port->name() + " R" };
-		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
-		{
+		return;
+	}
+
+	const QString name = uniquePortName( _name );
+	for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+	{
+		const QString portName = name + ( ch == 0 ? " L" : " R" );
 #ifdef LMMS_HAVE_JACK_PRENAME
-			jack_port_rename( m_client, m_portMap[_port].ports[ch],
-					name[ch].toLatin1().constData() );
+		jack_port_rename( m_client, _output->ports[ch],
+					portName.toUtf8().constData() );
 #else
-			jack_port_set_name( m_portMap[_port].ports[ch],
-					name[ch].toLatin1().constData() );
+		jack_port_set_name( _output->ports[ch],
+					portName.toUtf8().constData() );
 #endif
+	}
+}
+
+
+
+
+QString AudioJack::uniquePortName( const QString & _name ) const
+{
+	// JACK refuses to register two ports with the same name, while e.g.
+	// track names don't have to be unique
+	const QString prefix = QString( jack_get_client_name( m_client ) ) + ":";
+	QString name = _name;
+	for( int i = 2; jack_port_by_name( m_client,
+			( prefix + name + " L" ).toUtf8().constData() ) != nullptr; ++i )
+	{
+		name = QString( "%1 (%2)" ).arg( _name ).arg( i );
+	}
+	return name;
+}
+
+
+
+
+void AudioJack::publishExtOutputs( const QVector<ExtOutput *> & _removed )
+{
+	auto list = new ExtOutputList;
+	list->reserve( m_mixerOutputs.size() + m_portOutputs.size() );
+	list->insert( list->end(), m_mixerOutputs.begin(), m_mixerOutputs.end() );
+	list->insert( list->end(), m_portOutputs.begin(), m_portOutputs.end() );
+
+	ExtOutputList * old = nullptr;
+	{
+		// the rendering thread picks the new list up with the next period
+		const auto guard = audioEngine()->requestChangesGuard();
+		old = m_extOutputs.exchange( list, std::memory_order_acq_rel );
+	}
+
+	// the process callback might still use the old list until it returns,
+	// so we must not block on it here (the rendering thread could be
+	// waiting for our caller) but free it later
+	m_retiredExtOutputs.push_back( { m_callbackCount.load( std::memory_order_acquire ),
+						old, _removed } );
+	collectRetiredExtOutputs();
+}
+
+
+
+
+void AudioJack::collectRetiredExtOutputs()
+{
+	const bool callbackRunning = m_active && m_client != nullptr;
+	const quint64 callbackCount = m_callbackCount.load( std::memory_order_acquire );
+
+	auto it = m_retiredExtOutputs.begin();
+	while( it != m_retiredExtOutputs.end() )
+	{
+		if( callbackRunning && it->callbackCount == callbackCount )
+		{
+			++it;
+			continue;
 		}
+		deleteExtOutputs( it->list, it->outputs );
+		it = m_retiredExtOutputs.erase( it );
+	}
+
+	if( !m_retiredExtOutputs.isEmpty() )
+	{
+		QTimer::singleShot( 100, this, SLOT(collectRetiredExtOutputs()) );
 	}
-#endif // AUDIO_PORT_SUPPORT
 }
 
 
 
 
-int AudioJack::processCallback( jack_nframes_t _nframes, void * _udata )
+void AudioJack::clearExtOutputs()
 {
+	// only called while the process callback is not running
+	QMutexLocker lock( &m_extOutputsLock );
 
-	// do midi processing first so that midi input can
-	// add to the following sound processing
-	if( m_midiClient && _nframes > 0 )
+	QVector<ExtOutput *> outputs = m_mixerOutputs;
+	for( ExtOutput * output : m_portOutputs )
 	{
-		m_midiClient.load()->JackMidiRead(_nframes);
-		m_midiClient.load()->JackMidiWrite(_nframes);
+		outputs.push_back( output );
 	}
+	m_mixerOutputs.clear();
+	m_portOutputs.clear();
 
-	for( int c = 0; c < channels(); ++c )
+	ExtOutputList * list = nullptr;
 	{
-		m_tempOutBufs[c] =
-			(jack_default_audio_sample_t *) jack_port_get_buffer(
-												m_outputPorts[c], _nframes );
+		const auto guard = audioEngine()->requestChangesGuard();
+		list = m_extOutputs.exchange( nullptr, std::memory_order_acq_rel );
 	}
+	deleteExtOutputs( list, outputs );
 
-#ifdef AUDIO_PORT_SUPPORT
-	const int frames = qMin<int>( _nframes, audioEngine()->framesPerPeriod() );
-	for( JackPortMap::iterator it = m_portMap.begin();
-						it != m_portMap.end(); ++it )
+	for( const RetiredExtOutputs & retired : m_retiredExtOutputs )
 	{
-		for( ch_cnt_t ch = 0; ch < channels(); ++ch )
+		deleteExtOutputs( retired.list, retired.outputs );
+	}
+	m_retiredExtOutputs.clear();
+}
+
+
+
+
+void AudioJack::deleteExtOutputs( ExtOutputList * _list,
+					const QVector<ExtOutput *> & _outputs )
+{
+	delete _list;
+	for( ExtOutput * output : _outputs )
+	{
+		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+		{
+			// ports of a zombified client are gone already
+			if( m_client != nullptr && output->ports[ch] != nullptr )
+			{
+				jack_port_unregister( m_client, output->ports[ch] );
+			}
+		}
+		delete output;
+	}
+}
+
+
+
+
+void AudioJack::processExtOutputs()
+{
+	ExtOutputList * outputs = m_extOutputs.load( std::memory_order_acquire );
+	const qint64 period = m_renderedPeriods.load( std::memory_order_relaxed );
+	const fpp_t fpp = audioEngine()->framesPerPeriod();
+	const quint64 cycle = m_callbackCount.load( std::memory_order_relaxed );
+
+	if( outputs != nullptr )
+	{
+		Mixer * mixer = Engine::mixer();
+		for( ExtOutput * output : *outputs )
 		{
-			if( it.value().ports[ch] == nullptr )
+			const sampleFrame * buf = m_silence.data();
+			if( output->port != nullptr )
+			{
+				if( !output->port->isMuted() )
+				{
+					buf = output->port->buffer();
+				}
+			}
+			else if( output->mixerChannel < mixer->numChannels() )
+			{
+				MixerChannel * ch = mixer->mixerChannel( output->mixerChannel );
+				if( !ch->m_muted )
+				{
+					buf = ch->m_buffer;
+				}
+			}
+
+			if( m_directOutputOffset >= 0 )
 			{
+				// we're rendering inside the process callback, so write
+				// straight into the port buffers - unless the output has
+				// been added after they have been fetched
+				if( output->portCycle == cycle )
+				{
+					jack_default_audio_sample_t * l =
+						output->portBuffers[0] + m_directOutputOffset;
+					jack_default_audio_sample_t * r =
+						output->portBuffers[1] + m_directOutputOffset;
+					for( fpp_t f = 0; f < fpp; ++f )
+					{
+						l[f] = buf[f][0];
+						r[f] = buf[f][1];
+					}
+				}
 				continue;
 			}
-			jack_default_audio_sample_t * buf =
-			(jack_default_audio_sample_t *) jack_port_get_buffer(
-							it.value().ports[ch],
-								_nframes );
-			for( int frame = 0; frame < frames; ++frame )
+
+			output->buffer.write( buf, fpp );
+			if( output->firstPeriod.load( std::memory_order_relaxed ) < 0 )
 			{
-				buf[frame] = it.key()->buffer()[frame][ch];
+				output->firstPeriod.store( period, std::memory_order_release );
 			}
 		}
 	}
-#endif
+
+	m_renderedPeriods.store( period + 1, std::memory_order_release );
+}
+
+
+
+
+bool AudioJack::startExtOutput( ExtOutput * _output )
+{
+	if( _output->running )
+	{
+		return true;
+	}
+
+	const qint64 firstPeriod = _output->firstPeriod.load( std::memory_order_acquire );
+	if( firstPeriod < 0 || firstPeriod > m_currentPeriod )
+	{
+		return false;
+	}
+
+	// if the output has been picked up after its first period started
+	// playing, drop what should have been played already
+	const std::size_t late = ( m_currentPeriod - firstPeriod ) *
+			audioEngine()->framesPerPeriod() + m_framesDoneInCurBuf;
+	if( late > 0 )
+	{
+		_output->reader.read_max( late );
+	}
+	_output->running = true;
+	return true;
+}
+
+
+
+
+void AudioJack::writeExtOutputs( ExtOutputList * _outputs,
+				jack_nframes_t _offset, jack_nframes_t _frames )
+{
+	for( ExtOutput * output : *_outputs )
+	{
+		jack_nframes_t frames = 0;
+		if( m_extOutputsInSync && startExtOutput( output ) )
+		{
+			// deinterleave straight into the port buffers
+			auto data = output->reader.read_max( _frames );
+			frames = data.size();
+			jack_default_audio_sample_t * l = output->portBuffers[0] + _offset;
+			jack_default_audio_sample_t * r = output->portBuffers[1] + _offset;
+			for( jack_nframes_t f = 0; f < frames; ++f )
+			{
+				l[f] = data[f][0];
+				r[f] = data[f][1];
+			}
+		}
+		for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+		{
+			memset( output->portBuffers[ch] + _offset + frames, 0,
+				sizeof( jack_default_audio_sample_t ) * ( _frames - frames ) );
+		}
+	}
+}
+
+
+
+
+void AudioJack::skipExtOutputs( ExtOutputList * _outputs, fpp_t _frames )
+{
+	for( ExtOutput * output : *_outputs )
+	{
+		if( startExtOutput( output ) )
+		{
+			output->reader.read_max( _frames );
+		}
+	}
+}
+
+
+
+
+jack_nframes_t AudioJack::pullFromFifo( ExtOutputList * _outputs,
+						jack_nframes_t _nframes )
+{
+	const float gain = audioEngine()->masterGain();
 
 	jack_nframes_t done = 0;
 	while( done < _nframes && m_stopped == false )
 	{
 		jack_nframes_t todo = qMin<jack_nframes_t>(
-						_nframes,
+						_nframes - done,
 						m_framesToDoInCurBuf -
 							m_framesDoneInCurBuf );
-		const float gain = audioEngine()->masterGain();
 		for( int c = 0; c < channels(); ++c )
 		{
 			jack_default_audio_sample_t * o = m_tempOutBufs[c];
@@ -402,6 +802,10 @@ int AudioJack::processCallback( jack_nframes_t _nframes, void * _udata )
 				o[done+frame] = m_outBuf[m_framesDoneInCurBuf+frame][c] * gain;
 			}
 		}
+		if( _outputs != nullptr )
+		{
+			writeExtOutputs( _outputs, done, todo );
+		}
 		done += todo;
 		m_framesDoneInCurBuf += todo;
 		if( m_framesDoneInCurBuf == m_framesToDoInCurBuf )
@@ -413,9 +817,155 @@ int AudioJack::processCallback( jack_nframes_t _nframes, void * _udata )
 				m_stopped = true;
 				break;
 			}
+			++m_currentPeriod;
+			// the external outputs are not resampled, so keep them silent
+			// while the master output is
+			m_extOutputsInSync = m_framesToDoInCurBuf ==
+						audioEngine()->framesPerPeriod();
+			if( !m_extOutputsInSync && _outputs != nullptr )
+			{
+				skipExtOutputs( _outputs, audioEngine()->framesPerPeriod() );
+			}
 		}
 	}
 
+	return done;
+}
+
+
+
+
+jack_nframes_t AudioJack::renderInCallback( ExtOutputList * _outputs,
+						jack_nframes_t _nframes )
+{
+	// JACK's thread is now the engine's rendering thread
+	disable_denormals();
+
+	const fpp_t fpp = audioEngine()->framesPerPeriod();
+	const float gain = audioEngine()->masterGain();
+
+	jack_nframes_t done = 0;
+	while( done < _nframes && m_stopped == false )
+	{
+		if( m_framesDoneInCurBuf == m_framesToDoInCurBuf &&
+			_nframes - done >= static_cast<jack_nframes_t>( fpp ) )
+		{
+			// a whole period fits, so render it right into the port
+			// buffers
+			m_directOutputOffset = done;
+			const surroundSampleFrame * b =
+				audioEngine()->renderNextBufferSynchronously();
+			m_directOutputOffset = -1;
+			if( b == nullptr )
+			{
+				break;
+			}
+			++m_currentPeriod;
+
+			for( int c = 0; c < channels(); ++c )
+			{
+				jack_default_audio_sample_t * o = m_tempOutBufs[c] + done;
+				for( fpp_t frame = 0; frame < fpp; ++frame )
+				{
+					o[frame] = b[frame][c] * gain;
+				}
+			}
+			done += fpp;
+			continue;
+		}
+
+		if( m_framesDoneInCurBuf == m_framesToDoInCurBuf )
+		{
+			// JACK's buffer doesn't cover whole periods, so keep the rest
+			// of this one for the next callback
+			const surroundSampleFrame * b =
+				audioEngine()->renderNextBufferSynchronously();
+			if( b == nullptr )
+			{
+				break;
+			}
+			memcpy( m_outBuf, b, fpp * sizeof( surroundSampleFrame ) );
+			m_framesToDoInCurBuf = fpp;
+			m_framesDoneInCurBuf = 0;
+			++m_currentPeriod;
+			m_extOutputsInSync = true;
+		}
+
+		const jack_nframes_t todo = qMin<jack_nframes_t>( _nframes - done,
+					m_framesToDoInCurBuf - m_framesDoneInCurBuf );
+		for( int c = 0; c < channels(); ++c )
+		{
+			jack_default_audio_sample_t * o = m_tempOutBufs[c] + done;
+			for( jack_nframes_t frame = 0; frame < todo; ++frame )
+			{
+				o[frame] = m_outBuf[m_framesDoneInCurBuf+frame][c] * gain;
+			}
+		}
+		if( _outputs != nullptr )
+		{
+			writeExtOutputs( _outputs, done, todo );
+		}
+		done += todo;
+		m_framesDoneInCurBuf += todo;
+	}
+
+	return done;
+}
+
+
+
+
+int AudioJack::processCallback( jack_nframes_t _nframes, void * _udata )
+{
+
+	// do midi processing first so that midi input can
+	// add to the following sound processing
+	if( m_midiClient && _nframes > 0 )
+	{
+		m_midiClient.load()->JackMidiRead(_nframes);
+		m_midiClient.load()->JackMidiWrite(_nframes);
+	}
+
+	for( int c = 0; c < channels(); ++c )
+	{
+		m_tempOutBufs[c] =
+			(jack_default_audio_sample_t *) jack_port_get_buffer(
+												m_outputPorts[c], _nframes );
+	}
+
+	ExtOutputList * extOutputs = m_extOutputs.load( std::memory_order_acquire );
+	if( extOutputs != nullptr )
+	{
+		const quint64 cycle = m_callbackCount.load( std::memory_order_relaxed );
+		for( ExtOutput * output : *extOutputs )
+		{
+			for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+			{
+				output->portBuffers[ch] =
+					(jack_default_audio_sample_t *) jack_port_get_buffer(
+							output->ports[ch], _nframes );
+				if( m_renderInCallback )
+				{
+					// periods rendered in the callback only write the
+					// outputs still in use
+					memset( output->portBuffers[ch], 0,
+						sizeof( jack_default_audio_sample_t ) * _nframes );
+				}
+			}
+			output->portCycle = cycle;
+		}
+	}
+
+	jack_nframes_t done = 0;
+	if( m_renderInCallback )
+	{
+		done = renderInCallback( extOutputs, _nframes );
+	}
+	else
+	{
+		done = pullFromFifo( extOutputs, _nframes );
+	}
+
 	if( _nframes != done )
 	{
 		for( int c = 0; c < channels(); ++c )
@@ -423,8 +973,22 @@ int AudioJack::processCallback( jack_nframes_t _nframes, void * _udata )
 			jack_default_audio_sample_t * b = m_tempOutBufs[c] + done;
 			memset( b, 0, sizeof( *b ) * ( _nframes - done ) );
 		}
+		if( extOutputs != nullptr )
+		{
+			for( ExtOutput * output : *extOutputs )
+			{
+				for( ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch )
+				{
+					memset( output->portBuffers[ch] + done, 0,
+						sizeof( jack_default_audio_sample_t ) * ( _nframes - done ) );
+				}
+			}
+		}
 	}
 
+	// lets the GUI thread know that retired outputs are not in use anymore
+	m_callbackCount.fetch_add( 1, std::memory_order_release );
+
 	return 0;
 }
 
@@ -477,6 +1041,22 @@ AudioJack::setupWidget::setupWidget( QWidget * _parent ) :
 	m_channels->setLabel( tr( "Channels" ) );
 	m_channels->move( 180, 20 );
 
+	m_mixerOutputs = new gui::LedCheckBox( tr( "Output for each mixer channel" ), this );
+	m_mixerOutputs->move( 10, 60 );
+	m_mixerOutputs->setChecked( ConfigManager::inst()->value( "audiojack",
+							"mixeroutputs" ).toInt() );
+
+	m_trackOutputs = new gui::LedCheckBox( tr( "Output for each track" ), this );
+	m_trackOutputs->move( 10, 80 );
+	m_trackOutputs->setChecked( ConfigManager::inst()->value( "audiojack",
+							"trackoutputs" ).toInt() );
+
+	m_synchronous = new gui::LedCheckBox( tr( "Render in JACK callback (lower latency)" ), this );
+	m_synchronous->move( 10, 100 );
+	m_synchronous->setChecked( ConfigManager::inst()->value( "audiojack",
+							"synchronous" ).toInt() );
+
+	setMinimumHeight( 125 );
 }
 
 
@@ -496,6 +1076,12 @@ void AudioJack::setupWidget::saveSettings()
 							m_clientName->text() );
 	ConfigManager::inst()->setValue( "audiojack", "channels",
 				QString::number( m_channels->value<int>() ) );
+	ConfigManager::inst()->setValue( "audiojack", "mixeroutputs",
+				QString::number( m_mixerOutputs->model()->value() ) );
+	ConfigManager::inst()->setValue( "audiojack", "trackoutputs",
+				QString::number( m_trackOutputs->model()->value() ) );
+	ConfigManager::inst()->setValue( "audiojack", "synchronous",
+				QString::number( m_synchronous->model()->value() ) );
 }
 
 
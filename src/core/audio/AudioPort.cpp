@@ -43,6 +43,7 @@ AudioPort::AudioPort( const QString & _name, bool _has_effect_chain,
 	m_nextMixerChannel( 0 ),
 	m_name( "unnamed port" ),
 	m_effects( _has_effect_chain ? new EffectChain( nullptr ) : nullptr ),
+	m_sourceLatency( 0 ),
 	m_volumeModel( volumeModel ),
 	m_panningModel( panningModel ),
 	m_mutedModel( mutedModel )
@@ -103,10 +104,28 @@ bool AudioPort::processEffects()
 }
 
 
+f_cnt_t AudioPort::latency() const
+{
+	return m_sourceLatency + ( m_effects ? m_effects->latency() : 0 );
+}
+
+
+
+
+bool AudioPort::isMuted() const
+{
+	return m_mutedModel && m_mutedModel->value();
+}
+
+
+
+
 void AudioPort::doProcessing()
 {
-	if( m_mutedModel && m_mutedModel->value() )
+	if( isMuted() )
 	{
+		// don't play what was delayed before muting once unmuted
+		m_compensation.clear();
 		return;
 	}
 
@@ -222,8 +241,12 @@ void AudioPort::doProcessing()
 
 	// handle effects
 	const bool me = processEffects();
-	if( me || m_bufferUsage )
+
+	// line up with slower paths into the same channel, keep going while
+	// the delayed signal still has to come out
+	if( me || m_bufferUsage || m_compensation.isPending() )
 	{
+		m_compensation.process( m_portBuffer, fpp, me || m_bufferUsage );
 		Engine::mixer()->mixToChannel( m_portBuffer, m_nextMixerChannel ); 	// send output to mixer
 																			// TODO: improve the flow here - convert to pull model
 		m_bufferUsage = false;
@@ -25,8 +25,8 @@
 
 
 #include "AudioSampleRecorder.h"
+#include "Engine.h"
 #include "SampleBuffer.h"
-#include "debug.h"
 
 
 namespace lmms
@@ -37,7 +37,8 @@ AudioSampleRecorder::AudioSampleRecorder( const ch_cnt_t _channels,
 							bool & _success_ful,
 							AudioEngine * _audioEngine ) :
 	AudioDevice( _channels, _audioEngine ),
-	m_buffers()
+	m_take( Engine::diskRecorder()->startTake( "recording", sampleRate() ) ),
+	m_finished( false )
 {
 	_success_ful = true;
 }
@@ -47,10 +48,9 @@ AudioSampleRecorder::AudioSampleRecorder( const ch_cnt_t _channels,
 
 AudioSampleRecorder::~AudioSampleRecorder()
 {
-	while( !m_buffers.empty() )
+	if( !m_finished )
 	{
-		delete[] m_buffers.front().first;
-		m_buffers.erase( m_buffers.begin() );
+		Engine::diskRecorder()->finishTake( m_take );
 	}
 }
 
@@ -59,12 +59,7 @@ AudioSampleRecorder::~AudioSampleRecorder()
 
 f_cnt_t AudioSampleRecorder::framesRecorded() const
 {
-	f_cnt_t frames = 0;
-	for (const auto& buffer : m_buffers)
-	{
-		frames += buffer.second;
-	}
-	return frames;
+	return m_take->framesRecorded();
 }
 
 
@@ -72,27 +67,14 @@ f_cnt_t AudioSampleRecorder::framesRecorded() const
 
 void AudioSampleRecorder::createSampleBuffer( SampleBuffer** sampleBuf )
 {
-	const f_cnt_t frames = framesRecorded();
-	// create buffer to store all recorded buffers in
-	auto data = new sampleFrame[frames];
-	// make sure buffer is cleaned up properly at the end...
-	sampleFrame * data_ptr = data;
-
-
-	assert( data != nullptr );
-
-	// now copy all buffers into big buffer
-	for( BufferList::ConstIterator it = m_buffers.begin();
-						it != m_buffers.end(); ++it )
+	if( !m_finished )
 	{
-		memcpy( data_ptr, ( *it ).first, ( *it ).second *
-							sizeof( sampleFrame ) );
-		data_ptr += ( *it ).second;
+		Engine::diskRecorder()->finishTake( m_take );
+		Engine::diskRecorder()->waitForTake( m_take );
+		m_finished = true;
 	}
-	// create according sample-buffer out of big buffer
-	*sampleBuf = new SampleBuffer( data, frames );
-	( *sampleBuf )->setSampleRate( sampleRate() );
-	delete[] data;
+
+	*sampleBuf = m_take->isValid() ? new SampleBuffer( m_take->fileName() ) : new SampleBuffer;
 }
 
 
@@ -101,15 +83,10 @@ void AudioSampleRecorder::createSampleBuffer( SampleBuffer** sampleBuf )
 void AudioSampleRecorder::writeBuffer( const surroundSampleFrame * _ab,
 					const fpp_t _frames, const float )
 {
-	auto buf = new sampleFrame[_frames];
-	for( fpp_t frame = 0; frame < _frames; ++frame )
+	if( !m_finished )
 	{
-		for( ch_cnt_t chnl = 0; chnl < DEFAULT_CHANNELS; ++chnl )
-		{
-			buf[frame][chnl] = _ab[frame][chnl];
-		}
+		m_take->write( _ab, _frames );
 	}
-	m_buffers.push_back( qMakePair( buf, _frames ) );
 }
 
 
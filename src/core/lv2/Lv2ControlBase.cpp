@@ -148,6 +148,51 @@ void Lv2ControlBase::copyBuffersToLmms(sampleFrame *buf, fpp_t frames) const {
 
 
 
+void Lv2ControlBase::copyBuffersFromLmms(const PlanarBuffer &buf, fpp_t frames)
+{
+	unsigned firstChan = 0;
+	for (const auto& c : m_procs)
+	{
+		c->copyBuffersFromCore(buf, firstChan, m_channelsPerProc, frames);
+		firstChan += m_channelsPerProc;
+	}
+}
+
+
+
+
+void Lv2ControlBase::copyBuffersToLmms(PlanarBuffer &buf, fpp_t frames) const
+{
+	unsigned firstChan = 0;
+	for (const auto& c : m_procs)
+	{
+		c->copyBuffersToCore(buf, firstChan, m_channelsPerProc, frames);
+		firstChan += m_channelsPerProc;
+	}
+}
+
+
+
+
+bool Lv2ControlBase::connectBuffersToLmms(PlanarBuffer *in, PlanarBuffer *out)
+{
+	bool direct = true;
+	unsigned firstChan = 0;
+	for (const auto& c : m_procs)
+	{
+		direct &= c->connectBuffers(in, out, firstChan, m_channelsPerProc);
+		firstChan += m_channelsPerProc;
+	}
+	if (!direct)
+	{
+		for (const auto& c : m_procs) { c->connectBuffers(nullptr, nullptr, 0, 0); }
+	}
+	return direct;
+}
+
+
+
+
 void Lv2ControlBase::run(fpp_t frames) {
 	for (const auto& c : m_procs) { c->run(frames); }
 }
@@ -209,6 +254,16 @@ bool Lv2ControlBase::hasNoteInput() const
 
 
 
+f_cnt_t Lv2ControlBase::latency() const
+{
+	f_cnt_t latency = 0;
+	for (const auto& c : m_procs) { latency = std::max(latency, c->latency()); }
+	return latency;
+}
+
+
+
+
 void Lv2ControlBase::handleMidiInputEvent(const MidiEvent &event,
 	const TimePos &time, f_cnt_t offset)
 {
@@ -26,6 +26,7 @@
 
 #ifdef LMMS_HAVE_LV2
 
+#include <algorithm>
 #include <cmath>
 #include <lv2/lv2plug.in/ns/ext/midi/midi.h>
 #include <lv2/lv2plug.in/ns/ext/atom/atom.h>
@@ -43,6 +44,8 @@
 #include "Lv2Evbuf.h"
 #include "MidiEvent.h"
 #include "MidiEventToByteSeq.h"
+#include "PlanarBuffer.h"
+#include "ValueBuffer.h"
 
 
 namespace lmms
@@ -205,12 +208,25 @@ void Lv2Proc::copyModelsFromCore()
 
 	struct Copy : public Lv2Ports::Visitor
 	{
+		Lv2Proc* m_proc;
 		void visit(Lv2Ports::Control& ctrl) override
 		{
 			FloatFromModelVisitor ffm;
 			ffm.m_scalePointMap = &ctrl.m_scalePointMap;
 			ctrl.m_connectedModel->accept(ffm);
 			ctrl.m_val = ffm.m_res;
+
+			// follow automation within the period, see run()
+			if (m_proc->m_canSplit && m_proc->m_splitter.isEnabled())
+			{
+				auto model = dynamic_cast<FloatModel*>(ctrl.m_connectedModel.get());
+				if (ValueBuffer* vb = model ? model->valueBuffer() : nullptr)
+				{
+					m_proc->m_automatedControls.push_back({&ctrl, vb->values()});
+					m_proc->m_splitter.addControl(vb->values(),
+						SubBlockSplitter::DefaultTolerance * model->range());
+				}
+			}
 		}
 		void visit(Lv2Ports::Cv& cv) override
 		{
@@ -225,6 +241,10 @@ void Lv2Proc::copyModelsFromCore()
 			lv2_evbuf_reset(atomPort.m_buf.get(), true);
 		}
 	} copy;
+	copy.m_proc = this;
+
+	m_splitter.clear();
+	m_automatedControls.clear();
 
 	// feed each input port with the respective data from the LMMS core
 	for (const std::unique_ptr<Lv2Ports::PortBase>& port : m_ports)
@@ -329,9 +349,95 @@ void Lv2Proc::copyBuffersToCore(sampleFrame* buf,
 
 
 
+void Lv2Proc::copyBuffersFromCore(const PlanarBuffer &buf,
+									unsigned firstChan, unsigned num,
+									fpp_t frames)
+{
+	inPorts().m_left->copyBuffersFromCore(buf.channel(firstChan), frames);
+	if (num > 1)
+	{
+		if (inPorts().m_right)
+		{
+			inPorts().m_right->copyBuffersFromCore(buf.channel(firstChan + 1), frames);
+		}
+		else
+		{
+			inPorts().m_left->averageWithBuffersFromCore(buf.channel(firstChan + 1), frames);
+		}
+	}
+}
+
+
+
+
+void Lv2Proc::copyBuffersToCore(PlanarBuffer &buf,
+								unsigned firstChan, unsigned num,
+								fpp_t frames) const
+{
+	outPorts().m_left->copyBuffersToCore(buf.channel(firstChan + 0), frames);
+	if (num > 1)
+	{
+		Lv2Ports::Audio* ap = outPorts().m_right
+			? outPorts().m_right : outPorts().m_left;
+		ap->copyBuffersToCore(buf.channel(firstChan + 1), frames);
+	}
+}
+
+
+
+
+bool Lv2Proc::connectBuffers(PlanarBuffer *in, PlanarBuffer *out,
+								unsigned firstChan, unsigned num)
+{
+	// averaging inputs or duplicating outputs needs the own buffers
+	const bool direct = in && out && m_inPorts.m_left && m_outPorts.m_left
+		&& (num < 2 || (m_inPorts.m_right && m_outPorts.m_right));
+
+	bool changed = false;
+	const auto use = [&changed](Lv2Ports::Audio* port, sample_t* buf)
+	{
+		if (port) { changed |= port->useBuffer(buf); }
+	};
+	use(m_inPorts.m_left, direct ? in->channel(firstChan) : nullptr);
+	use(m_inPorts.m_right, direct && num > 1 ? in->channel(firstChan + 1) : nullptr);
+	use(m_outPorts.m_left, direct ? out->channel(firstChan) : nullptr);
+	use(m_outPorts.m_right, direct && num > 1 ? out->channel(firstChan + 1) : nullptr);
+
+	// the buffers of an effect chain only change when it is rearranged
+	if (changed) { connectAudioPorts(0); }
+	return direct;
+}
+
+
+
+
 void Lv2Proc::run(fpp_t frames)
 {
-	lilv_instance_run(m_instance, static_cast<uint32_t>(frames));
+	const std::size_t blocks = m_automatedControls.empty() ? 1 : m_splitter.split(frames);
+	if (blocks == 1)
+	{
+		lilv_instance_run(m_instance, static_cast<uint32_t>(frames));
+	}
+	else
+	{
+		// control ports only take one value per run, so run the plugin in
+		// blocks with the audio ports pointing into the period
+		for (std::size_t block = 0; block < blocks; ++block)
+		{
+			const fpp_t from = m_splitter.blockStart(block);
+			for (const AutomatedControl& automated : m_automatedControls)
+			{
+				automated.m_port->m_val = automated.m_values[from];
+			}
+			connectAudioPorts(from);
+			lilv_instance_run(m_instance,
+				static_cast<uint32_t>(m_splitter.blockEnd(block) - from));
+		}
+		connectAudioPorts(0);
+	}
+
+	m_splitter.clear();
+	m_automatedControls.clear();
 }
 
 
@@ -442,6 +548,17 @@ bool Lv2Proc::hasNoteInput() const
 
 
 
+f_cnt_t Lv2Proc::latency() const
+{
+	// the value is only meaningful after the plugin ran
+	return m_latencyPort
+		? static_cast<f_cnt_t>(std::max(m_latencyPort->m_val, 0.0f))
+		: 0;
+}
+
+
+
+
 void Lv2Proc::initMOptions()
 {
 	/*
@@ -686,6 +803,8 @@ void Lv2Proc::createPorts()
 		{
 			if(atomPort.m_flow == Lv2Ports::Flow::Input)
 			{
+				// events are timed relative to the whole period
+				m_proc->m_canSplit = false;
 				if(atomPort.flags & Lv2Ports::AtomSeq::FlagType::Midi)
 				{
 					// take any MIDI input, prefer mandatory MIDI input
@@ -712,6 +831,9 @@ void Lv2Proc::createPorts()
 
 	std::size_t maxPorts = lilv_plugin_get_num_ports(m_plugin);
 	m_ports.resize(maxPorts);
+	m_canSplit = true;
+	m_automatedControls.reserve(maxPorts);
+	m_splitter.reserve(maxPorts);
 
 	for (std::size_t portNum = 0; portNum < maxPorts; ++portNum)
 	{
@@ -721,6 +843,17 @@ void Lv2Proc::createPorts()
 		m_ports[portNum]->accept(registerPort);
 	}
 
+	m_latencyPort = nullptr;
+	if (lilv_plugin_has_latency(m_plugin))
+	{
+		std::size_t latencyPortNum = lilv_plugin_get_latency_port_index(m_plugin);
+		if (latencyPortNum < maxPorts)
+		{
+			auto ctrl = Lv2Ports::dcast<Lv2Ports::Control>(m_ports[latencyPortNum].get());
+			if (ctrl && ctrl->m_flow == Lv2Ports::Flow::Output) { m_latencyPort = ctrl; }
+		}
+	}
+
 	// initially assign model values to port values
 	copyModelsFromCore();
 
@@ -735,6 +868,10 @@ struct ConnectPortVisitor : public Lv2Ports::Visitor
 {
 	std::size_t m_num;
 	LilvInstance* m_instance;
+	//! frames into the audio buffers, for running parts of a period
+	fpp_t m_offset = 0;
+	//! leave all but audio ports alone
+	bool m_audioOnly = false;
 	void connectPort(void* location)
 	{
 		lilv_instance_connect_port(m_instance,
@@ -742,14 +879,26 @@ struct ConnectPortVisitor : public Lv2Ports::Visitor
 	}
 	void visit(Lv2Ports::AtomSeq& atomSeq) override
 	{
-		connectPort(lv2_evbuf_get_buffer(atomSeq.m_buf.get()));
+		if (!m_audioOnly) { connectPort(lv2_evbuf_get_buffer(atomSeq.m_buf.get())); }
+	}
+	void visit(Lv2Ports::Control& ctrl) override
+	{
+		if (!m_audioOnly) { connectPort(&ctrl.m_val); }
 	}
-	void visit(Lv2Ports::Control& ctrl) override { connectPort(&ctrl.m_val); }
 	void visit(Lv2Ports::Audio& audio) override
 	{
-		connectPort((audio.mustBeUsed()) ? audio.m_buffer.data() : nullptr);
+		// unused ports stay disconnected
+		if (audio.mustBeUsed())
+		{
+			float* buf = audio.m_coreBuffer ? audio.m_coreBuffer : audio.m_buffer.data();
+			connectPort(buf + m_offset);
+		}
+		else if (!m_audioOnly) { connectPort(nullptr); }
+	}
+	void visit(Lv2Ports::Unknown&) override
+	{
+		if (!m_audioOnly) { connectPort(nullptr); }
 	}
-	void visit(Lv2Ports::Unknown&) override { connectPort(nullptr); }
 	~ConnectPortVisitor() override = default;
 };
 
@@ -766,6 +915,23 @@ void Lv2Proc::connectPort(std::size_t num)
 
 
 
+// !This function must be realtime safe!
+void Lv2Proc::connectAudioPorts(fpp_t offset)
+{
+	ConnectPortVisitor connect;
+	connect.m_instance = m_instance;
+	connect.m_offset = offset;
+	connect.m_audioOnly = true;
+	for (std::size_t num = 0; num < m_ports.size(); ++num)
+	{
+		connect.m_num = num;
+		m_ports[num]->accept(connect);
+	}
+}
+
+
+
+
 void Lv2Proc::dumpPort(std::size_t num)
 {
 	struct DumpPortDetail : public Lv2Ports::ConstVisitor
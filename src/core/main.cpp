@@ -23,6 +23,8 @@
  *
  */
 
+#include <cmath>
+
 #include <QApplication>
 #include <QDebug>
 #include <QFileInfo>
@@ -56,6 +58,7 @@
 
 #include <csignal>
 
+#include "AutomationClip.h"
 #include "ConfigManager.h"
 #include "DataFile.h"
 #include "Engine.h"
@@ -68,7 +71,9 @@
 #include "OutputSettings.h"
 #include "ProjectRenderer.h"
 #include "RenderManager.h"
+#include "SegmentedRenderer.h"
 #include "Song.h"
+#include "ThreadConfiguration.h"
 #include "embed.h"
 
 #ifdef LMMS_DEBUG_FPE
@@ -101,6 +106,15 @@ static inline QString baseName(const QString& file) {
   return QFileInfo(file).absolutePath() + "/" + QFileInfo(file).completeBaseName();
 }
 
+// Whether automation or controllers change models of the project. Plugins
+// read most of them once per period, so large render blocks would move
+// those changes by up to a block.
+static bool isAutomated(const QString& file) {
+  DataFile dataFile(file);
+  return !dataFile.elementsByTagName(AutomationClip::classNodeName()).isEmpty()
+    || !dataFile.elementsByTagName("connection").isEmpty();
+}
+
 #ifdef LMMS_BUILD_WIN32
 // Workaround for old MinGW
 #ifdef __MINGW32__
@@ -141,6 +155,9 @@ void printHelp() {
     "  <no action> [options...] [<project>]  Start LMMS in normal GUI mode\n"
     "  dump <in>                             Dump XML of compressed file <in>\n"
     "  compress <in>                         Compress file <in>\n"
+    "  compare <reference> <file>            Report the numerical difference of\n"
+    "                                        two audio files, e.g. a segmented\n"
+    "                                        and a serial render\n"
     "  render <project> [options...]         Render given project file\n"
     "  rendertracks <project> [options...]   Render each track to a different file\n"
     "  upgrade <in> [out]                    Upgrade file <in> and save as <out>\n"
@@ -154,7 +171,19 @@ void printHelp() {
     "          caution).\n"
     "  -c, --config <configfile>      Get the configuration from <configfile>\n"
     "  -h, --help                     Show this usage information and exit.\n"
+    "      --lockmemory               Lock all memory into RAM with mlockall()\n"
+    "      --rendercpus <list>        Run the render thread on the CPUs in\n"
+    "          <list>, e.g. 0,2-3\n"
+    "      --renderpriority <policy>[:<priority>]\n"
+    "          Scheduling policy of the render thread,\n"
+    "          'default', 'fifo' or 'rr'\n"
     "  -v, --version                  Show version information and exit.\n"
+    "      --workercpus <list>        Pin each worker thread to one of the\n"
+    "          CPUs in <list>, in turn\n"
+    "      --workerpriority <policy>[:<priority>]\n"
+    "          Scheduling policy of the worker threads\n"
+    "      --workers <count>          Number of worker threads. Default: one\n"
+    "          less than the number of cores\n"
     "\nOptions if no action is given:\n"
     "      --geometry <geometry>      Specify the size and position of\n"
     "          the main window\n"
@@ -165,8 +194,16 @@ void printHelp() {
     "  -a, --float                    Use 32bit float bit depth\n"
     "  -b, --bitrate <bitrate>        Specify output bitrate in KBit/s\n"
     "          Default: 160.\n"
-    "  -f, --format <format>         Specify format of render-output where\n"
+    "      --crossfade <frames>       With --segments, crossfade the segments\n"
+    "          over <frames> instead of splicing them. Default: 0\n"
+    "      --blocksize <frames>       Specify the number of frames rendered\n"
+    "          at once. Larger blocks render faster, they\n"
+    "          are only used for projects without automation.\n"
+    "          Range: 32 to 8192, default: 256\n"
+    "  -f, --format <format>[,...]   Specify format of render-output where\n"
     "          Format is either 'wav', 'flac', 'ogg' or 'mp3'.\n"
+    "          Several comma-separated formats are encoded\n"
+    "          from a single render, e.g. 'wav,flac,mp3'.\n"
     "  -i, --interpolation <method>   Specify interpolation method\n"
     "          Possible values:\n"
     "            - linear\n"
@@ -185,9 +222,18 @@ void printHelp() {
     "          For \"rendertracks\", provide a directory path\n"
     "          If not specified, render will overwrite the input file\n"
     "          For \"rendertracks\", this might be required\n"
+    "      --overlap <frames>         Keep rendering <frames> after the end of\n"
+    "          --range, to crossfade with the next segment\n"
     "  -p, --profile <out>            Dump profiling information to file <out>\n"
+    "      --preroll <bars>           Start rendering <bars> before --range or\n"
+    "          each segment, so tails and envelopes settle.\n"
+    "          Default: 0, with --segments: 2\n"
+    "      --range <first>:<last>     Only render bars <first> to <last>\n"
     "  -s, --samplerate <samplerate>  Specify output samplerate in Hz\n"
     "          Range: 44100 (default) to 192000\n"
+    "      --segments <count>         Split the song into <count> segments,\n"
+    "          which are rendered by parallel processes\n"
+    "          and joined into one file (\"render\" only)\n"
     "  -x, --oversampling <value>     Specify oversampling\n"
     "          Possible values: 1, 2, 4, 8\n"
     "          Default: 2\n\n",
@@ -271,7 +317,7 @@ int main(int argc, char** argv) {
     QString arg = argv[i];
 
     if (arg == "--help" || arg == "-h" || arg == "--version" || arg == "-v" || arg == "render" || arg == "--render"
-      || arg == "-r") {
+      || arg == "-r" || arg == "compare") {
       coreOnly = true;
     } else if (arg == "rendertracks" || arg == "--rendertracks") {
       coreOnly = true;
@@ -309,7 +355,14 @@ int main(int argc, char** argv) {
   AudioEngine::qualitySettings qs(AudioEngine::qualitySettings::Mode_HighQuality);
   OutputSettings os(44100, OutputSettings::BitRateSettings(160, false), OutputSettings::Depth_16Bit,
     OutputSettings::StereoMode_JointStereo);
-  ProjectRenderer::ExportFileFormats eff = ProjectRenderer::WaveFile;
+  QVector<ProjectRenderer::ExportFileFormats> formats;
+  fpp_t renderBlockSize = 0;
+  bar_t rangeFirst = 0, rangeLast = 0, preRollBars = -1;
+  f_cnt_t overlapFrames = 0, crossfadeFrames = 0;
+  int segments = 0;
+  // keyed like the configuration file, which is loaded after parsing
+  QMap<QString, QString> threadOverrides;
+  QStringList threadArguments;
 
   // second of two command-line parsing stages
   for (int i = 1; i < argc; ++i) {
@@ -386,6 +439,28 @@ int main(int argc, char** argv) {
       QByteArray d = qCompress(f.readAll());
       fwrite(d.constData(), sizeof(char), d.size(), stdout);
 
+      return EXIT_SUCCESS;
+    } else if (arg == "compare") {
+      if (i + 2 >= argc) { return usageError("Two files are required for comparing"); }
+
+      const QString reference = QString::fromLocal8Bit(argv[i + 1]);
+      const QString file = QString::fromLocal8Bit(argv[i + 2]);
+      const auto difference = SegmentedRenderer::compare(reference, file);
+      if (!difference.error.isEmpty()) {
+        printf("%s\n", difference.error.toUtf8().constData());
+        return EXIT_FAILURE;
+      }
+
+      const auto toDecibels = [](double value) { return value > 0 ? 20 * std::log10(value) : -INFINITY; };
+      printf("Compared frames:    %d\n", difference.frames);
+      printf("Length difference:  %d frames\n", difference.lengthDifference);
+      printf("Peak difference:    %g (%.1f dBFS)\n", difference.peak, toDecibels(difference.peak));
+      printf("RMS difference:     %g (%.1f dBFS)\n", difference.rms, toDecibels(difference.rms));
+      if (difference.firstDifferentFrame >= 0) {
+        printf("First difference:   frame %d (%.3f s)\n", difference.firstDifferentFrame,
+          static_cast<double>(difference.firstDifferentFrame) / difference.sampleRate);
+      }
+
       return EXIT_SUCCESS;
     } else if (arg == "render" || arg == "--render" || arg == "-r" || arg == "rendertracks" || arg == "--rendertracks") {
       ++i;
@@ -413,17 +488,22 @@ int main(int argc, char** argv) {
         return usageError("No output format specified"); 
       }
 
-      const QString ext = QString(argv[i]);
-
-      if (ext == "wav") { eff = ProjectRenderer::WaveFile; }
+      // all formats are encoded from a single render
+      formats.clear();
+      for (const QString& ext : QString(argv[i]).split(',')) {
+        ProjectRenderer::ExportFileFormats eff;
+        if (ext == "wav") { eff = ProjectRenderer::WaveFile; }
 #ifdef LMMS_HAVE_OGGVORBIS
-      else if (ext == "ogg") { eff = ProjectRenderer::OggFile; }
+        else if (ext == "ogg") { eff = ProjectRenderer::OggFile; }
 #endif
 #ifdef LMMS_HAVE_MP3LAME
-      else if (ext == "mp3") { eff = ProjectRenderer::MP3File; }
+        else if (ext == "mp3") { eff = ProjectRenderer::MP3File; }
 #endif
-      else if (ext == "flac") { eff = ProjectRenderer::FlacFile; }
-      else { return usageError(QString("Invalid output format %1").arg(argv[i])); }
+        else if (ext == "flac") { eff = ProjectRenderer::FlacFile; }
+        else { return usageError(QString("Invalid output format %1").arg(ext)); }
+
+        if (!formats.contains(eff)) { formats.push_back(eff); }
+      }
     } else if (arg == "--samplerate" || arg == "-s") {
       ++i;
 
@@ -437,6 +517,52 @@ int main(int argc, char** argv) {
       } else { 
         return usageError(QString("Invalid samplerate %1").arg(argv[i])); 
       }
+    } else if (arg == "--blocksize") {
+      ++i;
+
+      if (i == argc) { 
+        return usageError("No block size specified"); 
+      }
+
+      const int blockSize = QString(argv[i]).toInt();
+      if (blockSize >= MINIMUM_BUFFER_SIZE && blockSize <= MAXIMUM_RENDER_BLOCK_SIZE) {
+        renderBlockSize = static_cast<fpp_t>(blockSize);
+      } else { 
+        return usageError(QString("Invalid block size %1").arg(argv[i])); 
+      }
+    } else if (arg == "--range") {
+      ++i;
+
+      if (i == argc) { return usageError("No range specified"); }
+
+      const QStringList bars = QString(argv[i]).split(':');
+      rangeFirst = bars.size() == 2 ? bars[0].toInt() : 0;
+      rangeLast = bars.size() == 2 ? bars[1].toInt() : 0;
+      if (rangeFirst < 1 || rangeLast < rangeFirst) { return usageError(QString("Invalid range %1").arg(argv[i])); }
+    } else if (arg == "--preroll") {
+      ++i;
+
+      if (i == argc) { return usageError("No pre-roll specified"); }
+
+      bool ok = false;
+      preRollBars = QString(argv[i]).toInt(&ok);
+      if (!ok || preRollBars < 0) { return usageError(QString("Invalid pre-roll %1").arg(argv[i])); }
+    } else if (arg == "--segments") {
+      ++i;
+
+      if (i == argc) { return usageError("No segment count specified"); }
+
+      segments = QString(argv[i]).toInt();
+      if (segments < 1) { return usageError(QString("Invalid segment count %1").arg(argv[i])); }
+    } else if (arg == "--crossfade" || arg == "--overlap") {
+      ++i;
+
+      if (i == argc) { return usageError("No frame count specified"); }
+
+      bool ok = false;
+      const int frames = QString(argv[i]).toInt(&ok);
+      if (!ok || frames < 0 || frames > 65536) { return usageError(QString("Invalid frame count %1").arg(argv[i])); }
+      (arg == "--crossfade" ? crossfadeFrames : overlapFrames) = frames;
     } else if (arg == "--bitrate" || arg == "-b") {
       ++i;
 
@@ -524,6 +650,41 @@ int main(int argc, char** argv) {
       if (i == argc) { return usageError("No profile specified"); }
 
       profilerOutputFile = QString::fromLocal8Bit(argv[i]);
+    } else if (arg == "--workers") {
+      ++i;
+
+      if (i == argc) { return usageError("No worker count specified"); }
+
+      bool ok = false;
+      const int workers = QString(argv[i]).toInt(&ok);
+      if (!ok || workers < 0) { return usageError(QString("Invalid worker count %1").arg(argv[i])); }
+      threadOverrides["workers"] = argv[i];
+      threadArguments << arg << argv[i];
+    } else if (arg == "--rendercpus" || arg == "--workercpus") {
+      ++i;
+
+      if (i == argc) { return usageError("No CPUs specified"); }
+
+      QList<int> cpus;
+      if (!ThreadConfiguration::parseCpuList(argv[i], cpus) || cpus.isEmpty()) {
+        return usageError(QString("Invalid CPU list %1").arg(argv[i]));
+      }
+      threadOverrides[arg.mid(2)] = argv[i];
+      threadArguments << arg << argv[i];
+    } else if (arg == "--renderpriority" || arg == "--workerpriority") {
+      ++i;
+
+      if (i == argc) { return usageError("No scheduling policy specified"); }
+
+      ThreadConfiguration::ThreadSettings settings;
+      if (!ThreadConfiguration::parsePriority(argv[i], settings)) {
+        return usageError(QString("Invalid scheduling policy %1").arg(argv[i]));
+      }
+      threadOverrides[arg.mid(2)] = argv[i];
+      threadArguments << arg << argv[i];
+    } else if (arg == "--lockmemory") {
+      threadOverrides["lockmemory"] = "1";
+      threadArguments << arg;
     } else if (arg == "--config" || arg == "-c") {
       ++i;
 
@@ -536,6 +697,11 @@ int main(int argc, char** argv) {
     }
   }
 
+  // the segments are rendered by other processes, which aren't profiled
+  if (segments > 1 && !renderTracks && !profilerOutputFile.isEmpty()) {
+    return usageError("--profile can't be combined with --segments");
+  }
+
   // Test file argument before continuing
   if (!fileToLoad.isEmpty()) { 
     fileCheck(fileToLoad); 
@@ -545,6 +711,8 @@ int main(int argc, char** argv) {
 
   ConfigManager::inst()->loadConfigFile(configFile);
 
+  ThreadConfiguration::setCurrent(ThreadConfiguration::fromConfig(threadOverrides));
+
   // Hidden settings
   MixHelpers::setNaNHandler(ConfigManager::inst()->value("app", "nanhandler", "1").toInt());
 
@@ -593,7 +761,11 @@ int main(int argc, char** argv) {
   // if we have an output file for rendering, just render the song
   // without starting the GUI
   if (!renderOut.isEmpty()) {
-    Engine::init(true);
+    if (renderBlockSize > DEFAULT_BUFFER_SIZE && isAutomated(fileToLoad)) {
+      printf("Notice: the project is automated, rendering blocks of %d frames.\n", DEFAULT_BUFFER_SIZE);
+      renderBlockSize = 0;
+    }
+    Engine::init(true, renderBlockSize);
     destroyEngine = true;
 
     printf("Loading project...\n");
@@ -606,26 +778,61 @@ int main(int argc, char** argv) {
 
     Engine::getSong()->setExportLoop(renderLoop);
 
+    if (formats.isEmpty()) { formats.push_back(ProjectRenderer::WaveFile); }
+
     // when rendering multiple tracks, renderOut is a directory
     // otherwise, it is a file, so we need to append the file extension
-    if (!renderTracks) { renderOut = baseName(renderOut) + ProjectRenderer::getFileExtensionFromFormat(eff); }
+    // of the first format, the others are derived from it
+    if (!renderTracks) { renderOut = baseName(renderOut) + ProjectRenderer::getFileExtensionFromFormat(formats.front()); }
+
+    if (segments > 1 && !renderTracks) {
+      // the same end as Song::startExport() uses for the whole song
+      Engine::getSong()->updateLength();
+      SegmentedRenderer::Settings settings;
+      settings.projectFile = fileToLoad;
+      settings.begin = TimePos(rangeLast > 0 ? rangeFirst - 1 : 0, 0);
+      settings.end = TimePos(rangeLast > 0 ? rangeLast : Engine::getSong()->length() + (renderLoop ? 0 : 1), 0);
+      settings.segments = segments;
+      settings.preRollBars = preRollBars < 0 ? 2 : preRollBars;
+      settings.crossfadeFrames = crossfadeFrames;
+      if (!configFile.isEmpty()) { settings.extraArguments << "--config" << configFile; }
+      if (allowRoot) { settings.extraArguments << "--allowroot"; }
+      settings.extraArguments << threadArguments;
+
+      auto r = new SegmentedRenderer(qs, os, formats, renderOut, settings);
+      // queued, as rendering may fail before the event loop runs
+      QObject::connect(r, &SegmentedRenderer::finished, r,
+        [](bool successful) { QCoreApplication::exit(successful ? EXIT_SUCCESS : EXIT_FAILURE); }, Qt::QueuedConnection);
+
+      auto t = new QTimer(r);
+      r->connect(t, SIGNAL(timeout()), SLOT(updateConsoleProgress()));
+      t->start(200);
+
+      r->render();
+    } else {
+      if (rangeLast > 0) {
+        const bar_t begin = rangeFirst - 1;
+        Engine::getSong()->setExportRange({TimePos(std::max(0, begin - std::max(0, preRollBars)), 0),
+          TimePos(begin, 0), TimePos(rangeLast, 0), overlapFrames});
+      }
 
-    // create renderer
-    auto r = new RenderManager(qs, os, eff, renderOut);
-    QCoreApplication::instance()->connect(r, SIGNAL(finished()), SLOT(quit()));
+      // create renderer
+      auto r = new RenderManager(qs, os, formats, renderOut);
+      QCoreApplication::instance()->connect(r, SIGNAL(finished()), SLOT(quit()));
 
-    // timer for progress-updates
-    auto t = new QTimer(r);
-    r->connect(t, SIGNAL(timeout()), SLOT(updateConsoleProgress()));
-    t->start(200);
+      // timer for progress-updates
+      auto t = new QTimer(r);
+      r->connect(t, SIGNAL(timeout()), SLOT(updateConsoleProgress()));
+      t->start(200);
 
-    if (profilerOutputFile.isEmpty() == false) {
-      Engine::audioEngine()->profiler().setOutputFile(profilerOutputFile);
-    }
+      if (profilerOutputFile.isEmpty() == false) {
+        Engine::audioEngine()->profiler().setOutputFile(profilerOutputFile);
+      }
 
-    // start now!
-    if (renderTracks) { r->renderTracks(); }
-    else { r->renderProject(); }
+      // start now!
+      if (renderTracks) { r->renderTracks(); }
+      else { r->renderProject(); }
+    }
   } else {
     // otherwise, start the GUI 
     using namespace lmms::gui;
@@ -255,6 +255,8 @@ void EffectRackView::addEffect()
 void EffectRackView::modelChanged()
 {
 	//clearViews();
+	// the effects are shown, so they are needed now
+	fxChain()->instantiatePendingEffects();
 	m_effectsGroupBox->setModel( &fxChain()->m_enabledModel );
 	connect( fxChain(), SIGNAL(aboutToClear()), this, SLOT(clearViews()));
 	update();
@@ -53,11 +53,12 @@
 #include "PluginFactory.h"
 #include "PresetPreviewPlayHandle.h"
 #include "SampleClip.h"
+#include "SampleIndex.h"
 #include "SamplePlayHandle.h"
+#include "SampleStream.h"
 #include "SampleTrack.h"
 #include "Song.h"
 #include "StringPairDrag.h"
-#include "TextFloat.h"
 
 namespace lmms::gui
 {
@@ -141,6 +142,15 @@ FileBrowser::FileBrowser(const QString & directories, const QString & filter,
 	m_fileBrowserTreeWidget = new FileBrowserTreeWidget( contentParent() );
 	addContentWidget( m_fileBrowserTreeWidget );
 
+	if (usesIndex())
+	{
+		m_searchResults = new FileBrowserTreeWidget(contentParent());
+		m_searchResults->setRootIsDecorated(false);
+		m_searchResults->hide();
+		addContentWidget(m_searchResults);
+		connect(Engine::sampleIndex(), SIGNAL(changed()), this, SLOT(updateSearchResults()));
+	}
+
 	// Whenever the FileBrowser has focus, Ctrl+F should direct focus to its filter box.
 	auto filterFocusShortcut = new QShortcut(QKeySequence(QKeySequence::Find), this, SLOT(giveFocusToFilter()));
 	filterFocusShortcut->setContext(Qt::WidgetWithChildrenShortcut);
@@ -151,6 +161,13 @@ FileBrowser::FileBrowser(const QString & directories, const QString & filter,
 
 bool FileBrowser::filterItems( const QString & filter, QTreeWidgetItem * item )
 {
+	// the index knows all files, not only those of expanded directories
+	if (item == nullptr && m_searchResults)
+	{
+		showSearchResults(filter);
+		return true;
+	}
+
 	// call with item=NULL to filter the entire tree
 	bool anyMatched = false;
 
@@ -199,6 +216,55 @@ bool FileBrowser::filterItems( const QString & filter, QTreeWidgetItem * item )
 }
 
 
+bool FileBrowser::usesIndex() const
+{
+	// only the library browsers, home and root directories are too large
+	return !m_userDir.isEmpty() && Engine::sampleIndex() != nullptr;
+}
+
+
+
+
+void FileBrowser::showSearchResults(const QString& filter)
+{
+	const bool searching = !filter.trimmed().isEmpty();
+	m_fileBrowserTreeWidget->setVisible(!searching);
+	m_searchResults->setVisible(searching);
+	m_searchResults->clear();
+	if (!searching) { return; }
+
+	m_searchResults->setUpdatesEnabled(false);
+	for (const SampleIndex::Entry& entry : Engine::sampleIndex()->search(filter, m_paths))
+	{
+		if (!QDir::match(m_filter, entry.key)) { continue; }
+
+		const QFileInfo info(entry.path);
+		auto item = new FileItem(m_searchResults, info.fileName(), info.path());
+		QString toolTip = QDir::toNativeSeparators(entry.path);
+		if (entry.type == SampleIndex::Type::Sample && entry.sampleRate > 0)
+		{
+			toolTip += "\n" + tr("%1 s, %2 Hz").arg(entry.duration(), 0, 'f', 2).arg(entry.sampleRate);
+		}
+		item->setToolTip(0, toolTip);
+	}
+	m_searchResults->setUpdatesEnabled(true);
+}
+
+
+
+
+void FileBrowser::updateSearchResults()
+{
+	// don't pull the results away while they are being browsed
+	if (m_searchResults->isVisible() && !m_searchResults->hasFocus())
+	{
+		showSearchResults(m_filterEdit->text());
+	}
+}
+
+
+
+
 void FileBrowser::reloadTree()
 {
 	QList<QString> expandedDirs = m_fileBrowserTreeWidget->expandedDirs();
@@ -214,12 +280,15 @@ void FileBrowser::reloadTree()
 	{
 		paths.removeAll(m_factoryDir);
 	}
+	m_paths = paths;
 
 	if (!paths.isEmpty())
 	{
 		for (const auto& path : paths)
 		{
 			addItems(path);
+			// only files that changed since the last scan are read again
+			if (m_searchResults) { Engine::sampleIndex()->addRoot(path); }
 		}
 	}
 	expandItems(nullptr, expandedDirs);
@@ -595,7 +664,7 @@ void FileBrowserTreeWidget::mousePressEvent(QMouseEvent * me )
 
 
 void FileBrowserTreeWidget::previewFileItem(FileItem* file)
-{	// TODO: We should do this work outside the event thread
+{
 	// Lock the preview mutex
 	QMutexLocker previewLocker(&m_pphMutex);
 	// If something is already playing, stop it before we continue
@@ -609,16 +678,14 @@ void FileBrowserTreeWidget::previewFileItem(FileItem* file)
 	// handling() rather than directly creating a SamplePlayHandle
 	if (file->type() == FileItem::SampleFile)
 	{
-		TextFloat * tf = TextFloat::displayMessage(
-			tr("Loading sample"),
-			tr("Please wait, loading sample for preview..."),
-			embed::getIconPixmap("sample_file", 24, 24), 0);
-		// TODO: this can be removed once we do this outside the event thread
-		qApp->processEvents(QEventLoop::ExcludeUserInputEvents);
-		auto s = new SamplePlayHandle(fileName);
+		// the sample is decoded in the background while it plays, so the
+		// event thread doesn't wait for it
+		auto stream = std::make_shared<SampleStream>(fileName,
+			Engine::audioEngine()->processingSampleRate());
+		stream->start();
+		auto s = new SamplePlayHandle(stream);
 		s->setDoneMayReturnTrue(false);
 		newPPH = s;
-		delete tf;
 	}
 	else if (
 		(ext == "xiz" || ext == "sf2" || ext == "sf3" ||
@@ -32,6 +32,7 @@
 #include <QLineEdit>
 #include <QPainter>
 
+#include "AudioEngine.h"
 #include "CaptionMenu.h"
 #include "ColorChooser.h"
 #include "embed.h"
@@ -80,7 +81,8 @@ MixerLine::MixerLine( QWidget * _parent, MixerView * _mv, int _channelIndex ) :
 	m_strokeOuterInactive( 0, 0, 0 ),
 	m_strokeInnerActive( 0, 0, 0 ),
 	m_strokeInnerInactive( 0, 0, 0 ),
-	m_inRename( false )
+	m_inRename( false ),
+	m_shownLatency( 0 )
 {
 	if( !s_sendBgArrow )
 	{
@@ -111,7 +113,7 @@ MixerLine::MixerLine( QWidget * _parent, MixerView * _mv, int _channelIndex ) :
 	m_lcd->setMarginWidth( 1 );
 	
 	QString name = Engine::mixer()->mixerChannel( m_channelIndex )->m_name;
-	setToolTip( name );
+	updateToolTip();
 
 	m_renameLineEdit = new QLineEdit();
 	m_renameLineEdit->setText( name );
@@ -310,8 +312,38 @@ void MixerLine::renameFinished()
 		m_renameLineEdit->setText( elideName( newName ) );
 		Engine::getSong()->setModified();
 	}
-	QString name = Engine::mixer()->mixerChannel( m_channelIndex )->m_name;
-	setToolTip( name );
+	updateToolTip();
+}
+
+
+
+
+void MixerLine::updateToolTip()
+{
+	const MixerChannel * ch = Engine::mixer()->mixerChannel( m_channelIndex );
+	m_shownLatency = ch->m_latency;
+	if( m_shownLatency == 0 )
+	{
+		setToolTip( ch->m_name );
+		return;
+	}
+
+	const float ms = m_shownLatency * 1000.0f / Engine::audioEngine()->processingSampleRate();
+	const QString latency = m_channelIndex == 0
+		? tr( "Total latency: %1 ms (%2 samples)" )
+		: tr( "Latency: %1 ms (%2 samples)" );
+	setToolTip( ch->m_name + "\n" + latency.arg( ms, 0, 'f', 1 ).arg( m_shownLatency ) );
+}
+
+
+
+
+void MixerLine::updateLatency()
+{
+	if( !m_inRename && Engine::mixer()->mixerChannel( m_channelIndex )->m_latency != m_shownLatency )
+	{
+		updateToolTip();
+	}
 }
 
 
@@ -358,7 +358,7 @@ void MixerView::updateMixerLine(int index)
 	// does current channel send to this channel?
 	int selIndex = m_currentMixerLine->channelIndex();
 	MixerLine * thisLine = m_mixerChannelViews[index]->m_mixerLine;
-	thisLine->setToolTip( Engine::mixer()->mixerChannel( index )->m_name );
+	thisLine->updateToolTip();
 
 	FloatModel * sendModel = mix->channelSendModel(selIndex, index);
 	if( sendModel == nullptr )
@@ -586,38 +586,46 @@ void MixerView::clear()
 
 void MixerView::updateFaders()
 {
-	Mixer * m = Engine::mixer();
+	// don't keep the meters' analysis running while nobody looks at them
+	if( !isVisible() ) { return; }
 
-	// apply master gain
-	m->mixerChannel(0)->m_peakLeft *= Engine::audioEngine()->masterGain();
-	m->mixerChannel(0)->m_peakRight *= Engine::audioEngine()->masterGain();
+	Mixer * m = Engine::mixer();
 
 	for( int i = 0; i < m_mixerChannelViews.size(); ++i )
 	{
-		const float opl = m_mixerChannelViews[i]->m_fader->getPeak_L();
-		const float opr = m_mixerChannelViews[i]->m_fader->getPeak_R();
-		const float fallOff = 1.25;
-		if( m->mixerChannel(i)->m_peakLeft >= opl/fallOff )
+		MixerChannel * ch = m->mixerChannel(i);
+		// keep the peak analysis running while we're displayed
+		ch->m_analysisTap.requestAnalysis();
+
+		m_mixerChannelViews[i]->m_mixerLine->updateLatency();
+
+		float peakLeft = 0.0f;
+		float peakRight = 0.0f;
+		bool newPeaks = true;
+		// m_muted is what masterMix() went by, muted channels aren't
+		// analyzed and their meters fall off
+		if( ch->m_muted == false )
 		{
-			m_mixerChannelViews[i]->m_fader->setPeak_L( m->mixerChannel(i)->m_peakLeft );
-			// Set to -1 so later we'll know if this value has been refreshed yet.
-			m->mixerChannel(i)->m_peakLeft = -1;
-		}
-		else if( m->mixerChannel(i)->m_peakLeft != -1 )
-		{
-			m_mixerChannelViews[i]->m_fader->setPeak_L( opl/fallOff );
-		}
+			newPeaks = ch->m_analysisTap.takePeaks( peakLeft, peakRight );
 
-		if( m->mixerChannel(i)->m_peakRight >= opr/fallOff )
-		{
-			m_mixerChannelViews[i]->m_fader->setPeak_R( m->mixerChannel(i)->m_peakRight );
-			// Set to -1 so later we'll know if this value has been refreshed yet.
-			m->mixerChannel(i)->m_peakRight = -1;
-		}
-		else if( m->mixerChannel(i)->m_peakRight != -1 )
-		{
-			m_mixerChannelViews[i]->m_fader->setPeak_R( opr/fallOff );
+			float v = ch->m_volumeModel.value();
+			if( i == 0 )
+			{
+				// apply master gain
+				v *= Engine::audioEngine()->masterGain();
+			}
+			peakLeft *= v;
+			peakRight *= v;
 		}
+
+		// hold the current display if no new data has been analyzed yet
+		if( !newPeaks ) { continue; }
+
+		const float opl = m_mixerChannelViews[i]->m_fader->getPeak_L();
+		const float opr = m_mixerChannelViews[i]->m_fader->getPeak_R();
+		const float fallOff = 1.25;
+		m_mixerChannelViews[i]->m_fader->setPeak_L( qMax( peakLeft, opl/fallOff ) );
+		m_mixerChannelViews[i]->m_fader->setPeak_R( qMax( peakRight, opr/fallOff ) );
 	}
 }
 
@@ -290,10 +290,14 @@ void AutomationClipView::paintEvent( QPaintEvent * )
 	lin2grad.setColorAt( 0.5, col );
 	lin2grad.setColorAt( 0, col.darker( 150 ) );
 
+	// values sampled at about one point per pixel
+	const auto curve = m_clip->curve( 1.0f / ppTick );
+	auto segment = curve->segments().begin();
+
 	p.setRenderHints( QPainter::Antialiasing, true );
 	for( AutomationClip::timeMap::const_iterator it =
 						m_clip->getTimeMap().begin();
-					it != m_clip->getTimeMap().end(); ++it )
+					it != m_clip->getTimeMap().end(); ++it, ++segment )
 	{
 		if( it+1 == m_clip->getTimeMap().end() )
 		{
@@ -312,38 +316,24 @@ void AutomationClipView::paintEvent( QPaintEvent * )
 			break;
 		}
 
-		float *values = m_clip->valuesAfter(POS(it));
+		// nodes recorded since the curve was built are drawn on the next update
+		if( segment == curve->segments().end() ) break;
 
 		// We are creating a path to draw a polygon representing the values between two
-		// nodes. When we have two nodes with discrete progression, we will basically have
-		// a rectangle with the outValue of the first node (that's why nextValue will match
-		// the outValue of the current node). When we have nodes with linear or cubic progression
-		// the value of the end of the shape between the two nodes will be the inValue of
-		// the next node.
-		float nextValue;
-		if( m_clip->progressionType() == AutomationClip::DiscreteProgression )
-		{
-			nextValue = OUTVAL(it);
-		}
-		else
-		{
-			nextValue = INVAL(it + 1);
-		}
+		// nodes. The curve ends discrete segments at the outValue of the first node and
+		// linear or cubic ones at the inValue of the next node.
+		const AutomationCurve::Point* last = curve->end( *segment ) - 1;
 
 		QPainterPath path;
 		QPointF origin = QPointF(POS(it) * ppTick, 0.0f);
 		path.moveTo( origin );
-		path.moveTo(QPointF(POS(it) * ppTick,values[0]));
-		float x;
-		for (int i = POS(it) + 1; i < POS(it + 1); i++)
+		for( auto point = curve->begin( *segment ); point != last; ++point )
 		{
-			x = i * ppTick;
+			const float x = point->tick * ppTick;
 			if( x > ( width() - BORDER_WIDTH ) ) break;
-			float value = values[i - POS(it)];
-			path.lineTo( QPointF( x, value ) );
-
+			path.lineTo( QPointF( x, point->value ) );
 		}
-		path.lineTo((POS(it + 1)) * ppTick, nextValue);
+		path.lineTo(last->tick * ppTick, last->value);
 		path.lineTo((POS(it + 1)) * ppTick, 0.0f);
 		path.lineTo( origin );
 
@@ -355,7 +345,6 @@ void AutomationClipView::paintEvent( QPaintEvent * )
 		{
 			p.fillPath( path, col );
 		}
-		delete [] values;
 	}
 
 	p.setRenderHints( QPainter::Antialiasing, false );
@@ -0,0 +1,132 @@
+/*
+ * ClipThumbnail.cpp - content of a clip view rendered in the background
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "ClipThumbnail.h"
+
+#include <QMutexLocker>
+#include <QPainter>
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace lmms::gui
+{
+
+
+class ClipThumbnail::RenderJob : public QRunnable
+{
+public:
+	RenderJob(std::shared_ptr<ClipThumbnail> thumbnail, const QSize& size, int generation, int request,
+		Renderer renderer) :
+		m_thumbnail(std::move(thumbnail)),
+		m_size(size),
+		m_generation(generation),
+		m_request(request),
+		m_renderer(std::move(renderer))
+	{
+	}
+
+	void run() override
+	{
+		m_thumbnail->render(m_size, m_generation, m_request, m_renderer);
+	}
+
+private:
+	//! Keeps the thumbnail alive even if its view was closed meanwhile
+	std::shared_ptr<ClipThumbnail> m_thumbnail;
+	QSize m_size;
+	int m_generation;
+	int m_request;
+	Renderer m_renderer;
+} ;
+
+
+
+
+ClipThumbnail::ClipThumbnail() :
+	m_imageGeneration(-1),
+	m_generation(0),
+	m_pendingGeneration(-1),
+	m_request(0)
+{
+}
+
+
+
+
+bool ClipThumbnail::isValid(const QSize& size) const
+{
+	QMutexLocker lock(&m_imageMutex);
+	return m_imageGeneration == m_generation && m_image.size() == size;
+}
+
+
+
+
+QImage ClipThumbnail::image() const
+{
+	QMutexLocker lock(&m_imageMutex);
+	return m_image;
+}
+
+
+
+
+void ClipThumbnail::request(const QSize& size, Renderer renderer)
+{
+	if (size.isEmpty() || (m_pendingGeneration == m_generation && m_pendingSize == size)) { return; }
+
+	m_pendingGeneration = m_generation;
+	m_pendingSize = size;
+	const int request = m_request.fetch_add(1, std::memory_order_relaxed) + 1;
+	QThreadPool::globalInstance()->start(
+		new RenderJob(shared_from_this(), size, m_generation, request, std::move(renderer)),
+		QThread::LowPriority);
+}
+
+
+
+
+void ClipThumbnail::render(const QSize& size, int generation, int request, const Renderer& renderer)
+{
+	// while resizing or editing, only the last state is worth rendering
+	if (request != m_request.load(std::memory_order_relaxed)) { return; }
+
+	QImage image(size, QImage::Format_ARGB32_Premultiplied);
+	image.fill(Qt::transparent);
+	QPainter p(&image);
+	renderer(p, size);
+	p.end();
+
+	{
+		QMutexLocker lock(&m_imageMutex);
+		// a later render may have overtaken this one
+		if (generation < m_imageGeneration) { return; }
+		m_image = std::move(image);
+		m_imageGeneration = generation;
+	}
+	emit ready();
+}
+
+
+} // namespace lmms::gui
@@ -26,11 +26,13 @@
 #include "MidiClipView.h"
 
 #include <cmath>
+#include <vector>
 #include <QApplication>
 #include <QInputDialog>
 #include <QMenu>
 #include <QPainter>
 
+#include "ClipThumbnail.h"
 #include "ConfigManager.h"
 #include "DeprecationHelper.h"
 #include "GuiApplication.h"
@@ -47,6 +49,9 @@ MidiClipView::MidiClipView( MidiClip* clip, TrackView* parent ) :
 	ClipView( clip, parent ),
 	m_clip( clip ),
 	m_paintPixmap(),
+	m_thumbnail(std::make_shared<ClipThumbnail>()),
+	m_thumbnailTop(0.f),
+	m_thumbnailBars(0),
 	m_noteFillColor(255, 255, 255, 220),
 	m_noteBorderColor(255, 255, 255, 220),
 	m_mutedNoteFillColor(100, 100, 100, 220),
@@ -56,6 +61,8 @@ MidiClipView::MidiClipView( MidiClip* clip, TrackView* parent ) :
 {
 	connect( getGUI()->pianoRoll(), SIGNAL(currentMidiClipChanged()),
 			this, SLOT(update()));
+	connect(m_thumbnail.get(), SIGNAL(ready()), this, SLOT(update()), Qt::QueuedConnection);
+	connect(m_clip, SIGNAL(dataChanged()), this, SLOT(invalidateThumbnail()));
 
 	if( s_stepBtnOn0 == nullptr )
 	{
@@ -378,6 +385,122 @@ static int computeNoteRange(int minKey, int maxKey)
 	return (maxKey - minKey) + 1;
 }
 
+
+
+
+namespace
+{
+
+//! What the thumbnail of a melody clip needs to know about a note
+struct NoteShape
+{
+	int key;
+	int pos;
+	int length;
+} ;
+
+//! Draw @p notes into an image of @p size, with the text box taking up
+//! @p distanceToTop pixels at the top
+void paintNotes(QPainter& p, const QSize& size, const std::vector<NoteShape>& notes, bar_t bars,
+	float distanceToTop, const QColor& noteFillColor, const QColor& noteBorderColor)
+{
+	// Compute the minimum and maximum key in the clip
+	// so that we know how much there is to draw.
+	int maxKey = std::numeric_limits<int>::min();
+	int minKey = std::numeric_limits<int>::max();
+
+	for (const NoteShape& note : notes)
+	{
+		maxKey = qMax(maxKey, note.key);
+		minKey = qMin(minKey, note.key);
+	}
+
+	// If needed adjust the note range so that we always have paint a certain interval
+	int const minimalNoteRange = 12; // Always paint at least one octave
+	int const actualNoteRange = computeNoteRange(minKey, maxKey);
+
+	if (actualNoteRange < minimalNoteRange)
+	{
+		int missingNumberOfNotes = minimalNoteRange - actualNoteRange;
+		minKey = std::max(0, minKey - missingNumberOfNotes / 2);
+		maxKey = maxKey + missingNumberOfNotes / 2;
+		if (missingNumberOfNotes % 2 == 1)
+		{
+			// Put more range at the top to bias drawing towards the bottom
+			++maxKey;
+		}
+	}
+
+	int const adjustedNoteRange = computeNoteRange(minKey, maxKey);
+
+	// Length of one tick in the [0,1] x [0,1] coordinate system
+	const float tickLength = 1.f / bars / TimePos::ticksPerBar();
+
+	int const notesBorder = 4; // Border for the notes towards the top and bottom in pixels
+
+	// Transform such that [0, 1] x [0, 1] paints in the correct area
+	p.translate(0., distanceToTop + notesBorder);
+	p.scale(size.width(), size.height() - distanceToTop - 2 * notesBorder);
+
+	bool const drawAsLines = size.height() < 64;
+	if (drawAsLines)
+	{
+		p.setPen(noteFillColor);
+	}
+	else
+	{
+		p.setPen(noteBorderColor);
+		p.setRenderHint(QPainter::Antialiasing);
+	}
+
+	// Needed for Qt5 although the documentation for QPainter::setPen(QColor) as it's used above
+	// states that it should already set a width of 0.
+	QPen pen = p.pen();
+	pen.setWidth(0);
+	p.setPen(pen);
+
+	float const noteHeight = 1. / adjustedNoteRange;
+
+	// scan through all the notes and draw them on the clip
+	for (const NoteShape& note : notes)
+	{
+		// Map to 0, 1, 2, ...
+		int mappedNoteKey = note.key - minKey;
+		int invertedMappedNoteKey = adjustedNoteRange - mappedNoteKey - 1;
+
+		float const noteStartX = note.pos * tickLength;
+		float const noteLength = note.length * tickLength;
+
+		float const noteStartY = invertedMappedNoteKey * noteHeight;
+
+		QRectF noteRectF( noteStartX, noteStartY, noteLength, noteHeight);
+		if (drawAsLines)
+		{
+			p.drawLine(QPointF(noteStartX, noteStartY + 0.5 * noteHeight),
+				   QPointF(noteStartX + noteLength, noteStartY + 0.5 * noteHeight));
+		}
+		else
+		{
+			p.fillRect( noteRectF, noteFillColor );
+			p.drawRect( noteRectF );
+		}
+	}
+}
+
+} // namespace
+
+
+
+
+void MidiClipView::invalidateThumbnail()
+{
+	m_thumbnail->invalidate();
+	update();
+}
+
+
+
+
 void MidiClipView::paintEvent( QPaintEvent * )
 {
 	QPainter painter( this );
@@ -451,10 +574,6 @@ void MidiClipView::paintEvent( QPaintEvent * )
 						: width() - BORDER_WIDTH;
 	const float pixelsPerBar = baseWidth / (float) m_clip->length().getBar();
 
-	// Length of one bar/beat in the [0,1] x [0,1] coordinate system
-	const float barLength = 1. / m_clip->length().getBar();
-	const float tickLength = barLength / TimePos::ticksPerBar();
-
 	const int x_base = BORDER_WIDTH;
 
 	bool displayPattern = fixedClips() || (pixelsPerBar >= 96 && m_legacySEPattern);
@@ -462,37 +581,8 @@ void MidiClipView::paintEvent( QPaintEvent * )
 	NoteVector const & noteCollection = m_clip->m_notes;
 	if( m_clip->m_clipType == MidiClip::MelodyClip && !noteCollection.empty() )
 	{
-		// Compute the minimum and maximum key in the clip
-		// so that we know how much there is to draw.
-		int maxKey = std::numeric_limits<int>::min();
-		int minKey = std::numeric_limits<int>::max();
-
-		for (Note const * note : noteCollection)
-		{
-			int const key = note->key();
-			maxKey = qMax( maxKey, key );
-			minKey = qMin( minKey, key );
-		}
-
-		// If needed adjust the note range so that we always have paint a certain interval
-		int const minimalNoteRange = 12; // Always paint at least one octave
-		int const actualNoteRange = computeNoteRange(minKey, maxKey);
-
-		if (actualNoteRange < minimalNoteRange)
-		{
-			int missingNumberOfNotes = minimalNoteRange - actualNoteRange;
-			minKey = std::max(0, minKey - missingNumberOfNotes / 2);
-			maxKey = maxKey + missingNumberOfNotes / 2;
-			if (missingNumberOfNotes % 2 == 1)
-			{
-				// Put more range at the top to bias drawing towards the bottom
-				++maxKey;
-			}
-		}
-
-		int const adjustedNoteRange = computeNoteRange(minKey, maxKey);
-
-		// Transform such that [0, 1] x [0, 1] paints in the correct area
+		// The notes are drawn in the background and cached, so that
+		// clips with many notes are as quick to repaint as empty ones
 		float distanceToTop = textBoxHeight;
 
 		// This moves the notes smoothly under the text
@@ -514,64 +604,40 @@ void MidiClipView::paintEvent( QPaintEvent * )
 			}
 		}
 
-		int const notesBorder = 4; // Border for the notes towards the top and bottom in pixels
-
-		// The relavant painting code starts here
-		p.save();
-
-		p.translate(0., distanceToTop + notesBorder);
-		p.scale(width(), height() - distanceToTop - 2 * notesBorder);
-
 		// set colour based on mute status
 		QColor noteFillColor = muted ? getMutedNoteFillColor() : getNoteFillColor();
 		QColor noteBorderColor = muted ? getMutedNoteBorderColor()
 									   : ( m_clip->hasColor() ? c.lighter( 200 ) : getNoteBorderColor() );
 
-		bool const drawAsLines = height() < 64;
-		if (drawAsLines)
+		const bar_t bars = m_clip->length().getBar();
+		if (noteFillColor != m_thumbnailFillColor || noteBorderColor != m_thumbnailBorderColor
+			|| distanceToTop != m_thumbnailTop || bars != m_thumbnailBars)
 		{
-			p.setPen(noteFillColor);
+			m_thumbnailFillColor = noteFillColor;
+			m_thumbnailBorderColor = noteBorderColor;
+			m_thumbnailTop = distanceToTop;
+			m_thumbnailBars = bars;
+			m_thumbnail->invalidate();
 		}
-		else
-		{
-			p.setPen(noteBorderColor);
-			p.setRenderHint(QPainter::Antialiasing);
-		}
-
-		// Needed for Qt5 although the documentation for QPainter::setPen(QColor) as it's used above
-		// states that it should already set a width of 0.
-		QPen pen = p.pen();
-		pen.setWidth(0);
-		p.setPen(pen);
 
-		float const noteHeight = 1. / adjustedNoteRange;
-
-		// scan through all the notes and draw them on the clip
-		for (Note const * currentNote : noteCollection)
+		if (!m_thumbnail->isValid(size()))
 		{
-			// Map to 0, 1, 2, ...
-			int mappedNoteKey = currentNote->key() - minKey;
-			int invertedMappedNoteKey = adjustedNoteRange - mappedNoteKey - 1;
-
-			float const noteStartX = currentNote->pos() * tickLength;
-			float const noteLength = currentNote->length() * tickLength;
-
-			float const noteStartY = invertedMappedNoteKey * noteHeight;
-
-			QRectF noteRectF( noteStartX, noteStartY, noteLength, noteHeight);
-			if (drawAsLines)
+			std::vector<NoteShape> notes;
+			notes.reserve(noteCollection.size());
+			for (Note const * note : noteCollection)
 			{
-				p.drawLine(QPointF(noteStartX, noteStartY + 0.5 * noteHeight),
-					   QPointF(noteStartX + noteLength, noteStartY + 0.5 * noteHeight));
+				notes.push_back({note->key(), note->pos(), note->length()});
 			}
-			else
+			m_thumbnail->request(size(), [notes = std::move(notes), bars, distanceToTop,
+				noteFillColor, noteBorderColor](QPainter& tp, const QSize& size)
 			{
-				p.fillRect( noteRectF, noteFillColor );
-				p.drawRect( noteRectF );
-			}
+				paintNotes(tp, size, notes, bars, distanceToTop, noteFillColor, noteBorderColor);
+			});
 		}
 
-		p.restore();
+		// until the current notes are ready, the last ones are stretched to fit
+		const QImage notes = m_thumbnail->image();
+		if (!notes.isNull()) { p.drawImage(rect(), notes); }
 	}
 	// beat clip paint event
 	else if (beatClip && displayPattern)
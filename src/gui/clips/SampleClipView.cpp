@@ -28,6 +28,7 @@
 #include <QMenu>
 #include <QPainter>
 
+#include "ClipThumbnail.h"
 #include "embed.h"
 #include "PathUtil.h"
 #include "SampleBuffer.h"
@@ -42,22 +43,29 @@ namespace lmms::gui
 SampleClipView::SampleClipView( SampleClip * _clip, TrackView * _tv ) :
 	ClipView( _clip, _tv ),
 	m_clip( _clip ),
-	m_paintPixmap()
+	m_paintPixmap(),
+	m_thumbnail(std::make_shared<ClipThumbnail>())
 {
+	connect(m_thumbnail.get(), SIGNAL(ready()), this, SLOT(update()), Qt::QueuedConnection);
+
 	// update UI and tooltip
 	updateSample();
 
 	// track future changes of SampleClip
 	connect(m_clip, SIGNAL(sampleChanged()), this, SLOT(updateSample()));
+	connect(m_clip, SIGNAL(dataChanged()), this, SLOT(invalidateThumbnail()));
 
-	connect(m_clip, SIGNAL(wasReversed()), this, SLOT(update()));
+	connect(m_clip, SIGNAL(wasReversed()), this, SLOT(invalidateThumbnail()));
 
 	setStyle( QApplication::style() );
 }
 
 void SampleClipView::updateSample()
 {
-	update();
+	// the sample buffer may have been replaced
+	connect(m_clip->m_sampleBuffer, SIGNAL(overviewUpdated()),
+		this, SLOT(invalidateThumbnail()), Qt::UniqueConnection);
+	invalidateThumbnail();
 	// set tooltip to filename so that user can see what sample this
 	// sample-clip contains
 	setToolTip(m_clip->m_sampleBuffer->audioFile() != "" ?
@@ -68,6 +76,15 @@ void SampleClipView::updateSample()
 
 
 
+void SampleClipView::invalidateThumbnail()
+{
+	m_thumbnail->invalidate();
+	update();
+}
+
+
+
+
 void SampleClipView::constructContextMenu(QMenu* cm)
 {
 	cm->addSeparator();
@@ -263,7 +280,27 @@ void SampleClipView::paintEvent( QPaintEvent * pe )
 	float offset =  m_clip->startTimeOffset() / ticksPerBar * pixelsPerBar();
 	QRect r = QRect( offset, spacing,
 			qMax( static_cast<int>( m_clip->sampleLength() * ppb / ticksPerBar ), 1 ), rect().bottom() - 2 * spacing );
-	m_clip->m_sampleBuffer->visualize( p, r, pe->rect() );
+	if (r != m_thumbnailRect || p.pen().color() != m_thumbnailColor)
+	{
+		m_thumbnailRect = r;
+		m_thumbnailColor = p.pen().color();
+		m_thumbnail->invalidate();
+	}
+	// the whole clip is cached in the thumbnail, so draw all of it
+	if (!m_thumbnail->isValid(size()))
+	{
+		// the clip may replace its buffer while the waveform is drawn
+		const auto buffer = std::shared_ptr<SampleBuffer>(
+			sharedObject::ref(m_clip->m_sampleBuffer), sharedObject::unref<SampleBuffer>);
+		m_thumbnail->request(size(), [buffer, r, pen = p.pen()](QPainter& tp, const QSize& size)
+		{
+			tp.setPen(pen);
+			buffer->visualize(tp, r, QRect(QPoint(0, 0), size));
+		});
+	}
+	// until the current waveform is ready, the last one is stretched to fit
+	const QImage waveform = m_thumbnail->image();
+	if (!waveform.isNull()) { p.drawImage(rect(), waveform); }
 
 	QString name = PathUtil::cleanName(m_clip->m_sampleBuffer->audioFile());
 	paintTextLabel(name, p);
@@ -320,7 +357,7 @@ void SampleClipView::reverseSample()
 {
 	m_clip->sampleBuffer()->setReversed(!m_clip->sampleBuffer()->reversed());
 	Engine::getSong()->setModified();
-	update();
+	invalidateThumbnail();
 }
 
 
@@ -1145,6 +1145,10 @@ void AutomationEditor::paintEvent(QPaintEvent * pe )
 		//Don't bother doing/rendering anything if there is no automation points
 		if( time_map.size() > 0 )
 		{
+			// values sampled at about one point per pixel
+			const auto curve = m_clip->curve( static_cast<float>( TimePos::ticksPerBar() ) / m_ppb );
+			auto segment = curve->segments().begin();
+
 			timeMap::iterator it = time_map.begin();
 			while( it+1 != time_map.end() )
 			{
@@ -1154,6 +1158,7 @@ void AutomationEditor::paintEvent(QPaintEvent * pe )
 				if( next_x < 0 )
 				{
 					++it;
+					++segment;
 					continue;
 				}
 
@@ -1163,42 +1168,32 @@ void AutomationEditor::paintEvent(QPaintEvent * pe )
 					break;
 				}
 
-				float *values = m_clip->valuesAfter(POS(it));
-
-				// We are creating a path to draw a polygon representing the values between two
-				// nodes. When we have two nodes with discrete progression, we will basically have
-				// a rectangle with the outValue of the first node (that's why nextValue will match
-				// the outValue of the current node). When we have nodes with linear or cubic progression
-				// the value of the end of the shape between the two nodes will be the inValue of
-				// the next node.
-				float nextValue;
-				if( m_clip->progressionType() == AutomationClip::DiscreteProgression )
+				// nodes recorded since the curve was built are drawn on the next update
+				if( segment == curve->segments().end() )
 				{
-					nextValue = OUTVAL(it);
-				}
-				else
-				{
-					nextValue = INVAL(it + 1);
+					break;
 				}
 
+				// We are creating a path to draw a polygon representing the values between two
+				// nodes. The curve ends discrete segments at the outValue of the first node and
+				// linear or cubic ones at the inValue of the next node.
 				p.setRenderHints( QPainter::Antialiasing, true );
 				QPainterPath path;
 				path.moveTo(QPointF(xCoordOfTick(POS(it)), yCoordOfLevel(0)));
-				for (int i = 0; i < POS(it + 1) - POS(it); i++)
+				for (auto point = curve->begin(*segment); point != curve->end(*segment); ++point)
 				{
-					path.lineTo(QPointF(xCoordOfTick(POS(it) + i), yCoordOfLevel(values[i])));
+					path.lineTo(QPointF(xCoordOfTick(point->tick), yCoordOfLevel(point->value)));
 				}
-				path.lineTo(QPointF(xCoordOfTick(POS(it + 1)), yCoordOfLevel(nextValue)));
 				path.lineTo(QPointF(xCoordOfTick(POS(it + 1)), yCoordOfLevel(0)));
 				path.lineTo(QPointF(xCoordOfTick(POS(it)), yCoordOfLevel(0)));
 				p.fillPath(path, m_graphColor);
 				p.setRenderHints( QPainter::Antialiasing, false );
-				delete [] values;
 
 				// Draw circle
 				drawAutomationPoint(p, it);
 
 				++it;
+				++segment;
 			}
 
 			for (
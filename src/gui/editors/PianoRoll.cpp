@@ -786,6 +786,7 @@ void PianoRoll::fitNoteLengths(bool fill)
 		}
 	}
 
+	m_midiClip->dataChanged();
 	update();
 	getGUI()->songEditor()->update();
 	Engine::getSong()->setModified();
@@ -812,6 +813,7 @@ void PianoRoll::constrainNoteLengths(bool constrainMax)
 		}
 	}
 
+	m_midiClip->dataChanged();
 	update();
 	getGUI()->songEditor()->update();
 	Engine::getSong()->setModified();
@@ -1710,39 +1712,18 @@ void PianoRoll::mousePressEvent(QMouseEvent * me )
 							m_currentPosition;
 
 
-			// get note-vector of current MIDI clip
-			const NoteVector & notes = m_midiClip->notes();
-
-			// will be our iterator in the following loop
-			NoteVector::ConstIterator it = notes.begin()+notes.size()-1;
-
-			// loop through whole note-vector...
-			for( int i = 0; i < notes.size(); ++i )
+			// the topmost note the user clicked on, if any
+			Note * clickedNote = nullptr;
+			if( ! edit_note )
 			{
-				Note *note = *it;
-				TimePos len = note->length();
-				if( len < 0 )
-				{
-					len = 4;
-				}
-				// and check whether the user clicked on an
-				// existing note or an edit-line
-				if( pos_ticks >= note->pos() &&
-						len > 0 &&
-					(
-					( ! edit_note &&
-					pos_ticks <= note->pos() + len &&
-					note->key() == key_num )
-					||
-					( edit_note &&
-					pos_ticks <= note->pos() +
-						NOTE_EDIT_LINE_WIDTH * TimePos::ticksPerBar() / m_ppb )
-					)
-					)
+				for( Note *note : m_midiClip->notesInRange( pos_ticks, pos_ticks, key_num, key_num ) )
 				{
-					break;
+					// notes without length can't be clicked on
+					if( note->length() != 0 )
+					{
+						clickedNote = note;
+					}
 				}
-				--it;
 			}
 
 			// first check whether the user clicked in note-edit-
@@ -1762,9 +1743,8 @@ void PianoRoll::mousePressEvent(QMouseEvent * me )
 				bool is_new_note = false;
 
 				Note * created_new_note = nullptr;
-				// did it reach end of vector because
-				// there's no note??
-				if( it == notes.begin()-1 )
+				// did the user click on empty space?
+				if( clickedNote == nullptr )
 				{
 					is_new_note = true;
 					m_midiClip->addJournalCheckPoint();
@@ -1808,17 +1788,12 @@ void PianoRoll::mousePressEvent(QMouseEvent * me )
 						}
 					}
 
-					// reset it so that it can be used for
-					// ops (move, resize) after this
-					// code-block
-					it = notes.begin();
-					while( it != notes.end() && *it != created_new_note )
-					{
-						++it;
-					}
+					// use it for ops (move, resize) after
+					// this code-block
+					clickedNote = created_new_note;
 				}
 
-				Note *current_note = *it;
+				Note *current_note = clickedNote;
 				m_currentNote = current_note;
 				m_lastNotePanning = current_note->getPanning();
 				m_lastNoteVolume = current_note->getVolume();
@@ -1928,10 +1903,10 @@ void PianoRoll::mousePressEvent(QMouseEvent * me )
 			{
 				// erase single note
 				m_mouseDownRight = true;
-				if( it != notes.begin()-1 )
+				if( clickedNote != nullptr )
 				{
 					m_midiClip->addJournalCheckPoint();
-					m_midiClip->removeNote( *it );
+					m_midiClip->removeNote( clickedNote );
 					Engine::getSong()->setModified();
 				}
 			}
@@ -2223,14 +2198,19 @@ void PianoRoll::computeSelectedNotes(bool shift)
 	//int y_base = noteEditTop() - 1;
 	if( hasValidMidiClip() )
 	{
-		for( Note *note : m_midiClip->notes() )
+		// make a new selection unless they're holding shift
+		if( ! shift )
 		{
-			// make a new selection unless they're holding shift
-			if( ! shift )
+			for( Note *note : m_midiClip->notes() )
 			{
 				note->setSelected( false );
 			}
+		}
 
+		// only look at the notes in the rectangle
+		for( Note *note : m_midiClip->notesInRange( sel_pos_start, sel_pos_end,
+			sel_key_start + m_startKey, sel_key_end + m_startKey - 1 ) )
+		{
 			int len_ticks = note->length();
 
 			if( len_ticks == 0 )
@@ -2566,34 +2546,17 @@ void PianoRoll::mouseMoveEvent( QMouseEvent * me )
 			int pos_ticks = ( x * TimePos::ticksPerBar() ) /
 						m_ppb + m_currentPosition;
 
-			// get note-vector of current MIDI clip
-			const NoteVector & notes = m_midiClip->notes();
-
-			// will be our iterator in the following loop
-			NoteVector::ConstIterator it = notes.begin()+notes.size()-1;
-
-			// loop through whole note-vector...
-			for( int i = 0; i < notes.size(); ++i )
+			// is the cursor over an existing note? Take the topmost one
+			Note *note = nullptr;
+			for( Note *candidate : m_midiClip->notesInRange( pos_ticks, pos_ticks, key_num, key_num ) )
 			{
-				Note *note = *it;
-				// and check whether the cursor is over an
-				// existing note
-				if( pos_ticks >= note->pos() &&
-			    		pos_ticks <= note->pos() +
-							note->length() &&
-					note->key() == key_num &&
-					note->length() > 0 )
+				if( candidate->length() > 0 )
 				{
-					break;
+					note = candidate;
 				}
-				--it;
 			}
-
-			// did it reach end of vector because there's
-			// no note??
-			if( it != notes.begin()-1 )
+			if( note != nullptr )
 			{
-				Note *note = *it;
 				// x coordinate of the right edge of the note
 				int noteRightX = ( note->pos() + note->length() -
 					m_currentPosition) * m_ppb/TimePos::ticksPerBar();
@@ -2643,16 +2606,16 @@ void PianoRoll::mouseMoveEvent( QMouseEvent * me )
 							m_currentPosition;
 
 
-			// get note-vector of current MIDI clip
-			const NoteVector & notes = m_midiClip->notes();
+			// ticks covered by the edit-line of a note
+			const int editLineTicks = NOTE_EDIT_LINE_WIDTH * TimePos::ticksPerBar() / m_ppb;
 
-			// will be our iterator in the following loop
-			NoteVector::ConstIterator it = notes.begin();
+			// only the notes near the cursor can be hit
+			const NoteVector notes = edit_note
+				? m_midiClip->notesInRange( pos_ticks - editLineTicks, pos_ticks )
+				: m_midiClip->notesInRange( pos_ticks, pos_ticks, key_num, key_num );
 
-			// loop through whole note-vector...
-			while( it != notes.end() )
+			for( Note *note : notes )
 			{
-				Note *note = *it;
 				TimePos len = note->length();
 				if( len < 0 )
 				{
@@ -2668,10 +2631,7 @@ void PianoRoll::mouseMoveEvent( QMouseEvent * me )
 					note->key() == key_num )
 					||
 					( edit_note &&
-					pos_ticks <= note->pos() +
-							NOTE_EDIT_LINE_WIDTH *
-						TimePos::ticksPerBar() /
-								m_ppb )
+					pos_ticks <= note->pos() + editLineTicks )
 					)
 					)
 				{
@@ -2679,10 +2639,6 @@ void PianoRoll::mouseMoveEvent( QMouseEvent * me )
 					m_midiClip->removeNote( note );
 					Engine::getSong()->setModified();
 				}
-				else
-				{
-					++it;
-				}
 			}
 		}
 		else if (me->buttons() == Qt::NoButton && m_editMode != ModeDraw && m_editMode != ModeEditKnife)
@@ -2814,6 +2770,8 @@ void PianoRoll::dragNotes(int x, int y, bool alt, bool shift, bool ctrl)
 
 	// get note-vector of current MIDI clip
 	const NoteVector & notes = m_midiClip->notes();
+	// the notes changed below, which the clip's index has to follow
+	NoteVector movedNotes;
 
 	if (m_action == ActionMoveNote)
 	{
@@ -2865,7 +2823,8 @@ void PianoRoll::dragNotes(int x, int y, bool alt, bool shift, bool ctrl)
 		}
 
 		// Apply offset to all selected notes
-		for (Note *note : getSelectedNotes())
+		movedNotes = getSelectedNotes();
+		for (Note *note : movedNotes)
 		{
 			// Quick resize is only enabled on Nudge mode, since resizing the note
 			// while in Snap mode breaks the calculation of the note offset
@@ -2908,6 +2867,7 @@ void PianoRoll::dragNotes(int x, int y, bool alt, bool shift, bool ctrl)
 		}
 
 		auto selectedNotes = getSelectedNotes();
+		movedNotes = selectedNotes;
 
 		if (shift)
 		{
@@ -2985,6 +2945,7 @@ void PianoRoll::dragNotes(int x, int y, bool alt, bool shift, bool ctrl)
 					{
 						int newStart = note->pos().getTicks() + posteriorDeltaThisFrame;
 						note->setPos( TimePos(newStart) );
+						movedNotes.push_back(note);
 					}
 				}
 			}
@@ -3015,7 +2976,7 @@ void PianoRoll::dragNotes(int x, int y, bool alt, bool shift, bool ctrl)
 	}
 
 	m_midiClip->updateLength();
-	m_midiClip->dataChanged();
+	m_midiClip->notesMoved(movedNotes);
 	Engine::getSong()->setModified();
 }
 
@@ -3463,7 +3424,12 @@ void PianoRoll::paintEvent(QPaintEvent * pe )
 		}
 		// -- End ghost MIDI clip
 
-		for( const Note *note : m_midiClip->notes() )
+		// only the notes in the visible range, with a few pixels of
+		// slack for the rounding below
+		const NoteVector visibleNotes = m_midiClip->notesInRange(
+			m_currentPosition - 2 * TimePos::ticksPerBar() / m_ppb - 1,
+			m_currentPosition + ( width() - m_whiteKeyWidth + 1 ) * TimePos::ticksPerBar() / m_ppb + 1 );
+		for( const Note *note : visibleNotes )
 		{
 			int len_ticks = note->length();
 
@@ -4709,8 +4675,8 @@ Note * PianoRoll::noteUnderMouse()
 	int pos_ticks = (pos.x() - m_whiteKeyWidth) *
 			TimePos::ticksPerBar() / m_ppb + m_currentPosition;
 
-	// loop through whole note-vector...
-	for( Note* const& note : m_midiClip->notes() )
+	// loop through the notes at the cursor...
+	for( Note* const& note : m_midiClip->notesInRange( pos_ticks, pos_ticks, key_num, key_num ) )
 	{
 		// and check whether the cursor is over an
 		// existing note
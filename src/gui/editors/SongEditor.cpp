@@ -397,6 +397,14 @@ namespace lmms::gui {
         / pixelsPerBar() * TimePos::ticksPerBar())
         + m_currentPosition;
 
+      //clips in the rect of selection may not have a view yet
+      const int firstTrackView = qMin(m_rubberBandStartTrackview, rubberBandTrackview);
+      const int lastTrackView = qMax(m_rubberBandStartTrackview, rubberBandTrackview);
+      for (int i = qMax(firstTrackView, 0); i <= lastTrackView && i < trackViews().size(); ++i) {
+        trackViews()[i]->getTrackContentWidget()->createPendingClipViews(
+          qMin(m_rubberbandStartTimePos, rubberbandTimePos), qMax(m_rubberbandStartTimePos, rubberbandTimePos));
+      }
+
       //are clips in the rect of selection?
       for (auto& it : findChildren<selectableObject*>()) {
         auto clip = dynamic_cast<ClipView*>(it);
@@ -748,6 +756,11 @@ namespace lmms::gui {
 
 
   void SongEditor::selectAllClips(bool select) {
+    if (select) {
+      for (const auto& trackView : trackViews()) {
+        trackView->getTrackContentWidget()->createPendingClipViews();
+      }
+    }
     QVector<selectableObject*> so = select ? rubberBand()->selectableObjects() : rubberBand()->selectedObjects();
     for (int i = 0; i < so.count(); ++i) {
       so.at(i)->setSelected(select);
@@ -341,6 +341,9 @@ void InstrumentTrackWindow::modelChanged()
 {
 	m_track = castModel<InstrumentTrack>();
 
+	// the window shows the instrument, so it's needed now
+	m_track->instantiatePendingInstrument();
+
 	m_nameLineEdit->setText( m_track->name() );
 
 	m_track->disconnect( SIGNAL(nameChanged()), this );
@@ -133,11 +133,25 @@ SetupDialog::SetupDialog(ConfigTabs tab_to_open) :
 			"ui", "smoothscroll").toInt()),
 	m_animateAFP(ConfigManager::inst()->value(
 			"ui", "animateafp", "1").toInt()),
+	m_saveWaveformOverview(ConfigManager::inst()->value(
+			"ui", "savewaveformoverview", "0").toInt()),
+	m_indexSampleLibrary(ConfigManager::inst()->value(
+			"ui", "indexsamplelibrary", "1").toInt()),
 	m_vstEmbedMethod(ConfigManager::inst()->vstEmbedMethod()),
 	m_vstAlwaysOnTop(ConfigManager::inst()->value(
 			"ui", "vstalwaysontop").toInt()),
 	m_disableAutoQuit(ConfigManager::inst()->value(
 			"ui", "disableautoquit", "1").toInt()),
+	m_sf2SharedSynth(ConfigManager::inst()->value(
+			"sf2player", "sharedsynth", "0").toInt()),
+	m_pipelineRemotePlugins(ConfigManager::inst()->value(
+			"audioengine", "pipelineremoteplugins", "0").toInt()),
+	m_planarBuffers(ConfigManager::inst()->value(
+			"audioengine", "planarbuffers", "1").toInt()),
+	m_delayCompensation(ConfigManager::inst()->value(
+			"audioengine", "delaycompensation", "1").toInt()),
+	m_lazyPlugins(ConfigManager::inst()->value(
+			"app", "lazyplugins", "1").toInt()),
 	m_NaNHandler(ConfigManager::inst()->value(
 			"app", "nanhandler", "1").toInt()),
 	m_hqAudioDev(ConfigManager::inst()->value(
@@ -380,6 +394,10 @@ SetupDialog::SetupDialog(ConfigTabs tab_to_open) :
 		m_smoothScroll, SLOT(toggleSmoothScroll(bool)), false);
 	addLedCheckBox(tr("Display playback cursor in AudioFileProcessor"), ui_fx_tw, counter,
 		m_animateAFP, SLOT(toggleAnimateAFP(bool)), false);
+	addLedCheckBox(tr("Save waveform overviews next to sample files"), ui_fx_tw, counter,
+		m_saveWaveformOverview, SLOT(toggleSaveWaveformOverview(bool)), false);
+	addLedCheckBox(tr("Index sample libraries in the background"), ui_fx_tw, counter,
+		m_indexSampleLibrary, SLOT(toggleIndexSampleLibrary(bool)), true);
 
 	ui_fx_tw->setFixedHeight(YDelta + YDelta * counter);
 
@@ -426,6 +444,18 @@ SetupDialog::SetupDialog(ConfigTabs tab_to_open) :
 
 	addLedCheckBox(tr("Keep effects running even without input"), plugins_tw, counter,
 		m_disableAutoQuit, SLOT(toggleDisableAutoQuit(bool)), false);
+#ifdef LMMS_HAVE_FLUIDSYNTH
+	addLedCheckBox(tr("Play all Sf2 Player tracks on one shared synth"), plugins_tw, counter,
+		m_sf2SharedSynth, SLOT(toggleSf2SharedSynth(bool)), true);
+#endif
+	addLedCheckBox(tr("Run out-of-process plugins one buffer ahead (adds latency)"), plugins_tw, counter,
+		m_pipelineRemotePlugins, SLOT(togglePipelineRemotePlugins(bool)), true);
+	addLedCheckBox(tr("Pass planar buffers to LADSPA and LV2 effects"), plugins_tw, counter,
+		m_planarBuffers, SLOT(togglePlanarBuffers(bool)), true);
+	addLedCheckBox(tr("Compensate plugin latency in the mixer"), plugins_tw, counter,
+		m_delayCompensation, SLOT(toggleDelayCompensation(bool)), true);
+	addLedCheckBox(tr("Load plugins of muted tracks and disabled effects when needed"), plugins_tw, counter,
+		m_lazyPlugins, SLOT(toggleLazyPlugins(bool)), false);
 
 	plugins_tw->setFixedHeight(YDelta + YDelta * counter);
 
@@ -913,12 +943,26 @@ void SetupDialog::accept()
 					QString::number(m_smoothScroll));
 	ConfigManager::inst()->setValue("ui", "animateafp",
 					QString::number(m_animateAFP));
+	ConfigManager::inst()->setValue("ui", "savewaveformoverview",
+					QString::number(m_saveWaveformOverview));
+	ConfigManager::inst()->setValue("ui", "indexsamplelibrary",
+					QString::number(m_indexSampleLibrary));
 	ConfigManager::inst()->setValue("ui", "vstembedmethod",
 					m_vstEmbedComboBox->currentData().toString());
 	ConfigManager::inst()->setValue("ui", "vstalwaysontop",
 					QString::number(m_vstAlwaysOnTop));
 	ConfigManager::inst()->setValue("ui", "disableautoquit",
 					QString::number(m_disableAutoQuit));
+	ConfigManager::inst()->setValue("sf2player", "sharedsynth",
+					QString::number(m_sf2SharedSynth));
+	ConfigManager::inst()->setValue("audioengine", "pipelineremoteplugins",
+					QString::number(m_pipelineRemotePlugins));
+	ConfigManager::inst()->setValue("audioengine", "planarbuffers",
+					QString::number(m_planarBuffers));
+	ConfigManager::inst()->setValue("audioengine", "delaycompensation",
+					QString::number(m_delayCompensation));
+	ConfigManager::inst()->setValue("app", "lazyplugins",
+					QString::number(m_lazyPlugins));
 	ConfigManager::inst()->setValue("audioengine", "audiodev",
 					m_audioIfaceNames[m_audioInterfaces->currentText()]);
 	ConfigManager::inst()->setValue("app", "nanhandler",
@@ -1097,6 +1141,18 @@ void SetupDialog::toggleAnimateAFP(bool enabled)
 }
 
 
+void SetupDialog::toggleSaveWaveformOverview(bool enabled)
+{
+	m_saveWaveformOverview = enabled;
+}
+
+
+void SetupDialog::toggleIndexSampleLibrary(bool enabled)
+{
+	m_indexSampleLibrary = enabled;
+}
+
+
 void SetupDialog::vstEmbedMethodChanged()
 {
 	m_vstEmbedMethod = m_vstEmbedComboBox->currentData().toString();
@@ -1116,6 +1172,36 @@ void SetupDialog::toggleDisableAutoQuit(bool enabled)
 }
 
 
+void SetupDialog::toggleSf2SharedSynth(bool enabled)
+{
+	m_sf2SharedSynth = enabled;
+}
+
+
+void SetupDialog::togglePipelineRemotePlugins(bool enabled)
+{
+	m_pipelineRemotePlugins = enabled;
+}
+
+
+void SetupDialog::togglePlanarBuffers(bool enabled)
+{
+	m_planarBuffers = enabled;
+}
+
+
+void SetupDialog::toggleDelayCompensation(bool enabled)
+{
+	m_delayCompensation = enabled;
+}
+
+
+void SetupDialog::toggleLazyPlugins(bool enabled)
+{
+	m_lazyPlugins = enabled;
+}
+
+
 
 
 // Audio settings slots.
@@ -45,6 +45,7 @@
 #include "MainWindow.h"
 #include "MidiClient.h"
 #include "MidiPortMenu.h"
+#include "TrackFreezer.h"
 #include "TrackLabelButton.h"
 
 
@@ -299,6 +300,12 @@ void InstrumentTrackView::toggleInstrumentWindow( bool _on )
 		}
 	}
 
+	// the window needs the instrument, which a frozen track has unloaded
+	if (_on && model()->isFrozen())
+	{
+		Engine::trackFreezer()->unfreeze(model());
+	}
+
 	getInstrumentTrackWindow()->toggleVisibility( _on );
 }
 
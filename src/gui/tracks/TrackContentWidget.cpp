@@ -24,6 +24,9 @@
 
 #include "TrackContentWidget.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <QApplication>
 #include <QContextMenuEvent>
 #include <QMenu>
@@ -52,6 +55,18 @@ namespace lmms::gui
 const int BARS_PER_GROUP = 4;
 
 
+/*! Whether any part of a clip lies within [begin, end]
+ */
+static bool clipInRange( const Clip * clip, int begin, int end )
+{
+	const int ts = clip->startPosition();
+	const int te = clip->endPosition()-3;
+	return ( ts >= begin && ts <= end ) ||
+		( te >= begin && te <= end ) ||
+		( ts <= begin && te >= end );
+}
+
+
 /*! \brief Create a new trackContentWidget
  *
  *  Creates a new track content widget for the given track.
@@ -66,7 +81,8 @@ TrackContentWidget::TrackContentWidget( TrackView * parent ) :
 	m_darkerColor( Qt::SolidPattern ),
 	m_lighterColor( Qt::SolidPattern ),
 	m_gridColor( Qt::SolidPattern ),
-	m_embossColor( Qt::SolidPattern )
+	m_embossColor( Qt::SolidPattern ),
+	m_creatingClipViews( false )
 {
 	setAcceptDrops( true );
 
@@ -169,6 +185,75 @@ void TrackContentWidget::removeClipView( ClipView * clipv )
 
 
 
+void TrackContentWidget::deferClipView( Clip * clip )
+{
+	m_pendingClips.push_back( clip );
+
+	// the clip may be moved into view without scrolling, e.g. by undo
+	connect( clip, SIGNAL(positionChanged()), this, SLOT(changePosition()) );
+	connect( clip, SIGNAL(lengthChanged()), this, SLOT(changePosition()) );
+}
+
+
+
+
+bool TrackContentWidget::isInView( const Clip * clip )
+{
+	const TimePos begin = m_trackView->trackContainerView()->currentPosition();
+	return clipInRange( clip, begin, endPosition( begin ) );
+}
+
+
+
+
+void TrackContentWidget::createPendingClipViews( const TimePos & begin, const TimePos & end )
+{
+	if( createClipViews( begin, end ) )
+	{
+		changePosition();
+	}
+}
+
+
+
+
+void TrackContentWidget::createPendingClipViews()
+{
+	createPendingClipViews( std::numeric_limits<int>::min(), std::numeric_limits<int>::max() );
+}
+
+
+
+
+bool TrackContentWidget::createClipViews( const TimePos & begin, const TimePos & end )
+{
+	std::vector<Clip *> clips;
+	const auto it = std::remove_if( m_pendingClips.begin(), m_pendingClips.end(),
+		[&]( const QPointer<Clip> & clip )
+		{
+			if( clip.isNull() ) { return true; }
+			if( !clipInRange( clip, begin, end ) ) { return false; }
+			clips.push_back( clip );
+			return true;
+		} );
+	m_pendingClips.erase( it, m_pendingClips.end() );
+
+	// views call changePosition() when they are added, they are positioned
+	// all at once afterwards instead
+	m_creatingClipViews = true;
+	for( Clip * clip : clips )
+	{
+		disconnect( clip, nullptr, this, nullptr );
+		clip->createView( m_trackView );
+	}
+	m_creatingClipViews = false;
+
+	return !clips.empty();
+}
+
+
+
+
 /*! \brief Update ourselves by updating all the ClipViews attached.
  *
  */
@@ -193,6 +278,11 @@ void TrackContentWidget::update()
  */
 void TrackContentWidget::changePosition( const TimePos & newPos )
 {
+	if( m_creatingClipViews )
+	{
+		return;
+	}
+
 	if (m_trackView->trackContainerView() == getGUI()->patternEditor()->m_editor)
 	{
 		const int curPattern = Engine::patternStore()->currentPattern();
@@ -229,18 +319,16 @@ void TrackContentWidget::changePosition( const TimePos & newPos )
 	const float ppb = m_trackView->trackContainerView()->pixelsPerBar();
 
 	setUpdatesEnabled( false );
+	createClipViews( begin, end );
 	for (const auto& clipView : m_clipViews)
 	{
 		Clip* clip = clipView->getClip();
 
 		clip->changeLength( clip->length() );
 
-		const int ts = clip->startPosition();
-		const int te = clip->endPosition()-3;
-		if( ( ts >= begin && ts <= end ) ||
-			( te >= begin && te <= end ) ||
-			( ts <= begin && te >= end ) )
+		if( clipInRange( clip, begin, end ) )
 		{
+			const int ts = clip->startPosition();
 			clipView->move(static_cast<int>((ts - begin) * ppb / TimePos::ticksPerBar()), clipView->y());
 			if (!clipView->isVisible())
 			{
@@ -249,7 +337,9 @@ void TrackContentWidget::changePosition( const TimePos & newPos )
 		}
 		else
 		{
+			// hidden views are neither painted nor updated
 			clipView->move(-clipView->width() - 10, clipView->y());
+			clipView->hide();
 		}
 	}
 	setUpdatesEnabled( true );
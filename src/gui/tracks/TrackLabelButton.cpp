@@ -68,6 +68,8 @@ TrackLabelButton::TrackLabelButton( TrackView * _tv, QWidget * _parent ) :
 	setIconSize( QSize( 24, 24 ) );
 	connect( m_trackView->getTrack(), SIGNAL(dataChanged()), this, SLOT(update()));
 	connect( m_trackView->getTrack(), SIGNAL(nameChanged()), this, SLOT(nameChanged()));
+	connect( m_trackView->getTrack(), SIGNAL(frozenChanged()), this, SLOT(frozenChanged()));
+	frozenChanged();
 }
 
 
@@ -130,6 +132,18 @@ void TrackLabelButton::nameChanged()
 
 
 
+//! Frozen tracks are set in italics, like a stem sitting in for the track
+void TrackLabelButton::frozenChanged()
+{
+	QFont f = font();
+	f.setItalic( m_trackView->getTrack()->isFrozen() );
+	setFont( f );
+	setText( elideName( m_trackView->getTrack()->displayName() ) );
+}
+
+
+
+
 void TrackLabelButton::dragEnterEvent( QDragEnterEvent * _dee )
 {
 	m_trackView->dragEnterEvent( _dee );
@@ -28,6 +28,7 @@
 #include <QMessageBox>
 #include <QMouseEvent>
 #include <QPainter>
+#include <QProgressDialog>
 #include <QPushButton>
 #include <QCheckBox>
 
@@ -45,6 +46,7 @@
 #include "StringPairDrag.h"
 #include "Track.h"
 #include "TrackContainerView.h"
+#include "TrackFreezer.h"
 #include "TrackView.h"
 
 namespace lmms::gui
@@ -253,6 +255,44 @@ void TrackOperationsWidget::clearTrack()
 
 
 
+/*! \brief Freeze or unfreeze this track
+ *
+ *  Freezing renders the track, which can take a while, so a progress
+ *  dialog lets the user cancel it.
+ */
+void TrackOperationsWidget::toggleFreeze()
+{
+	Track * t = m_trackView->getTrack();
+	TrackFreezer * freezer = Engine::trackFreezer();
+	if( t->isFrozen() )
+	{
+		freezer->unfreeze( t );
+		return;
+	}
+
+	QString reason;
+	if( !freezer->canFreeze( t, &reason ) )
+	{
+		QMessageBox::information( this, tr( "Can't freeze track" ), reason );
+		return;
+	}
+
+	QProgressDialog progress( tr( "Freezing \"%1\"..." ).arg( t->name() ), tr( "Cancel" ), 0, 100, this );
+	progress.setWindowModality( Qt::WindowModal );
+	progress.setMinimumDuration( 0 );
+	connect( freezer, SIGNAL(progressChanged(int)), &progress, SLOT(setValue(int)));
+	connect( freezer, SIGNAL(finished(bool)), &progress, SLOT(accept()));
+	connect( &progress, SIGNAL(canceled()), freezer, SLOT(abort()));
+
+	freezer->freeze( t );
+	if( freezer->isRendering() )
+	{
+		progress.exec();
+	}
+}
+
+
+
 /*! \brief Remove this track from the track list
  *
  */
@@ -342,6 +382,13 @@ void TrackOperationsWidget::updateMenu()
 		toMenu->addSeparator();
 		toMenu->addMenu(trackView->midiMenu());
 	}
+	const Track * track = m_trackView->getTrack();
+	if( ( track->type() == Track::InstrumentTrack || track->type() == Track::PatternTrack )
+		&& track->trackContainer() == Engine::getSong() )
+	{
+		toMenu->addAction( track->isFrozen() ? tr( "Unfreeze track" ) : tr( "Freeze track" ),
+							this, SLOT(toggleFreeze()));
+	}
 	if( dynamic_cast<AutomationTrackView *>( m_trackView ) )
 	{
 		toMenu->addAction( tr( "Turn all recording on" ), this, SLOT(recordingOn()));
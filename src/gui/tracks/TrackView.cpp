@@ -366,6 +366,12 @@ namespace lmms::gui {
    *  \todo is this a good description for what this method does?
    */
   void TrackView::createClipView(Clip* clip) {
+    // the song editor creates views only for clips that are scrolled into view
+    if (!m_trackContainerView->fixedClips() && !clip->getSelectViewOnCreate()
+      && !m_trackContentWidget.isInView(clip)) {
+      m_trackContentWidget.deferClipView(clip);
+      return;
+    }
     ClipView* tv = clip->createView(this);
     if (clip->getSelectViewOnCreate() == true) {
       tv->setSelected(true);
@@ -23,7 +23,10 @@
  */
 
 
+#include <utility>
+
 #include <QMouseEvent>
+#include <QMutexLocker>
 #include <QPainter>
 
 #include "Oscilloscope.h"
@@ -44,19 +47,25 @@ Oscilloscope::Oscilloscope( QWidget * _p ) :
 	QWidget( _p ),
 	m_background( embed::getIconPixmap( "output_graph" ) ),
 	m_points( new QPointF[Engine::audioEngine()->framesPerPeriod()] ),
+	m_published( false ),
 	m_active( false ),
+	m_maxLevel( 0.0f ),
 	m_normalColor(71, 253, 133),
 	m_clippingColor(255, 64, 64)
 {
 	setFixedSize( m_background.width(), m_background.height() );
 	setAttribute( Qt::WA_OpaquePaintEvent, true );
-	setActive( ConfigManager::inst()->value( "ui", "displaywaveform").toInt() );
 
 	const fpp_t frames = Engine::audioEngine()->framesPerPeriod();
 	m_buffer = new sampleFrame[frames];
+	m_analysisBuffer = new sampleFrame[frames];
+	m_publishedBuffer = new sampleFrame[frames];
 
 	BufferManager::clear( m_buffer, frames );
+	BufferManager::clear( m_analysisBuffer, frames );
+	BufferManager::clear( m_publishedBuffer, frames );
 
+	setActive( ConfigManager::inst()->value( "ui", "displaywaveform").toInt() );
 
 	setToolTip(tr("Oscilloscope"));
 }
@@ -66,20 +75,55 @@ Oscilloscope::Oscilloscope( QWidget * _p ) :
 
 Oscilloscope::~Oscilloscope()
 {
+	// the engine may already be gone when the main window is torn down
+	if( AudioEngine * audioEngine = Engine::audioEngine() )
+	{
+		audioEngine->outputTap().removeProcessor( this );
+	}
 	delete[] m_buffer;
+	delete[] m_analysisBuffer;
+	delete[] m_publishedBuffer;
 	delete[] m_points;
 }
 
 
 
 
-void Oscilloscope::updateAudioBuffer( const surroundSampleFrame * buffer )
+void Oscilloscope::analyze( const sampleFrame * buffer, fpp_t frames )
+{
+	// only the most recent period is displayed
+	const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
+	if( frames >= fpp )
+	{
+		memcpy( m_analysisBuffer, buffer + frames - fpp, sizeof( sampleFrame ) * fpp );
+	}
+	else if( frames > 0 )
+	{
+		memmove( m_analysisBuffer, m_analysisBuffer + frames, sizeof( sampleFrame ) * ( fpp - frames ) );
+		memcpy( m_analysisBuffer + fpp - frames, buffer, sizeof( sampleFrame ) * frames );
+	}
+	else
+	{
+		return;
+	}
+
+	// paintEvent() takes it from here, without ever seeing a half written
+	// period
+	QMutexLocker lock( &m_publishLock );
+	memcpy( m_publishedBuffer, m_analysisBuffer, sizeof( sampleFrame ) * fpp );
+	m_published = true;
+}
+
+
+
+
+void Oscilloscope::periodicalUpdate()
 {
-	if( !Engine::getSong()->isExporting() )
+	if( !Engine::getSong()->isExporting() && isVisible() )
 	{
-		const fpp_t fpp = Engine::audioEngine()->framesPerPeriod();
-		memcpy( m_buffer, buffer, sizeof( surroundSampleFrame ) * fpp );
+		Engine::audioEngine()->outputTap().requestAnalysis();
 	}
+	update();
 }
 
 
@@ -92,19 +136,15 @@ void Oscilloscope::setActive( bool _active )
 	{
 		connect( getGUI()->mainWindow(),
 					SIGNAL(periodicUpdate()),
-					this, SLOT(update()));
-		connect( Engine::audioEngine(),
-			SIGNAL(nextAudioBuffer(const lmms::surroundSampleFrame*)),
-			this, SLOT(updateAudioBuffer(const lmms::surroundSampleFrame*)) );
+					this, SLOT(periodicalUpdate()));
+		Engine::audioEngine()->outputTap().addProcessor( this );
 	}
 	else
 	{
 		disconnect( getGUI()->mainWindow(),
 					SIGNAL(periodicUpdate()),
-					this, SLOT(update()));
-		disconnect( Engine::audioEngine(),
-			SIGNAL( nextAudioBuffer( const lmms::surroundSampleFrame* ) ),
-			this, SLOT( updateAudioBuffer( const lmms::surroundSampleFrame* ) ) );
+					this, SLOT(periodicalUpdate()));
+		Engine::audioEngine()->outputTap().removeProcessor( this );
 		// we have to update (remove last waves),
 		// because timer doesn't do that anymore
 		update();
@@ -146,11 +186,23 @@ void Oscilloscope::paintEvent( QPaintEvent * )
 		float master_output = audioEngine->masterGain();
 
 		const fpp_t frames = audioEngine->framesPerPeriod();
-		AudioEngine::StereoSample peakValues = audioEngine->getPeakValues(m_buffer, frames);
-		const float max_level = qMax<float>( peakValues.left, peakValues.right );
+		{
+			QMutexLocker lock( &m_publishLock );
+			if( m_published )
+			{
+				std::swap( m_buffer, m_publishedBuffer );
+				m_published = false;
+			}
+		}
+
+		float peakLeft, peakRight;
+		if( audioEngine->outputTap().takePeaks( peakLeft, peakRight ) )
+		{
+			m_maxLevel = qMax( peakLeft, peakRight );
+		}
 
 		// Set the color of the line according to the maximum level
-		float const maxLevelWithAppliedMasterGain = max_level * master_output;
+		float const maxLevelWithAppliedMasterGain = m_maxLevel * master_output;
 		p.setPen(QPen(determineLineColor(maxLevelWithAppliedMasterGain), 0.7));
 
 		p.setRenderHint( QPainter::Antialiasing );
@@ -28,6 +28,7 @@
 #include "ConfigManager.h"
 #include "ControllerConnection.h"
 #include "DataFile.h"
+#include "FrozenStem.h"
 #include "Mixer.h"
 #include "InstrumentTrackView.h"
 #include "Instrument.h"
@@ -38,7 +39,9 @@
 #include "PatternStore.h"
 #include "PatternTrack.h"
 #include "Pitch.h"
+#include "PluginLoaderThread.h"
 #include "Song.h"
+#include "TrackFreezer.h"
 
 namespace lmms
 {
@@ -107,6 +110,15 @@ InstrumentTrack::InstrumentTrack( TrackContainer* tc ) :
 	connect(&m_pitchModel, SIGNAL(dataChanged()), this, SLOT(updatePitch()), Qt::DirectConnection);
 	connect(&m_pitchRangeModel, SIGNAL(dataChanged()), this, SLOT(updatePitchRange()), Qt::DirectConnection);
 	connect(&m_mixerChannelModel, SIGNAL(dataChanged()), this, SLOT(updateMixerChannel()), Qt::DirectConnection);
+
+	// the instrument of a muted track may not have been instantiated while
+	// loading, which only happens if the mute state was neither automated
+	// nor controlled. Automation added since unmutes it on another thread,
+	// which the automatic connection queues.
+	connect(&m_mutedModel, &BoolModel::dataChanged, this, [this]
+	{
+		if (!isMuted() && !isFrozen()) { loadPendingInstrument(); }
+	});
 }
 
 
@@ -208,9 +220,11 @@ InstrumentTrack::~InstrumentTrack()
 	}
 
 	// kill all running notes and the iph
+	waitForInstrumentLoader();
 	silenceAllNotes( true );
 
 	// now we're save deleting the instrument
+	m_instrumentLoader.reset();
 	if( m_instrument ) delete m_instrument;
 }
 
@@ -219,6 +233,12 @@ InstrumentTrack::~InstrumentTrack()
 
 void InstrumentTrack::processAudioBuffer( sampleFrame* buf, const fpp_t frames, NotePlayHandle* n )
 {
+	if( m_instrument )
+	{
+		// picked up by the mixer to delay faster tracks
+		m_audioPort.setSourceLatency( m_instrument->latency() );
+	}
+
 	// we must not play the sound if this InstrumentTrack is muted...
 	if( isMuted() || ( Engine::getSong()->playMode() != Song::Mode_PlayMidiClip &&
 				n && n->isPatternTrackMuted() ) || ! m_instrument )
@@ -349,6 +369,12 @@ void InstrumentTrack::processInEvent( const MidiEvent& event, const TimePos& tim
 					{
 						m_notes[event.key()] = nullptr;
 					}
+					if( m_instrument == nullptr )
+					{
+						// the instrument was deferred; events may come from
+						// any thread
+						QMetaObject::invokeMethod( this, "loadPendingInstrument", Qt::QueuedConnection );
+					}
 				}
 				eventHandled = true;
 				break;
@@ -686,6 +712,16 @@ void InstrumentTrack::removeMidiPortNode( DataFile & _dataFile )
 bool InstrumentTrack::play( const TimePos & _start, const fpp_t _frames,
 							const f_cnt_t _offset, int _clip_num )
 {
+	if( isFrozen() )
+	{
+		// the stem plays the song instead
+		if( _clip_num < 0 )
+		{
+			frozenStem()->sync( _start, _offset );
+		}
+		return false;
+	}
+
 	if( ! m_instrument || ! tryLock() )
 	{
 		return false;
@@ -789,6 +825,8 @@ Clip* InstrumentTrack::createClip(const TimePos & pos)
 {
 	auto p = new MidiClip(this);
 	p->movePosition(pos);
+	// a deferred instrument is needed once the track gets notes
+	connect(p, &MidiClip::dataChanged, this, &InstrumentTrack::loadPendingInstrument);
 	return p;
 }
 
@@ -836,6 +874,11 @@ void InstrumentTrack::saveTrackSpecificSettings( QDomDocument& doc, QDomElement
 		}
 		thisElement.appendChild( i );
 	}
+	else if( hasPendingInstrument() )
+	{
+		// save it just as it was loaded
+		thisElement.appendChild( doc.importNode( m_pendingInstrument.documentElement(), true ) );
+	}
 	m_soundShaping.saveState( doc, thisElement );
 	m_noteStacking.saveState( doc, thisElement );
 	m_arpeggio.saveState( doc, thisElement );
@@ -859,16 +902,48 @@ void InstrumentTrack::saveTrackSpecificSettings( QDomDocument& doc, QDomElement
 
 
 
+//! Whether a clip of the saved track @p track has notes
+static bool hasSavedNotes( const QDomElement & track )
+{
+	for( QDomElement clip = track.firstChildElement( "midiclip" ); !clip.isNull();
+		clip = clip.nextSiblingElement( "midiclip" ) )
+	{
+		if( !clip.firstChildElement( "note" ).isNull() )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+
 void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement )
 {
 	// don't delete instrument in preview mode if it's the same
 	// we can't do this for other situations due to some issues with linked models
 	bool reuseInstrument = m_previewMode && m_instrument && m_instrument->nodeName() == getSavedInstrumentName(thisElement);
 	// remove the InstrumentPlayHandle if and only if we need to delete the instrument
+	waitForInstrumentLoader();
 	silenceAllNotes(!reuseInstrument);
 
+	// a muted track doesn't need its instrument until it's unmuted, unless
+	// automation or a controller may unmute it while playing. Neither does
+	// a track of the pattern store without notes until it gets some.
+	const QDomElement track = thisElement.parentNode().toElement();
+	const bool deferInstrument = !m_previewMode && Plugin::deferInstantiation()
+		&& ((isMuted() && !AutomatableModel::isSavedAutomated(track, "muted"))
+			|| (trackContainer() == Engine::patternStore() && !hasSavedNotes(track)));
+	// neither does a track which will play its frozen stem
+	const bool frozen = !m_previewMode && Engine::getSong()->isLoadingProject()
+		&& TrackFreezer::hasStem(savedFreezeKey());
+
 	lock();
 
+	m_pendingInstrument = QDomDocument();
+	m_instrumentLoader.reset();
+
 	m_volumeModel.loadSettings( thisElement, "vol" );
 	m_panningModel.loadSettings( thisElement, "pan" );
 	m_pitchRangeModel.loadSettings( thisElement, "pitchrange" );
@@ -914,7 +989,14 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 			}
 			else if( m_audioPort.effects()->nodeName() == node.nodeName() )
 			{
-				m_audioPort.effects()->restoreState( node.toElement() );
+				if( frozen )
+				{
+					m_audioPort.effects()->holdEffects( node.toElement() );
+				}
+				else
+				{
+					m_audioPort.effects()->restoreState( node.toElement() );
+				}
 			}
 			else if(node.nodeName() == "instrument")
 			{
@@ -925,6 +1007,13 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 				{
 					m_instrument->restoreState(node.firstChildElement());
 				}
+				else if (frozen || (deferInstrument && Plugin::canDeferInstantiation(node.toElement())))
+				{
+					delete m_instrument;
+					m_instrument = nullptr;
+					m_pendingInstrument.appendChild(m_pendingInstrument.importNode(node, true));
+					emit instrumentChanged();
+				}
 				else
 				{
 					delete m_instrument;
@@ -973,6 +1062,142 @@ void InstrumentTrack::loadTrackSpecificSettings( const QDomElement & thisElement
 
 
 
+void InstrumentTrack::instantiatePendingInstrument()
+{
+	if( m_instrumentLoader )
+	{
+		// it's on its way already
+		adoptLoadedInstrument();
+		return;
+	}
+	if( !hasPendingInstrument() )
+	{
+		return;
+	}
+
+	const QDomElement node = m_pendingInstrument.documentElement();
+	using PluginKey = Plugin::Descriptor::SubPluginFeatures::Key;
+	PluginKey key(node.elementsByTagName("key").item(0).toElement());
+
+	// the track keeps playing while the instrument is created
+	Instrument* instrument = Instrument::instantiate(node.attribute("name"), this, &key);
+	instrument->restoreState(node.firstChildElement());
+
+	lock();
+	std::swap(m_instrument, instrument);
+	m_pendingInstrument = QDomDocument();
+	unlock();
+	delete instrument;
+
+	emit instrumentChanged();
+}
+
+
+
+
+void InstrumentTrack::loadPendingInstrument()
+{
+	if( !hasPendingInstrument() || m_instrumentLoader || isFrozen()
+		|| Engine::getSong()->isLoadingProject() )
+	{
+		return;
+	}
+
+	if( !PluginLoaderThread::canLoad(m_pendingInstrument.documentElement().attribute("name")) )
+	{
+		// only the main thread can tell the user it's missing
+		instantiatePendingInstrument();
+		return;
+	}
+
+	// the loader works on its own copy, the settings are implicitly shared
+	m_instrumentLoader = std::make_unique<PluginLoaderThread>(
+		[this, state = m_pendingInstrument.cloneNode(true).toDocument()]
+	{
+		const QDomElement node = state.documentElement();
+		using PluginKey = Plugin::Descriptor::SubPluginFeatures::Key;
+		PluginKey key(node.elementsByTagName("key").item(0).toElement());
+
+		Instrument* instrument = Instrument::instantiate(node.attribute("name"), this, &key);
+		instrument->restoreState(node.firstChildElement());
+		return std::vector<Plugin*>{instrument};
+	});
+	connect(m_instrumentLoader.get(), SIGNAL(finished()), this, SLOT(instrumentLoaded()));
+	m_instrumentLoader->start();
+}
+
+
+
+
+void InstrumentTrack::instrumentLoaded()
+{
+	// the instrument may have been replaced since the loader was started
+	if( m_instrumentLoader && sender() == m_instrumentLoader.get() )
+	{
+		adoptLoadedInstrument();
+	}
+}
+
+
+
+
+void InstrumentTrack::adoptLoadedInstrument()
+{
+	auto instrument = static_cast<Instrument*>(m_instrumentLoader->takePlugins().front());
+	m_instrumentLoader.reset();
+
+	lock();
+	std::swap(m_instrument, instrument);
+	m_pendingInstrument = QDomDocument();
+	unlock();
+	delete instrument;
+
+	emit instrumentChanged();
+}
+
+
+
+
+void InstrumentTrack::waitForInstrumentLoader()
+{
+	if( m_instrumentLoader )
+	{
+		m_instrumentLoader->wait();
+	}
+}
+
+
+
+
+void InstrumentTrack::unloadPlugins( const QDomElement & state )
+{
+	const QDomElement settings = state.firstChildElement( nodeName() );
+
+	waitForInstrumentLoader();
+	silenceAllNotes( true );
+
+	lock();
+	delete m_instrument;
+	m_instrument = nullptr;
+	m_pendingInstrument = QDomDocument();
+	m_instrumentLoader.reset();
+	const QDomElement instrument = settings.firstChildElement( "instrument" );
+	if( !instrument.isNull() )
+	{
+		m_pendingInstrument.appendChild( m_pendingInstrument.importNode( instrument, true ) );
+	}
+	// nothing feeds the port anymore
+	m_audioPort.setSourceLatency( 0 );
+	unlock();
+
+	emit instrumentChanged();
+
+	m_audioPort.effects()->holdEffects( settings.firstChildElement( m_audioPort.effects()->nodeName() ) );
+}
+
+
+
+
 void InstrumentTrack::setPreviewMode( const bool value )
 {
 	m_previewMode = value;
@@ -1026,10 +1251,13 @@ Instrument * InstrumentTrack::loadInstrument(const QString & _plugin_name,
 	if(keyFromDnd)
 		Q_ASSERT(!key);
 
+	waitForInstrumentLoader();
 	silenceAllNotes( true );
 
 	lock();
 	delete m_instrument;
+	m_pendingInstrument = QDomDocument();
+	m_instrumentLoader.reset();
 	m_instrument = Instrument::instantiate(_plugin_name, this,
 					key, keyFromDnd);
 	unlock();
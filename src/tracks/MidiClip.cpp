@@ -49,6 +49,8 @@ MidiClip::MidiClip( InstrumentTrack * _instrument_track ) :
 	Clip( _instrument_track ),
 	m_instrumentTrack( _instrument_track ),
 	m_clipType( BeatClip ),
+	m_noteIndex( m_notes ),
+	m_noteIndexUpdated( false ),
 	m_steps( TimePos::stepsPerBar() )
 {
 	if (_instrument_track->trackContainer()	== Engine::patternStore())
@@ -66,11 +68,13 @@ MidiClip::MidiClip( const MidiClip& other ) :
 	Clip( other.m_instrumentTrack ),
 	m_instrumentTrack( other.m_instrumentTrack ),
 	m_clipType( other.m_clipType ),
+	m_noteIndex( m_notes ),
+	m_noteIndexUpdated( false ),
 	m_steps( other.m_steps )
 {
 	for (const auto& note : other.m_notes)
 	{
-		m_notes.push_back(new Note(*note));
+		m_notes.push_back(m_noteArena.create(*note));
 	}
 
 	init();
@@ -95,7 +99,7 @@ MidiClip::~MidiClip()
 
 	for (const auto& note : m_notes)
 	{
-		delete note;
+		m_noteArena.destroy(note);
 	}
 
 	m_notes.clear();
@@ -133,6 +137,11 @@ void MidiClip::init()
 {
 	connect( Engine::getSong(), SIGNAL(timeSignatureChanged(int,int)),
 				this, SLOT(changeTimeSignature()));
+	// the piano roll changes notes in place and emits dataChanged() afterwards
+	connect( this, &MidiClip::dataChanged, this, [this]
+	{
+		if( !m_noteIndexUpdated ) { m_noteIndex.invalidate(); }
+	}, Qt::DirectConnection );
 	saveJournallingState( false );
 
 	updateLength();
@@ -192,9 +201,20 @@ TimePos MidiClip::beatClipLength() const
 
 
 
+void MidiClip::notesMoved( const NoteVector & notes )
+{
+	m_noteIndex.update( notes );
+	m_noteIndexUpdated = true;
+	emit dataChanged();
+	m_noteIndexUpdated = false;
+}
+
+
+
+
 Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 {
-	auto new_note = new Note(_new_note);
+	auto new_note = m_noteArena.create(_new_note);
 	if (_quant_pos && gui::getGUI()->pianoRoll())
 	{
 		new_note->quantizePos(gui::getGUI()->pianoRoll()->quantization());
@@ -202,6 +222,7 @@ Note * MidiClip::addNote( const Note & _new_note, const bool _quant_pos )
 
 	instrumentTrack()->lock();
 	m_notes.insert(std::upper_bound(m_notes.begin(), m_notes.end(), new_note, Note::lessThan), new_note);
+	m_noteIndex.invalidate();
 	instrumentTrack()->unlock();
 
 	checkType();
@@ -223,8 +244,9 @@ void MidiClip::removeNote( Note * _note_to_del )
 	{
 		if( *it == _note_to_del )
 		{
-			delete *it;
+			m_noteArena.destroy( *it );
 			m_notes.erase( it );
+			m_noteIndex.invalidate();
 			break;
 		}
 		++it;
@@ -258,6 +280,7 @@ void MidiClip::rearrangeAllNotes()
 {
 	// sort notes by start time
 	std::sort(m_notes.begin(), m_notes.end(), Note::lessThan);
+	m_noteIndex.invalidate();
 }
 
 
@@ -267,9 +290,11 @@ void MidiClip::clearNotes()
 	instrumentTrack()->lock();
 	for (const auto& note : m_notes)
 	{
-		delete note;
+		m_noteArena.destroy(note);
 	}
 	m_notes.clear();
+	m_noteArena.clear();
+	m_noteIndex.invalidate();
 	instrumentTrack()->unlock();
 
 	checkType();
@@ -437,12 +462,13 @@ void MidiClip::loadSettings( const QDomElement & _this )
 		if( node.isElement() &&
 			!node.toElement().attribute( "metadata" ).toInt() )
 		{
-			auto n = new Note;
+			auto n = m_noteArena.create( Note() );
 			n->restoreState( node.toElement() );
 			m_notes.push_back( n );
 		}
 		node = node.nextSibling();
         }
+	m_noteIndex.invalidate();
 
 	m_steps = _this.attribute( "steps" ).toInt();
 	if( m_steps == 0 )
@@ -27,6 +27,7 @@
 
 #include "AudioEngine.h"
 #include "Engine.h"
+#include "FrozenStem.h"
 #include "PatternClip.h"
 #include "PatternStore.h"
 #include "PatternTrackView.h"
@@ -94,6 +95,14 @@ bool PatternTrack::play( const TimePos & _start, const fpp_t _frames,
 		return false;
 	}
 
+	if( isFrozen() && _clip_num < 0 )
+	{
+		// the stem plays the song instead, the instruments of the pattern
+		// keep playing the other pattern tracks
+		frozenStem()->sync( _start, _offset );
+		return false;
+	}
+
 	if( _clip_num >= 0 )
 	{
 		return Engine::patternStore()->play(_start, _frames, _offset, s_infoMap[this]);
@@ -4,12 +4,15 @@
 
 #include <QDebug>
 
+#include "AudioEngine.h"
 #include "Engine.h"
 
 int main(int argc, char* argv[])
 {
 	new QCoreApplication(argc, argv);
-	lmms::Engine::init(true);
+	// e.g. LMMS_RENDER_BLOCK_SIZE=4096 to benchmark large render blocks
+	const int blockSize = qEnvironmentVariableIntValue("LMMS_RENDER_BLOCK_SIZE");
+	lmms::Engine::init(true, static_cast<lmms::fpp_t>(qBound(0, blockSize, int{lmms::MAXIMUM_RENDER_BLOCK_SIZE})));
 
 	int numsuites = QTestSuite::suites().size();
 	qDebug() << ">> Will run" << numsuites << "test suites";
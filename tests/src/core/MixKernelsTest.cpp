@@ -0,0 +1,260 @@
+/*
+ * MixKernelsTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "MixKernels.h"
+
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+Q_DECLARE_METATYPE(lmms::MixKernels::InstructionSet)
+
+using namespace lmms::MixKernels;
+
+namespace
+{
+
+//! A period of the default buffer size, in samples
+constexpr std::size_t BenchmarkSamples = 2 * 256;
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b)
+{
+	return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+std::vector<float> randomSamples(std::mt19937& generator, std::size_t count, float range)
+{
+	std::uniform_real_distribution<float> distribution(-range, range);
+	std::vector<float> samples(count);
+	for (float& sample : samples) { sample = distribution(generator); }
+	return samples;
+}
+
+//! Put a special value at a random position, if there is any
+void insert(std::mt19937& generator, std::vector<float>& samples, float value)
+{
+	if (!samples.empty()) { samples[generator() % samples.size()] = value; }
+}
+
+} // namespace
+
+
+class MixKernelsTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void BitExactnessTests_data()
+	{
+		addInstructionSets(false);
+	}
+
+	//! Every kernel must give exactly the results of the scalar kernels
+	void BitExactnessTests()
+	{
+		QFETCH(InstructionSet, set);
+		const KernelTable* tested = kernels(set);
+		if (tested == nullptr) { QSKIP("not supported by this CPU"); }
+		const KernelTable* reference = kernels(InstructionSet::Scalar);
+		QVERIFY(reference != nullptr);
+
+		const float infinity = std::numeric_limits<float>::infinity();
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+
+		std::mt19937 generator(1);
+		// cover every remainder of the vector loops
+		for (std::size_t count = 0; count <= 130; ++count)
+		{
+			for (int round = 0; round < 4; ++round)
+			{
+				std::vector<float> dst = randomSamples(generator, count, 2.0f);
+				std::vector<float> src = randomSamples(generator, count, 2000.0f);
+				insert(generator, dst, -0.0f);
+				if (round == 1) { insert(generator, src, infinity); }
+				if (round == 2) { insert(generator, src, -nan); }
+				if (round == 3) { insert(generator, src, 1e-38f); }
+
+				for (float coeff : { 0.5f, -1.3f, infinity })
+				{
+					std::vector<float> expected = dst;
+					std::vector<float> actual = dst;
+					reference->add(expected.data(), src.data(), count);
+					tested->add(actual.data(), src.data(), count);
+					QVERIFY(sameBits(expected, actual));
+
+					expected = actual = dst;
+					reference->addMultiplied(expected.data(), src.data(), coeff, count);
+					tested->addMultiplied(actual.data(), src.data(), coeff, count);
+					QVERIFY(sameBits(expected, actual));
+
+					expected = actual = dst;
+					reference->addSanitizedMultiplied(expected.data(), src.data(), coeff, count);
+					tested->addSanitizedMultiplied(actual.data(), src.data(), coeff, count);
+					QVERIFY(sameBits(expected, actual));
+				}
+
+				std::vector<float> expected = src;
+				std::vector<float> actual = src;
+				QCOMPARE(tested->sanitize(actual.data(), count), reference->sanitize(expected.data(), count));
+				QVERIFY(sameBits(expected, actual));
+
+				float expectedPeaks[2] = { 0.0f, 0.0f };
+				float actualPeaks[2] = { 0.0f, 0.0f };
+				reference->peak(src.data(), count, expectedPeaks);
+				tested->peak(src.data(), count, actualPeaks);
+				// QCOMPARE would compare fuzzily
+				QVERIFY(actualPeaks[0] == expectedPeaks[0]);
+				QVERIFY(actualPeaks[1] == expectedPeaks[1]);
+
+				std::vector<float> quiet(count, 0.0f);
+				insert(generator, quiet, round % 2 ? SilenceThreshold : -0.0f);
+				QCOMPARE(tested->isSilent(quiet.data(), count), reference->isSilent(quiet.data(), count));
+				QCOMPARE(tested->isSilent(dst.data(), count), reference->isSilent(dst.data(), count));
+
+				for (bool swapBytes : { false, true })
+				{
+					// converting NaNs is undefined, dst has none
+					std::vector<int16_t> expectedS16(count);
+					std::vector<int16_t> actualS16(count);
+					reference->convertToS16(dst.data(), count, 0.8f, expectedS16.data(), swapBytes);
+					tested->convertToS16(dst.data(), count, 0.8f, actualS16.data(), swapBytes);
+					QVERIFY(expectedS16 == actualS16);
+				}
+
+				// deinterleave() and interleave() take frames, not samples
+				const std::size_t frames = count / 2;
+				std::vector<float> expectedLeft(frames), expectedRight(frames);
+				std::vector<float> actualLeft(frames), actualRight(frames);
+				reference->deinterleave(src.data(), expectedLeft.data(), expectedRight.data(), frames);
+				tested->deinterleave(src.data(), actualLeft.data(), actualRight.data(), frames);
+				QVERIFY(sameBits(expectedLeft, actualLeft));
+				QVERIFY(sameBits(expectedRight, actualRight));
+
+				expected.assign(frames * 2, 0.0f);
+				actual.assign(frames * 2, 0.0f);
+				reference->interleave(expectedLeft.data(), expectedRight.data(), expected.data(), frames);
+				tested->interleave(actualLeft.data(), actualRight.data(), actual.data(), frames);
+				QVERIFY(sameBits(expected, actual));
+				// the round trip must restore the input
+				QVERIFY(std::memcmp(actual.data(), src.data(), actual.size() * sizeof(float)) == 0);
+			}
+		}
+	}
+
+	void SelectionTests()
+	{
+		QVERIFY(kernels(InstructionSet::Scalar) != nullptr);
+		QCOMPARE(&kernels(), kernels(instructionSet()));
+	}
+
+	void AddSanitizedMultipliedBenchmark_data() { addInstructionSets(true); }
+	void AddSanitizedMultipliedBenchmark()
+	{
+		QFETCH(InstructionSet, set);
+		const KernelTable* tested = kernels(set);
+		if (tested == nullptr) { QSKIP("not supported by this CPU"); }
+
+		std::vector<float> dst(BenchmarkSamples, 0.0f);
+		const std::vector<float> src(BenchmarkSamples, 0.25f);
+		QBENCHMARK
+		{
+			tested->addSanitizedMultiplied(dst.data(), src.data(), 0.5f, BenchmarkSamples);
+		}
+	}
+
+	void SanitizeBenchmark_data() { addInstructionSets(true); }
+	void SanitizeBenchmark()
+	{
+		QFETCH(InstructionSet, set);
+		const KernelTable* tested = kernels(set);
+		if (tested == nullptr) { QSKIP("not supported by this CPU"); }
+
+		std::vector<float> data(BenchmarkSamples, 0.25f);
+		QBENCHMARK
+		{
+			tested->sanitize(data.data(), BenchmarkSamples);
+		}
+	}
+
+	void PeakBenchmark_data() { addInstructionSets(true); }
+	void PeakBenchmark()
+	{
+		QFETCH(InstructionSet, set);
+		const KernelTable* tested = kernels(set);
+		if (tested == nullptr) { QSKIP("not supported by this CPU"); }
+
+		const std::vector<float> data(BenchmarkSamples, 0.25f);
+		float peaks[2] = { 0.0f, 0.0f };
+		QBENCHMARK
+		{
+			tested->peak(data.data(), BenchmarkSamples, peaks);
+		}
+	}
+
+	void DeinterleaveBenchmark_data() { addInstructionSets(true); }
+	void DeinterleaveBenchmark()
+	{
+		QFETCH(InstructionSet, set);
+		const KernelTable* tested = kernels(set);
+		if (tested == nullptr) { QSKIP("not supported by this CPU"); }
+
+		std::vector<float> data(BenchmarkSamples, 0.25f);
+		std::vector<float> left(BenchmarkSamples / 2);
+		std::vector<float> right(BenchmarkSamples / 2);
+		QBENCHMARK
+		{
+			tested->deinterleave(data.data(), left.data(), right.data(), BenchmarkSamples / 2);
+			tested->interleave(left.data(), right.data(), data.data(), BenchmarkSamples / 2);
+		}
+	}
+
+	void ConvertToS16Benchmark_data() { addInstructionSets(true); }
+	void ConvertToS16Benchmark()
+	{
+		QFETCH(InstructionSet, set);
+		const KernelTable* tested = kernels(set);
+		if (tested == nullptr) { QSKIP("not supported by this CPU"); }
+
+		const std::vector<float> data(BenchmarkSamples, 0.25f);
+		std::vector<int16_t> output(BenchmarkSamples);
+		QBENCHMARK
+		{
+			tested->convertToS16(data.data(), BenchmarkSamples, 0.8f, output.data(), false);
+		}
+	}
+
+private:
+	void addInstructionSets(bool withScalar)
+	{
+		QTest::addColumn<InstructionSet>("set");
+		if (withScalar) { QTest::newRow("scalar") << InstructionSet::Scalar; }
+		QTest::newRow("sse2") << InstructionSet::Sse2;
+		QTest::newRow("avx2") << InstructionSet::Avx2;
+		QTest::newRow("avx512") << InstructionSet::Avx512;
+	}
+} MixKernelsTests;
+
+#include "MixKernelsTest.moc"
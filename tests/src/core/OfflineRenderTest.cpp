@@ -0,0 +1,118 @@
+/*
+ * OfflineRenderTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "AudioEngine.h"
+#include "AutomatableModel.h"
+#include "AutomationClip.h"
+#include "AutomationTrack.h"
+#include "Engine.h"
+#include "Mixer.h"
+#include "RenderManager.h"
+#include "Song.h"
+
+class OfflineRenderTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	//! Several automation ticks in one period must all show up in the
+	//! value buffer, as they do with large render blocks
+	void SubBlockAutomationTests()
+	{
+		using namespace lmms;
+
+		FloatModel model(0.0f, 0.0f, 1.0f);
+		const fpp_t half = Engine::audioEngine()->framesPerPeriod() / 2;
+
+		// keep the render thread from starting the next period
+		Engine::audioEngine()->requestChangeInModel();
+		model.setAutomatedValue(0.5f, 0);
+		model.setAutomatedValue(1.0f, half);
+		const ValueBuffer* values = model.valueBuffer();
+		Engine::audioEngine()->doneChangeInModel();
+
+		QVERIFY(values != nullptr);
+		QCOMPARE(values->value(0), 0.0f);
+		QCOMPARE(values->value(half / 2), 0.25f);
+		QCOMPARE(values->value(half), 0.5f);
+		QCOMPARE(values->value(half + half / 2), 0.75f);
+		QCOMPARE(model.value(), 1.0f);
+	}
+
+	//! A tick inside the period holds the old value until the tick
+	void MidPeriodAutomationTests()
+	{
+		using namespace lmms;
+
+		FloatModel model(0.0f, 0.0f, 1.0f);
+		const fpp_t half = Engine::audioEngine()->framesPerPeriod() / 2;
+
+		Engine::audioEngine()->requestChangeInModel();
+		model.setAutomatedValue(1.0f, half);
+		const ValueBuffer* values = model.valueBuffer();
+		Engine::audioEngine()->doneChangeInModel();
+
+		QVERIFY(values != nullptr);
+		QCOMPARE(values->value(half - 1), 0.0f);
+		QCOMPARE(values->value(half), 0.0f);
+		QCOMPARE(values->value(half + half / 2), 0.5f);
+	}
+
+	//! Export 17 bars of automated master volume. Compare the block sizes
+	//! by running the tests with e.g. LMMS_RENDER_BLOCK_SIZE=4096.
+	void ExportBenchmark()
+	{
+		using namespace lmms;
+
+		QTemporaryDir dir;
+		QVERIFY(dir.isValid());
+
+		auto song = Engine::getSong();
+		AutomationTrack track(song);
+		AutomationClip clip(&track);
+		clip.setProgressionType(AutomationClip::LinearProgression);
+		clip.putValue(TimePos(0, 0), 0.5f, false);
+		clip.putValue(TimePos(16, 0), 1.5f, false);
+		clip.movePosition(0);
+		clip.addObject(&Engine::mixer()->mixerChannel(0)->m_volumeModel);
+
+		const AudioEngine::qualitySettings qs(AudioEngine::qualitySettings::Mode_Draft);
+		const OutputSettings os(44100, OutputSettings::BitRateSettings(160, false), OutputSettings::Depth_16Bit,
+			OutputSettings::StereoMode_JointStereo);
+
+		QBENCHMARK
+		{
+			RenderManager manager(qs, os, ProjectRenderer::WaveFile, dir.filePath("export.wav"));
+			QSignalSpy finished(&manager, SIGNAL(finished()));
+			manager.renderProject();
+			QVERIFY(finished.wait(120000));
+		}
+	}
+} OfflineRenderTests;
+
+#include "OfflineRenderTest.moc"
@@ -0,0 +1,190 @@
+/*
+ * RemotePluginAudioSyncTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "RemotePluginAudioSync.h"
+#include "SharedMemory.h"
+
+#include <QUuid>
+
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+#include <sys/socket.h>
+#include <sys/wait.h>
+#endif
+
+class RemotePluginAudioSyncTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void MidiEventQueueTests()
+	{
+		using namespace lmms;
+
+		SharedMemory<RemotePluginAudioSync> sync;
+		sync.create(QUuid::createUuid().toString().toStdString());
+
+		RemotePluginMidiEvent event;
+		QVERIFY(!sync->popMidiEvent(event, sync->midiEventsEnd()));
+
+		// wrap around a few times, the queue must keep the order
+		int32_t written = 0;
+		int32_t read = 0;
+		for (int round = 0; round < 5; ++round)
+		{
+			while (sync->pushMidiEvent(RemotePluginMidiEvent{0, 0, written, 0, written}))
+			{
+				++written;
+			}
+			QCOMPARE(written - read, static_cast<int32_t>(RemotePluginAudioSync::MidiEventCapacity));
+
+			sync->requestProcessing();
+			const uint32_t end = sync->midiEventsEnd();
+			for (uint32_t i = 0; i < RemotePluginAudioSync::MidiEventCapacity / 2 + round; ++i)
+			{
+				QVERIFY(sync->popMidiEvent(event, end));
+				QCOMPARE(event.param0, read);
+				++read;
+			}
+		}
+		sync->requestProcessing();
+		while (sync->popMidiEvent(event, sync->midiEventsEnd()))
+		{
+			QCOMPARE(event.param0, read);
+			++read;
+		}
+		QCOMPARE(read, written);
+	}
+
+	//! Events pushed while the client handles a request belong to the next one
+	void MidiEventsAfterRequestTests()
+	{
+		using namespace lmms;
+
+		SharedMemory<RemotePluginAudioSync> sync;
+		sync.create(QUuid::createUuid().toString().toStdString());
+
+		QVERIFY(sync->pushMidiEvent(RemotePluginMidiEvent{0, 0, 1, 0, 0}));
+		QVERIFY(sync->pushMidiEvent(RemotePluginMidiEvent{0, 0, 2, 0, 0}));
+		sync->requestProcessing();
+		QVERIFY(sync->pushMidiEvent(RemotePluginMidiEvent{0, 0, 3, 0, 0}));
+
+		RemotePluginMidiEvent event;
+		uint32_t end = sync->midiEventsEnd();
+		QVERIFY(sync->popMidiEvent(event, end));
+		QCOMPARE(event.param0, 1);
+		QVERIFY(sync->popMidiEvent(event, end));
+		QCOMPARE(event.param0, 2);
+		QVERIFY(!sync->popMidiEvent(event, end));
+
+		sync->requestProcessing();
+		end = sync->midiEventsEnd();
+		QVERIFY(sync->popMidiEvent(event, end));
+		QCOMPARE(event.param0, 3);
+		QVERIFY(!sync->popMidiEvent(event, end));
+	}
+
+	//! Baseline: a message round trip over a local socket, like
+	//! RemotePlugin::process() does without the audio sync
+	void MessageRoundTripBenchmark()
+	{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+		int sockets[2];
+		QVERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, sockets) == 0);
+
+		const pid_t child = fork();
+		QVERIFY(child != -1);
+		if (child == 0)
+		{
+			// echo message headers (id and argument count) until the host quits
+			int32_t header[2];
+			while (read(sockets[1], header, sizeof(header)) == sizeof(header) && header[0] != 0)
+			{
+				if (write(sockets[1], header, sizeof(header)) != sizeof(header)) { break; }
+			}
+			_exit(0);
+		}
+
+		int32_t header[2] = { 1, 0 };
+		QBENCHMARK
+		{
+			QVERIFY(write(sockets[0], header, sizeof(header)) == sizeof(header));
+			QVERIFY(read(sockets[0], header, sizeof(header)) == sizeof(header));
+		}
+
+		header[0] = 0;
+		QVERIFY(write(sockets[0], header, sizeof(header)) == sizeof(header));
+		waitpid(child, nullptr, 0);
+		close(sockets[0]);
+		close(sockets[1]);
+#else
+		QSKIP("the audio sync handshake is not supported on this platform");
+#endif
+	}
+
+	//! A period handshake with one MIDI event through shared memory
+	void AudioSyncRoundTripBenchmark()
+	{
+#ifdef LMMS_HAVE_REMOTE_PLUGIN_AUDIO_SYNC
+		using namespace lmms;
+
+		SharedMemory<RemotePluginAudioSync> sync;
+		sync.create(QUuid::createUuid().toString().toStdString());
+
+		// the child shares the mapping, just like an attached client would
+		const pid_t child = fork();
+		QVERIFY(child != -1);
+		if (child == 0)
+		{
+			uint32_t handled = 0;
+			uint32_t request;
+			RemotePluginMidiEvent event;
+			while (!RemotePluginAudioSync::atomic(sync->quit).load())
+			{
+				if (sync->waitForRequest(handled, request, 500))
+				{
+					while (sync->popMidiEvent(event, sync->midiEventsEnd())) {}
+					sync->processingDone(request);
+					handled = request;
+				}
+			}
+			_exit(0);
+		}
+
+		const auto event = RemotePluginMidiEvent{0x90, 0, 60, 100, 0};
+		QBENCHMARK
+		{
+			QVERIFY(sync->pushMidiEvent(event));
+			QVERIFY(sync->waitForProcessing(sync->requestProcessing(), 1000));
+		}
+
+		sync->requestQuit();
+		waitpid(child, nullptr, 0);
+#else
+		QSKIP("the audio sync handshake is not supported on this platform");
+#endif
+	}
+} RemotePluginAudioSyncTests;
+
+#include "RemotePluginAudioSyncTest.moc"
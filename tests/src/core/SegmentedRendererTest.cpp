@@ -0,0 +1,162 @@
+/*
+ * SegmentedRendererTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <cmath>
+#include <vector>
+
+#include <QTemporaryDir>
+
+#include <sndfile.h>
+
+#include "SegmentedRenderer.h"
+
+using namespace lmms;
+
+namespace
+{
+
+constexpr sample_rate_t SampleRate = 44100;
+
+//! Write stereo frames as 32 bit float file, like the segment processes do
+bool writeFile(const QString& path, const std::vector<sampleFrame>& frames, sample_rate_t sampleRate = SampleRate)
+{
+	SF_INFO info = {};
+	info.samplerate = static_cast<int>(sampleRate);
+	info.channels = DEFAULT_CHANNELS;
+	info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+	SNDFILE* file = sf_open(path.toLocal8Bit().constData(), SFM_WRITE, &info);
+	if (file == nullptr) { return false; }
+	const sf_count_t written = sf_writef_float(file, frames.front().data(), static_cast<sf_count_t>(frames.size()));
+	sf_close(file);
+	return written == static_cast<sf_count_t>(frames.size());
+}
+
+//! What a serial render of a song gives
+std::vector<sampleFrame> render(f_cnt_t frames)
+{
+	std::vector<sampleFrame> result(frames);
+	for (f_cnt_t f = 0; f < frames; ++f)
+	{
+		result[f] = { std::sin(f * 0.01f), 0.5f * std::cos(f * 0.003f) };
+	}
+	return result;
+}
+
+} // namespace
+
+
+class SegmentedRendererTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	//! Segments rendering the same material as a serial render, each
+	//! running on into the next one by the crossfade, are joined into it
+	void SpliceTests()
+	{
+		QTemporaryDir dir;
+		QVERIFY(dir.isValid());
+
+		constexpr f_cnt_t Length = 10000;
+		const std::vector<sampleFrame> song = render(Length);
+		const f_cnt_t starts[] = { 0, 3000, 7100, Length };
+
+		for (f_cnt_t crossfade : { 0, 500 })
+		{
+			QStringList files;
+			for (int i = 0; i < 3; ++i)
+			{
+				const f_cnt_t end = i < 2 ? starts[i + 1] + crossfade : Length;
+				files << dir.filePath(QString("segment-%1-%2.wav").arg(crossfade).arg(i));
+				QVERIFY(writeFile(files.back(), std::vector<sampleFrame>(song.begin() + starts[i], song.begin() + end)));
+			}
+
+			std::vector<surroundSampleFrame> spliced;
+			const QString error = SegmentedRenderer::spliceFiles(files, crossfade,
+				[&spliced](const surroundSampleFrame* frames, f_cnt_t count)
+				{
+					spliced.insert(spliced.end(), frames, frames + count);
+				});
+			QVERIFY(error.isEmpty());
+
+			QCOMPARE(static_cast<f_cnt_t>(spliced.size()), Length);
+			for (f_cnt_t f = 0; f < Length; ++f)
+			{
+				for (ch_cnt_t ch = 0; ch < DEFAULT_CHANNELS; ++ch)
+				{
+					// crossfading a sample with itself may round off its last bit
+					QVERIFY(std::abs(spliced[f][ch] - song[f][ch]) <= 1e-6f);
+				}
+			}
+		}
+
+		QVERIFY(!SegmentedRenderer::spliceFiles({ dir.filePath("missing.wav") }, 0,
+			[](const surroundSampleFrame*, f_cnt_t) {}).isEmpty());
+	}
+
+	void CompareTests()
+	{
+		QTemporaryDir dir;
+		QVERIFY(dir.isValid());
+
+		const QString reference = dir.filePath("reference.wav");
+		QVERIFY(writeFile(reference, std::vector<sampleFrame>(1000, sampleFrame{})));
+
+		std::vector<sampleFrame> frames(1010, sampleFrame{});
+		frames[100][0] = 0.5f;
+		frames[200][1] = -0.25f;
+		// beyond the reference, so only the length differs
+		frames[1005][0] = 1.0f;
+		const QString file = dir.filePath("file.wav");
+		QVERIFY(writeFile(file, frames));
+
+		auto difference = SegmentedRenderer::compare(reference, file);
+		QVERIFY(difference.error.isEmpty());
+		QCOMPARE(difference.sampleRate, SampleRate);
+		QCOMPARE(difference.frames, f_cnt_t{1000});
+		QCOMPARE(difference.lengthDifference, f_cnt_t{10});
+		QCOMPARE(difference.peak, 0.5);
+		QCOMPARE(difference.rms, std::sqrt((0.5 * 0.5 + 0.25 * 0.25) / (1000 * 2)));
+		QCOMPARE(difference.firstDifferentFrame, f_cnt_t{100});
+
+		// the threshold only affects the first differing frame
+		difference = SegmentedRenderer::compare(reference, file, 0.4);
+		QCOMPARE(difference.firstDifferentFrame, f_cnt_t{100});
+		difference = SegmentedRenderer::compare(reference, file, 0.6);
+		QCOMPARE(difference.firstDifferentFrame, f_cnt_t{-1});
+		QCOMPARE(difference.peak, 0.5);
+
+		difference = SegmentedRenderer::compare(reference, reference);
+		QCOMPARE(difference.peak, 0.0);
+		QCOMPARE(difference.rms, 0.0);
+		QCOMPARE(difference.firstDifferentFrame, f_cnt_t{-1});
+
+		const QString otherRate = dir.filePath("other-rate.wav");
+		QVERIFY(writeFile(otherRate, std::vector<sampleFrame>(1000, sampleFrame{}), 48000));
+		QVERIFY(!SegmentedRenderer::compare(reference, otherRate).error.isEmpty());
+	}
+} SegmentedRendererTests;
+
+#include "SegmentedRendererTest.moc"
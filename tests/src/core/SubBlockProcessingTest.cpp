@@ -0,0 +1,314 @@
+/*
+ * SubBlockProcessingTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include "PolyphaseResampler.h"
+#include "SubBlockSplitter.h"
+#include "lmms_constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace lmms;
+
+namespace
+{
+
+constexpr fpp_t Period = 256;
+constexpr float SampleRate = 44100.f;
+//! Periods of the cutoff sweep the accuracy is measured over, one second
+constexpr int SweepPeriods = 172;
+constexpr float MinCutoff = 20.f;
+constexpr float MaxCutoff = 20000.f;
+//! Block size standing for running the filter once per frame
+constexpr int EveryFrame = -1;
+
+//! Stands in for a plugin with a control rate cutoff port: the coefficient
+//! is calculated once per run, like plugins do when their controls change
+struct OnePole
+{
+	float state = 0.f;
+
+	void run(const float* in, float* out, fpp_t frames, float cutoff)
+	{
+		const float coefficient = 1.f - std::exp(-2.f * F_PI * cutoff / SampleRate);
+		for (fpp_t f = 0; f < frames; ++f)
+		{
+			state += coefficient * (in[f] - state);
+			out[f] = state;
+		}
+	}
+} ;
+
+//! Run @p filter on a period the way the hosts do
+void process(OnePole& filter, SubBlockSplitter& splitter, int blockFrames,
+	const float* in, const float* cutoff, float* out)
+{
+	if (blockFrames == EveryFrame)
+	{
+		for (fpp_t f = 0; f < Period; ++f)
+		{
+			filter.run(in + f, out + f, 1, cutoff[f]);
+		}
+		return;
+	}
+
+	splitter.clear();
+	splitter.addControl(cutoff, SubBlockSplitter::DefaultTolerance * (MaxCutoff - MinCutoff));
+	const std::size_t blocks = splitter.split(Period);
+	for (std::size_t block = 0; block < blocks; ++block)
+	{
+		const fpp_t from = splitter.blockStart(block);
+		filter.run(in + from, out + from, splitter.blockEnd(block) - from, cutoff[from]);
+	}
+}
+
+//! An exponential sweep over all periods, as automation would produce it
+std::vector<float> sweep()
+{
+	std::vector<float> cutoff(static_cast<std::size_t>(Period) * SweepPeriods);
+	for (std::size_t f = 0; f < cutoff.size(); ++f)
+	{
+		cutoff[f] = MinCutoff * std::pow(MaxCutoff / MinCutoff, static_cast<float>(f) / cutoff.size());
+	}
+	return cutoff;
+}
+
+std::vector<float> noise(std::size_t frames)
+{
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+	std::vector<float> samples(frames);
+	for (float& sample : samples) { sample = distribution(generator); }
+	return samples;
+}
+
+//! The sweep processed with @p blockFrames
+std::vector<float> render(int blockFrames, const std::vector<float>& in, const std::vector<float>& cutoff)
+{
+	SubBlockSplitter splitter(blockFrames == EveryFrame ? 0 : blockFrames);
+	OnePole filter;
+	std::vector<float> out(in.size());
+	for (std::size_t offset = 0; offset < in.size(); offset += Period)
+	{
+		process(filter, splitter, blockFrames, in.data() + offset, cutoff.data() + offset, out.data() + offset);
+	}
+	return out;
+}
+
+//! Level of the difference of @p a and @p b relative to @p b, in dB
+double errorLevel(const std::vector<float>& a, const std::vector<float>& b)
+{
+	double error = 0.;
+	double signal = 0.;
+	for (std::size_t f = 0; f < a.size(); ++f)
+	{
+		error += (a[f] - b[f]) * (a[f] - b[f]);
+		signal += b[f] * b[f];
+	}
+	return error > 0. ? 10. * std::log10(error / signal) : -std::numeric_limits<double>::infinity();
+}
+
+std::vector<sampleFrame> sine(std::size_t frames, float frequency, float sampleRate)
+{
+	std::vector<sampleFrame> samples(frames);
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		samples[f][0] = samples[f][1] = 0.5f * std::sin(2.f * F_PI * frequency * f / sampleRate);
+	}
+	return samples;
+}
+
+} // namespace
+
+
+class SubBlockProcessingTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void SplitterTests()
+	{
+		std::vector<float> values(Period, 0.5f);
+
+		// unchanged controls don't split
+		SubBlockSplitter splitter(32);
+		splitter.addControl(values.data(), 0.001f);
+		QCOMPARE(splitter.split(Period), std::size_t{1});
+		QCOMPARE(splitter.blockStart(0), fpp_t{0});
+		QCOMPARE(splitter.blockEnd(0), Period);
+
+		// a step is followed at the next multiple of the granularity
+		std::fill(values.begin() + 100, values.end(), 1.f);
+		QCOMPARE(splitter.split(Period), std::size_t{2});
+		QCOMPARE(splitter.blockEnd(0), fpp_t{128});
+		QCOMPARE(splitter.blockEnd(1), Period);
+
+		// a ramp moving more than the tolerance per block splits everywhere
+		for (fpp_t f = 0; f < Period; ++f) { values[f] = static_cast<float>(f) / Period; }
+		QCOMPARE(splitter.split(Period), std::size_t{Period / 32});
+		for (std::size_t block = 0; block < Period / 32; ++block)
+		{
+			QCOMPARE(splitter.blockStart(block), static_cast<fpp_t>(block * 32));
+		}
+
+		// but only as often as needed to stay within a larger tolerance
+		splitter.clear();
+		splitter.addControl(values.data(), 0.2f);
+		QCOMPARE(splitter.split(Period), std::size_t{4});
+
+		// the granularity is clamped, 0 disables splitting
+		QCOMPARE(SubBlockSplitter(1).blockFrames(), SubBlockSplitter::MinBlockFrames);
+		QCOMPARE(SubBlockSplitter(1000).blockFrames(), SubBlockSplitter::MaxBlockFrames);
+		SubBlockSplitter disabled(0);
+		disabled.addControl(values.data(), 0.f);
+		QCOMPARE(disabled.split(Period), std::size_t{1});
+	}
+
+	void AccuracyTests()
+	{
+		const std::vector<float> cutoff = sweep();
+		const std::vector<float> in = noise(cutoff.size());
+		const std::vector<float> reference = render(EveryFrame, in, cutoff);
+
+		// finer blocks must follow the automation more closely
+		double last = errorLevel(render(0, in, cutoff), reference);
+		for (int blockFrames : { 64, 32, 16 })
+		{
+			const double level = errorLevel(render(blockFrames, in, cutoff), reference);
+			QVERIFY(level < last);
+			last = level;
+		}
+	}
+
+	void ResamplerFrameCountTests()
+	{
+		for (sample_rate_t dstRate : { 48000u, 44100u, 22050u })
+		{
+			PolyphaseResampler resampler(96000, dstRate);
+			const std::vector<sampleFrame> in(Period);
+			std::vector<sampleFrame> out(resampler.maxOutput(Period));
+
+			f_cnt_t total = 0;
+			for (int period = 0; period < 1000; ++period)
+			{
+				const f_cnt_t frames = resampler.process(in.data(), Period, out.data());
+				QVERIFY(frames <= resampler.maxOutput(Period));
+				total += frames;
+			}
+			// no frame must get lost over time
+			const f_cnt_t expected = static_cast<f_cnt_t>(1000ull * Period * dstRate / 96000);
+			QVERIFY(std::abs(static_cast<long>(total) - static_cast<long>(expected)) <= 1);
+		}
+	}
+
+	void ResamplerAccuracyTests()
+	{
+		// down and back up, as Effect does for plugins with a limited rate
+		PolyphaseResampler down(96000, 44100);
+		PolyphaseResampler up(44100, 96000);
+
+		const std::size_t frames = 96000 / 4;
+		const std::vector<sampleFrame> in = sine(frames, 1000.f, 96000.f);
+		std::vector<sampleFrame> middle(down.maxOutput(frames));
+		middle.resize(down.process(in.data(), frames, middle.data()));
+		std::vector<sampleFrame> out(up.maxOutput(middle.size()));
+		out.resize(up.process(middle.data(), middle.size(), out.data()));
+
+		// compare with the input, delayed by the latency of both filters
+		const double latency = down.latency() + up.latency() * up.ratio();
+		const auto delay = static_cast<std::size_t>(std::lround(latency));
+		double error = 0.;
+		for (std::size_t f = frames / 2; f < out.size(); ++f)
+		{
+			error = std::max<double>(error, std::abs(out[f][0] - in[f - delay][0]));
+		}
+		// rounding the delay to whole frames is the largest part of that
+		QVERIFY(error < 0.02);
+
+		// content above the lower Nyquist frequency is removed
+		PolyphaseResampler filter(96000, 44100);
+		const std::vector<sampleFrame> high = sine(frames, 30000.f, 96000.f);
+		middle.resize(filter.maxOutput(frames));
+		middle.resize(filter.process(high.data(), frames, middle.data()));
+		double peak = 0.;
+		for (std::size_t f = middle.size() / 2; f < middle.size(); ++f)
+		{
+			peak = std::max<double>(peak, std::abs(middle[f][0]));
+		}
+		QVERIFY(peak < 0.005);
+	}
+
+	void SubBlockBenchmark_data()
+	{
+		QTest::addColumn<int>("blockFrames");
+		QTest::newRow("whole period") << 0;
+		QTest::newRow("64 frames") << 64;
+		QTest::newRow("32 frames") << 32;
+		QTest::newRow("16 frames") << 16;
+		QTest::newRow("every frame") << EveryFrame;
+	}
+
+	//! CPU cost of a period with a fast cutoff sweep, together with the
+	//! error of the whole sweep against running the filter every frame
+	void SubBlockBenchmark()
+	{
+		QFETCH(int, blockFrames);
+
+		const std::vector<float> cutoff = sweep();
+		const std::vector<float> in = noise(cutoff.size());
+		const double level = errorLevel(render(blockFrames, in, cutoff), render(EveryFrame, in, cutoff));
+		qInfo("error: %.1f dB", level);
+
+		// the middle of the sweep, where the cutoff moves fastest in Hz
+		const std::size_t offset = static_cast<std::size_t>(Period) * (SweepPeriods / 2);
+		SubBlockSplitter splitter(blockFrames == EveryFrame ? 0 : blockFrames);
+		OnePole filter;
+		std::vector<float> out(Period);
+		QBENCHMARK
+		{
+			process(filter, splitter, blockFrames, in.data() + offset, cutoff.data() + offset, out.data());
+		}
+	}
+
+	void ResamplerBenchmark()
+	{
+		PolyphaseResampler down(96000, 44100);
+		PolyphaseResampler up(44100, 96000);
+		const std::vector<sampleFrame> in = sine(Period, 1000.f, 96000.f);
+		std::vector<sampleFrame> middle(down.maxOutput(Period));
+		std::vector<sampleFrame> out(up.maxOutput(middle.size()));
+		QBENCHMARK
+		{
+			const f_cnt_t frames = down.process(in.data(), Period, middle.data());
+			up.process(middle.data(), frames, out.data());
+		}
+	}
+} SubBlockProcessingTests;
+
+#include "SubBlockProcessingTest.moc"
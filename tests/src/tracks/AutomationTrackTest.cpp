@@ -79,6 +79,40 @@ private slots:
 		QCOMPARE(c.valueAt(150), 1.0f);
 	}
 
+	void testClipCurve()
+	{
+		using namespace lmms;
+
+		AutomationClip c(nullptr);
+		c.setProgressionType(AutomationClip::CubicHermiteProgression);
+		c.putValue(0, 0.0, false);
+		c.putValue(100, 1.0, false);
+		c.putValue(300, 0.5, false);
+
+		// the finest resolution has every value
+		auto curve = c.curve(1.0f);
+		QCOMPARE(curve->segments().size(), std::size_t(2));
+		for (const auto& segment : curve->segments())
+		{
+			QCOMPARE(curve->begin(segment)->tick, segment.begin);
+			QCOMPARE((curve->end(segment) - 1)->tick, segment.end);
+			for (auto point = curve->begin(segment) + 1; point != curve->end(segment); ++point)
+			{
+				QCOMPARE(point->value, c.valueAt(point->tick));
+			}
+		}
+
+		// coarser ones are shared until the nodes change
+		auto coarse = c.curve(20.0f);
+		QCOMPARE(coarse->ticksPerPoint(), 16);
+		QVERIFY(coarse->end(coarse->segments()[1]) - coarse->begin(coarse->segments()[1]) < 20);
+		QCOMPARE(c.curve(20.0f), coarse);
+
+		c.putValue(200, 0.0, false);
+		QVERIFY(c.curve(20.0f) != coarse);
+		QCOMPARE(c.curve(20.0f)->segments().size(), std::size_t(3));
+	}
+
 	void testClips()
 	{
 		using namespace lmms;
@@ -0,0 +1,233 @@
+/*
+ * InstrumentTrackTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "ConfigManager.h"
+#include "DataFile.h"
+#include "EffectChain.h"
+#include "InstrumentTrack.h"
+#include "PluginFactory.h"
+
+#include "Engine.h"
+#include "Song.h"
+
+using namespace lmms;
+
+namespace
+{
+
+//! Settings no plugin could restore, so they only survive if the plugins
+//! are never instantiated
+const char* const SavedInstrument =
+	"<instrument name=\"deferredsynth\"><deferredsynth cutoff=\"1234\"/></instrument>";
+const char* const SavedEffects =
+	"<fxchain enabled=\"0\" numofeffects=\"1\">"
+	"<effect name=\"deferredeffect\"><deferredeffectcontrols gain=\"3\"/><key/></effect>"
+	"</fxchain>";
+
+QDomElement parseElement(const char* xml)
+{
+	QDomDocument doc;
+	doc.setContent(QString(xml));
+	return doc.documentElement();
+}
+
+//! Save a song with @p tracks muted tracks playing @p instrument. With
+//! @p replace, the plugins of the first one are replaced by the ones above.
+void saveMutedTracks(const QString& fileName, int tracks, const QString& instrument,
+	bool replace)
+{
+	Song* song = Engine::getSong();
+	song->clearProject();
+	for (int i = 0; i < tracks; ++i)
+	{
+		auto track = dynamic_cast<InstrumentTrack*>(Track::create(Track::InstrumentTrack, song));
+		track->loadInstrument(instrument);
+		track->setName(QString("Muted %1").arg(i));
+		track->setMuted(true);
+	}
+	QVERIFY(song->saveProjectFile(fileName));
+
+	if (!replace) { return; }
+
+	DataFile dataFile(fileName);
+	QDomElement settings = dataFile.elementsByTagName("instrumenttrack").item(0).toElement();
+	QVERIFY(!settings.isNull());
+	settings.replaceChild(dataFile.importNode(parseElement(SavedInstrument), true),
+		settings.firstChildElement("instrument"));
+	settings.replaceChild(dataFile.importNode(parseElement(SavedEffects), true),
+		settings.firstChildElement("fxchain"));
+	QVERIFY(dataFile.writeFile(fileName));
+}
+
+InstrumentTrack* firstInstrumentTrack()
+{
+	for (Track* track : Engine::getSong()->tracks())
+	{
+		if (auto instrumentTrack = dynamic_cast<InstrumentTrack*>(track)) { return instrumentTrack; }
+	}
+	return nullptr;
+}
+
+//! The resident set size of the process
+std::size_t residentBytes()
+{
+#ifdef Q_OS_LINUX
+	QFile statm("/proc/self/statm");
+	if (!statm.open(QIODevice::ReadOnly)) { return 0; }
+	const QList<QByteArray> pages = statm.readAll().split(' ');
+	return pages.size() > 1 ? pages[1].toULongLong() * sysconf(_SC_PAGESIZE) : 0;
+#else
+	return 0;
+#endif
+}
+
+} // namespace
+
+class InstrumentTrackTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void initTestCase()
+	{
+		m_lazyPlugins = ConfigManager::inst()->value("app", "lazyplugins", "1");
+		ConfigManager::inst()->setValue("app", "lazyplugins", "1");
+	}
+
+	void cleanupTestCase()
+	{
+		ConfigManager::inst()->setValue("app", "lazyplugins", m_lazyPlugins);
+		Engine::getSong()->clearProject();
+	}
+
+	void DeferredPluginRoundTripTest()
+	{
+		QTemporaryDir dir;
+		const QString fileName = dir.filePath("deferred.mmp");
+		saveMutedTracks(fileName, 1, "tripleoscillator", true);
+
+		Engine::getSong()->loadProject(fileName);
+		InstrumentTrack* track = firstInstrumentTrack();
+		QVERIFY(track != nullptr);
+		QVERIFY(track->isMuted());
+		QVERIFY(track->hasPendingInstrument());
+		QVERIFY(track->instrument() == nullptr);
+		QVERIFY(track->audioPort()->effects()->hasPendingEffects());
+
+		// the plugins are saved just as they were loaded
+		QDomDocument doc;
+		QDomElement parent = doc.createElement("test");
+		doc.appendChild(parent);
+		track->saveState(doc, parent);
+		const QDomElement settings = parent.firstChildElement("track").firstChildElement("instrumenttrack");
+		const QDomElement instrument = settings.firstChildElement("instrument");
+		QCOMPARE(instrument.attribute("name"), QString("deferredsynth"));
+		QCOMPARE(instrument.firstChildElement("deferredsynth").attribute("cutoff"), QString("1234"));
+		const QDomElement effects = settings.firstChildElement("fxchain");
+		QCOMPARE(effects.attribute("numofeffects"), QString("1"));
+		QCOMPARE(effects.firstChildElement("effect").firstChildElement("deferredeffectcontrols")
+			.attribute("gain"), QString("3"));
+	}
+
+	void InstantiateOnUnmuteTest()
+	{
+		QTemporaryDir dir;
+		const QString fileName = dir.filePath("unmute.mmp");
+		saveMutedTracks(fileName, 1, "tripleoscillator", true);
+
+		Engine::getSong()->loadProject(fileName);
+		InstrumentTrack* track = firstInstrumentTrack();
+		QVERIFY(track != nullptr);
+		QVERIFY(track->hasPendingInstrument());
+
+		// missing plugins are instantiated right away, others in the background
+		QSignalSpy instrumentChanged(track, SIGNAL(instrumentChanged()));
+		track->setMuted(false);
+		QVERIFY(instrumentChanged.count() > 0 || instrumentChanged.wait());
+		QVERIFY(!track->hasPendingInstrument());
+		QVERIFY(track->instrument() != nullptr);
+
+		// the effects wait for the chain to be enabled
+		QVERIFY(track->audioPort()->effects()->hasPendingEffects());
+	}
+
+	//! Compares the time and memory it takes to open a project with muted
+	//! tracks with and without deferring their instruments
+	void ProjectOpenBenchmark()
+	{
+		constexpr int Tracks = 32;
+		const QString instrument = "tripleoscillator";
+		if (getPluginFactory()->pluginInfo(instrument.toUtf8()).isNull())
+		{
+			QSKIP("The instrument plugins weren't found");
+		}
+
+		QTemporaryDir dir;
+		const QString fileName = dir.filePath("benchmark.mmp");
+		saveMutedTracks(fileName, Tracks, instrument, false);
+
+		const auto openProject = [&](const char* lazy, qint64& elapsed, std::size_t& resident)
+		{
+			ConfigManager::inst()->setValue("app", "lazyplugins", lazy);
+			Engine::getSong()->clearProject();
+			const std::size_t before = residentBytes();
+			QElapsedTimer timer;
+			timer.start();
+			Engine::getSong()->loadProject(fileName);
+			elapsed = timer.nsecsElapsed();
+			const std::size_t after = residentBytes();
+			resident = after > before ? after - before : 0;
+		};
+
+		qint64 eagerTime, lazyTime;
+		std::size_t eagerResident, lazyResident;
+		// the first project opened loads the plugin libraries
+		openProject("0", eagerTime, eagerResident);
+		openProject("0", eagerTime, eagerResident);
+		openProject("1", lazyTime, lazyResident);
+		ConfigManager::inst()->setValue("app", "lazyplugins", "1");
+
+		QVERIFY(firstInstrumentTrack() != nullptr);
+		QVERIFY(firstInstrumentTrack()->hasPendingInstrument());
+		qInfo("Opening a project with %d muted tracks: %.1f ms and %zu KiB more resident "
+			"instantiating them, %.1f ms and %zu KiB more resident deferring them",
+			Tracks, eagerTime / 1e6, eagerResident / 1024, lazyTime / 1e6, lazyResident / 1024);
+	}
+
+private:
+	QString m_lazyPlugins;
+} InstrumentTrackTests;
+
+#include "InstrumentTrackTest.moc"
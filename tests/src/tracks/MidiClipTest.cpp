@@ -0,0 +1,300 @@
+/*
+ * MidiClipTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <random>
+#ifdef __GLIBC__
+#include <malloc.h>
+#if __GLIBC_PREREQ(2, 33)
+#define HAS_MALLINFO2
+#endif
+#endif
+
+#include <QDomDocument>
+
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "NoteArena.h"
+#include "TrackContainer.h"
+
+#include "Engine.h"
+#include "Song.h"
+
+using namespace lmms;
+
+namespace
+{
+
+//! Notes of the clip the benchmark edits, about what a dense orchestral
+//! MIDI file has on one track
+constexpr int DenseNotes = 50000;
+//! Ticks the piano roll shows at its default zoom
+constexpr int VisibleTicks = 4 * DefaultTicksPerBar;
+
+MidiClip* createClip()
+{
+	auto track = dynamic_cast<InstrumentTrack*>(Track::create(Track::InstrumentTrack, Engine::getSong()));
+	return dynamic_cast<MidiClip*>(track->createClip(0));
+}
+
+//! Fill @p clip with @p count random notes, loaded at once like a project
+void fill(MidiClip* clip, int count, std::mt19937& generator)
+{
+	std::uniform_int_distribution<int> key(24, 96);
+	std::uniform_int_distribution<int> step(0, 8);
+	std::uniform_int_distribution<int> length(-1, 4 * DefaultTicksPerBar / 4);
+
+	QDomDocument doc;
+	QDomElement element = doc.createElement(clip->nodeName());
+	element.setAttribute("type", MidiClip::MelodyClip);
+	int pos = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		pos += step(generator);
+		// a few step notes, which have a negative length
+		const int len = length(generator);
+		Note(TimePos(len < 0 ? -DefaultTicksPerBar : len), TimePos(pos), key(generator)).saveState(doc, element);
+	}
+	clip->loadSettings(element);
+}
+
+//! What the piano roll did before it used the index
+NoteVector scan(const MidiClip* clip, tick_t from, tick_t to, int lowKey, int highKey)
+{
+	NoteVector result;
+	for (Note* note : clip->notes())
+	{
+		const tick_t length = note->length() < 0 ? NoteIndex::StepNoteLength : static_cast<tick_t>(note->length());
+		if (note->key() >= lowKey && note->key() <= highKey && note->pos() <= to && note->pos() + length >= from)
+		{
+			result.push_back(note);
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+
+class MidiClipTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void NoteIndexTests()
+	{
+		std::mt19937 generator(1);
+		MidiClip* clip = createClip();
+		fill(clip, 2000, generator);
+
+		const auto compare = [&]
+		{
+			std::uniform_int_distribution<int> tick(-DefaultTicksPerBar, clip->length());
+			std::uniform_int_distribution<int> key(0, NumKeys - 1);
+			for (int query = 0; query < 200; ++query)
+			{
+				const int from = tick(generator);
+				const int to = from + tick(generator) / 8;
+				int lowKey = key(generator);
+				int highKey = key(generator);
+				if (lowKey > highKey) { std::swap(lowKey, highKey); }
+				QCOMPARE(clip->notesInRange(from, to, lowKey, highKey), scan(clip, from, to, lowKey, highKey));
+			}
+		};
+		compare();
+
+		// notes moved in place, like the piano roll does while dragging
+		std::uniform_int_distribution<int> index(0, clip->notes().size() - 1);
+		for (int i = 0; i < 100; ++i)
+		{
+			Note* note = clip->notes()[index(generator)];
+			note->setPos(note->pos() + DefaultTicksPerBar);
+			note->setKey(note->key() + 1);
+		}
+		emit clip->dataChanged();
+		compare();
+
+		// only the dragged notes are updated
+		NoteVector moved;
+		for (int i = 0; i < 20; ++i)
+		{
+			Note* note = clip->notes()[index(generator)];
+			note->setPos(note->pos() + DefaultTicksPerBar / 4);
+			note->setKey(note->key() - 1);
+			note->setLength(note->length() + 1);
+			moved.push_back(note);
+		}
+		clip->notesMoved(moved);
+		compare();
+
+		clip->rearrangeAllNotes();
+		compare();
+
+		for (int i = 0; i < 100; ++i)
+		{
+			clip->removeNote(clip->notes()[i * 10]);
+		}
+		compare();
+
+		clip->addNote(Note(TimePos(DefaultTicksPerBar), TimePos(0), 60), false);
+		compare();
+	}
+
+	void ScriptedEditBenchmark_data()
+	{
+		QTest::addColumn<bool>("indexed");
+		QTest::addColumn<bool>("incremental");
+		QTest::newRow("linear scan") << false << false;
+		QTest::newRow("index rebuilt per step") << true << false;
+		QTest::newRow("index updated per step") << true << true;
+	}
+
+	//! Replays what editing a dense clip in the piano roll asks for per
+	//! mouse move: the notes to paint, the note under the cursor and the
+	//! notes in the selection rectangle, with a note dragged every time.
+	//! The index is either rebuilt after every step or follows the note.
+	void ScriptedEditBenchmark()
+	{
+		QFETCH(bool, indexed);
+		QFETCH(bool, incremental);
+
+		std::mt19937 generator(1);
+		MidiClip* clip = createClip();
+		fill(clip, DenseNotes, generator);
+
+		const auto query = [&](tick_t from, tick_t to, int lowKey, int highKey)
+		{
+			return indexed
+				? clip->notesInRange(from, to, lowKey, highKey)
+				: scan(clip, from, to, lowKey, highKey);
+		};
+
+		std::uniform_int_distribution<int> tick(0, clip->length() - VisibleTicks);
+		std::uniform_int_distribution<int> index(0, DenseNotes - 1);
+		std::size_t found = 0;
+		QBENCHMARK
+		{
+			const int view = tick(generator);
+			Note* dragged = clip->notes()[index(generator)];
+
+			for (int step = 0; step < 16; ++step)
+			{
+				dragged->setPos(dragged->pos() + 1);
+				if (incremental)
+				{
+					clip->notesMoved({dragged});
+				}
+				else
+				{
+					emit clip->dataChanged();
+				}
+
+				found += query(view, view + VisibleTicks, 0, NumKeys - 1).size();
+				found += query(dragged->pos(), dragged->pos(), dragged->key(), dragged->key()).size();
+				found += query(view, view + DefaultTicksPerBar, 48, 60).size();
+			}
+		}
+		QVERIFY(found > 0);
+	}
+
+	//! Compares the heap used by notes without detuning allocated one by
+	//! one with the same notes in a NoteArena
+	void NoteArenaMemoryBenchmark()
+	{
+#ifdef HAS_MALLINFO2
+		constexpr int Notes = 10000;
+		const auto heapUsed = [] { return mallinfo2().uordblks; };
+		const auto note = [](int i) { return Note(TimePos(DefaultTicksPerBar), TimePos(i * 4), DefaultKey); };
+
+		std::vector<Note*> separate;
+		separate.reserve(Notes);
+		std::size_t before = heapUsed();
+		for (int i = 0; i < Notes; ++i)
+		{
+			separate.push_back(new Note(note(i)));
+		}
+		const std::size_t separateBytes = heapUsed() - before;
+		for (Note* n : separate)
+		{
+			delete n;
+		}
+
+		NoteArena arena;
+		std::vector<Note*> inArena;
+		inArena.reserve(Notes);
+		before = heapUsed();
+		for (int i = 0; i < Notes; ++i)
+		{
+			inArena.push_back(arena.create(note(i)));
+		}
+		const std::size_t arenaBytes = heapUsed() - before;
+		for (Note* n : inArena)
+		{
+			arena.destroy(n);
+		}
+
+		qInfo("Heap per note of %zu bytes: %zu bytes allocated separately, %zu bytes in an arena",
+			sizeof(Note), separateBytes / Notes, arenaBytes / Notes);
+		QVERIFY(arenaBytes < separateBytes);
+#else
+		QSKIP("Measuring the heap requires glibc 2.33 or later");
+#endif
+	}
+
+	//! Measures what a detuning adds to a note, which notes used to create
+	//! up front
+	void NoteDetuningMemoryBenchmark()
+	{
+#ifdef HAS_MALLINFO2
+		constexpr int Notes = 1000;
+		const auto heapUsed = [] { return mallinfo2().uordblks; };
+
+		std::vector<Note*> notes;
+		notes.reserve(Notes);
+		const std::size_t before = heapUsed();
+		for (int i = 0; i < Notes; ++i)
+		{
+			notes.push_back(new Note(TimePos(DefaultTicksPerBar), TimePos(i * 4), DefaultKey));
+		}
+		const std::size_t plainBytes = heapUsed() - before;
+		for (Note* note : notes)
+		{
+			note->createDetuning();
+		}
+		const std::size_t detunedBytes = heapUsed() - before;
+		for (Note* note : notes)
+		{
+			delete note;
+		}
+
+		qInfo("Heap per note: %zu bytes without detuning, %zu bytes with one",
+			plainBytes / Notes, detunedBytes / Notes);
+		QVERIFY(plainBytes < detunedBytes);
+#else
+		QSKIP("Measuring the heap requires glibc 2.33 or later");
+#endif
+	}
+} MidiClipTests;
+
+#include "MidiClipTest.moc"
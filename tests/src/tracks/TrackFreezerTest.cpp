@@ -0,0 +1,119 @@
+/*
+ * TrackFreezerTest.cpp
+ *
+ * Copyright (c) 2026 LMMS Developers
+ *
+ * This file is part of LMMS - https://lmms.io
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "QTestSuite.h"
+
+#include <vector>
+
+#include "InstrumentTrack.h"
+#include "MidiClip.h"
+#include "PatternStore.h"
+#include "TrackFreezer.h"
+
+#include "Engine.h"
+#include "Song.h"
+
+using namespace lmms;
+
+class TrackFreezerTest : QTestSuite
+{
+	Q_OBJECT
+private slots:
+	void init()
+	{
+		m_tempo = Engine::getSong()->getTempo();
+	}
+
+	void cleanup()
+	{
+		for (Track* track : m_tracks)
+		{
+			delete track;
+		}
+		m_tracks.clear();
+		Engine::getSong()->setTempo(m_tempo);
+	}
+
+	void StateKeyTests()
+	{
+		auto track = dynamic_cast<InstrumentTrack*>(createTrack(Track::InstrumentTrack, Engine::getSong()));
+		auto clip = dynamic_cast<MidiClip*>(track->createClip(0));
+		clip->addNote(Note(TimePos(DefaultTicksPerBar / 4), TimePos(0), 60), false);
+
+		const QString key = TrackFreezer::stateKey(track);
+		QCOMPARE(key.size(), 40);
+		QCOMPARE(TrackFreezer::stateKey(track), key);
+
+		// what doesn't change the output doesn't change the key
+		track->setName("Renamed");
+		track->setMuted(true);
+		QCOMPARE(TrackFreezer::stateKey(track), key);
+		track->setMuted(false);
+
+		clip->addNote(Note(TimePos(DefaultTicksPerBar / 4), TimePos(DefaultTicksPerBar / 4), 64), false);
+		QVERIFY(TrackFreezer::stateKey(track) != key);
+
+		const QString noteKey = TrackFreezer::stateKey(track);
+		track->volumeModel()->setValue(50);
+		QVERIFY(TrackFreezer::stateKey(track) != noteKey);
+
+		// the song plays the track at another speed
+		const QString volumeKey = TrackFreezer::stateKey(track);
+		Engine::getSong()->setTempo(Engine::getSong()->getTempo() + 10);
+		QVERIFY(TrackFreezer::stateKey(track) != volumeKey);
+	}
+
+	void CanFreezeTests()
+	{
+		TrackFreezer* freezer = Engine::trackFreezer();
+		QString reason;
+
+		auto track = createTrack(Track::InstrumentTrack, Engine::getSong());
+		QVERIFY(freezer->canFreeze(track, &reason));
+
+		// only the song editor plays tracks along with the song
+		auto patternTrack = createTrack(Track::InstrumentTrack, Engine::patternStore());
+		QVERIFY(!freezer->canFreeze(patternTrack, &reason));
+		QVERIFY(!reason.isEmpty());
+
+		auto sampleTrack = createTrack(Track::SampleTrack, Engine::getSong());
+		QVERIFY(!freezer->canFreeze(sampleTrack));
+
+		QVERIFY(!TrackFreezer::hasStem(QString()));
+	}
+
+private:
+	//! Create a track which is deleted after the test
+	Track* createTrack(Track::TrackTypes type, TrackContainer* container)
+	{
+		Track* track = Track::create(type, container);
+		m_tracks.push_back(track);
+		return track;
+	}
+
+	int m_tempo;
+	std::vector<Track*> m_tracks;
+} TrackFreezerTests;
+
+#include "TrackFreezerTest.moc"